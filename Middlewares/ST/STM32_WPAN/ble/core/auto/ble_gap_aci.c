@@ -51,7 +51,7 @@ tBleStatus aci_gap_set_limited_discoverable(uint8_t Advertising_Type,
                                             uint16_t Slave_Conn_Interval_Max)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_set_limited_discoverable_cp0 *cp0 = (aci_gap_set_limited_discoverable_cp0*)(cmd_buffer);
   aci_gap_set_limited_discoverable_cp1 *cp1 = (aci_gap_set_limited_discoverable_cp1*)(cmd_buffer + 1 + 2 + 2 + 1 + 1 + 1 + Local_Name_Length * (sizeof(uint8_t)));
   aci_gap_set_limited_discoverable_cp2 *cp2 = (aci_gap_set_limited_discoverable_cp2*)(cmd_buffer + 1 + 2 + 2 + 1 + 1 + 1 + Local_Name_Length * (sizeof(uint8_t)) + 1 + Service_Uuid_length * (sizeof(uint8_t)));
@@ -96,7 +96,7 @@ tBleStatus aci_gap_set_limited_discoverable(uint8_t Advertising_Type,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -118,7 +118,7 @@ tBleStatus aci_gap_set_discoverable(uint8_t Advertising_Type,
                                     uint16_t Slave_Conn_Interval_Max)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_set_discoverable_cp0 *cp0 = (aci_gap_set_discoverable_cp0*)(cmd_buffer);
   aci_gap_set_discoverable_cp1 *cp1 = (aci_gap_set_discoverable_cp1*)(cmd_buffer + 1 + 2 + 2 + 1 + 1 + 1 + Local_Name_Length * (sizeof(uint8_t)));
   aci_gap_set_discoverable_cp2 *cp2 = (aci_gap_set_discoverable_cp2*)(cmd_buffer + 1 + 2 + 2 + 1 + 1 + 1 + Local_Name_Length * (sizeof(uint8_t)) + 1 + Service_Uuid_length * (sizeof(uint8_t)));
@@ -162,7 +162,7 @@ tBleStatus aci_gap_set_discoverable(uint8_t Advertising_Type,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -179,7 +179,7 @@ tBleStatus aci_gap_set_direct_connectable(uint8_t Own_Address_Type,
                                           uint16_t Advertising_Interval_Max)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_set_direct_connectable_cp0 *cp0 = (aci_gap_set_direct_connectable_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -202,7 +202,7 @@ tBleStatus aci_gap_set_direct_connectable(uint8_t Own_Address_Type,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -214,7 +214,7 @@ tBleStatus aci_gap_set_direct_connectable(uint8_t Own_Address_Type,
 tBleStatus aci_gap_set_io_capability(uint8_t IO_Capability)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_set_io_capability_cp0 *cp0 = (aci_gap_set_io_capability_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -227,7 +227,7 @@ tBleStatus aci_gap_set_io_capability(uint8_t IO_Capability)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -247,7 +247,7 @@ tBleStatus aci_gap_set_authentication_requirement(uint8_t Bonding_Mode,
                                                   uint8_t Identity_Address_Type)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_set_authentication_requirement_cp0 *cp0 = (aci_gap_set_authentication_requirement_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -276,7 +276,7 @@ tBleStatus aci_gap_set_authentication_requirement(uint8_t Bonding_Mode,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -289,7 +289,7 @@ tBleStatus aci_gap_set_authorization_requirement(uint16_t Connection_Handle,
                                                  uint8_t Authorization_Enable)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_set_authorization_requirement_cp0 *cp0 = (aci_gap_set_authorization_requirement_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -304,7 +304,7 @@ tBleStatus aci_gap_set_authorization_requirement(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -317,7 +317,7 @@ tBleStatus aci_gap_pass_key_resp(uint16_t Connection_Handle,
                                  uint32_t Pass_Key)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_pass_key_resp_cp0 *cp0 = (aci_gap_pass_key_resp_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -332,7 +332,7 @@ tBleStatus aci_gap_pass_key_resp(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -345,7 +345,7 @@ tBleStatus aci_gap_authorization_resp(uint16_t Connection_Handle,
                                       uint8_t Authorize)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_authorization_resp_cp0 *cp0 = (aci_gap_authorization_resp_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -360,7 +360,7 @@ tBleStatus aci_gap_authorization_resp(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -377,7 +377,7 @@ tBleStatus aci_gap_init(uint8_t Role,
                         uint16_t *Appearance_Char_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_init_cp0 *cp0 = (aci_gap_init_cp0*)(cmd_buffer);
   aci_gap_init_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -395,7 +395,7 @@ tBleStatus aci_gap_init(uint8_t Role,
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -411,7 +411,7 @@ tBleStatus aci_gap_set_non_connectable(uint8_t Advertising_Event_Type,
                                        uint8_t Own_Address_Type)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_set_non_connectable_cp0 *cp0 = (aci_gap_set_non_connectable_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -426,7 +426,7 @@ tBleStatus aci_gap_set_non_connectable(uint8_t Advertising_Event_Type,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -441,7 +441,7 @@ tBleStatus aci_gap_set_undirected_connectable(uint16_t Advertising_Interval_Min,
                                               uint8_t Adv_Filter_Policy)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_set_undirected_connectable_cp0 *cp0 = (aci_gap_set_undirected_connectable_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -460,7 +460,7 @@ tBleStatus aci_gap_set_undirected_connectable(uint16_t Advertising_Interval_Min,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -472,7 +472,7 @@ tBleStatus aci_gap_set_undirected_connectable(uint16_t Advertising_Interval_Min,
 tBleStatus aci_gap_slave_security_req(uint16_t Connection_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_slave_security_req_cp0 *cp0 = (aci_gap_slave_security_req_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -486,7 +486,7 @@ tBleStatus aci_gap_slave_security_req(uint16_t Connection_Handle)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -499,7 +499,7 @@ tBleStatus aci_gap_update_adv_data(uint8_t AdvDataLen,
                                    uint8_t AdvData[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_update_adv_data_cp0 *cp0 = (aci_gap_update_adv_data_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -514,7 +514,7 @@ tBleStatus aci_gap_update_adv_data(uint8_t AdvDataLen,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -526,7 +526,7 @@ tBleStatus aci_gap_update_adv_data(uint8_t AdvDataLen,
 tBleStatus aci_gap_delete_ad_type(uint8_t ADType)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_delete_ad_type_cp0 *cp0 = (aci_gap_delete_ad_type_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -539,7 +539,7 @@ tBleStatus aci_gap_delete_ad_type(uint8_t ADType)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -553,7 +553,7 @@ tBleStatus aci_gap_get_security_level(uint16_t Connection_Handle,
                                       uint8_t *Security_Level)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_get_security_level_cp0 *cp0 = (aci_gap_get_security_level_cp0*)(cmd_buffer);
   aci_gap_get_security_level_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -567,7 +567,7 @@ tBleStatus aci_gap_get_security_level(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -581,7 +581,7 @@ tBleStatus aci_gap_get_security_level(uint16_t Connection_Handle,
 tBleStatus aci_gap_set_event_mask(uint16_t GAP_Evt_Mask)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_set_event_mask_cp0 *cp0 = (aci_gap_set_event_mask_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -594,7 +594,7 @@ tBleStatus aci_gap_set_event_mask(uint16_t GAP_Evt_Mask)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -625,7 +625,7 @@ tBleStatus aci_gap_terminate(uint16_t Connection_Handle,
                              uint8_t Reason)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_terminate_cp0 *cp0 = (aci_gap_terminate_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -641,7 +641,7 @@ tBleStatus aci_gap_terminate(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -671,7 +671,7 @@ tBleStatus aci_gap_clear_security_db(void)
 tBleStatus aci_gap_allow_rebond(uint16_t Connection_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_allow_rebond_cp0 *cp0 = (aci_gap_allow_rebond_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -684,7 +684,7 @@ tBleStatus aci_gap_allow_rebond(uint16_t Connection_Handle)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -699,7 +699,7 @@ tBleStatus aci_gap_start_limited_discovery_proc(uint16_t LE_Scan_Interval,
                                                 uint8_t Filter_Duplicates)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_start_limited_discovery_proc_cp0 *cp0 = (aci_gap_start_limited_discovery_proc_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -719,7 +719,7 @@ tBleStatus aci_gap_start_limited_discovery_proc(uint16_t LE_Scan_Interval,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -734,7 +734,7 @@ tBleStatus aci_gap_start_general_discovery_proc(uint16_t LE_Scan_Interval,
                                                 uint8_t Filter_Duplicates)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_start_general_discovery_proc_cp0 *cp0 = (aci_gap_start_general_discovery_proc_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -754,7 +754,7 @@ tBleStatus aci_gap_start_general_discovery_proc(uint16_t LE_Scan_Interval,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -776,7 +776,7 @@ tBleStatus aci_gap_start_name_discovery_proc(uint16_t LE_Scan_Interval,
                                              uint16_t Maximum_CE_Length)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_start_name_discovery_proc_cp0 *cp0 = (aci_gap_start_name_discovery_proc_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -810,7 +810,7 @@ tBleStatus aci_gap_start_name_discovery_proc(uint16_t LE_Scan_Interval,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -832,7 +832,7 @@ tBleStatus aci_gap_start_auto_connection_establish_proc(uint16_t LE_Scan_Interva
                                                         Whitelist_Entry_t Whitelist_Entry[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_start_auto_connection_establish_proc_cp0 *cp0 = (aci_gap_start_auto_connection_establish_proc_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -866,7 +866,7 @@ tBleStatus aci_gap_start_auto_connection_establish_proc(uint16_t LE_Scan_Interva
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -883,7 +883,7 @@ tBleStatus aci_gap_start_general_connection_establish_proc(uint8_t LE_Scan_Type,
                                                            uint8_t Filter_Duplicates)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_start_general_connection_establish_proc_cp0 *cp0 = (aci_gap_start_general_connection_establish_proc_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -907,7 +907,7 @@ tBleStatus aci_gap_start_general_connection_establish_proc(uint8_t LE_Scan_Type,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -926,7 +926,7 @@ tBleStatus aci_gap_start_selective_connection_establish_proc(uint8_t LE_Scan_Typ
                                                              Whitelist_Entry_t Whitelist_Entry[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_start_selective_connection_establish_proc_cp0 *cp0 = (aci_gap_start_selective_connection_establish_proc_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -954,7 +954,7 @@ tBleStatus aci_gap_start_selective_connection_establish_proc(uint8_t LE_Scan_Typ
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -976,7 +976,7 @@ tBleStatus aci_gap_create_connection(uint16_t LE_Scan_Interval,
                                      uint16_t Maximum_CE_Length)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_create_connection_cp0 *cp0 = (aci_gap_create_connection_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1010,7 +1010,7 @@ tBleStatus aci_gap_create_connection(uint16_t LE_Scan_Interval,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1022,7 +1022,7 @@ tBleStatus aci_gap_create_connection(uint16_t LE_Scan_Interval,
 tBleStatus aci_gap_terminate_gap_proc(uint8_t Procedure_Code)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_terminate_gap_proc_cp0 *cp0 = (aci_gap_terminate_gap_proc_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1035,7 +1035,7 @@ tBleStatus aci_gap_terminate_gap_proc(uint8_t Procedure_Code)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1053,7 +1053,7 @@ tBleStatus aci_gap_start_connection_update(uint16_t Connection_Handle,
                                            uint16_t Maximum_CE_Length)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_start_connection_update_cp0 *cp0 = (aci_gap_start_connection_update_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1079,7 +1079,7 @@ tBleStatus aci_gap_start_connection_update(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1092,7 +1092,7 @@ tBleStatus aci_gap_send_pairing_req(uint16_t Connection_Handle,
                                     uint8_t Force_Rebond)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_send_pairing_req_cp0 *cp0 = (aci_gap_send_pairing_req_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1108,7 +1108,7 @@ tBleStatus aci_gap_send_pairing_req(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1121,7 +1121,7 @@ tBleStatus aci_gap_resolve_private_addr(uint8_t Address[6],
                                         uint8_t Actual_Address[6])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_resolve_private_addr_cp0 *cp0 = (aci_gap_resolve_private_addr_cp0*)(cmd_buffer);
   aci_gap_resolve_private_addr_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -1135,7 +1135,7 @@ tBleStatus aci_gap_resolve_private_addr(uint8_t Address[6],
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -1155,7 +1155,7 @@ tBleStatus aci_gap_set_broadcast_mode(uint16_t Advertising_Interval_Min,
                                       Whitelist_Entry_t Whitelist_Entry[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_set_broadcast_mode_cp0 *cp0 = (aci_gap_set_broadcast_mode_cp0*)(cmd_buffer);
   aci_gap_set_broadcast_mode_cp1 *cp1 = (aci_gap_set_broadcast_mode_cp1*)(cmd_buffer + 2 + 2 + 1 + 1 + 1 + Adv_Data_Length * (sizeof(uint8_t)));
   tBleStatus status = 0;
@@ -1188,7 +1188,7 @@ tBleStatus aci_gap_set_broadcast_mode(uint16_t Advertising_Interval_Min,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1205,7 +1205,7 @@ tBleStatus aci_gap_start_observation_proc(uint16_t LE_Scan_Interval,
                                           uint8_t Scanning_Filter_Policy)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_start_observation_proc_cp0 *cp0 = (aci_gap_start_observation_proc_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1229,7 +1229,7 @@ tBleStatus aci_gap_start_observation_proc(uint16_t LE_Scan_Interval,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1264,7 +1264,7 @@ tBleStatus aci_gap_is_device_bonded(uint8_t Peer_Address_Type,
                                     uint8_t Peer_Address[6])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_is_device_bonded_cp0 *cp0 = (aci_gap_is_device_bonded_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1279,7 +1279,7 @@ tBleStatus aci_gap_is_device_bonded(uint8_t Peer_Address_Type,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1292,7 +1292,7 @@ tBleStatus aci_gap_numeric_comparison_value_confirm_yesno(uint16_t Connection_Ha
                                                           uint8_t Confirm_Yes_No)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_numeric_comparison_value_confirm_yesno_cp0 *cp0 = (aci_gap_numeric_comparison_value_confirm_yesno_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1307,7 +1307,7 @@ tBleStatus aci_gap_numeric_comparison_value_confirm_yesno(uint16_t Connection_Ha
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1320,7 +1320,7 @@ tBleStatus aci_gap_passkey_input(uint16_t Connection_Handle,
                                  uint8_t Input_Type)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_passkey_input_cp0 *cp0 = (aci_gap_passkey_input_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1335,7 +1335,7 @@ tBleStatus aci_gap_passkey_input(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1351,7 +1351,7 @@ tBleStatus aci_gap_get_oob_data(uint8_t OOB_Data_Type,
                                 uint8_t OOB_Data[16])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_get_oob_data_cp0 *cp0 = (aci_gap_get_oob_data_cp0*)(cmd_buffer);
   aci_gap_get_oob_data_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -1365,7 +1365,7 @@ tBleStatus aci_gap_get_oob_data(uint8_t OOB_Data_Type,
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -1386,7 +1386,7 @@ tBleStatus aci_gap_set_oob_data(uint8_t Device_Type,
                                 uint8_t OOB_Data[16])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_set_oob_data_cp0 *cp0 = (aci_gap_set_oob_data_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1409,7 +1409,7 @@ tBleStatus aci_gap_set_oob_data(uint8_t Device_Type,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1423,7 +1423,7 @@ tBleStatus aci_gap_add_devices_to_resolving_list(uint8_t Num_of_Resolving_list_E
                                                  uint8_t Clear_Resolving_List)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_add_devices_to_resolving_list_cp0 *cp0 = (aci_gap_add_devices_to_resolving_list_cp0*)(cmd_buffer);
   aci_gap_add_devices_to_resolving_list_cp1 *cp1 = (aci_gap_add_devices_to_resolving_list_cp1*)(cmd_buffer + 1 + Num_of_Resolving_list_Entries * (sizeof(Whitelist_Identity_Entry_t)));
   tBleStatus status = 0;
@@ -1446,7 +1446,7 @@ tBleStatus aci_gap_add_devices_to_resolving_list(uint8_t Num_of_Resolving_list_E
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1459,7 +1459,7 @@ tBleStatus aci_gap_remove_bonded_device(uint8_t Peer_Identity_Address_Type,
                                         uint8_t Peer_Identity_Address[6])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gap_remove_bonded_device_cp0 *cp0 = (aci_gap_remove_bonded_device_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1474,7 +1474,7 @@ tBleStatus aci_gap_remove_bonded_device(uint8_t Peer_Identity_Address_Type,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -45,7 +45,7 @@ tBleStatus aci_gatt_add_service(uint8_t Service_UUID_Type,
                                 uint16_t *Service_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_add_service_cp0 *cp0 = (aci_gatt_add_service_cp0*)(cmd_buffer);
   aci_gatt_add_service_cp1 *cp1 = (aci_gatt_add_service_cp1*)(cmd_buffer + 1 + (Service_UUID_Type == 1 ? 2 : (Service_UUID_Type == 2 ? 16 : 0)));
   aci_gatt_add_service_rp0 resp;
@@ -59,7 +59,7 @@ tBleStatus aci_gatt_add_service(uint8_t Service_UUID_Type,
     switch (Service_UUID_Type) {
       case 1: size = 2; break;
       case 2: size = 16; break;
-      default: return BLE_STATUS_ERROR;
+      default: hci_cmd_cancel(); return BLE_STATUS_ERROR;
     }
     Osal_MemCpy((void *) &cp0->Service_UUID, (const void *) Service_UUID, size);
     index_input += size;
@@ -79,7 +79,7 @@ tBleStatus aci_gatt_add_service(uint8_t Service_UUID_Type,
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -97,7 +97,7 @@ tBleStatus aci_gatt_include_service(uint16_t Service_Handle,
                                     uint16_t *Include_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_include_service_cp0 *cp0 = (aci_gatt_include_service_cp0*)(cmd_buffer);
   aci_gatt_include_service_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -120,7 +120,7 @@ tBleStatus aci_gatt_include_service(uint16_t Service_Handle,
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -142,7 +142,7 @@ tBleStatus aci_gatt_add_char(uint16_t Service_Handle,
                              uint16_t *Char_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_add_char_cp0 *cp0 = (aci_gatt_add_char_cp0*)(cmd_buffer);
   aci_gatt_add_char_cp1 *cp1 = (aci_gatt_add_char_cp1*)(cmd_buffer + 2 + 1 + (Char_UUID_Type == 1 ? 2 : (Char_UUID_Type == 2 ? 16 : 0)));
   aci_gatt_add_char_rp0 resp;
@@ -158,7 +158,7 @@ tBleStatus aci_gatt_add_char(uint16_t Service_Handle,
     switch (Char_UUID_Type) {
       case 1: size = 2; break;
       case 2: size = 16; break;
-      default: return BLE_STATUS_ERROR;
+      default: hci_cmd_cancel(); return BLE_STATUS_ERROR;
     }
     Osal_MemCpy((void *) &cp0->Char_UUID, (const void *) Char_UUID, size);
     index_input += size;
@@ -194,7 +194,7 @@ tBleStatus aci_gatt_add_char(uint16_t Service_Handle,
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -219,7 +219,7 @@ tBleStatus aci_gatt_add_char_desc(uint16_t Service_Handle,
                                   uint16_t *Char_Desc_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_add_char_desc_cp0 *cp0 = (aci_gatt_add_char_desc_cp0*)(cmd_buffer);
   aci_gatt_add_char_desc_cp1 *cp1 = (aci_gatt_add_char_desc_cp1*)(cmd_buffer + 2 + 2 + 1 + (Char_Desc_Uuid_Type == 1 ? 2 : (Char_Desc_Uuid_Type == 2 ? 16 : 0)));
   aci_gatt_add_char_desc_cp2 *cp2 = (aci_gatt_add_char_desc_cp2*)(cmd_buffer + 2 + 2 + 1 + (Char_Desc_Uuid_Type == 1 ? 2 : (Char_Desc_Uuid_Type == 2 ? 16 : 0)) + 1 + 1 + Char_Desc_Value_Length * (sizeof(uint8_t)));
@@ -238,7 +238,7 @@ tBleStatus aci_gatt_add_char_desc(uint16_t Service_Handle,
     switch (Char_Desc_Uuid_Type) {
       case 1: size = 2; break;
       case 2: size = 16; break;
-      default: return BLE_STATUS_ERROR;
+      default: hci_cmd_cancel(); return BLE_STATUS_ERROR;
     }
     Osal_MemCpy((void *) &cp0->Char_Desc_Uuid, (const void *) Char_Desc_Uuid, size);
     index_input += size;
@@ -280,7 +280,7 @@ tBleStatus aci_gatt_add_char_desc(uint16_t Service_Handle,
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -297,7 +297,7 @@ tBleStatus aci_gatt_update_char_value(uint16_t Service_Handle,
                                       uint8_t Char_Value[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_update_char_value_cp0 *cp0 = (aci_gatt_update_char_value_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -318,7 +318,7 @@ tBleStatus aci_gatt_update_char_value(uint16_t Service_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -331,7 +331,7 @@ tBleStatus aci_gatt_del_char(uint16_t Serv_Handle,
                              uint16_t Char_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_del_char_cp0 *cp0 = (aci_gatt_del_char_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -346,7 +346,7 @@ tBleStatus aci_gatt_del_char(uint16_t Serv_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -358,7 +358,7 @@ tBleStatus aci_gatt_del_char(uint16_t Serv_Handle,
 tBleStatus aci_gatt_del_service(uint16_t Serv_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_del_service_cp0 *cp0 = (aci_gatt_del_service_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -371,7 +371,7 @@ tBleStatus aci_gatt_del_service(uint16_t Serv_Handle)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -384,7 +384,7 @@ tBleStatus aci_gatt_del_include_service(uint16_t Serv_Handle,
                                         uint16_t Include_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_del_include_service_cp0 *cp0 = (aci_gatt_del_include_service_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -399,7 +399,7 @@ tBleStatus aci_gatt_del_include_service(uint16_t Serv_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -411,7 +411,7 @@ tBleStatus aci_gatt_del_include_service(uint16_t Serv_Handle,
 tBleStatus aci_gatt_set_event_mask(uint32_t GATT_Evt_Mask)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_set_event_mask_cp0 *cp0 = (aci_gatt_set_event_mask_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -424,7 +424,7 @@ tBleStatus aci_gatt_set_event_mask(uint32_t GATT_Evt_Mask)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -436,7 +436,7 @@ tBleStatus aci_gatt_set_event_mask(uint32_t GATT_Evt_Mask)
 tBleStatus aci_gatt_exchange_config(uint16_t Connection_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_exchange_config_cp0 *cp0 = (aci_gatt_exchange_config_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -450,7 +450,7 @@ tBleStatus aci_gatt_exchange_config(uint16_t Connection_Handle)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -464,7 +464,7 @@ tBleStatus aci_att_find_info_req(uint16_t Connection_Handle,
                                  uint16_t End_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_att_find_info_req_cp0 *cp0 = (aci_att_find_info_req_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -482,7 +482,7 @@ tBleStatus aci_att_find_info_req(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -499,7 +499,7 @@ tBleStatus aci_att_find_by_type_value_req(uint16_t Connection_Handle,
                                           uint8_t Attribute_Val[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_att_find_by_type_value_req_cp0 *cp0 = (aci_att_find_by_type_value_req_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -523,7 +523,7 @@ tBleStatus aci_att_find_by_type_value_req(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -539,7 +539,7 @@ tBleStatus aci_att_read_by_type_req(uint16_t Connection_Handle,
                                     UUID_t *UUID)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_att_read_by_type_req_cp0 *cp0 = (aci_att_read_by_type_req_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -562,7 +562,7 @@ tBleStatus aci_att_read_by_type_req(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -578,7 +578,7 @@ tBleStatus aci_att_read_by_group_type_req(uint16_t Connection_Handle,
                                           UUID_t *UUID)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_att_read_by_group_type_req_cp0 *cp0 = (aci_att_read_by_group_type_req_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -601,7 +601,7 @@ tBleStatus aci_att_read_by_group_type_req(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -617,7 +617,7 @@ tBleStatus aci_att_prepare_write_req(uint16_t Connection_Handle,
                                      uint8_t Attribute_Val[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_att_prepare_write_req_cp0 *cp0 = (aci_att_prepare_write_req_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -639,7 +639,7 @@ tBleStatus aci_att_prepare_write_req(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -652,7 +652,7 @@ tBleStatus aci_att_execute_write_req(uint16_t Connection_Handle,
                                      uint8_t Execute)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_att_execute_write_req_cp0 *cp0 = (aci_att_execute_write_req_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -668,7 +668,7 @@ tBleStatus aci_att_execute_write_req(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -680,7 +680,7 @@ tBleStatus aci_att_execute_write_req(uint16_t Connection_Handle,
 tBleStatus aci_gatt_disc_all_primary_services(uint16_t Connection_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_disc_all_primary_services_cp0 *cp0 = (aci_gatt_disc_all_primary_services_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -694,7 +694,7 @@ tBleStatus aci_gatt_disc_all_primary_services(uint16_t Connection_Handle)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -708,7 +708,7 @@ tBleStatus aci_gatt_disc_primary_service_by_uuid(uint16_t Connection_Handle,
                                                  UUID_t *UUID)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_disc_primary_service_by_uuid_cp0 *cp0 = (aci_gatt_disc_primary_service_by_uuid_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -727,7 +727,7 @@ tBleStatus aci_gatt_disc_primary_service_by_uuid(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -741,7 +741,7 @@ tBleStatus aci_gatt_find_included_services(uint16_t Connection_Handle,
                                            uint16_t End_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_find_included_services_cp0 *cp0 = (aci_gatt_find_included_services_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -759,7 +759,7 @@ tBleStatus aci_gatt_find_included_services(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -773,7 +773,7 @@ tBleStatus aci_gatt_disc_all_char_of_service(uint16_t Connection_Handle,
                                              uint16_t End_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_disc_all_char_of_service_cp0 *cp0 = (aci_gatt_disc_all_char_of_service_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -791,7 +791,7 @@ tBleStatus aci_gatt_disc_all_char_of_service(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -807,7 +807,7 @@ tBleStatus aci_gatt_disc_char_by_uuid(uint16_t Connection_Handle,
                                       UUID_t *UUID)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_disc_char_by_uuid_cp0 *cp0 = (aci_gatt_disc_char_by_uuid_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -830,7 +830,7 @@ tBleStatus aci_gatt_disc_char_by_uuid(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -844,7 +844,7 @@ tBleStatus aci_gatt_disc_all_char_desc(uint16_t Connection_Handle,
                                        uint16_t End_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_disc_all_char_desc_cp0 *cp0 = (aci_gatt_disc_all_char_desc_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -862,7 +862,7 @@ tBleStatus aci_gatt_disc_all_char_desc(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -875,7 +875,7 @@ tBleStatus aci_gatt_read_char_value(uint16_t Connection_Handle,
                                     uint16_t Attr_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_read_char_value_cp0 *cp0 = (aci_gatt_read_char_value_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -891,7 +891,7 @@ tBleStatus aci_gatt_read_char_value(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -907,7 +907,7 @@ tBleStatus aci_gatt_read_using_char_uuid(uint16_t Connection_Handle,
                                          UUID_t *UUID)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_read_using_char_uuid_cp0 *cp0 = (aci_gatt_read_using_char_uuid_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -930,7 +930,7 @@ tBleStatus aci_gatt_read_using_char_uuid(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -944,7 +944,7 @@ tBleStatus aci_gatt_read_long_char_value(uint16_t Connection_Handle,
                                          uint16_t Val_Offset)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_read_long_char_value_cp0 *cp0 = (aci_gatt_read_long_char_value_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -962,7 +962,7 @@ tBleStatus aci_gatt_read_long_char_value(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -976,7 +976,7 @@ tBleStatus aci_gatt_read_multiple_char_value(uint16_t Connection_Handle,
                                              Handle_Entry_t Handle_Entry[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_read_multiple_char_value_cp0 *cp0 = (aci_gatt_read_multiple_char_value_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -994,7 +994,7 @@ tBleStatus aci_gatt_read_multiple_char_value(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1009,7 +1009,7 @@ tBleStatus aci_gatt_write_char_value(uint16_t Connection_Handle,
                                      uint8_t Attribute_Val[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_write_char_value_cp0 *cp0 = (aci_gatt_write_char_value_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1029,7 +1029,7 @@ tBleStatus aci_gatt_write_char_value(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1045,7 +1045,7 @@ tBleStatus aci_gatt_write_long_char_value(uint16_t Connection_Handle,
                                           uint8_t Attribute_Val[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_write_long_char_value_cp0 *cp0 = (aci_gatt_write_long_char_value_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1067,7 +1067,7 @@ tBleStatus aci_gatt_write_long_char_value(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1083,7 +1083,7 @@ tBleStatus aci_gatt_write_char_reliable(uint16_t Connection_Handle,
                                         uint8_t Attribute_Val[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_write_char_reliable_cp0 *cp0 = (aci_gatt_write_char_reliable_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1105,7 +1105,7 @@ tBleStatus aci_gatt_write_char_reliable(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1121,7 +1121,7 @@ tBleStatus aci_gatt_write_long_char_desc(uint16_t Connection_Handle,
                                          uint8_t Attribute_Val[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_write_long_char_desc_cp0 *cp0 = (aci_gatt_write_long_char_desc_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1143,7 +1143,7 @@ tBleStatus aci_gatt_write_long_char_desc(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1157,7 +1157,7 @@ tBleStatus aci_gatt_read_long_char_desc(uint16_t Connection_Handle,
                                         uint16_t Val_Offset)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_read_long_char_desc_cp0 *cp0 = (aci_gatt_read_long_char_desc_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1175,7 +1175,7 @@ tBleStatus aci_gatt_read_long_char_desc(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1190,7 +1190,7 @@ tBleStatus aci_gatt_write_char_desc(uint16_t Connection_Handle,
                                     uint8_t Attribute_Val[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_write_char_desc_cp0 *cp0 = (aci_gatt_write_char_desc_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1210,7 +1210,7 @@ tBleStatus aci_gatt_write_char_desc(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1223,7 +1223,7 @@ tBleStatus aci_gatt_read_char_desc(uint16_t Connection_Handle,
                                    uint16_t Attr_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_read_char_desc_cp0 *cp0 = (aci_gatt_read_char_desc_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1239,7 +1239,7 @@ tBleStatus aci_gatt_read_char_desc(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1254,7 +1254,7 @@ tBleStatus aci_gatt_write_without_resp(uint16_t Connection_Handle,
                                        uint8_t Attribute_Val[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_write_without_resp_cp0 *cp0 = (aci_gatt_write_without_resp_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1273,7 +1273,7 @@ tBleStatus aci_gatt_write_without_resp(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1288,7 +1288,7 @@ tBleStatus aci_gatt_signed_write_without_resp(uint16_t Connection_Handle,
                                               uint8_t Attribute_Val[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_signed_write_without_resp_cp0 *cp0 = (aci_gatt_signed_write_without_resp_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1307,7 +1307,7 @@ tBleStatus aci_gatt_signed_write_without_resp(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1319,7 +1319,7 @@ tBleStatus aci_gatt_signed_write_without_resp(uint16_t Connection_Handle,
 tBleStatus aci_gatt_confirm_indication(uint16_t Connection_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_confirm_indication_cp0 *cp0 = (aci_gatt_confirm_indication_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1332,7 +1332,7 @@ tBleStatus aci_gatt_confirm_indication(uint16_t Connection_Handle)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1349,7 +1349,7 @@ tBleStatus aci_gatt_write_resp(uint16_t Connection_Handle,
                                uint8_t Attribute_Val[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_write_resp_cp0 *cp0 = (aci_gatt_write_resp_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1372,7 +1372,7 @@ tBleStatus aci_gatt_write_resp(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1384,7 +1384,7 @@ tBleStatus aci_gatt_write_resp(uint16_t Connection_Handle,
 tBleStatus aci_gatt_allow_read(uint16_t Connection_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_allow_read_cp0 *cp0 = (aci_gatt_allow_read_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1397,7 +1397,7 @@ tBleStatus aci_gatt_allow_read(uint16_t Connection_Handle)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1411,7 +1411,7 @@ tBleStatus aci_gatt_set_security_permission(uint16_t Serv_Handle,
                                             uint8_t Security_Permissions)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_set_security_permission_cp0 *cp0 = (aci_gatt_set_security_permission_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1428,7 +1428,7 @@ tBleStatus aci_gatt_set_security_permission(uint16_t Serv_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1445,7 +1445,7 @@ tBleStatus aci_gatt_set_desc_value(uint16_t Serv_Handle,
                                    uint8_t Char_Desc_Value[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_set_desc_value_cp0 *cp0 = (aci_gatt_set_desc_value_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1468,7 +1468,7 @@ tBleStatus aci_gatt_set_desc_value(uint16_t Serv_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1485,7 +1485,7 @@ tBleStatus aci_gatt_read_handle_value(uint16_t Attr_Handle,
                                       uint8_t Value[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_read_handle_value_cp0 *cp0 = (aci_gatt_read_handle_value_cp0*)(cmd_buffer);
   aci_gatt_read_handle_value_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -1503,7 +1503,7 @@ tBleStatus aci_gatt_read_handle_value(uint16_t Attr_Handle,
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -1525,7 +1525,7 @@ tBleStatus aci_gatt_update_char_value_ext(uint16_t Conn_Handle_To_Notify,
                                           uint8_t Value[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_update_char_value_ext_cp0 *cp0 = (aci_gatt_update_char_value_ext_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1552,7 +1552,7 @@ tBleStatus aci_gatt_update_char_value_ext(uint16_t Conn_Handle_To_Notify,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1565,7 +1565,7 @@ tBleStatus aci_gatt_deny_read(uint16_t Connection_Handle,
                               uint8_t Error_Code)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_deny_read_cp0 *cp0 = (aci_gatt_deny_read_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1580,7 +1580,7 @@ tBleStatus aci_gatt_deny_read(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1594,7 +1594,7 @@ tBleStatus aci_gatt_set_access_permission(uint16_t Serv_Handle,
                                           uint8_t Access_Permissions)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_gatt_set_access_permission_cp0 *cp0 = (aci_gatt_set_access_permission_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1611,7 +1611,7 @@ tBleStatus aci_gatt_set_access_permission(uint16_t Serv_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -45,7 +45,7 @@ tBleStatus aci_hal_write_config_data(uint8_t Offset,
                                      uint8_t Value[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_hal_write_config_data_cp0 *cp0 = (aci_hal_write_config_data_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -62,7 +62,7 @@ tBleStatus aci_hal_write_config_data(uint8_t Offset,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -76,7 +76,7 @@ tBleStatus aci_hal_read_config_data(uint8_t Offset,
                                     uint8_t Data[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_hal_read_config_data_cp0 *cp0 = (aci_hal_read_config_data_cp0*)(cmd_buffer);
   aci_hal_read_config_data_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -90,7 +90,7 @@ tBleStatus aci_hal_read_config_data(uint8_t Offset,
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -105,7 +105,7 @@ tBleStatus aci_hal_set_tx_power_level(uint8_t En_High_Power,
                                       uint8_t PA_Level)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_hal_set_tx_power_level_cp0 *cp0 = (aci_hal_set_tx_power_level_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -120,7 +120,7 @@ tBleStatus aci_hal_set_tx_power_level(uint8_t En_High_Power,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -153,7 +153,7 @@ tBleStatus aci_hal_tone_start(uint8_t RF_Channel,
                               uint8_t Freq_offset)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_hal_tone_start_cp0 *cp0 = (aci_hal_tone_start_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -168,7 +168,7 @@ tBleStatus aci_hal_tone_start(uint8_t RF_Channel,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -220,7 +220,7 @@ tBleStatus aci_hal_get_link_status(uint8_t Link_Status[8],
 tBleStatus aci_hal_set_radio_activity_mask(uint16_t Radio_Activity_Mask)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_hal_set_radio_activity_mask_cp0 *cp0 = (aci_hal_set_radio_activity_mask_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -233,7 +233,7 @@ tBleStatus aci_hal_set_radio_activity_mask(uint16_t Radio_Activity_Mask)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -267,7 +267,7 @@ tBleStatus aci_hal_get_anchor_period(uint32_t *Anchor_Period,
 tBleStatus aci_hal_set_event_mask(uint32_t Event_Mask)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_hal_set_event_mask_cp0 *cp0 = (aci_hal_set_event_mask_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -280,7 +280,7 @@ tBleStatus aci_hal_set_event_mask(uint32_t Event_Mask)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -292,7 +292,7 @@ tBleStatus aci_hal_set_event_mask(uint32_t Event_Mask)
 tBleStatus aci_hal_set_smp_eng_config(uint32_t SMP_Config)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_hal_set_smp_eng_config_cp0 *cp0 = (aci_hal_set_smp_eng_config_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -305,7 +305,7 @@ tBleStatus aci_hal_set_smp_eng_config(uint32_t SMP_Config)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -342,7 +342,7 @@ tBleStatus aci_hal_read_radio_reg(uint8_t Register_Address,
                                   uint8_t *reg_val)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_hal_read_radio_reg_cp0 *cp0 = (aci_hal_read_radio_reg_cp0*)(cmd_buffer);
   aci_hal_read_radio_reg_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -356,7 +356,7 @@ tBleStatus aci_hal_read_radio_reg(uint8_t Register_Address,
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -370,7 +370,7 @@ tBleStatus aci_hal_write_radio_reg(uint8_t Register_Address,
                                    uint8_t Register_Value)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_hal_write_radio_reg_cp0 *cp0 = (aci_hal_write_radio_reg_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -385,7 +385,7 @@ tBleStatus aci_hal_write_radio_reg(uint8_t Register_Address,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -417,7 +417,7 @@ tBleStatus aci_hal_read_raw_rssi(uint8_t Value[3])
 tBleStatus aci_hal_rx_start(uint8_t RF_Channel)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_hal_rx_start_cp0 *cp0 = (aci_hal_rx_start_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -430,7 +430,7 @@ tBleStatus aci_hal_rx_start(uint8_t RF_Channel)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
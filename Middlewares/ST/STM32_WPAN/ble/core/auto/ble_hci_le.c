@@ -24,7 +24,7 @@ tBleStatus hci_disconnect(uint16_t Connection_Handle,
                           uint8_t Reason)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_disconnect_cp0 *cp0 = (hci_disconnect_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -40,7 +40,7 @@ tBleStatus hci_disconnect(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -52,7 +52,7 @@ tBleStatus hci_disconnect(uint16_t Connection_Handle,
 tBleStatus hci_read_remote_version_information(uint16_t Connection_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_read_remote_version_information_cp0 *cp0 = (hci_read_remote_version_information_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -66,7 +66,7 @@ tBleStatus hci_read_remote_version_information(uint16_t Connection_Handle)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -78,7 +78,7 @@ tBleStatus hci_read_remote_version_information(uint16_t Connection_Handle)
 tBleStatus hci_set_event_mask(uint8_t Event_Mask[8])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_set_event_mask_cp0 *cp0 = (hci_set_event_mask_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -91,7 +91,7 @@ tBleStatus hci_set_event_mask(uint8_t Event_Mask[8])
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -123,7 +123,7 @@ tBleStatus hci_read_transmit_power_level(uint16_t Connection_Handle,
                                          uint8_t *Transmit_Power_Level)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_read_transmit_power_level_cp0 *cp0 = (hci_read_transmit_power_level_cp0*)(cmd_buffer);
   hci_read_transmit_power_level_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -139,7 +139,7 @@ tBleStatus hci_read_transmit_power_level(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -152,7 +152,7 @@ tBleStatus hci_read_transmit_power_level(uint16_t Connection_Handle,
 tBleStatus hci_set_controller_to_host_flow_control(uint8_t Flow_Control_Enable)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_set_controller_to_host_flow_control_cp0 *cp0 = (hci_set_controller_to_host_flow_control_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -166,7 +166,7 @@ tBleStatus hci_set_controller_to_host_flow_control(uint8_t Flow_Control_Enable)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -181,7 +181,7 @@ tBleStatus hci_host_buffer_size(uint16_t Host_ACL_Data_Packet_Length,
                                 uint16_t Host_Total_Num_Synchronous_Data_Packets)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_host_buffer_size_cp0 *cp0 = (hci_host_buffer_size_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -201,7 +201,7 @@ tBleStatus hci_host_buffer_size(uint16_t Host_ACL_Data_Packet_Length,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -214,7 +214,7 @@ tBleStatus hci_host_number_of_completed_packets(uint8_t Number_Of_Handles,
                                                 Host_Nb_Of_Completed_Pkt_Pair_t Host_Nb_Of_Completed_Pkt_Pair[])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_host_number_of_completed_packets_cp0 *cp0 = (hci_host_number_of_completed_packets_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -230,7 +230,7 @@ tBleStatus hci_host_number_of_completed_packets(uint8_t Number_Of_Handles,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -331,7 +331,7 @@ tBleStatus hci_read_rssi(uint16_t Connection_Handle,
                          uint8_t *RSSI)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_read_rssi_cp0 *cp0 = (hci_read_rssi_cp0*)(cmd_buffer);
   hci_read_rssi_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -345,7 +345,7 @@ tBleStatus hci_read_rssi(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -358,7 +358,7 @@ tBleStatus hci_read_rssi(uint16_t Connection_Handle,
 tBleStatus hci_le_set_event_mask(uint8_t LE_Event_Mask[8])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_set_event_mask_cp0 *cp0 = (hci_le_set_event_mask_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -371,7 +371,7 @@ tBleStatus hci_le_set_event_mask(uint8_t LE_Event_Mask[8])
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -425,7 +425,7 @@ tBleStatus hci_le_read_local_supported_features(uint8_t LE_Features[8])
 tBleStatus hci_le_set_random_address(uint8_t Random_Address[6])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_set_random_address_cp0 *cp0 = (hci_le_set_random_address_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -438,7 +438,7 @@ tBleStatus hci_le_set_random_address(uint8_t Random_Address[6])
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -457,7 +457,7 @@ tBleStatus hci_le_set_advertising_parameters(uint16_t Advertising_Interval_Min,
                                              uint8_t Advertising_Filter_Policy)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_set_advertising_parameters_cp0 *cp0 = (hci_le_set_advertising_parameters_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -484,7 +484,7 @@ tBleStatus hci_le_set_advertising_parameters(uint16_t Advertising_Interval_Min,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -517,7 +517,7 @@ tBleStatus hci_le_set_advertising_data(uint8_t Advertising_Data_Length,
                                        uint8_t Advertising_Data[31])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_set_advertising_data_cp0 *cp0 = (hci_le_set_advertising_data_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -532,7 +532,7 @@ tBleStatus hci_le_set_advertising_data(uint8_t Advertising_Data_Length,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -545,7 +545,7 @@ tBleStatus hci_le_set_scan_response_data(uint8_t Scan_Response_Data_Length,
                                          uint8_t Scan_Response_Data[31])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_set_scan_response_data_cp0 *cp0 = (hci_le_set_scan_response_data_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -560,7 +560,7 @@ tBleStatus hci_le_set_scan_response_data(uint8_t Scan_Response_Data_Length,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -572,7 +572,7 @@ tBleStatus hci_le_set_scan_response_data(uint8_t Scan_Response_Data_Length,
 tBleStatus hci_le_set_advertise_enable(uint8_t Advertising_Enable)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_set_advertise_enable_cp0 *cp0 = (hci_le_set_advertise_enable_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -585,7 +585,7 @@ tBleStatus hci_le_set_advertise_enable(uint8_t Advertising_Enable)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -601,7 +601,7 @@ tBleStatus hci_le_set_scan_parameters(uint8_t LE_Scan_Type,
                                       uint8_t Scanning_Filter_Policy)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_set_scan_parameters_cp0 *cp0 = (hci_le_set_scan_parameters_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -622,7 +622,7 @@ tBleStatus hci_le_set_scan_parameters(uint8_t LE_Scan_Type,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -635,7 +635,7 @@ tBleStatus hci_le_set_scan_enable(uint8_t LE_Scan_Enable,
                                   uint8_t Filter_Duplicates)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_set_scan_enable_cp0 *cp0 = (hci_le_set_scan_enable_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -650,7 +650,7 @@ tBleStatus hci_le_set_scan_enable(uint8_t LE_Scan_Enable,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -673,7 +673,7 @@ tBleStatus hci_le_create_connection(uint16_t LE_Scan_Interval,
                                     uint16_t Maximum_CE_Length)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_create_connection_cp0 *cp0 = (hci_le_create_connection_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -709,7 +709,7 @@ tBleStatus hci_le_create_connection(uint16_t LE_Scan_Interval,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -778,7 +778,7 @@ tBleStatus hci_le_add_device_to_white_list(uint8_t Address_Type,
                                            uint8_t Address[6])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_add_device_to_white_list_cp0 *cp0 = (hci_le_add_device_to_white_list_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -793,7 +793,7 @@ tBleStatus hci_le_add_device_to_white_list(uint8_t Address_Type,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -806,7 +806,7 @@ tBleStatus hci_le_remove_device_from_white_list(uint8_t Address_Type,
                                                 uint8_t Address[6])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_remove_device_from_white_list_cp0 *cp0 = (hci_le_remove_device_from_white_list_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -821,7 +821,7 @@ tBleStatus hci_le_remove_device_from_white_list(uint8_t Address_Type,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -839,7 +839,7 @@ tBleStatus hci_le_connection_update(uint16_t Connection_Handle,
                                     uint16_t Maximum_CE_Length)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_connection_update_cp0 *cp0 = (hci_le_connection_update_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -865,7 +865,7 @@ tBleStatus hci_le_connection_update(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -877,7 +877,7 @@ tBleStatus hci_le_connection_update(uint16_t Connection_Handle,
 tBleStatus hci_le_set_host_channel_classification(uint8_t LE_Channel_Map[5])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_set_host_channel_classification_cp0 *cp0 = (hci_le_set_host_channel_classification_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -890,7 +890,7 @@ tBleStatus hci_le_set_host_channel_classification(uint8_t LE_Channel_Map[5])
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -903,7 +903,7 @@ tBleStatus hci_le_read_channel_map(uint16_t Connection_Handle,
                                    uint8_t LE_Channel_Map[5])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_read_channel_map_cp0 *cp0 = (hci_le_read_channel_map_cp0*)(cmd_buffer);
   hci_le_read_channel_map_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -917,7 +917,7 @@ tBleStatus hci_le_read_channel_map(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -930,7 +930,7 @@ tBleStatus hci_le_read_channel_map(uint16_t Connection_Handle,
 tBleStatus hci_le_read_remote_used_features(uint16_t Connection_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_read_remote_used_features_cp0 *cp0 = (hci_le_read_remote_used_features_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -944,7 +944,7 @@ tBleStatus hci_le_read_remote_used_features(uint16_t Connection_Handle)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -958,7 +958,7 @@ tBleStatus hci_le_encrypt(uint8_t Key[16],
                           uint8_t Encrypted_Data[16])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_encrypt_cp0 *cp0 = (hci_le_encrypt_cp0*)(cmd_buffer);
   hci_le_encrypt_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -974,7 +974,7 @@ tBleStatus hci_le_encrypt(uint8_t Key[16],
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -1010,7 +1010,7 @@ tBleStatus hci_le_start_encryption(uint16_t Connection_Handle,
                                    uint8_t Long_Term_Key[16])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_start_encryption_cp0 *cp0 = (hci_le_start_encryption_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1030,7 +1030,7 @@ tBleStatus hci_le_start_encryption(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1043,7 +1043,7 @@ tBleStatus hci_le_long_term_key_request_reply(uint16_t Connection_Handle,
                                               uint8_t Long_Term_Key[16])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_long_term_key_request_reply_cp0 *cp0 = (hci_le_long_term_key_request_reply_cp0*)(cmd_buffer);
   hci_le_long_term_key_request_reply_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -1059,7 +1059,7 @@ tBleStatus hci_le_long_term_key_request_reply(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -1071,7 +1071,7 @@ tBleStatus hci_le_long_term_key_request_reply(uint16_t Connection_Handle,
 tBleStatus hci_le_long_term_key_requested_negative_reply(uint16_t Connection_Handle)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_long_term_key_requested_negative_reply_cp0 *cp0 = (hci_le_long_term_key_requested_negative_reply_cp0*)(cmd_buffer);
   hci_le_long_term_key_requested_negative_reply_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -1085,7 +1085,7 @@ tBleStatus hci_le_long_term_key_requested_negative_reply(uint16_t Connection_Han
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -1117,7 +1117,7 @@ tBleStatus hci_le_read_supported_states(uint8_t LE_States[8])
 tBleStatus hci_le_receiver_test(uint8_t RX_Frequency)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_receiver_test_cp0 *cp0 = (hci_le_receiver_test_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1130,7 +1130,7 @@ tBleStatus hci_le_receiver_test(uint8_t RX_Frequency)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1144,7 +1144,7 @@ tBleStatus hci_le_transmitter_test(uint8_t TX_Frequency,
                                    uint8_t Packet_Payload)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_transmitter_test_cp0 *cp0 = (hci_le_transmitter_test_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1161,7 +1161,7 @@ tBleStatus hci_le_transmitter_test(uint8_t TX_Frequency,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1195,7 +1195,7 @@ tBleStatus hci_le_set_data_length(uint16_t Connection_Handle,
                                   uint16_t TxTime)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_set_data_length_cp0 *cp0 = (hci_le_set_data_length_cp0*)(cmd_buffer);
   hci_le_set_data_length_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -1213,7 +1213,7 @@ tBleStatus hci_le_set_data_length(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -1248,7 +1248,7 @@ tBleStatus hci_le_write_suggested_default_data_length(uint16_t SuggestedMaxTxOct
                                                       uint16_t SuggestedMaxTxTime)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_write_suggested_default_data_length_cp0 *cp0 = (hci_le_write_suggested_default_data_length_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1263,7 +1263,7 @@ tBleStatus hci_le_write_suggested_default_data_length(uint16_t SuggestedMaxTxOct
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1294,7 +1294,7 @@ tBleStatus hci_le_read_local_p256_public_key(void)
 tBleStatus hci_le_generate_dhkey(uint8_t Remote_P256_Public_Key[64])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_generate_dhkey_cp0 *cp0 = (hci_le_generate_dhkey_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1308,7 +1308,7 @@ tBleStatus hci_le_generate_dhkey(uint8_t Remote_P256_Public_Key[64])
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1323,7 +1323,7 @@ tBleStatus hci_le_add_device_to_resolving_list(uint8_t Peer_Identity_Address_Typ
                                                uint8_t Local_IRK[16])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_add_device_to_resolving_list_cp0 *cp0 = (hci_le_add_device_to_resolving_list_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1342,7 +1342,7 @@ tBleStatus hci_le_add_device_to_resolving_list(uint8_t Peer_Identity_Address_Typ
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1355,7 +1355,7 @@ tBleStatus hci_le_remove_device_from_resolving_list(uint8_t Peer_Identity_Addres
                                                     uint8_t Peer_Identity_Address[6])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_remove_device_from_resolving_list_cp0 *cp0 = (hci_le_remove_device_from_resolving_list_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1370,7 +1370,7 @@ tBleStatus hci_le_remove_device_from_resolving_list(uint8_t Peer_Identity_Addres
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1422,7 +1422,7 @@ tBleStatus hci_le_read_peer_resolvable_address(uint8_t Peer_Identity_Address_Typ
                                                uint8_t Peer_Resolvable_Address[6])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_read_peer_resolvable_address_cp0 *cp0 = (hci_le_read_peer_resolvable_address_cp0*)(cmd_buffer);
   hci_le_read_peer_resolvable_address_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -1438,7 +1438,7 @@ tBleStatus hci_le_read_peer_resolvable_address(uint8_t Peer_Identity_Address_Typ
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -1453,7 +1453,7 @@ tBleStatus hci_le_read_local_resolvable_address(uint8_t Peer_Identity_Address_Ty
                                                 uint8_t Local_Resolvable_Address[6])
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_read_local_resolvable_address_cp0 *cp0 = (hci_le_read_local_resolvable_address_cp0*)(cmd_buffer);
   hci_le_read_local_resolvable_address_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -1469,7 +1469,7 @@ tBleStatus hci_le_read_local_resolvable_address(uint8_t Peer_Identity_Address_Ty
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -1482,7 +1482,7 @@ tBleStatus hci_le_read_local_resolvable_address(uint8_t Peer_Identity_Address_Ty
 tBleStatus hci_le_set_address_resolution_enable(uint8_t Address_Resolution_Enable)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_set_address_resolution_enable_cp0 *cp0 = (hci_le_set_address_resolution_enable_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1495,7 +1495,7 @@ tBleStatus hci_le_set_address_resolution_enable(uint8_t Address_Resolution_Enabl
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1507,7 +1507,7 @@ tBleStatus hci_le_set_address_resolution_enable(uint8_t Address_Resolution_Enabl
 tBleStatus hci_le_set_resolvable_private_address_timeout(uint16_t RPA_Timeout)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_set_resolvable_private_address_timeout_cp0 *cp0 = (hci_le_set_resolvable_private_address_timeout_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1520,7 +1520,7 @@ tBleStatus hci_le_set_resolvable_private_address_timeout(uint16_t RPA_Timeout)
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1560,7 +1560,7 @@ tBleStatus hci_le_read_phy(uint16_t Connection_Handle,
                            uint8_t *RX_PHY)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_read_phy_cp0 *cp0 = (hci_le_read_phy_cp0*)(cmd_buffer);
   hci_le_read_phy_rp0 resp;
   Osal_MemSet(&resp, 0, sizeof(resp));
@@ -1574,7 +1574,7 @@ tBleStatus hci_le_read_phy(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &resp;
   rq.rlen = sizeof(resp);
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (resp.Status) 
   {
@@ -1590,7 +1590,7 @@ tBleStatus hci_le_set_default_phy(uint8_t ALL_PHYS,
                                   uint8_t RX_PHYS)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_set_default_phy_cp0 *cp0 = (hci_le_set_default_phy_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1607,7 +1607,7 @@ tBleStatus hci_le_set_default_phy(uint8_t ALL_PHYS,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1623,7 +1623,7 @@ tBleStatus hci_le_set_phy(uint16_t Connection_Handle,
                           uint16_t PHY_options)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_set_phy_cp0 *cp0 = (hci_le_set_phy_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1645,7 +1645,7 @@ tBleStatus hci_le_set_phy(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1659,7 +1659,7 @@ tBleStatus hci_le_enhanced_receiver_test(uint8_t RX_Frequency,
                                          uint8_t Modulation_Index)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_enhanced_receiver_test_cp0 *cp0 = (hci_le_enhanced_receiver_test_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1676,7 +1676,7 @@ tBleStatus hci_le_enhanced_receiver_test(uint8_t RX_Frequency,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -1691,7 +1691,7 @@ tBleStatus hci_le_enhanced_transmitter_test(uint8_t TX_Frequency,
                                             uint8_t PHY)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   hci_le_enhanced_transmitter_test_cp0 *cp0 = (hci_le_enhanced_transmitter_test_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -1710,7 +1710,7 @@ tBleStatus hci_le_enhanced_transmitter_test(uint8_t TX_Frequency,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -27,7 +27,7 @@ tBleStatus aci_l2cap_connection_parameter_update_req(uint16_t Connection_Handle,
                                                      uint16_t Timeout_Multiplier)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_l2cap_connection_parameter_update_req_cp0 *cp0 = (aci_l2cap_connection_parameter_update_req_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -49,7 +49,7 @@ tBleStatus aci_l2cap_connection_parameter_update_req(uint16_t Connection_Handle,
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
@@ -69,7 +69,7 @@ tBleStatus aci_l2cap_connection_parameter_update_resp(uint16_t Connection_Handle
                                                       uint8_t Accept)
 {
   struct hci_request rq;
-  uint8_t cmd_buffer[BLE_CMD_MAX_PARAM_LEN];
+  uint8_t *cmd_buffer = (uint8_t *)hci_cmd_reserve();
   aci_l2cap_connection_parameter_update_resp_cp0 *cp0 = (aci_l2cap_connection_parameter_update_resp_cp0*)(cmd_buffer);
   tBleStatus status = 0;
   int index_input = 0;
@@ -98,7 +98,7 @@ tBleStatus aci_l2cap_connection_parameter_update_resp(uint16_t Connection_Handle
   rq.clen = index_input;
   rq.rparam = &status;
   rq.rlen = 1;
-  if (hci_send_req(&rq, FALSE) < 0)
+  if (hci_cmd_commit(&rq) < 0)
     return BLE_STATUS_TIMEOUT;
   if (status) 
   {
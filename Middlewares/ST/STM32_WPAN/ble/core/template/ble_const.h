@@ -91,6 +91,16 @@ struct hci_request
 };
 extern int hci_send_req( struct hci_request* req, uint8_t async );
 
+/* In place command building:
+ * hci_cmd_reserve() locks the command buffer shared with the BLE core and
+ * returns a pointer to its payload where the command parameters are written.
+ * hci_cmd_commit() then sends the command, waits for the response and
+ * releases the buffer. The cparam field of the request is not used.
+ * hci_cmd_cancel() releases the buffer when the command is not sent. */
+extern void* hci_cmd_reserve( void );
+extern int hci_cmd_commit( struct hci_request* req );
+extern void hci_cmd_cancel( void );
+
 
 /* Byte order conversions */
 #define htob( d, n )  (d)     /* LE */
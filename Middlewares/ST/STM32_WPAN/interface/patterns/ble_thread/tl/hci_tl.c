@@ -28,6 +28,13 @@
 
 
 /* Private typedef -----------------------------------------------------------*/
+typedef enum
+{
+  HCI_TL_CmdBufferFree,
+  HCI_TL_CmdBufferSync,
+  HCI_TL_CmdBufferAsync,
+} HCI_TL_CmdBufferOwner_t;
+
 /* Private defines -----------------------------------------------------------*/
 
 /**
@@ -35,6 +42,30 @@
  */
 #define HCI_TL_DEFAULT_TIMEOUT (33000)
 
+/**
+ * Maximum number of user events reported to the application on each call of hci_user_evt_proc()
+ * When set to 1, the events are reported one by one (default behavior)
+ */
+#ifndef CFG_TLBLE_EVT_DRAIN_MAX_NBR
+#define CFG_TLBLE_EVT_DRAIN_MAX_NBR (1)
+#endif
+
+/**
+ * Maximum time in us spent in hci_user_evt_proc() before giving back the hand to the scheduler
+ * This is checked after each reported event. When set to 0, only CFG_TLBLE_EVT_DRAIN_MAX_NBR applies.
+ * When not 0, the application shall implement hci_get_timestamp_us()
+ */
+#ifndef CFG_TLBLE_EVT_DRAIN_BUDGET_US
+#define CFG_TLBLE_EVT_DRAIN_BUDGET_US (0)
+#endif
+
+/**
+ * Maximum number of asynchronous commands waiting to be sent to the BLE core
+ */
+#ifndef CFG_TLBLE_ASYNC_CMD_QUEUE_LENGTH
+#define CFG_TLBLE_ASYNC_CMD_QUEUE_LENGTH (4)
+#endif
+
 /* Private macros ------------------------------------------------------------*/
 /* Public variables ---------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
@@ -42,7 +73,7 @@
  * START of Section BLE_DRIVER_CONTEXT
  */
 PLACE_IN_SECTION("BLE_DRIVER_CONTEXT") static volatile uint8_t hci_timer_id;
-PLACE_IN_SECTION("BLE_DRIVER_CONTEXT") static tListNode HciAsynchEventQueue;
+PLACE_IN_SECTION("BLE_DRIVER_CONTEXT") static tListQueue HciAsynchEventQueue;
 PLACE_IN_SECTION("BLE_DRIVER_CONTEXT") static TL_CmdPacket_t *pCmdBuffer;
 PLACE_IN_SECTION("BLE_DRIVER_CONTEXT") HCI_TL_UserEventFlowStatus_t UserEventFlow;
 /**
@@ -50,14 +81,33 @@ PLACE_IN_SECTION("BLE_DRIVER_CONTEXT") HCI_TL_UserEventFlowStatus_t UserEventFlo
  */
 
 static tHciContext hciContext;
-static tListNode HciCmdEventQueue;
+/**
+ * HciCmdEventQueue, HciAsynchEventQueue and HciAsyncCmdDoneQueue are filled from the IPCC interrupt handler
+ * and read from the background so they are lock free queues.
+ * HciCmdEventQueue is only read by hci_cmd_commit(), HciAsynchEventQueue and HciAsyncCmdDoneQueue are only
+ * read by hci_user_evt_proc()
+ */
+static tListQueue HciCmdEventQueue;
+static tListQueue HciAsyncCmdDoneQueue;
+static tListNode HciAsyncCmdQueue;
+static uint32_t HciAsyncCmdQueueNbr;
+static HCI_TL_AsyncCmd_t * volatile pHciAsyncCmdInFlight;
+static volatile HCI_TL_CmdBufferOwner_t HciCmdBufferOwner;
+static volatile uint8_t HciSyncCmdPending;
+static volatile uint8_t HciCmdCredit;
 static void (* StatusNotCallBackFunction) (HCI_TL_CmdStatus_t status);
 
 /* Private function prototypes -----------------------------------------------*/
 static void NotifyCmdStatus(HCI_TL_CmdStatus_t hcicmdstatus);
-static void SendCmd(uint16_t opcode, uint8_t plen, void *param);
+static void SendCmd(uint16_t opcode, uint8_t plen);
 static void TlEvtReceived(TL_EvtPacket_t *hcievt);
 static void TlInit( TL_CmdPacket_t * p_cmdbuffer );
+static uint8_t DrainBudgetAvailable( uint32_t nbr_evt_reported, uint32_t start_time );
+static HCI_TL_CmdStatus_t CmdEvtProc( struct hci_request *p_cmd, TL_EvtPacket_t *pevtpacket );
+static void AsyncCmdEvtProc( TL_EvtPacket_t *pevtpacket );
+static void AsyncCmdReport( void );
+static void AsyncCmdSendNext( void );
+static void ReleaseCmdBuffer( void );
 
 /* Interface ------- ---------------------------------------------------------*/
 void hci_init(void(* UserEvtRx)(void* pData), void* pConf)
@@ -76,6 +126,8 @@ void hci_user_evt_proc(void)
 {
   TL_EvtPacket_t *phcievtbuffer;
   tHCI_UserEvtRxParam UserEvtRxParam;
+  uint32_t nbr_evt_reported;
+  uint32_t start_time;
 
   /**
    * Up to release version v1.2.0, a while loop was implemented to read out events from the queue as long as
@@ -85,17 +137,32 @@ void hci_user_evt_proc(void)
    * From now, the events are reported one by one. When it is checked there is still an event pending in the queue,
    * a request to the user is made to call again hci_user_evt_proc().
    * This gives the opportunity to the application to run other background tasks between each event.
+   * Under heavy traffic, the number of events reported on each call may be increased with
+   * CFG_TLBLE_EVT_DRAIN_MAX_NBR and bounded in time with CFG_TLBLE_EVT_DRAIN_BUDGET_US.
+   * In that case, all the buffers released during the call are sent back to the CPU2 at once.
    */
 
   /**
-   * It is more secure to use LST_remove_head()/LST_insert_head() compare to LST_get_next_node()/LST_remove_node()
-   * in case the user overwrite the header where the next/prev pointers are located
+   * It is more secure to use LST_queue_remove_head()/LST_queue_insert_head() compare to a read of the event
+   * followed by its removal in case the user overwrite the header where the next/prev pointers are located
    */
 
-  if((LST_is_empty(&HciAsynchEventQueue) == FALSE) && (UserEventFlow != HCI_TL_UserEventFlow_Disable))
+  /**
+   * Report first the asynchronous commands that have completed if any
+   */
+  AsyncCmdReport( );
+
+  nbr_evt_reported = 0;
+#if (CFG_TLBLE_EVT_DRAIN_BUDGET_US != 0)
+  start_time = hci_get_timestamp_us();
+#else
+  start_time = 0;
+#endif
+
+  while((UserEventFlow != HCI_TL_UserEventFlow_Disable)
+        && (DrainBudgetAvailable(nbr_evt_reported, start_time) != FALSE)
+        && ((phcievtbuffer = (TL_EvtPacket_t *)LST_queue_remove_head( &HciAsynchEventQueue )) != NULL))
   {
-    LST_remove_head ( &HciAsynchEventQueue, (tListNode **)&phcievtbuffer );
-
     if (hciContext.UserEvtRx != NULL)
     {
       UserEvtRxParam.pckt = phcievtbuffer;
@@ -110,18 +177,25 @@ void hci_user_evt_proc(void)
 
     if(UserEventFlow != HCI_TL_UserEventFlow_Disable)
     {
-      TL_MM_EvtDone( phcievtbuffer );
+      TL_MM_EvtRelease( phcievtbuffer );
     }
     else
     {
       /**
        * put back the event in the queue
        */
-      LST_insert_head ( &HciAsynchEventQueue, (tListNode *)phcievtbuffer );
+      LST_queue_insert_head ( &HciAsynchEventQueue, (tListNode *)phcievtbuffer );
     }
+
+    nbr_evt_reported++;
   }
 
-  if((LST_is_empty(&HciAsynchEventQueue) == FALSE) && (UserEventFlow != HCI_TL_UserEventFlow_Disable))
+  /**
+   * Send back to the CPU2 all buffers released in the loop above
+   */
+  TL_MM_EvtFlush( );
+
+  if((LST_queue_get_size(&HciAsynchEventQueue) != 0) && (UserEventFlow != HCI_TL_UserEventFlow_Disable))
   {
     hci_notify_asynch_evt((void*) &HciAsynchEventQueue);
   }
@@ -146,17 +220,86 @@ void hci_resume_flow( void )
 int hci_send_req(struct hci_request *p_cmd, uint8_t async)
 {
   (void)(async);
-  uint16_t opcode;
-  TL_CcEvt_t  *pcommand_complete_event;
-  TL_CsEvt_t    *pcommand_status_event;
+
+  memcpy( hci_cmd_reserve( ), p_cmd->cparam, p_cmd->clen );
+
+  return hci_cmd_commit( p_cmd );
+}
+
+int hci_send_req_async( HCI_TL_AsyncCmd_t *p_async_cmd )
+{
+  int return_value;
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();  /**< backup PRIMASK bit */
+  __disable_irq();                  /**< Disable all interrupts by setting PRIMASK bit on Cortex*/
+  if(HciAsyncCmdQueueNbr < CFG_TLBLE_ASYNC_CMD_QUEUE_LENGTH)
+  {
+    LST_insert_tail(&HciAsyncCmdQueue, (tListNode *)p_async_cmd);
+    HciAsyncCmdQueueNbr++;
+    return_value = 0;
+  }
+  else
+  {
+    return_value = -1;
+  }
+  __set_PRIMASK(primask_bit);     /**< Restore PRIMASK bit*/
+
+  AsyncCmdSendNext( );
+
+  return return_value;
+}
+
+void * hci_cmd_reserve( void )
+{
+  uint8_t buffer_reserved;
+  uint32_t primask_bit;
+
+  NotifyCmdStatus(HCI_TL_CmdBusy);
+
+  /**
+   * Prevent any further asynchronous command to be sent and wait for the one in progress
+   * The buffer is released by TlEvtReceived() when the response of the asynchronous command is received
+   * so this does not depend on hci_user_evt_proc() that may not be called while the command status is busy
+   */
+  HciSyncCmdPending = TRUE;
+  buffer_reserved = FALSE;
+  while(buffer_reserved == FALSE)
+  {
+    primask_bit = __get_PRIMASK();  /**< backup PRIMASK bit */
+    __disable_irq();                  /**< Disable all interrupts by setting PRIMASK bit on Cortex*/
+    if(HciCmdBufferOwner == HCI_TL_CmdBufferFree)
+    {
+      HciCmdBufferOwner = HCI_TL_CmdBufferSync;
+      buffer_reserved = TRUE;
+    }
+    __set_PRIMASK(primask_bit);     /**< Restore PRIMASK bit*/
+
+    if(buffer_reserved == FALSE)
+    {
+      hci_cmd_resp_wait(HCI_TL_DEFAULT_TIMEOUT);
+    }
+  }
+
+  return (void *)pCmdBuffer->cmdserial.cmd.payload;
+}
+
+void hci_cmd_cancel( void )
+{
+  ReleaseCmdBuffer( );
+
+  NotifyCmdStatus(HCI_TL_CmdAvailable);
+
+  return;
+}
+
+int hci_cmd_commit( struct hci_request *p_cmd )
+{
   TL_EvtPacket_t *pevtpacket;
-  uint8_t hci_cmd_complete_return_parameters_length;
   HCI_TL_CmdStatus_t local_cmd_status;
 
-  NotifyCmdStatus(HCI_TL_CmdBusy);
   local_cmd_status = HCI_TL_CmdBusy;
-  opcode = ((p_cmd->ocf) & 0x03ff) | ((p_cmd->ogf) << 10);
-  SendCmd(opcode, p_cmd->clen, p_cmd->cparam);
+  SendCmd(((p_cmd->ocf) & 0x03ff) | ((p_cmd->ogf) << 10), p_cmd->clen);
 
   while(local_cmd_status == HCI_TL_CmdBusy)
   {
@@ -165,42 +308,17 @@ int hci_send_req(struct hci_request *p_cmd, uint8_t async)
     /**
      * Process Cmd Event
      */
-    while(LST_is_empty(&HciCmdEventQueue) == FALSE)
+    while((pevtpacket = (TL_EvtPacket_t *)LST_queue_remove_head(&HciCmdEventQueue)) != NULL)
     {
-      LST_remove_head (&HciCmdEventQueue, (tListNode **)&pevtpacket);
-
-      if(pevtpacket->evtserial.evt.evtcode == TL_BLEEVT_CS_OPCODE)
-      {
-        pcommand_status_event = (TL_CsEvt_t*)pevtpacket->evtserial.evt.payload;
-        if(pcommand_status_event->cmdcode == opcode)
-        {
-          *(uint8_t *)(p_cmd->rparam) = pcommand_status_event->status;
-        }
-
-        if(pcommand_status_event->numcmd != 0)
-        {
-          local_cmd_status = HCI_TL_CmdAvailable;
-        }
-      }
-      else
+      if(CmdEvtProc( p_cmd, pevtpacket ) == HCI_TL_CmdAvailable)
       {
-        pcommand_complete_event = (TL_CcEvt_t*)pevtpacket->evtserial.evt.payload;
-
-        if(pcommand_complete_event->cmdcode == opcode)
-        {
-          hci_cmd_complete_return_parameters_length = pevtpacket->evtserial.evt.plen - TL_EVT_HDR_SIZE;
-          p_cmd->rlen = MIN(hci_cmd_complete_return_parameters_length, p_cmd->rlen);
-          memcpy(p_cmd->rparam, pcommand_complete_event->payload, p_cmd->rlen);
-        }
-
-        if(pcommand_complete_event->numcmd != 0)
-        {
-          local_cmd_status = HCI_TL_CmdAvailable;
-        }
+        local_cmd_status = HCI_TL_CmdAvailable;
       }
     }
   }
 
+  ReleaseCmdBuffer( );
+
   NotifyCmdStatus(HCI_TL_CmdAvailable);
 
   return 0;
@@ -214,14 +332,22 @@ static void TlInit( TL_CmdPacket_t * p_cmdbuffer )
   /**
    * Always initialize the command event queue
    */
-  LST_init_head (&HciCmdEventQueue);
+  LST_queue_init (&HciCmdEventQueue);
+  LST_queue_init (&HciAsyncCmdDoneQueue);
 
   pCmdBuffer = p_cmdbuffer;
 
-  LST_init_head (&HciAsynchEventQueue);
+  LST_queue_init (&HciAsynchEventQueue);
 
   UserEventFlow = HCI_TL_UserEventFlow_Enable;
 
+  LST_init_head (&HciAsyncCmdQueue);
+  HciAsyncCmdQueueNbr = 0;
+  pHciAsyncCmdInFlight = NULL;
+  HciCmdBufferOwner = HCI_TL_CmdBufferFree;
+  HciSyncCmdPending = FALSE;
+  HciCmdCredit = 1;
+
   /* Initialize low level driver */
   if (hciContext.io.Init)
   {
@@ -234,11 +360,13 @@ static void TlInit( TL_CmdPacket_t * p_cmdbuffer )
   return;
 }
 
-static void SendCmd(uint16_t opcode, uint8_t plen, void *param)
+static void SendCmd(uint16_t opcode, uint8_t plen)
 {
+  /**
+   * The payload has already been written in the command buffer
+   */
   pCmdBuffer->cmdserial.cmd.cmdcode = opcode;
   pCmdBuffer->cmdserial.cmd.plen = plen;
-  memcpy( pCmdBuffer->cmdserial.cmd.payload, param, plen );
 
   hciContext.io.Send(0,0);
 
@@ -265,16 +393,188 @@ static void NotifyCmdStatus(HCI_TL_CmdStatus_t hcicmdstatus)
   return;
 }
 
+static uint8_t DrainBudgetAvailable( uint32_t nbr_evt_reported, uint32_t start_time )
+{
+  uint8_t return_value;
+
+  if(nbr_evt_reported == 0)
+  {
+    /**
+     * At least one event is always reported
+     */
+    return_value = TRUE;
+  }
+  else if(nbr_evt_reported >= CFG_TLBLE_EVT_DRAIN_MAX_NBR)
+  {
+    return_value = FALSE;
+  }
+#if (CFG_TLBLE_EVT_DRAIN_BUDGET_US != 0)
+  else if((hci_get_timestamp_us() - start_time) >= CFG_TLBLE_EVT_DRAIN_BUDGET_US)
+  {
+    return_value = FALSE;
+  }
+#endif
+  else
+  {
+    (void)(start_time);
+    return_value = TRUE;
+  }
+
+  return return_value;
+}
+
+static HCI_TL_CmdStatus_t CmdEvtProc( struct hci_request *p_cmd, TL_EvtPacket_t *pevtpacket )
+{
+  uint16_t opcode;
+  TL_CcEvt_t  *pcommand_complete_event;
+  TL_CsEvt_t    *pcommand_status_event;
+  uint8_t hci_cmd_complete_return_parameters_length;
+  HCI_TL_CmdStatus_t local_cmd_status;
+
+  local_cmd_status = HCI_TL_CmdBusy;
+  opcode = ((p_cmd->ocf) & 0x03ff) | ((p_cmd->ogf) << 10);
+
+  if(pevtpacket->evtserial.evt.evtcode == TL_BLEEVT_CS_OPCODE)
+  {
+    pcommand_status_event = (TL_CsEvt_t*)pevtpacket->evtserial.evt.payload;
+    if(pcommand_status_event->cmdcode == opcode)
+    {
+      *(uint8_t *)(p_cmd->rparam) = pcommand_status_event->status;
+    }
+
+    HciCmdCredit = pcommand_status_event->numcmd;
+  }
+  else
+  {
+    pcommand_complete_event = (TL_CcEvt_t*)pevtpacket->evtserial.evt.payload;
+
+    if(pcommand_complete_event->cmdcode == opcode)
+    {
+      hci_cmd_complete_return_parameters_length = pevtpacket->evtserial.evt.plen - TL_EVT_HDR_SIZE;
+      p_cmd->rlen = MIN(hci_cmd_complete_return_parameters_length, p_cmd->rlen);
+      memcpy(p_cmd->rparam, pcommand_complete_event->payload, p_cmd->rlen);
+    }
+
+    HciCmdCredit = pcommand_complete_event->numcmd;
+  }
+
+  if(HciCmdCredit != 0)
+  {
+    local_cmd_status = HCI_TL_CmdAvailable;
+  }
+
+  return local_cmd_status;
+}
+
+static void AsyncCmdEvtProc( TL_EvtPacket_t *pevtpacket )
+{
+  HCI_TL_AsyncCmd_t *p_async_cmd;
+
+  /**
+   * Called from the IPCC interrupt handler
+   */
+  p_async_cmd = pHciAsyncCmdInFlight;
+
+  if(CmdEvtProc( p_async_cmd->p_cmd, pevtpacket ) == HCI_TL_CmdAvailable)
+  {
+    /**
+     * The response has been copied out of the command buffer so it can be used for the next command
+     */
+    pHciAsyncCmdInFlight = NULL;
+    HciCmdBufferOwner = HCI_TL_CmdBufferFree;
+    LST_queue_insert_tail(&HciAsyncCmdDoneQueue, (tListNode *)p_async_cmd);
+
+    if(HciSyncCmdPending != FALSE)
+    {
+      hci_cmd_resp_release(0); /**< Notify hci_cmd_reserve() the command buffer is available */
+    }
+    hci_notify_asynch_evt((void*) &HciAsynchEventQueue); /**< The completion is reported from hci_user_evt_proc() */
+  }
+
+  return;
+}
+
+static void AsyncCmdReport( void )
+{
+  HCI_TL_AsyncCmd_t *p_async_cmd;
+
+  while((p_async_cmd = (HCI_TL_AsyncCmd_t *)LST_queue_remove_head(&HciAsyncCmdDoneQueue)) != NULL)
+  {
+    if(p_async_cmd->CmdRespCallBack != NULL)
+    {
+      p_async_cmd->CmdRespCallBack(p_async_cmd);
+    }
+  }
+
+  AsyncCmdSendNext( );
+
+  return;
+}
+
+static void AsyncCmdSendNext( void )
+{
+  HCI_TL_AsyncCmd_t *p_async_cmd;
+  struct hci_request *p_cmd;
+  uint32_t primask_bit;
+
+  p_async_cmd = NULL;
+
+  primask_bit = __get_PRIMASK();  /**< backup PRIMASK bit */
+  __disable_irq();                  /**< Disable all interrupts by setting PRIMASK bit on Cortex*/
+  if((HciCmdBufferOwner == HCI_TL_CmdBufferFree) && (HciSyncCmdPending == FALSE) && (HciCmdCredit != 0)
+     && (LST_is_empty(&HciAsyncCmdQueue) == FALSE))
+  {
+    LST_remove_head (&HciAsyncCmdQueue, (tListNode **)&p_async_cmd);
+    HciAsyncCmdQueueNbr--;
+    HciCmdBufferOwner = HCI_TL_CmdBufferAsync;
+    pHciAsyncCmdInFlight = p_async_cmd;
+  }
+  __set_PRIMASK(primask_bit);     /**< Restore PRIMASK bit*/
+
+  if(p_async_cmd != NULL)
+  {
+    p_cmd = p_async_cmd->p_cmd;
+    memcpy( pCmdBuffer->cmdserial.cmd.payload, p_cmd->cparam, p_cmd->clen );
+    SendCmd(((p_cmd->ocf) & 0x03ff) | ((p_cmd->ogf) << 10), p_cmd->clen);
+  }
+
+  return;
+}
+
+static void ReleaseCmdBuffer( void )
+{
+  HciCmdBufferOwner = HCI_TL_CmdBufferFree;
+  HciSyncCmdPending = FALSE;
+
+  /**
+   * Resume the asynchronous commands that may have been queued in the meantime
+   */
+  AsyncCmdSendNext( );
+
+  return;
+}
+
 static void TlEvtReceived(TL_EvtPacket_t *hcievt)
 {
   if ( ((hcievt->evtserial.evt.evtcode) == TL_BLEEVT_CS_OPCODE) || ((hcievt->evtserial.evt.evtcode) == TL_BLEEVT_CC_OPCODE ) )
   {
-    LST_insert_tail(&HciCmdEventQueue, (tListNode *)hcievt);
-    hci_cmd_resp_release(0); /**< Notify the application a full Cmd Event has been received */
+    if(HciCmdBufferOwner == HCI_TL_CmdBufferAsync)
+    {
+      /**
+       * The response of an asynchronous command is not queued. The event is in the command buffer
+       * so it is handled at once and the command is reported from hci_user_evt_proc()
+       */
+      AsyncCmdEvtProc( hcievt );
+    }
+    else
+    {
+      LST_queue_insert_tail(&HciCmdEventQueue, (tListNode *)hcievt);
+      hci_cmd_resp_release(0); /**< Notify the application a full Cmd Event has been received */
+    }
   }
   else
   {
-    LST_insert_tail(&HciAsynchEventQueue, (tListNode *)hcievt);
+    LST_queue_insert_tail(&HciAsynchEventQueue, (tListNode *)hcievt);
     hci_notify_asynch_evt((void*) &HciAsynchEventQueue); /**< Notify the application a full HCI event has been received */
   }
 
@@ -23,6 +23,7 @@
 #define __HCI_TL_H_
 
 #include "stm32_wpan_common.h"
+#include "stm_list.h"
 #include "tl.h"
 
 /* Exported defines -----------------------------------------------------------*/
@@ -79,6 +80,23 @@ typedef struct
   void (* StatusNotCallBack) (HCI_TL_CmdStatus_t status);
 } HCI_TL_HciInitConf_t;
 
+/**
+ * @brief Asynchronous command descriptor.
+ *        The descriptor, the request and the buffers it points to are owned by the application and
+ *        shall remain valid until CmdRespCallBack() is called.
+ * @{
+ */
+typedef struct _HCI_TL_AsyncCmd_t
+{
+  tListNode node; /**< Reserved to the HCI layer */
+  struct hci_request *p_cmd; /**< Command to send. The response is written in p_cmd->rparam */
+  void (* CmdRespCallBack) (struct _HCI_TL_AsyncCmd_t *p_async_cmd); /**< Called when the response has been received */
+  void *p_context; /**< Free for the application */
+} HCI_TL_AsyncCmd_t;
+/**
+ * @}
+ */
+
 /**
  * @brief  Register IO bus services.
  * @param  fops The HCI IO structure managing the IO BUS
@@ -128,6 +146,16 @@ void hci_cmd_resp_wait(uint32_t timeout);
  */
 void hci_cmd_resp_release(uint32_t flag);
 
+/**
+ * @brief  This function is called by hci_user_evt_proc() to check the time spent in reporting
+ *         the user events. It shall return a free running timestamp in us.
+ *         It is needed only when CFG_TLBLE_EVT_DRAIN_BUDGET_US is not set to 0.
+ *
+ * @param  None
+ * @retval Timestamp in us
+ */
+uint32_t hci_get_timestamp_us(void);
+
 
 
 /**
@@ -175,6 +203,19 @@ void hci_user_evt_proc(void);
  */
 void hci_init(void(* UserEvtRx)(void* pData), void* pConf);
 
+/**
+ * @brief  Queue an ACI/HCI command to be sent to the BLE core without waiting for its response.
+ *         The commands are sent one by one in the order they have been queued when the BLE core
+ *         reports it can accept a new command (Num_HCI_Command_Packets).
+ *         The response is reported with p_async_cmd->CmdRespCallBack() from hci_user_evt_proc() only.
+ *         A blocking command is always sent after the asynchronous command in progress completes and
+ *         before the next queued one.
+ *
+ * @param  p_async_cmd: Asynchronous command descriptor
+ * @retval 0 when the command is queued, -1 when the queue is full (CFG_TLBLE_ASYNC_CMD_QUEUE_LENGTH)
+ */
+int hci_send_req_async( HCI_TL_AsyncCmd_t *p_async_cmd );
+
 /**
  * END OF SECTION - INTERFACES USED BY THE BLE DRIVER
  *********************************************************************************************************************
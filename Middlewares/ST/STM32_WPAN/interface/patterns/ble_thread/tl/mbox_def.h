@@ -105,6 +105,9 @@ extern "C" {
     uint8_t   *notifM0toM4_buffer;
     uint8_t   *appliCmdM4toM0_buffer;
     uint8_t   *loggingM0toM4_buffer;
+#ifdef ZIGBEE_NOTIF_RING
+    uint32_t  notifM0toM4_ring_depth;   /**< Number of slots of TL_ZIGBEE_NOTIF_SLOT_SIZE bytes in notifM0toM4_buffer */
+#endif
   } MB_ZigbeeTable_t;
   /**
    * msg
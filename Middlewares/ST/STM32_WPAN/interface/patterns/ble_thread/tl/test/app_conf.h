@@ -0,0 +1,46 @@
+/**
+  ******************************************************************************
+  * @file    app_conf.h
+  * @author  MCD Application Team
+  * @brief   Application configuration of the transport layer host tests: the
+  *          Cortex intrinsics used by the transport layer are routed to the
+  *          model of the CPU1 in hw_ipcc_sim.c
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __APP_CONF_H
+#define __APP_CONF_H
+
+#include "cmsis_compiler.h"
+#include "hw_ipcc_sim.h"
+
+/* The CMSIS functions are declared above, the calls are replaced from here */
+#undef __get_PRIMASK
+#define __get_PRIMASK()                 HW_IPCC_SIM_GetPrimask()
+#undef __set_PRIMASK
+#define __set_PRIMASK(__PRIMASK__)      HW_IPCC_SIM_SetPrimask(__PRIMASK__)
+#undef __disable_irq
+#define __disable_irq()                 HW_IPCC_SIM_SetPrimask(1U)
+#undef __DMB
+#define __DMB()                         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+/* The CPU1 interrupts are not taken between the load and the store */
+#undef __LDREXW
+#define __LDREXW(__ADDR__)              (*(__ADDR__))
+#undef __STREXW
+#define __STREXW(__VALUE__, __ADDR__)   ((*(__ADDR__) = (__VALUE__)), 0U)
+
+#endif /* __APP_CONF_H */
+
+/******************* (C) COPYRIGHT 2019 STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,27 @@
+/**
+  ******************************************************************************
+  * @file    ble_conf.h
+  * @author  MCD Application Team
+  * @brief   BLE configuration of the transport layer host tests
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BLE_CONF_H
+#define __BLE_CONF_H
+
+#include "app_conf.h"
+#endif /* __BLE_CONF_H */
+
+/******************* (C) COPYRIGHT 2019 STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,1791 @@
+/**
+  ******************************************************************************
+  * @file    hw_ipcc_sim.c
+  * @author  MCD Application Team
+  * @brief   Host backend of the HW_IPCC_* hooks of hw.h
+  *          The hooks and the interrupt handlers are the ones of
+  *          STM32_WPAN/Target/hw_ipcc.c, on a model of the IPCC registers.
+  *          The CPU1 interrupts are taken on the thread of the CPU1 when
+  *          PRIMASK is cleared and in HW_IPCC_SIM_WaitForInterrupt().
+  *          The fake CPU2 is a thread that reaches the tables of tl_mbox.c
+  *          through the MAPPING_TABLE section, as the CPU2 does, and only
+  *          accesses buffers of the MB_MEM1 and MB_MEM2 sections.
+  *          The MAC 802.15.4 and the LLD tests channels are not modeled.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "stm32_wpan_common.h"
+#include "hw.h"
+#include "app_conf.h"
+
+#include "stm_list.h"
+#include "tl.h"
+#include "mbox_def.h"
+#include "hw_ipcc_sim.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Registers of the IPCC seen by the CPU1 */
+typedef struct
+{
+  uint32_t C1CR;      /**< RXOIE, TXFIE */
+  uint32_t C1MR;      /**< Receive channels masked on bits 0 to 5, transmit channels on bits 16 to 21 */
+  uint32_t C1TOC2SR;  /**< Flags set by the CPU1 */
+  uint32_t C2TOC1SR;  /**< Flags set by the CPU2 */
+} SimIpcc_t;
+
+typedef struct
+{
+  HW_IPCC_SIM_Stream_t Cfg;
+  uint32_t Seq;       /**< Next packet to post */
+  uint64_t DueNs;     /**< Time of the next packet */
+  uint8_t Stalled;    /**< The next packet waits for a free buffer */
+  uint8_t AwaitAck;   /**< A notification has been posted and is not acked */
+} SimStream_t;
+
+typedef enum
+{
+  SIM_PROTOCOL_NONE,
+  SIM_PROTOCOL_THREAD,
+  SIM_PROTOCOL_ZIGBEE,
+} SimProtocol_t;
+
+/* Private defines -----------------------------------------------------------*/
+#define SIM_C1CR_RXOIE                  (0x00000001U)
+#define SIM_C1CR_TXFIE                  (0x00010000U)
+#define SIM_C1MR_RESET                  (0x003F003FU)
+#define SIM_CHANNEL_ALL                 (0x0000003FU)
+#define SIM_CHANNEL_NBR                 (6U)
+
+#define SIM_EVTCODE                     (0xFFU)
+#define SIM_EVT_BUFFER_SIZE             (DIVC(sizeof(TL_PacketHeader_t) + TL_EVT_HDR_SIZE + 255U, 4U) * 4U)
+#define SIM_WAIT_FOREVER                (UINT64_MAX)
+
+/* Private macros ------------------------------------------------------------*/
+/* Same as STM32_WPAN/Target/hw_ipcc.c */
+#define HW_IPCC_TX_PENDING( channel ) ( !(SimIsActiveFlag( channel )) ) && ( ((~(Sim.Ipcc.C1MR)) & ((channel) << 16U)) )
+#define HW_IPCC_RX_PENDING( channel ) ( (SimC2IsActiveFlag( channel )) ) && ( ((~(Sim.Ipcc.C1MR)) & (channel)) )
+
+/* Private variables ---------------------------------------------------------*/
+static struct
+{
+  pthread_mutex_t Mutex;
+  pthread_cond_t Cpu1Cond;          /**< Signaled when the CPU2 has written a register */
+  pthread_cond_t Cpu2Cond;          /**< Signaled when the CPU1 has written a register */
+  pthread_t Cpu2Thread;
+  uint8_t Cpu2Running;
+  uint8_t Cpu2Stop;
+  uint8_t Cpu2Kick;                 /**< The CPU1 has written a register since the last pass of the CPU2 */
+  uint8_t BleReady;                 /**< The tables have been set before the call of the HW_IPCC_*_Init() */
+  uint8_t SysReady;
+  uint8_t TracesReady;
+  uint8_t SysReadyEvtPending;
+  SimProtocol_t Protocol;
+  SimIpcc_t Ipcc;
+  HW_IPCC_SIM_Config_t Config;
+  SimStream_t Streams[HW_IPCC_SIM_STREAM_NBR];
+  uint32_t CmdSeen;                 /**< Commands for which the answer is delayed */
+  uint64_t CmdDueNs[SIM_CHANNEL_NBR];
+  uint8_t CreditPending;
+  uint64_t CreditDueNs;
+  tListNode BlePending;             /**< Packets waiting for the IPCC channel to be free */
+  tListNode SysPending;
+  tListNode TracesPending;
+  tListNode FreeEvt;                /**< Free buffers of the pools */
+  uint8_t *Pool[2];
+  uint32_t PoolSlots[2];
+  uint32_t SlotSize;
+  uint8_t *Outstanding;             /**< Buffers of the pools held by the CPU1 */
+  HW_IPCC_SIM_Stats_t Stats;
+} Sim = {
+  .Mutex = PTHREAD_MUTEX_INITIALIZER,
+  .Ipcc = { 0, SIM_C1MR_RESET, 0, 0 },
+  .Config = { 0, 0, HW_IPCC_SIM_RSP_CC, 1, 0, 0 },
+};
+
+static pthread_once_t SimOnce = PTHREAD_ONCE_INIT;
+static __thread uint32_t Primask;
+static __thread uint8_t Cpu2Context;
+static uint8_t InIrq;
+static void (*FreeBufCb)( void );
+
+/**
+ * Sections of the CPU1 memory shared with the CPU2, provided by the linker
+ */
+extern uint8_t __start_MAPPING_TABLE[], __stop_MAPPING_TABLE[];
+extern uint8_t __start_MB_MEM1[], __stop_MB_MEM1[];
+extern uint8_t __start_MB_MEM2[], __stop_MB_MEM2[];
+
+/* Private function prototypes -----------------------------------------------*/
+static void HW_IPCC_BLE_EvtHandler( void );
+static void HW_IPCC_BLE_AclDataEvtHandler( void );
+static void HW_IPCC_MM_FreeBufHandler( void );
+static void HW_IPCC_SYS_CmdEvtHandler( void );
+static void HW_IPCC_SYS_EvtHandler( void );
+static void HW_IPCC_TRACES_EvtHandler( void );
+static void HW_IPCC_OT_CmdEvtHandler( void );
+static void HW_IPCC_THREAD_NotEvtHandler( void );
+static void HW_IPCC_THREAD_CliNotEvtHandler( void );
+static void HW_IPCC_ZIGBEE_CmdEvtHandler( void );
+static void HW_IPCC_ZIGBEE_StackNotifEvtHandler( void );
+static void HW_IPCC_ZIGBEE_StackLoggingEvtHandler( void );
+
+static void SimInit( void );
+static void SimError( const char *msg );
+static uint32_t SimIsActiveFlag( uint32_t channel );
+static uint32_t SimC2IsActiveFlag( uint32_t channel );
+static void SimSetFlag( uint32_t channel );
+static void SimClearFlag( uint32_t channel );
+static void SimEnableTransmitChannel( uint32_t channel );
+static void SimDisableTransmitChannel( uint32_t channel );
+static void SimEnableReceiveChannel( uint32_t channel );
+static void SimDisableReceiveChannel( uint32_t channel );
+static uint32_t SimRxPending( void );
+static uint32_t SimTxPending( void );
+static uint32_t SimHandledChannels( void );
+static void SimRunIrq( void );
+static void SimWait( pthread_cond_t *p_cond, uint64_t deadline_ns );
+
+static void *Cpu2Main( void *arg );
+static volatile MB_RefTable_t *Cpu2RefTable( void );
+static uint8_t *Cpu2Buffer( uint8_t *p_buffer, uint32_t size );
+static void Cpu2Boot( void );
+static void Cpu2Shutdown( void );
+static TL_EvtPacket_t *Cpu2AllocEvt( void );
+static int32_t Cpu2SlotIndex( const uint8_t *p_buffer );
+static void Cpu2FillEvt( TL_EvtPacket_t *p_evt, uint8_t type, SimStream_t *p_stream );
+static void Cpu2FreeBuf( void );
+static void Cpu2Commands( uint64_t now, uint64_t *p_next );
+static void Cpu2BleCmd( void );
+static void Cpu2SysCmd( void );
+static void Cpu2OtCmd( void );
+static void Cpu2CliCmd( void );
+static void Cpu2AclData( void );
+static void Cpu2Credit( uint64_t now, uint64_t *p_next );
+static void Cpu2PoolStreams( uint64_t now, uint64_t *p_next );
+static void Cpu2NotStreams( uint64_t now, uint64_t *p_next );
+static void Cpu2Doorbell( tListNode *p_pending, uint8_t *p_queue, uint32_t channel, HW_IPCC_SIM_StreamId_t stream );
+static uint64_t Cpu2StreamDue( SimStream_t *p_stream, uint64_t now );
+
+/* Public function definition -----------------------------------------------*/
+/******************************************************************************
+ * INTERRUPT HANDLER
+ ******************************************************************************/
+void HW_IPCC_Rx_Handler( void )
+{
+  if (HW_IPCC_RX_PENDING( HW_IPCC_SYSTEM_EVENT_CHANNEL ))
+  {
+      HW_IPCC_SYS_EvtHandler();
+  }
+  else if ((Sim.Protocol == SIM_PROTOCOL_THREAD) && (HW_IPCC_RX_PENDING( HW_IPCC_THREAD_NOTIFICATION_ACK_CHANNEL )))
+  {
+    HW_IPCC_THREAD_NotEvtHandler();
+  }
+  else if ((Sim.Protocol == SIM_PROTOCOL_THREAD) && (HW_IPCC_RX_PENDING( HW_IPCC_THREAD_CLI_NOTIFICATION_ACK_CHANNEL )))
+  {
+    HW_IPCC_THREAD_CliNotEvtHandler();
+  }
+  else if ((Sim.Protocol == SIM_PROTOCOL_ZIGBEE) && (HW_IPCC_RX_PENDING( HW_IPCC_ZIGBEE_APPLI_NOTIF_ACK_CHANNEL )))
+  {
+    HW_IPCC_ZIGBEE_StackNotifEvtHandler();
+  }
+  else if ((Sim.Protocol == SIM_PROTOCOL_ZIGBEE) && (HW_IPCC_RX_PENDING( HW_IPCC_ZIGBEE_APPLI_LOGGING_CHANNEL )))
+  {
+    HW_IPCC_ZIGBEE_StackLoggingEvtHandler();
+  }
+  else if (HW_IPCC_RX_PENDING( HW_IPCC_BLE_EVENT_CHANNEL ))
+  {
+    HW_IPCC_BLE_EvtHandler();
+  }
+  else if (HW_IPCC_RX_PENDING( HW_IPCC_TRACES_CHANNEL ))
+  {
+    HW_IPCC_TRACES_EvtHandler();
+  }
+
+  return;
+}
+
+void HW_IPCC_Tx_Handler( void )
+{
+  if (HW_IPCC_TX_PENDING( HW_IPCC_SYSTEM_CMD_RSP_CHANNEL ))
+  {
+    HW_IPCC_SYS_CmdEvtHandler();
+  }
+  else if ((Sim.Protocol == SIM_PROTOCOL_THREAD) && (HW_IPCC_TX_PENDING( HW_IPCC_THREAD_OT_CMD_RSP_CHANNEL )))
+  {
+    HW_IPCC_OT_CmdEvtHandler();
+  }
+  else if ((Sim.Protocol == SIM_PROTOCOL_ZIGBEE) && (HW_IPCC_TX_PENDING( HW_IPCC_ZIGBEE_CMD_APPLI_CHANNEL )))
+  {
+    HW_IPCC_ZIGBEE_CmdEvtHandler();
+  }
+  else if (HW_IPCC_TX_PENDING( HW_IPCC_MM_RELEASE_BUFFER_CHANNEL ))
+  {
+    HW_IPCC_MM_FreeBufHandler();
+  }
+  else if (HW_IPCC_TX_PENDING( HW_IPCC_HCI_ACL_DATA_CHANNEL ))
+  {
+    HW_IPCC_BLE_AclDataEvtHandler();
+  }
+
+  return;
+}
+
+/******************************************************************************
+ * GENERAL
+ ******************************************************************************/
+void HW_IPCC_Enable( void )
+{
+  SimInit();
+
+  pthread_mutex_lock(&Sim.Mutex);
+  if(Sim.Cpu2Running == FALSE)
+  {
+    Sim.Cpu2Running = TRUE;
+    Sim.Cpu2Stop = FALSE;
+    pthread_create(&Sim.Cpu2Thread, 0, Cpu2Main, 0);
+  }
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  return;
+}
+
+void HW_IPCC_Init( void )
+{
+  SimInit();
+
+  pthread_mutex_lock(&Sim.Mutex);
+  Sim.Ipcc.C1CR |= SIM_C1CR_RXOIE | SIM_C1CR_TXFIE;
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  return;
+}
+
+/******************************************************************************
+ * BLE
+ ******************************************************************************/
+void HW_IPCC_BLE_Init( void )
+{
+  pthread_mutex_lock(&Sim.Mutex);
+  Sim.BleReady = TRUE;
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  SimEnableReceiveChannel( HW_IPCC_BLE_EVENT_CHANNEL );
+
+  return;
+}
+
+void HW_IPCC_BLE_SendCmd( void )
+{
+  SimSetFlag( HW_IPCC_BLE_CMD_CHANNEL );
+
+  return;
+}
+
+static void HW_IPCC_BLE_EvtHandler( void )
+{
+  HW_IPCC_BLE_RxEvtNot();
+
+  SimClearFlag( HW_IPCC_BLE_EVENT_CHANNEL );
+
+  return;
+}
+
+void HW_IPCC_BLE_SendAclData( void )
+{
+  SimSetFlag( HW_IPCC_HCI_ACL_DATA_CHANNEL );
+  SimEnableTransmitChannel( HW_IPCC_HCI_ACL_DATA_CHANNEL );
+
+  return;
+}
+
+static void HW_IPCC_BLE_AclDataEvtHandler( void )
+{
+  SimDisableTransmitChannel( HW_IPCC_HCI_ACL_DATA_CHANNEL );
+
+  HW_IPCC_BLE_AclDataAckNot();
+
+  return;
+}
+
+/******************************************************************************
+ * SYSTEM
+ ******************************************************************************/
+void HW_IPCC_SYS_Init( void )
+{
+  pthread_mutex_lock(&Sim.Mutex);
+  Sim.SysReady = TRUE;
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  SimEnableReceiveChannel( HW_IPCC_SYSTEM_EVENT_CHANNEL );
+
+  return;
+}
+
+void HW_IPCC_SYS_SendCmd( void )
+{
+  SimSetFlag( HW_IPCC_SYSTEM_CMD_RSP_CHANNEL );
+  SimEnableTransmitChannel( HW_IPCC_SYSTEM_CMD_RSP_CHANNEL );
+
+  return;
+}
+
+static void HW_IPCC_SYS_CmdEvtHandler( void )
+{
+  SimDisableTransmitChannel( HW_IPCC_SYSTEM_CMD_RSP_CHANNEL );
+
+  HW_IPCC_SYS_CmdEvtNot();
+
+  return;
+}
+
+static void HW_IPCC_SYS_EvtHandler( void )
+{
+  HW_IPCC_SYS_EvtNot();
+
+  SimClearFlag( HW_IPCC_SYSTEM_EVENT_CHANNEL );
+
+  return;
+}
+
+/******************************************************************************
+ * THREAD
+ ******************************************************************************/
+void HW_IPCC_THREAD_Init( void )
+{
+  pthread_mutex_lock(&Sim.Mutex);
+  Sim.Protocol = SIM_PROTOCOL_THREAD;
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  SimEnableReceiveChannel( HW_IPCC_THREAD_NOTIFICATION_ACK_CHANNEL );
+  SimEnableReceiveChannel( HW_IPCC_THREAD_CLI_NOTIFICATION_ACK_CHANNEL );
+
+  return;
+}
+
+void HW_IPCC_OT_SendCmd( void )
+{
+  SimSetFlag( HW_IPCC_THREAD_OT_CMD_RSP_CHANNEL );
+  SimEnableTransmitChannel( HW_IPCC_THREAD_OT_CMD_RSP_CHANNEL );
+
+  return;
+}
+
+void HW_IPCC_CLI_SendCmd( void )
+{
+  SimSetFlag( HW_IPCC_THREAD_CLI_CMD_CHANNEL );
+
+  return;
+}
+
+void HW_IPCC_THREAD_SendAck( void )
+{
+  SimClearFlag( HW_IPCC_THREAD_NOTIFICATION_ACK_CHANNEL );
+  SimEnableReceiveChannel( HW_IPCC_THREAD_NOTIFICATION_ACK_CHANNEL );
+
+  return;
+}
+
+void HW_IPCC_THREAD_CliSendAck( void )
+{
+  SimClearFlag( HW_IPCC_THREAD_CLI_NOTIFICATION_ACK_CHANNEL );
+  SimEnableReceiveChannel( HW_IPCC_THREAD_CLI_NOTIFICATION_ACK_CHANNEL );
+
+  return;
+}
+
+static void HW_IPCC_OT_CmdEvtHandler( void )
+{
+  SimDisableTransmitChannel( HW_IPCC_THREAD_OT_CMD_RSP_CHANNEL );
+
+  HW_IPCC_OT_CmdEvtNot();
+
+  return;
+}
+
+static void HW_IPCC_THREAD_NotEvtHandler( void )
+{
+  SimDisableReceiveChannel( HW_IPCC_THREAD_NOTIFICATION_ACK_CHANNEL );
+
+  HW_IPCC_THREAD_EvtNot();
+
+  return;
+}
+
+static void HW_IPCC_THREAD_CliNotEvtHandler( void )
+{
+  SimDisableReceiveChannel( HW_IPCC_THREAD_CLI_NOTIFICATION_ACK_CHANNEL );
+
+  HW_IPCC_THREAD_CliEvtNot();
+
+  return;
+}
+
+/******************************************************************************
+ * ZIGBEE
+ ******************************************************************************/
+void HW_IPCC_ZIGBEE_Init( void )
+{
+  pthread_mutex_lock(&Sim.Mutex);
+  Sim.Protocol = SIM_PROTOCOL_ZIGBEE;
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  SimEnableReceiveChannel( HW_IPCC_ZIGBEE_APPLI_NOTIF_ACK_CHANNEL );
+  SimEnableReceiveChannel( HW_IPCC_ZIGBEE_APPLI_LOGGING_CHANNEL );
+
+  return;
+}
+
+void HW_IPCC_ZIGBEE_SendAppliCmd( void )
+{
+  SimSetFlag( HW_IPCC_ZIGBEE_CMD_APPLI_CHANNEL );
+  SimEnableTransmitChannel( HW_IPCC_ZIGBEE_CMD_APPLI_CHANNEL );
+
+  return;
+}
+
+void HW_IPCC_ZIGBEE_SendAppliCmdAck( void )
+{
+  SimClearFlag( HW_IPCC_ZIGBEE_APPLI_NOTIF_ACK_CHANNEL );
+  SimEnableReceiveChannel( HW_IPCC_ZIGBEE_APPLI_NOTIF_ACK_CHANNEL );
+
+  return;
+}
+
+void HW_IPCC_ZIGBEE_SendLoggingAck( void )
+{
+  SimClearFlag( HW_IPCC_ZIGBEE_APPLI_LOGGING_CHANNEL );
+  SimEnableReceiveChannel( HW_IPCC_ZIGBEE_APPLI_LOGGING_CHANNEL );
+
+  return;
+}
+
+static void HW_IPCC_ZIGBEE_CmdEvtHandler( void )
+{
+  SimDisableTransmitChannel( HW_IPCC_ZIGBEE_CMD_APPLI_CHANNEL );
+
+  HW_IPCC_ZIGBEE_AppliCmdNotification();
+
+  return;
+}
+
+static void HW_IPCC_ZIGBEE_StackNotifEvtHandler( void )
+{
+  SimDisableReceiveChannel( HW_IPCC_ZIGBEE_APPLI_NOTIF_ACK_CHANNEL );
+
+  HW_IPCC_ZIGBEE_AppliAsyncEvtNotification();
+
+  return;
+}
+
+static void HW_IPCC_ZIGBEE_StackLoggingEvtHandler( void )
+{
+  SimDisableReceiveChannel( HW_IPCC_ZIGBEE_APPLI_LOGGING_CHANNEL );
+
+  HW_IPCC_ZIGBEE_AppliAsyncLoggingNotification();
+
+  return;
+}
+
+/******************************************************************************
+ * MEMORY MANAGER
+ ******************************************************************************/
+void HW_IPCC_MM_SendFreeBuf( void (*cb)( void ) )
+{
+  if ( SimIsActiveFlag( HW_IPCC_MM_RELEASE_BUFFER_CHANNEL ) )
+  {
+    FreeBufCb = cb;
+    SimEnableTransmitChannel( HW_IPCC_MM_RELEASE_BUFFER_CHANNEL );
+  }
+  else
+  {
+    cb();
+
+    SimSetFlag( HW_IPCC_MM_RELEASE_BUFFER_CHANNEL );
+  }
+
+  return;
+}
+
+static void HW_IPCC_MM_FreeBufHandler( void )
+{
+  SimDisableTransmitChannel( HW_IPCC_MM_RELEASE_BUFFER_CHANNEL );
+
+  FreeBufCb();
+
+  SimSetFlag( HW_IPCC_MM_RELEASE_BUFFER_CHANNEL );
+
+  return;
+}
+
+/******************************************************************************
+ * TRACES
+ ******************************************************************************/
+void HW_IPCC_TRACES_Init( void )
+{
+  pthread_mutex_lock(&Sim.Mutex);
+  Sim.TracesReady = TRUE;
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  SimEnableReceiveChannel( HW_IPCC_TRACES_CHANNEL );
+
+  return;
+}
+
+static void HW_IPCC_TRACES_EvtHandler( void )
+{
+  HW_IPCC_TRACES_EvtNot();
+
+  SimClearFlag( HW_IPCC_TRACES_CHANNEL );
+
+  return;
+}
+
+/******************************************************************************
+ * SIMULATION
+ ******************************************************************************/
+void HW_IPCC_SIM_Config( const HW_IPCC_SIM_Config_t *p_config )
+{
+  SimInit();
+
+  pthread_mutex_lock(&Sim.Mutex);
+  Sim.Config = *p_config;
+  Sim.Cpu2Kick = TRUE;
+  pthread_cond_broadcast(&Sim.Cpu2Cond);
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  return;
+}
+
+void HW_IPCC_SIM_Post( HW_IPCC_SIM_StreamId_t stream, const HW_IPCC_SIM_Stream_t *p_stream )
+{
+  SimStream_t *p_sim_stream;
+
+  SimInit();
+
+  pthread_mutex_lock(&Sim.Mutex);
+  p_sim_stream = &Sim.Streams[stream];
+  p_sim_stream->Cfg = *p_stream;
+  if(p_sim_stream->Cfg.Len < HW_IPCC_SIM_STAMP_SIZE)
+  {
+    p_sim_stream->Cfg.Len = HW_IPCC_SIM_STAMP_SIZE;
+  }
+  p_sim_stream->Seq = 0;
+  p_sim_stream->DueNs = HW_IPCC_SIM_TimeNs();
+  p_sim_stream->Stalled = FALSE;
+  Sim.Cpu2Kick = TRUE;
+  pthread_cond_broadcast(&Sim.Cpu2Cond);
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  return;
+}
+
+void HW_IPCC_SIM_Stop( void )
+{
+  SimInit();
+
+  pthread_mutex_lock(&Sim.Mutex);
+  if(Sim.Cpu2Running != FALSE)
+  {
+    Sim.Cpu2Stop = TRUE;
+    pthread_cond_broadcast(&Sim.Cpu2Cond);
+    pthread_mutex_unlock(&Sim.Mutex);
+    pthread_join(Sim.Cpu2Thread, 0);
+    pthread_mutex_lock(&Sim.Mutex);
+    Sim.Cpu2Running = FALSE;
+  }
+
+  Sim.BleReady = FALSE;
+  Sim.SysReady = FALSE;
+  Sim.TracesReady = FALSE;
+  Sim.Protocol = SIM_PROTOCOL_NONE;
+  Sim.Ipcc.C1CR = 0;
+  Sim.Ipcc.C1MR = SIM_C1MR_RESET;
+  Sim.Ipcc.C1TOC2SR = 0;
+  Sim.Ipcc.C2TOC1SR = 0;
+  memset(Sim.Streams, 0, sizeof(Sim.Streams));
+  Sim.CmdSeen = 0;
+  Sim.CreditPending = FALSE;
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  return;
+}
+
+uint32_t HW_IPCC_SIM_WaitForInterrupt( uint32_t timeout_us )
+{
+  uint64_t deadline_ns;
+  uint32_t pending;
+
+  SimInit();
+
+  deadline_ns = HW_IPCC_SIM_TimeNs() + ((uint64_t)timeout_us * 1000U);
+
+  pthread_mutex_lock(&Sim.Mutex);
+  while(((pending = (SimRxPending() | SimTxPending())) == 0) && (HW_IPCC_SIM_TimeNs() < deadline_ns))
+  {
+    SimWait(&Sim.Cpu1Cond, deadline_ns);
+  }
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  /**
+   * As __WFI(), the interrupts masked with PRIMASK wake up the CPU1 without being taken
+   */
+  if((pending != 0) && (Primask == 0))
+  {
+    SimRunIrq();
+  }
+
+  return (pending != 0);
+}
+
+uint32_t HW_IPCC_SIM_Idle( void )
+{
+  uint32_t idle;
+  uint32_t stream;
+
+  SimInit();
+
+  pthread_mutex_lock(&Sim.Mutex);
+  idle = (Sim.Ipcc.C1TOC2SR == 0) && (Sim.Ipcc.C2TOC1SR == 0) && (Sim.CreditPending == FALSE)
+         && (Sim.SysReadyEvtPending == FALSE) && (Sim.Stats.EvtOutstanding == 0)
+         && (LST_is_empty(&Sim.BlePending) != FALSE) && (LST_is_empty(&Sim.SysPending) != FALSE)
+         && (LST_is_empty(&Sim.TracesPending) != FALSE);
+  for(stream = 0; stream < HW_IPCC_SIM_STREAM_NBR; stream++)
+  {
+    if(Sim.Streams[stream].Seq != Sim.Streams[stream].Cfg.Count)
+    {
+      idle = FALSE;
+    }
+  }
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  return idle;
+}
+
+void HW_IPCC_SIM_GetStats( HW_IPCC_SIM_Stats_t *p_stats )
+{
+  SimInit();
+
+  pthread_mutex_lock(&Sim.Mutex);
+  *p_stats = Sim.Stats;
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  return;
+}
+
+uint64_t HW_IPCC_SIM_TimeNs( void )
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t HW_IPCC_SIM_ReadStamp( const uint8_t *p_payload, uint32_t *p_seq )
+{
+  uint64_t time_ns;
+  uint32_t index;
+
+  *p_seq = 0;
+  for(index = 0; index < 4U; index++)
+  {
+    *p_seq |= (uint32_t)p_payload[index] << (8U * index);
+  }
+
+  time_ns = 0;
+  for(index = 0; index < 8U; index++)
+  {
+    time_ns |= (uint64_t)p_payload[4U + index] << (8U * index);
+  }
+
+  return HW_IPCC_SIM_TimeNs() - time_ns;
+}
+
+uint32_t HW_IPCC_SIM_GetPrimask( void )
+{
+  return Primask;
+}
+
+void HW_IPCC_SIM_SetPrimask( uint32_t primask )
+{
+  Primask = primask;
+
+  if((primask == 0) && (Cpu2Context == FALSE) && (InIrq == FALSE))
+  {
+    SimRunIrq();
+  }
+
+  return;
+}
+
+/* Private function definition -----------------------------------------------*/
+/******************************************************************************
+ * IPCC MODEL
+ ******************************************************************************/
+static void SimInitOnce( void )
+{
+  pthread_condattr_t attr;
+
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&Sim.Cpu1Cond, &attr);
+  pthread_cond_init(&Sim.Cpu2Cond, &attr);
+  pthread_condattr_destroy(&attr);
+
+  LST_init_head(&Sim.BlePending);
+  LST_init_head(&Sim.SysPending);
+  LST_init_head(&Sim.TracesPending);
+  LST_init_head(&Sim.FreeEvt);
+
+  return;
+}
+
+static void SimInit( void )
+{
+  pthread_once(&SimOnce, SimInitOnce);
+
+  return;
+}
+
+/* Called with the mutex locked */
+static void SimError( const char *msg )
+{
+  if(Sim.Stats.Errors == 0)
+  {
+    Sim.Stats.FirstError = msg;
+  }
+  Sim.Stats.Errors++;
+
+  return;
+}
+
+/* Called with the mutex locked */
+static uint32_t SimIsActiveFlag( uint32_t channel )
+{
+  return ((Sim.Ipcc.C1TOC2SR & channel) != 0);
+}
+
+/* Called with the mutex locked */
+static uint32_t SimC2IsActiveFlag( uint32_t channel )
+{
+  return ((Sim.Ipcc.C2TOC1SR & channel) != 0);
+}
+
+static void SimSetFlag( uint32_t channel )
+{
+  pthread_mutex_lock(&Sim.Mutex);
+  if(SimIsActiveFlag(channel))
+  {
+    SimError("CPU1 flag set while it is already set");
+  }
+  Sim.Ipcc.C1TOC2SR |= channel;
+  Sim.Cpu2Kick = TRUE;
+  pthread_cond_broadcast(&Sim.Cpu2Cond);
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  return;
+}
+
+static void SimClearFlag( uint32_t channel )
+{
+  pthread_mutex_lock(&Sim.Mutex);
+  if(SimC2IsActiveFlag(channel) == FALSE)
+  {
+    SimError("CPU2 flag cleared while it is not set");
+  }
+  Sim.Ipcc.C2TOC1SR &= ~channel;
+  Sim.Cpu2Kick = TRUE;
+  pthread_cond_broadcast(&Sim.Cpu2Cond);
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  return;
+}
+
+static void SimEnableTransmitChannel( uint32_t channel )
+{
+  pthread_mutex_lock(&Sim.Mutex);
+  Sim.Ipcc.C1MR &= ~(channel << 16U);
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  return;
+}
+
+static void SimDisableTransmitChannel( uint32_t channel )
+{
+  pthread_mutex_lock(&Sim.Mutex);
+  Sim.Ipcc.C1MR |= (channel << 16U);
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  return;
+}
+
+static void SimEnableReceiveChannel( uint32_t channel )
+{
+  pthread_mutex_lock(&Sim.Mutex);
+  Sim.Ipcc.C1MR &= ~channel;
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  return;
+}
+
+static void SimDisableReceiveChannel( uint32_t channel )
+{
+  pthread_mutex_lock(&Sim.Mutex);
+  Sim.Ipcc.C1MR |= channel;
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  return;
+}
+
+/* Called with the mutex locked */
+static uint32_t SimRxPending( void )
+{
+  uint32_t pending;
+
+  pending = 0;
+  if((Sim.Ipcc.C1CR & SIM_C1CR_RXOIE) != 0)
+  {
+    pending = Sim.Ipcc.C2TOC1SR & ~Sim.Ipcc.C1MR & SIM_CHANNEL_ALL;
+  }
+
+  return pending;
+}
+
+/* Called with the mutex locked */
+static uint32_t SimTxPending( void )
+{
+  uint32_t pending;
+
+  pending = 0;
+  if((Sim.Ipcc.C1CR & SIM_C1CR_TXFIE) != 0)
+  {
+    pending = ~Sim.Ipcc.C1TOC2SR & ~(Sim.Ipcc.C1MR >> 16U) & SIM_CHANNEL_ALL;
+  }
+
+  return pending;
+}
+
+/* Channels for which the handlers above have a branch. Called with the mutex locked */
+static uint32_t SimHandledChannels( void )
+{
+  uint32_t channels;
+
+  channels = HW_IPCC_SYSTEM_EVENT_CHANNEL | HW_IPCC_BLE_EVENT_CHANNEL | HW_IPCC_TRACES_CHANNEL
+             | HW_IPCC_MM_RELEASE_BUFFER_CHANNEL | HW_IPCC_HCI_ACL_DATA_CHANNEL;
+  if(Sim.Protocol == SIM_PROTOCOL_THREAD)
+  {
+    channels |= HW_IPCC_THREAD_NOTIFICATION_ACK_CHANNEL | HW_IPCC_THREAD_CLI_NOTIFICATION_ACK_CHANNEL;
+  }
+  else if(Sim.Protocol == SIM_PROTOCOL_ZIGBEE)
+  {
+    channels |= HW_IPCC_ZIGBEE_APPLI_NOTIF_ACK_CHANNEL | HW_IPCC_ZIGBEE_APPLI_LOGGING_CHANNEL;
+  }
+
+  return channels;
+}
+
+/**
+ * Run the interrupt handlers of the CPU1 as long as an interrupt is pending
+ * The handlers are called without the mutex
+ */
+static void SimRunIrq( void )
+{
+  uint32_t rx_pending;
+  uint32_t tx_pending;
+  uint32_t handled;
+
+  for(;;)
+  {
+    pthread_mutex_lock(&Sim.Mutex);
+    rx_pending = SimRxPending();
+    tx_pending = SimTxPending();
+    handled = SimHandledChannels();
+    if(((rx_pending | tx_pending) & ~handled) != 0)
+    {
+      /**
+       * The interrupt would be taken again and again on the target
+       */
+      SimError("CPU1 interrupt without handler");
+      Sim.Ipcc.C1MR |= (rx_pending & ~handled) | ((tx_pending & ~handled) << 16U);
+    }
+    if(rx_pending != 0)
+    {
+      Sim.Stats.RxIrq++;
+    }
+    else if(tx_pending != 0)
+    {
+      Sim.Stats.TxIrq++;
+    }
+    pthread_mutex_unlock(&Sim.Mutex);
+
+    if((rx_pending & handled) != 0)
+    {
+      InIrq = TRUE;
+      HW_IPCC_Rx_Handler();
+      InIrq = FALSE;
+    }
+    else if((tx_pending & handled) != 0)
+    {
+      InIrq = TRUE;
+      HW_IPCC_Tx_Handler();
+      InIrq = FALSE;
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  return;
+}
+
+/* Called with the mutex locked */
+static void SimWait( pthread_cond_t *p_cond, uint64_t deadline_ns )
+{
+  struct timespec ts;
+
+  if(deadline_ns == SIM_WAIT_FOREVER)
+  {
+    pthread_cond_wait(p_cond, &Sim.Mutex);
+  }
+  else
+  {
+    ts.tv_sec = (time_t)(deadline_ns / 1000000000U);
+    ts.tv_nsec = (long)(deadline_ns % 1000000000U);
+    (void)pthread_cond_timedwait(p_cond, &Sim.Mutex, &ts);
+  }
+
+  return;
+}
+
+/******************************************************************************
+ * CPU2
+ ******************************************************************************/
+static void *Cpu2Main( void *arg )
+{
+  uint64_t now;
+  uint64_t next;
+  SimIpcc_t ipcc;
+
+  (void)(arg);
+
+  Cpu2Context = TRUE;
+
+  pthread_mutex_lock(&Sim.Mutex);
+
+  Cpu2Boot();
+
+  while(Sim.Cpu2Stop == FALSE)
+  {
+    Sim.Cpu2Kick = FALSE;
+    ipcc = Sim.Ipcc;
+    now = HW_IPCC_SIM_TimeNs();
+    next = SIM_WAIT_FOREVER;
+
+    Cpu2FreeBuf();
+    Cpu2Commands(now, &next);
+    Cpu2Credit(now, &next);
+    Cpu2PoolStreams(now, &next);
+    Cpu2NotStreams(now, &next);
+
+    if(memcmp(&ipcc, &Sim.Ipcc, sizeof(ipcc)) != 0)
+    {
+      pthread_cond_broadcast(&Sim.Cpu1Cond);
+    }
+
+    if((Sim.Cpu2Kick == FALSE) && (Sim.Cpu2Stop == FALSE) && (next > HW_IPCC_SIM_TimeNs()))
+    {
+      SimWait(&Sim.Cpu2Cond, next);
+    }
+  }
+
+  Cpu2Shutdown();
+
+  pthread_mutex_unlock(&Sim.Mutex);
+
+  return 0;
+}
+
+static volatile MB_RefTable_t *Cpu2RefTable( void )
+{
+  return (volatile MB_RefTable_t *)__start_MAPPING_TABLE;
+}
+
+/**
+ * Return the buffer when it is in the memory shared with the CPU2, NULL otherwise
+ */
+static uint8_t *Cpu2Buffer( uint8_t *p_buffer, uint32_t size )
+{
+  uint8_t *p_return;
+
+  p_return = 0;
+  if(((p_buffer >= __start_MB_MEM1) && ((p_buffer + size) <= __stop_MB_MEM1))
+     || ((p_buffer >= __start_MB_MEM2) && ((p_buffer + size) <= __stop_MB_MEM2)))
+  {
+    p_return = p_buffer;
+  }
+  else
+  {
+    SimError("buffer out of MB_MEM1 and MB_MEM2");
+  }
+
+  return p_return;
+}
+
+/**
+ * Carve the event buffers in the pools given with TL_MM_Init()
+ */
+static void Cpu2Boot( void )
+{
+  volatile MB_MemManagerTable_t *p_mm_table;
+  uint8_t *p_pool;
+  uint32_t pool_size;
+  uint32_t pool;
+  uint32_t slot;
+  uint32_t slot_nbr;
+
+  if((uint32_t)(__stop_MAPPING_TABLE - __start_MAPPING_TABLE) < sizeof(MB_RefTable_t))
+  {
+    SimError("MAPPING_TABLE section too small");
+    return;
+  }
+
+  Sim.SlotSize = Sim.Config.EvtBufferSize;
+  if(Sim.SlotSize == 0)
+  {
+    Sim.SlotSize = SIM_EVT_BUFFER_SIZE;
+  }
+  /**
+   * The list nodes of the host hold 64 bits pointers
+   */
+  Sim.SlotSize = DIVC(Sim.SlotSize, sizeof(tListNode *)) * sizeof(tListNode *);
+
+  LST_init_head(&Sim.FreeEvt);
+  slot_nbr = 0;
+  p_mm_table = Cpu2RefTable()->p_mem_manager_table;
+  if(Cpu2Buffer((uint8_t *)p_mm_table, sizeof(MB_MemManagerTable_t)) != 0)
+  {
+    for(pool = 0; pool < 2U; pool++)
+    {
+      p_pool = (pool == 0) ? p_mm_table->blepool : p_mm_table->traces_evt_pool;
+      pool_size = (pool == 0) ? p_mm_table->blepoolsize : p_mm_table->tracespoolsize;
+      Sim.Pool[pool] = 0;
+      Sim.PoolSlots[pool] = 0;
+      if((p_pool != 0) && (pool_size != 0) && (Cpu2Buffer(p_pool, pool_size) != 0))
+      {
+        Sim.Pool[pool] = p_pool;
+        Sim.PoolSlots[pool] = pool_size / Sim.SlotSize;
+        for(slot = 0; slot < Sim.PoolSlots[pool]; slot++)
+        {
+          LST_insert_tail(&Sim.FreeEvt, (tListNode *)(p_pool + (slot * Sim.SlotSize)));
+        }
+        slot_nbr += Sim.PoolSlots[pool];
+      }
+    }
+  }
+  if(slot_nbr == 0)
+  {
+    SimError("no event buffer in the memory manager pools");
+  }
+  Sim.Outstanding = calloc(slot_nbr + 1U, 1U);
+  Sim.Stats.EvtOutstanding = 0;
+
+  /**
+   * The system is ready once the CPU1 has initialized the system channel
+   */
+  Sim.SysReadyEvtPending = TRUE;
+
+  return;
+}
+
+static void Cpu2Shutdown( void )
+{
+  tListNode *p_node;
+
+  while(LST_is_empty(&Sim.BlePending) == FALSE)
+  {
+    LST_remove_head(&Sim.BlePending, &p_node);
+  }
+  while(LST_is_empty(&Sim.SysPending) == FALSE)
+  {
+    LST_remove_head(&Sim.SysPending, &p_node);
+  }
+  while(LST_is_empty(&Sim.TracesPending) == FALSE)
+  {
+    LST_remove_head(&Sim.TracesPending, &p_node);
+  }
+  LST_init_head(&Sim.FreeEvt);
+  free(Sim.Outstanding);
+  Sim.Outstanding = 0;
+  Sim.Pool[0] = 0;
+  Sim.Pool[1] = 0;
+  Sim.SysReadyEvtPending = FALSE;
+  Sim.Stats.EvtOutstanding = 0;
+
+  return;
+}
+
+static int32_t Cpu2SlotIndex( const uint8_t *p_buffer )
+{
+  uint32_t pool;
+  uint32_t offset;
+  int32_t index;
+
+  index = 0;
+  for(pool = 0; pool < 2U; pool++)
+  {
+    if((Sim.Pool[pool] != 0) && (p_buffer >= Sim.Pool[pool]))
+    {
+      offset = (uint32_t)(p_buffer - Sim.Pool[pool]);
+      if((offset < (Sim.PoolSlots[pool] * Sim.SlotSize)) && ((offset % Sim.SlotSize) == 0))
+      {
+        return index + (int32_t)(offset / Sim.SlotSize);
+      }
+    }
+    index += (int32_t)Sim.PoolSlots[pool];
+  }
+
+  return -1;
+}
+
+static TL_EvtPacket_t *Cpu2AllocEvt( void )
+{
+  tListNode *p_node;
+
+  p_node = 0;
+  if(LST_is_empty(&Sim.FreeEvt) == FALSE)
+  {
+    LST_remove_head(&Sim.FreeEvt, &p_node);
+    Sim.Outstanding[Cpu2SlotIndex((uint8_t *)p_node)] = TRUE;
+    Sim.Stats.EvtOutstanding++;
+  }
+
+  return (TL_EvtPacket_t *)p_node;
+}
+
+static void Cpu2FillEvt( TL_EvtPacket_t *p_evt, uint8_t type, SimStream_t *p_stream )
+{
+  uint64_t time_ns;
+  uint32_t index;
+  uint8_t *p_payload;
+
+  p_evt->evtserial.type = type;
+  p_evt->evtserial.evt.evtcode = SIM_EVTCODE;
+  p_evt->evtserial.evt.plen = p_stream->Cfg.Len;
+
+  p_payload = p_evt->evtserial.evt.payload;
+  time_ns = HW_IPCC_SIM_TimeNs();
+  for(index = 0; index < 4U; index++)
+  {
+    p_payload[index] = (uint8_t)(p_stream->Seq >> (8U * index));
+  }
+  for(index = 0; index < 8U; index++)
+  {
+    p_payload[4U + index] = (uint8_t)(time_ns >> (8U * index));
+  }
+  for(index = HW_IPCC_SIM_STAMP_SIZE; index < p_stream->Cfg.Len; index++)
+  {
+    p_payload[index] = (uint8_t)(p_stream->Seq + index);
+  }
+
+  p_stream->Seq++;
+
+  return;
+}
+
+/**
+ * Take back the buffers sent back by the CPU1
+ */
+static void Cpu2FreeBuf( void )
+{
+  tListNode *p_queue;
+  tListNode *p_node;
+  int32_t index;
+
+  if(SimIsActiveFlag(HW_IPCC_MM_RELEASE_BUFFER_CHANNEL) == FALSE)
+  {
+    return;
+  }
+
+  p_queue = (tListNode *)Cpu2Buffer(Cpu2RefTable()->p_mem_manager_table->pevt_free_buffer_queue, sizeof(tListNode));
+  if(p_queue != 0)
+  {
+    /**
+     * The buffers may have been sent back from the background while the notification was pending
+     */
+    if(LST_is_empty(p_queue) != FALSE)
+    {
+      Sim.Stats.FreeBufEmpty++;
+    }
+
+    while(LST_is_empty(p_queue) == FALSE)
+    {
+      LST_remove_head(p_queue, &p_node);
+      index = Cpu2SlotIndex((uint8_t *)p_node);
+      if(index < 0)
+      {
+        SimError("buffer sent back out of the pools");
+      }
+      else if(Sim.Outstanding[index] == FALSE)
+      {
+        SimError("buffer sent back while it is free");
+      }
+      else
+      {
+        Sim.Outstanding[index] = FALSE;
+        Sim.Stats.EvtOutstanding--;
+        Sim.Stats.EvtReturned++;
+        LST_insert_tail(&Sim.FreeEvt, p_node);
+      }
+    }
+  }
+  Sim.Stats.FreeBufDoorbells++;
+
+  Sim.Ipcc.C1TOC2SR &= ~HW_IPCC_MM_RELEASE_BUFFER_CHANNEL;
+
+  return;
+}
+
+/**
+ * Answer the commands of the CPU1 after Config.CmdDelayUs
+ */
+static void Cpu2Commands( uint64_t now, uint64_t *p_next )
+{
+  static const uint32_t channels[] = { HW_IPCC_BLE_CMD_CHANNEL, HW_IPCC_SYSTEM_CMD_RSP_CHANNEL,
+                                       HW_IPCC_THREAD_OT_CMD_RSP_CHANNEL, HW_IPCC_THREAD_CLI_CMD_CHANNEL,
+                                       HW_IPCC_HCI_ACL_DATA_CHANNEL };
+  uint32_t index;
+  uint32_t channel;
+  uint32_t position;
+  uint64_t delay_ns;
+
+  for(index = 0; index < (sizeof(channels) / sizeof(channels[0])); index++)
+  {
+    channel = channels[index];
+    if(SimIsActiveFlag(channel) == FALSE)
+    {
+      continue;
+    }
+
+    position = (uint32_t)__builtin_ctz(channel);
+    if((Sim.CmdSeen & channel) == 0)
+    {
+      delay_ns = (channel == HW_IPCC_HCI_ACL_DATA_CHANNEL) ? Sim.Config.AclDelayUs : Sim.Config.CmdDelayUs;
+      Sim.CmdDueNs[position] = now + (delay_ns * 1000U);
+      Sim.CmdSeen |= channel;
+    }
+
+    if(Sim.CmdDueNs[position] > now)
+    {
+      *p_next = MIN(*p_next, Sim.CmdDueNs[position]);
+      continue;
+    }
+
+    Sim.CmdSeen &= ~channel;
+    switch(channel)
+    {
+      case HW_IPCC_BLE_CMD_CHANNEL:
+        Cpu2BleCmd();
+        break;
+
+      case HW_IPCC_SYSTEM_CMD_RSP_CHANNEL:
+        Cpu2SysCmd();
+        break;
+
+      case HW_IPCC_THREAD_OT_CMD_RSP_CHANNEL:
+        Cpu2OtCmd();
+        break;
+
+      case HW_IPCC_THREAD_CLI_CMD_CHANNEL:
+        Cpu2CliCmd();
+        break;
+
+      default:
+        Cpu2AclData();
+        break;
+    }
+    Sim.Ipcc.C1TOC2SR &= ~channel;
+  }
+
+  return;
+}
+
+/**
+ * The command complete is written in the command buffer, the command status in the CS buffer of the table
+ */
+static void Cpu2BleCmd( void )
+{
+  volatile MB_BleTable_t *p_ble_table;
+  TL_CmdPacket_t *p_cmd;
+  TL_EvtPacket_t *p_evt;
+  TL_CcEvt_t *p_cc;
+  TL_CsEvt_t *p_cs;
+  uint16_t opcode;
+  uint8_t plen;
+  uint8_t param[255];
+
+  Sim.Stats.BleCmd++;
+
+  if(Sim.BleReady == FALSE)
+  {
+    SimError("BLE command before HW_IPCC_BLE_Init()");
+    return;
+  }
+
+  p_ble_table = Cpu2RefTable()->p_ble_table;
+  p_cmd = (TL_CmdPacket_t *)Cpu2Buffer(p_ble_table->pcmd_buffer, sizeof(TL_CmdPacket_t));
+  if(p_cmd == 0)
+  {
+    return;
+  }
+  if(p_cmd->cmdserial.type != TL_BLECMD_PKT_TYPE)
+  {
+    SimError("BLE command packet type");
+  }
+
+  opcode = p_cmd->cmdserial.cmd.cmdcode;
+  plen = MIN(p_cmd->cmdserial.cmd.plen, (uint8_t)(255U - TL_EVT_HDR_SIZE - 1U));
+  memcpy(param, p_cmd->cmdserial.cmd.payload, plen);
+
+  if((Sim.Config.BleRsp == HW_IPCC_SIM_RSP_CS) && (Sim.Config.BleNumCmd != 0))
+  {
+    p_evt = (TL_EvtPacket_t *)Cpu2Buffer(p_ble_table->pcs_buffer, TL_BLEEVT_CS_BUFFER_SIZE);
+    if(p_evt == 0)
+    {
+      return;
+    }
+    p_evt->evtserial.type = TL_BLEEVT_PKT_TYPE;
+    p_evt->evtserial.evt.evtcode = TL_BLEEVT_CS_OPCODE;
+    p_evt->evtserial.evt.plen = TL_EVT_CS_PAYLOAD_SIZE;
+    p_cs = (TL_CsEvt_t *)p_evt->evtserial.evt.payload;
+    p_cs->status = 0;
+    p_cs->numcmd = Sim.Config.BleNumCmd;
+    p_cs->cmdcode = opcode;
+  }
+  else
+  {
+    p_evt = (TL_EvtPacket_t *)p_cmd;
+    p_evt->evtserial.type = TL_BLEEVT_PKT_TYPE;
+    p_evt->evtserial.evt.evtcode = TL_BLEEVT_CC_OPCODE;
+    p_evt->evtserial.evt.plen = TL_EVT_HDR_SIZE + 1U + plen;
+    p_cc = (TL_CcEvt_t *)p_evt->evtserial.evt.payload;
+    p_cc->numcmd = Sim.Config.BleNumCmd;
+    p_cc->cmdcode = opcode;
+    p_cc->payload[0] = 0;
+    memcpy(&p_cc->payload[1], param, plen);
+
+    if(Sim.Config.BleNumCmd == 0)
+    {
+      Sim.CreditPending = TRUE;
+      Sim.CreditDueNs = HW_IPCC_SIM_TimeNs() + ((uint64_t)Sim.Config.BleCreditDelayUs * 1000U);
+    }
+  }
+
+  LST_insert_tail(&Sim.BlePending, (tListNode *)p_evt);
+
+  return;
+}
+
+/**
+ * The response of a system command is written at the start of the command buffer, without the packet header
+ */
+static void Cpu2SysCmd( void )
+{
+  TL_CmdPacket_t *p_cmd;
+  TL_EvtSerial_t *p_rsp;
+  TL_CcEvt_t *p_cc;
+  uint16_t opcode;
+  uint8_t plen;
+  uint8_t param[255];
+
+  Sim.Stats.SysCmd++;
+
+  if(Sim.SysReady == FALSE)
+  {
+    SimError("system command before HW_IPCC_SYS_Init()");
+    return;
+  }
+
+  p_cmd = (TL_CmdPacket_t *)Cpu2Buffer(Cpu2RefTable()->p_sys_table->pcmd_buffer, sizeof(TL_CmdPacket_t));
+  if(p_cmd == 0)
+  {
+    return;
+  }
+  if(p_cmd->cmdserial.type != TL_SYSCMD_PKT_TYPE)
+  {
+    SimError("system command packet type");
+  }
+
+  opcode = p_cmd->cmdserial.cmd.cmdcode;
+  plen = MIN(p_cmd->cmdserial.cmd.plen, (uint8_t)(255U - TL_EVT_HDR_SIZE - 1U));
+  memcpy(param, p_cmd->cmdserial.cmd.payload, plen);
+
+  p_rsp = (TL_EvtSerial_t *)p_cmd;
+  p_rsp->type = TL_SYSRSP_PKT_TYPE;
+  p_rsp->evt.evtcode = TL_BLEEVT_CC_OPCODE;
+  p_rsp->evt.plen = TL_EVT_HDR_SIZE + 1U + plen;
+  p_cc = (TL_CcEvt_t *)p_rsp->evt.payload;
+  p_cc->numcmd = 1;
+  p_cc->cmdcode = opcode;
+  p_cc->payload[0] = 0;
+  memcpy(&p_cc->payload[1], param, plen);
+
+  return;
+}
+
+/**
+ * The Thread OT and Zigbee application commands are answered in place
+ */
+static void Cpu2OtCmd( void )
+{
+  TL_CmdPacket_t *p_cmd;
+  uint8_t *p_buffer;
+
+  Sim.Stats.OtCmd++;
+
+  if(Sim.Protocol == SIM_PROTOCOL_THREAD)
+  {
+    p_buffer = Cpu2RefTable()->p_thread_table->otcmdrsp_buffer;
+  }
+  else if(Sim.Protocol == SIM_PROTOCOL_ZIGBEE)
+  {
+    p_buffer = Cpu2RefTable()->p_zigbee_table->appliCmdM4toM0_buffer;
+  }
+  else
+  {
+    SimError("Thread or Zigbee command before HW_IPCC_THREAD_Init() or HW_IPCC_ZIGBEE_Init()");
+    return;
+  }
+
+  p_cmd = (TL_CmdPacket_t *)Cpu2Buffer(p_buffer, sizeof(TL_CmdPacket_t));
+  if(p_cmd == 0)
+  {
+    return;
+  }
+  if(p_cmd->cmdserial.type != TL_OTCMD_PKT_TYPE)
+  {
+    SimError("Thread or Zigbee command packet type");
+  }
+  p_cmd->cmdserial.type = TL_OTRSP_PKT_TYPE;
+
+  return;
+}
+
+static void Cpu2CliCmd( void )
+{
+  TL_CmdPacket_t *p_cmd;
+
+  Sim.Stats.CliCmd++;
+
+  if(Sim.Protocol != SIM_PROTOCOL_THREAD)
+  {
+    SimError("CLI command before HW_IPCC_THREAD_Init()");
+    return;
+  }
+
+  p_cmd = (TL_CmdPacket_t *)Cpu2Buffer(Cpu2RefTable()->p_thread_table->clicmdrsp_buffer, sizeof(TL_CmdPacket_t));
+  if((p_cmd != 0) && (p_cmd->cmdserial.type != TL_CLICMD_PKT_TYPE))
+  {
+    SimError("CLI command packet type");
+  }
+
+  return;
+}
+
+static void Cpu2AclData( void )
+{
+  TL_AclDataPacket_t *p_acl;
+
+  if(Sim.BleReady == FALSE)
+  {
+    SimError("ACL data before HW_IPCC_BLE_Init()");
+    return;
+  }
+
+  p_acl = (TL_AclDataPacket_t *)Cpu2Buffer(Cpu2RefTable()->p_ble_table->phci_acl_data_buffer,
+                                           sizeof(TL_AclDataPacket_t));
+  if(p_acl == 0)
+  {
+    return;
+  }
+  if(p_acl->AclDataSerial.type != TL_ACL_DATA_PKT_TYPE)
+  {
+    SimError("ACL data packet type");
+  }
+
+  Sim.Stats.AclData++;
+  Sim.Stats.AclBytes += p_acl->AclDataSerial.length;
+
+  return;
+}
+
+/**
+ * Command status without opcode giving back a credit when the BLE responses have none
+ */
+static void Cpu2Credit( uint64_t now, uint64_t *p_next )
+{
+  TL_EvtPacket_t *p_evt;
+  TL_CsEvt_t *p_cs;
+
+  if(Sim.CreditPending == FALSE)
+  {
+    return;
+  }
+
+  if(Sim.CreditDueNs > now)
+  {
+    *p_next = MIN(*p_next, Sim.CreditDueNs);
+    return;
+  }
+
+  Sim.CreditPending = FALSE;
+  p_evt = (TL_EvtPacket_t *)Cpu2Buffer(Cpu2RefTable()->p_ble_table->pcs_buffer, TL_BLEEVT_CS_BUFFER_SIZE);
+  if(p_evt == 0)
+  {
+    return;
+  }
+  p_evt->evtserial.type = TL_BLEEVT_PKT_TYPE;
+  p_evt->evtserial.evt.evtcode = TL_BLEEVT_CS_OPCODE;
+  p_evt->evtserial.evt.plen = TL_EVT_CS_PAYLOAD_SIZE;
+  p_cs = (TL_CsEvt_t *)p_evt->evtserial.evt.payload;
+  p_cs->status = 0;
+  p_cs->numcmd = 1;
+  p_cs->cmdcode = 0;
+
+  LST_insert_tail(&Sim.BlePending, (tListNode *)p_evt);
+  Sim.Stats.BleCredit++;
+
+  return;
+}
+
+static uint64_t Cpu2StreamDue( SimStream_t *p_stream, uint64_t now )
+{
+  if(p_stream->Cfg.PeriodUs == 0)
+  {
+    p_stream->DueNs = now;
+  }
+  else
+  {
+    p_stream->DueNs += (uint64_t)p_stream->Cfg.PeriodUs * 1000U;
+  }
+
+  return p_stream->DueNs;
+}
+
+/**
+ * Post the events and the traces from the pools, then give them to the CPU1 when their channel is free
+ */
+static void Cpu2PoolStreams( uint64_t now, uint64_t *p_next )
+{
+  static const uint8_t types[] = { TL_BLEEVT_PKT_TYPE, TL_SYSEVT_PKT_TYPE, TL_TRACES_WL_PKT_TYPE };
+  tListNode * const pending[] = { &Sim.BlePending, &Sim.SysPending, &Sim.TracesPending };
+  const uint8_t ready[] = { Sim.BleReady, Sim.SysReady, Sim.TracesReady };
+  SimStream_t *p_stream;
+  TL_EvtPacket_t *p_evt;
+  TL_AsynchEvt_t *p_asynch;
+  uint32_t stream;
+
+  if((Sim.SysReadyEvtPending != FALSE) && (Sim.SysReady != FALSE))
+  {
+    p_evt = Cpu2AllocEvt();
+    if(p_evt != 0)
+    {
+      p_evt->evtserial.type = TL_SYSEVT_PKT_TYPE;
+      p_evt->evtserial.evt.evtcode = SIM_EVTCODE;
+      p_evt->evtserial.evt.plen = 3;
+      p_asynch = (TL_AsynchEvt_t *)p_evt->evtserial.evt.payload;
+      p_asynch->subevtcode = HW_IPCC_SIM_SYS_READY_SUBEVT;
+      p_asynch->payload[0] = 0;
+      LST_insert_tail(&Sim.SysPending, (tListNode *)p_evt);
+      Sim.SysReadyEvtPending = FALSE;
+    }
+  }
+
+  for(stream = HW_IPCC_SIM_BLE_EVT; stream <= HW_IPCC_SIM_TRACES; stream++)
+  {
+    p_stream = &Sim.Streams[stream];
+    if(ready[stream] == FALSE)
+    {
+      continue;
+    }
+
+    while((p_stream->Seq < p_stream->Cfg.Count) && (p_stream->DueNs <= now))
+    {
+      p_evt = Cpu2AllocEvt();
+      if(p_evt == 0)
+      {
+        if(p_stream->Stalled == FALSE)
+        {
+          Sim.Stats.EvtStalls++;
+          p_stream->Stalled = TRUE;
+        }
+        break;
+      }
+      p_stream->Stalled = FALSE;
+
+      Cpu2FillEvt(p_evt, types[stream], p_stream);
+      LST_insert_tail(pending[stream], (tListNode *)p_evt);
+      Sim.Stats.Posted[stream]++;
+      (void)Cpu2StreamDue(p_stream, now);
+    }
+
+    if((p_stream->Seq < p_stream->Cfg.Count) && (p_stream->Stalled == FALSE))
+    {
+      *p_next = MIN(*p_next, p_stream->DueNs);
+    }
+  }
+
+  if(Sim.BleReady != FALSE)
+  {
+    Cpu2Doorbell(&Sim.BlePending, Cpu2RefTable()->p_ble_table->pevt_queue, HW_IPCC_BLE_EVENT_CHANNEL,
+                 HW_IPCC_SIM_BLE_EVT);
+  }
+  if(Sim.SysReady != FALSE)
+  {
+    Cpu2Doorbell(&Sim.SysPending, Cpu2RefTable()->p_sys_table->sys_queue, HW_IPCC_SYSTEM_EVENT_CHANNEL,
+                 HW_IPCC_SIM_SYS_EVT);
+  }
+  if(Sim.TracesReady != FALSE)
+  {
+    Cpu2Doorbell(&Sim.TracesPending, Cpu2RefTable()->p_traces_table->traces_queue, HW_IPCC_TRACES_CHANNEL,
+                 HW_IPCC_SIM_TRACES);
+  }
+
+  return;
+}
+
+static void Cpu2Doorbell( tListNode *p_pending, uint8_t *p_queue, uint32_t channel, HW_IPCC_SIM_StreamId_t stream )
+{
+  tListNode *p_list;
+
+  if((LST_is_empty(p_pending) != FALSE) || (SimC2IsActiveFlag(channel) != FALSE))
+  {
+    return;
+  }
+
+  p_list = (tListNode *)Cpu2Buffer(p_queue, sizeof(tListNode));
+  if(p_list == 0)
+  {
+    return;
+  }
+  if(LST_is_empty(p_list) == FALSE)
+  {
+    SimError("CPU2 flag cleared before the queue is read");
+  }
+
+  LST_splice_tail(p_list, p_pending);
+  Sim.Ipcc.C2TOC1SR |= channel;
+  Sim.Stats.Doorbells[stream]++;
+
+  return;
+}
+
+/**
+ * Post the notifications in their buffer once the previous one is acked
+ */
+static void Cpu2NotStreams( uint64_t now, uint64_t *p_next )
+{
+  SimStream_t *p_stream;
+  TL_EvtPacket_t *p_evt;
+  uint8_t *p_buffer;
+  uint32_t stream;
+  uint32_t channel;
+  uint8_t type;
+
+  for(stream = HW_IPCC_SIM_THREAD_NOT; stream < HW_IPCC_SIM_STREAM_NBR; stream++)
+  {
+    p_stream = &Sim.Streams[stream];
+
+    switch(stream)
+    {
+      case HW_IPCC_SIM_THREAD_NOT:
+        channel = (Sim.Protocol == SIM_PROTOCOL_THREAD) ? HW_IPCC_THREAD_NOTIFICATION_ACK_CHANNEL : 0;
+        p_buffer = Cpu2RefTable()->p_thread_table->notack_buffer;
+        type = TL_OTNOT_PKT_TYPE;
+        break;
+
+      case HW_IPCC_SIM_THREAD_CLI_NOT:
+        channel = (Sim.Protocol == SIM_PROTOCOL_THREAD) ? HW_IPCC_THREAD_CLI_NOTIFICATION_ACK_CHANNEL : 0;
+        p_buffer = Cpu2RefTable()->p_thread_table->clicmdrsp_buffer;
+        type = TL_CLINOT_PKT_TYPE;
+        break;
+
+      case HW_IPCC_SIM_ZIGBEE_NOT:
+        channel = (Sim.Protocol == SIM_PROTOCOL_ZIGBEE) ? HW_IPCC_ZIGBEE_APPLI_NOTIF_ACK_CHANNEL : 0;
+        p_buffer = Cpu2RefTable()->p_zigbee_table->notifM0toM4_buffer;
+        type = TL_OTNOT_PKT_TYPE;
+        break;
+
+      default:
+        channel = (Sim.Protocol == SIM_PROTOCOL_ZIGBEE) ? HW_IPCC_ZIGBEE_APPLI_LOGGING_CHANNEL : 0;
+        p_buffer = Cpu2RefTable()->p_zigbee_table->loggingM0toM4_buffer;
+        type = TL_OTNOT_PKT_TYPE;
+        break;
+    }
+
+    if((channel == 0) || (SimC2IsActiveFlag(channel) != FALSE))
+    {
+      continue;
+    }
+
+    if(p_stream->AwaitAck != FALSE)
+    {
+      /**
+       * The CPU1 writes the ack in the buffer before clearing the flag, except for the CLI
+       */
+      p_stream->AwaitAck = FALSE;
+      if((stream != HW_IPCC_SIM_THREAD_CLI_NOT) && (((TL_EvtPacket_t *)p_buffer)->evtserial.type != TL_OTACK_PKT_TYPE))
+      {
+        SimError("notification ack packet type");
+      }
+    }
+
+    /**
+     * The CLI buffer is also used by the CLI commands
+     */
+    if((stream == HW_IPCC_SIM_THREAD_CLI_NOT) && (SimIsActiveFlag(HW_IPCC_THREAD_CLI_CMD_CHANNEL) != FALSE))
+    {
+      continue;
+    }
+
+    if((p_stream->Seq < p_stream->Cfg.Count) && (p_stream->DueNs <= now))
+    {
+      p_evt = (TL_EvtPacket_t *)Cpu2Buffer(p_buffer, sizeof(TL_PacketHeader_t) + TL_EVT_HDR_SIZE + p_stream->Cfg.Len);
+      if(p_evt == 0)
+      {
+        p_stream->Seq = p_stream->Cfg.Count;
+        continue;
+      }
+      Cpu2FillEvt(p_evt, type, p_stream);
+      p_stream->AwaitAck = TRUE;
+      Sim.Ipcc.C2TOC1SR |= channel;
+      Sim.Stats.Posted[stream]++;
+      Sim.Stats.Doorbells[stream]++;
+      (void)Cpu2StreamDue(p_stream, now);
+    }
+    else if(p_stream->Seq < p_stream->Cfg.Count)
+    {
+      *p_next = MIN(*p_next, p_stream->DueNs);
+    }
+  }
+
+  return;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,176 @@
+/**
+  ******************************************************************************
+  * @file    hw_ipcc_sim.h
+  * @author  MCD Application Team
+  * @brief   Host backend of the HW_IPCC_* hooks of hw.h: model of the IPCC
+  *          and of the CPU1 interrupts, and a fake CPU2 thread that answers
+  *          the commands and posts the events, the notifications and the
+  *          traces at the rates set with HW_IPCC_SIM_Post()
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HW_IPCC_SIM_H
+#define __HW_IPCC_SIM_H
+
+#include <stdint.h>
+
+/* Exported defines ----------------------------------------------------------*/
+/* Channels of the IPCC, as in stm32wbxx_ll_ipcc.h (used by mbox_def.h) */
+#define LL_IPCC_CHANNEL_1                   (0x00000001U)
+#define LL_IPCC_CHANNEL_2                   (0x00000002U)
+#define LL_IPCC_CHANNEL_3                   (0x00000004U)
+#define LL_IPCC_CHANNEL_4                   (0x00000008U)
+#define LL_IPCC_CHANNEL_5                   (0x00000010U)
+#define LL_IPCC_CHANNEL_6                   (0x00000020U)
+
+/**
+ * Each packet posted by the CPU2 starts with its sequence number in the stream (4 bytes) and the
+ * HW_IPCC_SIM_TimeNs() at which it has been posted (8 bytes), both little endian
+ */
+#define HW_IPCC_SIM_STAMP_SIZE              (12U)
+
+/**
+ * Sub event code of the system event posted by the CPU2 when it has booted (SHCI_SUB_EVT_CODE_READY)
+ */
+#define HW_IPCC_SIM_SYS_READY_SUBEVT        (0x9200U)
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum
+{
+  HW_IPCC_SIM_BLE_EVT,        /**< BLE asynchronous events, from the memory manager pool */
+  HW_IPCC_SIM_SYS_EVT,        /**< System events, from the memory manager pool */
+  HW_IPCC_SIM_TRACES,         /**< Traces, from the traces pool or the memory manager pool */
+  HW_IPCC_SIM_THREAD_NOT,     /**< Thread notifications, in the notification buffer */
+  HW_IPCC_SIM_THREAD_CLI_NOT, /**< Thread CLI notifications, in the CLI buffer */
+  HW_IPCC_SIM_ZIGBEE_NOT,     /**< Zigbee notifications, in the notification buffer */
+  HW_IPCC_SIM_ZIGBEE_LOG,     /**< Zigbee logging, in the logging buffer */
+  HW_IPCC_SIM_STREAM_NBR
+} HW_IPCC_SIM_StreamId_t;
+
+/**
+ * Packets posted by the CPU2 on a stream
+ * The packets of the memory manager pool are posted as long as there are free buffers. All the packets
+ * waiting when the IPCC channel is free are given to the CPU1 with a single notification.
+ * The notifications use a single buffer: the next one is posted once the CPU1 has sent the ack.
+ */
+typedef struct
+{
+  uint32_t Count;             /**< Number of packets to post */
+  uint32_t PeriodUs;          /**< Time between two packets. When 0, they are posted as fast as possible */
+  uint8_t  Len;               /**< Payload length, at least HW_IPCC_SIM_STAMP_SIZE */
+} HW_IPCC_SIM_Stream_t;
+
+typedef enum
+{
+  HW_IPCC_SIM_RSP_CC,         /**< Command complete, returning the status 0 and the command parameters */
+  HW_IPCC_SIM_RSP_CS,         /**< Command status, with the status 0 */
+} HW_IPCC_SIM_BleRsp_t;
+
+/**
+ * Behavior of the CPU2 on the commands
+ * All the commands are answered with the same parameters as they have been sent, after the status
+ */
+typedef struct
+{
+  uint32_t CmdDelayUs;        /**< Time to answer a command (BLE, system, Thread, Zigbee) */
+  uint32_t AclDelayUs;        /**< Time to send an ACL data packet */
+  HW_IPCC_SIM_BleRsp_t BleRsp;
+  uint8_t  BleNumCmd;         /**< Num_HCI_Command_Packets of the BLE responses */
+  /**
+   * When BleNumCmd is 0, the response is a command complete and a command status without opcode
+   * giving back one credit is posted after BleCreditDelayUs
+   */
+  uint32_t BleCreditDelayUs;
+  /**
+   * Size of the buffers carved in the memory manager pools when the CPU2 boots. When 0, the size of
+   * the largest event. The pools shall be aligned on the size of a pointer of the host.
+   */
+  uint32_t EvtBufferSize;
+} HW_IPCC_SIM_Config_t;
+
+typedef struct
+{
+  uint32_t Posted[HW_IPCC_SIM_STREAM_NBR];    /**< Packets posted on each stream */
+  uint32_t Doorbells[HW_IPCC_SIM_STREAM_NBR]; /**< IPCC notifications used to post them */
+  uint32_t BleCmd;
+  uint32_t BleCredit;                         /**< Command status posted to give back a credit */
+  uint32_t SysCmd;
+  uint32_t OtCmd;                             /**< Thread OT and Zigbee application commands */
+  uint32_t CliCmd;
+  uint32_t AclData;
+  uint64_t AclBytes;
+  uint32_t EvtReturned;                       /**< Buffers sent back by the CPU1 */
+  uint32_t FreeBufDoorbells;                  /**< IPCC notifications used to send them back */
+  uint32_t FreeBufEmpty;                      /**< IPCC notifications without buffer */
+  uint32_t EvtOutstanding;                    /**< Buffers of the pools held by the CPU1 */
+  uint32_t EvtStalls;                         /**< Packets delayed as the pools were empty */
+  uint32_t RxIrq;                             /**< CPU1 interrupts */
+  uint32_t TxIrq;
+  uint32_t Errors;                            /**< Protocol errors seen by the CPU2 */
+  const char *FirstError;
+} HW_IPCC_SIM_Stats_t;
+
+/* Exported functions ------------------------------------------------------- */
+/**
+ * @brief  Set the behavior of the CPU2. It may be changed at any time.
+ *         The default is an immediate command complete with one credit.
+ */
+void HW_IPCC_SIM_Config( const HW_IPCC_SIM_Config_t *p_config );
+
+/**
+ * @brief  Start posting packets on a stream. The packets not yet posted on this stream are discarded.
+ */
+void HW_IPCC_SIM_Post( HW_IPCC_SIM_StreamId_t stream, const HW_IPCC_SIM_Stream_t *p_stream );
+
+/**
+ * @brief  Stop the CPU2 and reset the IPCC. HW_IPCC_Enable() boots the CPU2 again.
+ */
+void HW_IPCC_SIM_Stop( void );
+
+/**
+ * @brief  Wait for an interrupt of the CPU1 (__WFI()) and run the handlers of all the pending ones
+ * @param  timeout_us: Maximum waiting time
+ * @retval 0 when no interrupt has been received
+ */
+uint32_t HW_IPCC_SIM_WaitForInterrupt( uint32_t timeout_us );
+
+/**
+ * @brief  Return 1 when all the packets of the streams are posted, the commands answered, the buffers
+ *         sent back by the CPU1 and no notification is waiting for the CPU1
+ */
+uint32_t HW_IPCC_SIM_Idle( void );
+
+void HW_IPCC_SIM_GetStats( HW_IPCC_SIM_Stats_t *p_stats );
+
+/**
+ * @brief  Monotonic time of the host
+ */
+uint64_t HW_IPCC_SIM_TimeNs( void );
+
+/**
+ * @brief  Read the stamp of a packet posted by the CPU2
+ * @retval Time from the post to now
+ */
+uint64_t HW_IPCC_SIM_ReadStamp( const uint8_t *p_payload, uint32_t *p_seq );
+
+/**
+ * @brief  PRIMASK of the CPU1. The pending interrupts are handled when it is cleared.
+ */
+uint32_t HW_IPCC_SIM_GetPrimask( void );
+void HW_IPCC_SIM_SetPrimask( uint32_t primask );
+
+#endif /* __HW_IPCC_SIM_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,1160 @@
+/**
+  ******************************************************************************
+  * @file    tl_test.c
+  * @author  MCD Application Team
+  * @brief   Host test of the transport layer (tl_mbox.c, hci_tl.c, shci_tl.c)
+  *          on the IPCC backend of hw_ipcc_sim.c: boot, system and BLE
+  *          commands (synchronous, asynchronous, in place, without credit),
+  *          event streams with flow control, ACL data, Thread and Zigbee
+  *          commands and notifications, and protocol errors.
+  *          make test : scenarios, with the default transport layer
+  *                      configuration and with batched event releases
+  *          make bench: events, commands, ACL data and notifications per
+  *                      second, and latency of the events
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+ */
+
+#include <stdbool.h>
+#include "ble_common.h"
+#include "ble_const.h"
+
+#include "stm_list.h"
+#include "tl.h"
+#include "hci_tl.h"
+#include "shci_tl.h"
+#include "hw_ipcc_sim.h"
+
+/* Same defaults as hci_tl.c and tl_mbox.c */
+#ifndef CFG_TLBLE_EVT_DRAIN_MAX_NBR
+#define CFG_TLBLE_EVT_DRAIN_MAX_NBR         (1)
+#endif
+#ifndef CFG_TLBLE_ASYNC_CMD_QUEUE_LENGTH
+#define CFG_TLBLE_ASYNC_CMD_QUEUE_LENGTH    (4)
+#endif
+#ifndef CFG_TL_MM_EVT_RELEASE_HWM
+#define CFG_TL_MM_EVT_RELEASE_HWM           (1)
+#endif
+
+#define TEST_EVT_BUFFER_SIZE                (DIVC(sizeof(TL_PacketHeader_t) + TL_EVT_HDR_SIZE + 255U, 8U) * 8U)
+#define TEST_EVT_BUFFER_NBR                 (20U)   /* CFG_TLBLE_EVT_QUEUE_LENGTH * 4 of the applications */
+#define TEST_TRACES_BUFFER_NBR              (4U)
+#define TEST_SLOT_NBR                       (TEST_EVT_BUFFER_NBR + TEST_TRACES_BUFFER_NBR)
+#define TEST_ASYNC_NBR                      (CFG_TLBLE_ASYNC_CMD_QUEUE_LENGTH + 2U)
+#define TEST_TIMEOUT_MS                     (10000U)
+#define TEST_WFI_US                         (1000U)
+#define TEST_SYS_OPCODE                     (0xFC55U)
+
+/* Buffers shared with the CPU2. They are all static: the lists of stm_list.c
+ * store the pointers on 32 bits and the test is linked without PIE. They are
+ * aligned for the 64 bits pointers of the list nodes of the host */
+PLACE_IN_SECTION("MB_MEM2") ALIGN(8) static uint8_t test_evt_pool[TEST_EVT_BUFFER_NBR * TEST_EVT_BUFFER_SIZE];
+PLACE_IN_SECTION("MB_MEM2") ALIGN(8) static uint8_t test_traces_pool[TEST_TRACES_BUFFER_NBR * TEST_EVT_BUFFER_SIZE];
+PLACE_IN_SECTION("MB_MEM2") ALIGN(8) static uint8_t test_sys_spare_buffer[TEST_EVT_BUFFER_SIZE];
+PLACE_IN_SECTION("MB_MEM2") ALIGN(8) static uint8_t test_ble_spare_buffer[TEST_EVT_BUFFER_SIZE];
+PLACE_IN_SECTION("MB_MEM2") ALIGN(8) static TL_CmdPacket_t test_sys_cmd_buffer;
+PLACE_IN_SECTION("MB_MEM2") ALIGN(8) static TL_CmdPacket_t test_ble_cmd_buffer;
+PLACE_IN_SECTION("MB_MEM2") ALIGN(8) static uint8_t test_acl_buffer[sizeof(TL_PacketHeader_t) + 5U + 251U];
+PLACE_IN_SECTION("MB_MEM2") ALIGN(8) static TL_CmdPacket_t test_ot_cmd_buffer;
+PLACE_IN_SECTION("MB_MEM2") ALIGN(8) static TL_CmdPacket_t test_cli_buffer;
+PLACE_IN_SECTION("MB_MEM2") ALIGN(8) static TL_CmdPacket_t test_not_buffer;
+PLACE_IN_SECTION("MB_MEM2") ALIGN(8) static TL_CmdPacket_t test_zb_cmd_buffer;
+PLACE_IN_SECTION("MB_MEM2") ALIGN(8) static TL_CmdPacket_t test_zb_not_buffer;
+PLACE_IN_SECTION("MB_MEM2") ALIGN(8) static TL_CmdPacket_t test_zb_log_buffer;
+
+/* Asynchronous commands, queued in the lists of hci_tl.c */
+static HCI_TL_AsyncCmd_t test_async[TEST_ASYNC_NBR];
+static struct hci_request test_async_req[TEST_ASYNC_NBR];
+static uint8_t test_async_cparam[TEST_ASYNC_NBR][4];
+static uint8_t test_async_rparam[TEST_ASYNC_NBR][8];
+static uint32_t test_async_submitted, test_async_done, test_async_target;
+static uint32_t test_async_order[TEST_ASYNC_NBR];
+static bool test_async_cs;
+
+/* Packets received on each stream of hw_ipcc_sim.h */
+static const uint8_t test_stream_type[HW_IPCC_SIM_STREAM_NBR] = {
+  TL_BLEEVT_PKT_TYPE, TL_SYSEVT_PKT_TYPE, TL_TRACES_WL_PKT_TYPE, TL_OTNOT_PKT_TYPE, TL_CLINOT_PKT_TYPE,
+  TL_OTNOT_PKT_TYPE, TL_OTNOT_PKT_TYPE };
+static const char * const test_stream_name[HW_IPCC_SIM_STREAM_NBR] = {
+  "BLE events", "system events", "traces", "Thread notifications", "Thread CLI notifications",
+  "Zigbee notifications", "Zigbee logging" };
+static uint8_t test_stream_len[HW_IPCC_SIM_STREAM_NBR];
+static uint32_t test_rx[HW_IPCC_SIM_STREAM_NBR];
+static uint64_t test_latency_sum[HW_IPCC_SIM_STREAM_NBR];
+static uint64_t test_latency_max[HW_IPCC_SIM_STREAM_NBR];
+static uint32_t test_ack_pending;
+static uint32_t test_not_overwritten;
+
+/* Application context */
+static const char *test_scenario;
+static bool test_hci_resp, test_shci_resp, test_hci_evt, test_shci_evt;
+static bool test_sys_ready, test_ot_rsp, test_zb_rsp, test_acl_ack;
+static uint32_t test_flow_disable_seq = UINT32_MAX;
+static uint32_t test_evt_per_call, test_evt_per_call_max;
+static uint32_t test_sim_errors;
+static uint8_t test_sys_rsp[sizeof(TL_PacketHeader_t) + TL_EVT_HDR_SIZE + 255U];
+
+static void test_fail(const char *msg, unsigned long arg)
+{
+  printf("FAIL: %s (%lu), %s\n", msg, arg, test_scenario);
+  exit(1);
+}
+
+static uint64_t test_deadline(uint32_t timeout_ms)
+{
+  return HW_IPCC_SIM_TimeNs() + (MIN(timeout_ms, TEST_TIMEOUT_MS) * 1000000ULL);
+}
+
+static void test_wfi(uint64_t deadline_ns, const char *what)
+{
+  if ((HW_IPCC_SIM_WaitForInterrupt(TEST_WFI_US) == 0U) && (HW_IPCC_SIM_TimeNs() > deadline_ns))
+  {
+    test_fail(what, 0U);
+  }
+}
+
+static void test_check_sim(void)
+{
+  HW_IPCC_SIM_Stats_t stats;
+
+  HW_IPCC_SIM_GetStats(&stats);
+  if (stats.Errors != test_sim_errors)
+  {
+    printf("CPU2: %s\n", stats.FirstError);
+    test_fail("protocol error", stats.Errors);
+  }
+}
+
+/* Check the packet of a stream, posted by the CPU2 with the sequence number,
+ * the time and a filler depending on the sequence number */
+static void test_check_packet(HW_IPCC_SIM_StreamId_t stream, TL_EvtPacket_t *p_evt)
+{
+  uint64_t latency;
+  uint32_t seq;
+  uint32_t i;
+  const uint8_t *p_payload = p_evt->evtserial.evt.payload;
+
+  /* TL_THREAD_CliSendAck() writes the ack in the buffer of the Thread notifications:
+   * one posted just before is read with this type */
+  if ((stream == HW_IPCC_SIM_THREAD_NOT) && (p_evt->evtserial.type == TL_OTACK_PKT_TYPE))
+  {
+    test_not_overwritten++;
+  }
+  else if (p_evt->evtserial.type != test_stream_type[stream])
+  {
+    test_fail(test_stream_name[stream], p_evt->evtserial.type);
+  }
+  if ((p_evt->evtserial.evt.evtcode != 0xFFU) || (p_evt->evtserial.evt.plen != test_stream_len[stream]))
+  {
+    test_fail("packet length", p_evt->evtserial.evt.plen);
+  }
+  latency = HW_IPCC_SIM_ReadStamp(p_payload, &seq);
+  if (seq != test_rx[stream])
+  {
+    test_fail("packet lost or out of order", seq);
+  }
+  for (i = HW_IPCC_SIM_STAMP_SIZE; i < test_stream_len[stream]; i++)
+  {
+    if (p_payload[i] != (uint8_t)(seq + i))
+    {
+      test_fail("packet content", i);
+    }
+  }
+  test_rx[stream]++;
+  test_latency_sum[stream] += latency;
+  test_latency_max[stream] = MAX(test_latency_max[stream], latency);
+}
+
+static void test_post(HW_IPCC_SIM_StreamId_t stream, uint32_t count, uint32_t period_us, uint8_t len)
+{
+  HW_IPCC_SIM_Stream_t cfg = { count, period_us, len };
+
+  test_stream_len[stream] = MAX(len, HW_IPCC_SIM_STAMP_SIZE);
+  test_rx[stream] = 0U;
+  test_latency_sum[stream] = 0U;
+  test_latency_max[stream] = 0U;
+  HW_IPCC_SIM_Post(stream, &cfg);
+}
+
+static void test_config(uint32_t cmd_delay_us, HW_IPCC_SIM_BleRsp_t rsp, uint8_t numcmd, uint32_t credit_delay_us)
+{
+  HW_IPCC_SIM_Config_t cfg = { cmd_delay_us, 0U, rsp, numcmd, credit_delay_us, 0U };
+
+  HW_IPCC_SIM_Config(&cfg);
+}
+
+/******************************************************************************
+ * Application hooks of the transport layer
+ ******************************************************************************/
+void hci_notify_asynch_evt(void* pdata)
+{
+  (void)pdata;
+  test_hci_evt = true;
+}
+
+void hci_cmd_resp_release(uint32_t flag)
+{
+  (void)flag;
+  test_hci_resp = true;
+}
+
+void hci_cmd_resp_wait(uint32_t timeout)
+{
+  uint64_t deadline = test_deadline(timeout);
+
+  while (!test_hci_resp)
+  {
+    test_wfi(deadline, "no BLE command response");
+  }
+  test_hci_resp = false;
+}
+
+uint32_t hci_get_timestamp_us(void)
+{
+  return (uint32_t)(HW_IPCC_SIM_TimeNs() / 1000U);
+}
+
+void shci_notify_asynch_evt(void* pdata)
+{
+  (void)pdata;
+  test_shci_evt = true;
+}
+
+void shci_cmd_resp_release(uint32_t flag)
+{
+  (void)flag;
+  test_shci_resp = true;
+}
+
+void shci_cmd_resp_wait(uint32_t timeout)
+{
+  uint64_t deadline = test_deadline(timeout);
+
+  while (!test_shci_resp)
+  {
+    test_wfi(deadline, "no system command response");
+  }
+  test_shci_resp = false;
+}
+
+static void test_shci_status(SHCI_TL_CmdStatus_t status)
+{
+  (void)status;
+}
+
+static void test_sys_user_evt(void *p_data)
+{
+  TL_EvtPacket_t *p_evt = ((tSHCI_UserEvtRxParam *)p_data)->pckt;
+  TL_AsynchEvt_t *p_asynch = (TL_AsynchEvt_t *)p_evt->evtserial.evt.payload;
+
+  if ((p_evt->evtserial.evt.plen == 3U) && (p_asynch->subevtcode == HW_IPCC_SIM_SYS_READY_SUBEVT))
+  {
+    if (test_sys_ready)
+    {
+      test_fail("second ready event", 0U);
+    }
+    test_sys_ready = true;
+  }
+  else
+  {
+    test_check_packet(HW_IPCC_SIM_SYS_EVT, p_evt);
+  }
+}
+
+static void test_ble_user_evt(void *p_data)
+{
+  tHCI_UserEvtRxParam *p_param = (tHCI_UserEvtRxParam *)p_data;
+
+  /* The event put back in the queue is reported again */
+  if (test_rx[HW_IPCC_SIM_BLE_EVT] == test_flow_disable_seq)
+  {
+    test_flow_disable_seq = UINT32_MAX;
+    p_param->status = HCI_TL_UserEventFlow_Disable;
+    return;
+  }
+  test_check_packet(HW_IPCC_SIM_BLE_EVT, p_param->pckt);
+  test_evt_per_call++;
+}
+
+/* Events received by an application using TL_BLE_Init() without hci_tl.c */
+static void test_tm_evt(TL_EvtPacket_t *p_evt)
+{
+  test_check_packet(HW_IPCC_SIM_BLE_EVT, p_evt);
+  TL_MM_EvtDone(p_evt);
+}
+
+static void test_tm_acl_ack(void)
+{
+  test_acl_ack = true;
+}
+
+void TL_TRACES_EvtReceived(TL_EvtPacket_t *hcievt)
+{
+  test_check_packet(HW_IPCC_SIM_TRACES, hcievt);
+  TL_MM_EvtDone(hcievt);
+}
+
+void TL_OT_CmdEvtReceived(TL_EvtPacket_t *Otbuffer)
+{
+  if (Otbuffer->evtserial.type != TL_OTRSP_PKT_TYPE)
+  {
+    test_fail("Thread response packet type", Otbuffer->evtserial.type);
+  }
+  test_ot_rsp = true;
+}
+
+/* The notifications are acknowledged from the background, as the applications do */
+void TL_THREAD_NotReceived(TL_EvtPacket_t *Notbuffer)
+{
+  test_check_packet(HW_IPCC_SIM_THREAD_NOT, Notbuffer);
+  test_ack_pending |= 1U << HW_IPCC_SIM_THREAD_NOT;
+}
+
+void TL_THREAD_CliNotReceived(TL_EvtPacket_t *Notbuffer)
+{
+  test_check_packet(HW_IPCC_SIM_THREAD_CLI_NOT, Notbuffer);
+  test_ack_pending |= 1U << HW_IPCC_SIM_THREAD_CLI_NOT;
+}
+
+void TL_ZIGBEE_CmdEvtReceived(TL_EvtPacket_t *Otbuffer)
+{
+  if (Otbuffer->evtserial.type != TL_OTRSP_PKT_TYPE)
+  {
+    test_fail("Zigbee response packet type", Otbuffer->evtserial.type);
+  }
+  test_zb_rsp = true;
+}
+
+void TL_ZIGBEE_NotReceived(TL_EvtPacket_t *Notbuffer)
+{
+  test_check_packet(HW_IPCC_SIM_ZIGBEE_NOT, Notbuffer);
+  test_ack_pending |= 1U << HW_IPCC_SIM_ZIGBEE_NOT;
+}
+
+void TL_ZIGBEE_LoggingReceived(TL_EvtPacket_t *Otbuffer)
+{
+  test_check_packet(HW_IPCC_SIM_ZIGBEE_LOG, Otbuffer);
+  test_ack_pending |= 1U << HW_IPCC_SIM_ZIGBEE_LOG;
+}
+
+/******************************************************************************
+ * Background of the application
+ ******************************************************************************/
+static void test_poll(void)
+{
+  uint32_t acks;
+
+  if (test_hci_evt)
+  {
+    test_hci_evt = false;
+    test_evt_per_call = 0U;
+    hci_user_evt_proc();
+    if (test_evt_per_call > CFG_TLBLE_EVT_DRAIN_MAX_NBR)
+    {
+      test_fail("events reported on one call", test_evt_per_call);
+    }
+    test_evt_per_call_max = MAX(test_evt_per_call_max, test_evt_per_call);
+  }
+  if (test_shci_evt)
+  {
+    test_shci_evt = false;
+    shci_user_evt_proc();
+  }
+
+  acks = test_ack_pending;
+  test_ack_pending = 0U;
+  if (acks & (1U << HW_IPCC_SIM_THREAD_NOT))
+  {
+    TL_THREAD_SendAck();
+  }
+  if (acks & (1U << HW_IPCC_SIM_THREAD_CLI_NOT))
+  {
+    TL_THREAD_CliSendAck();
+  }
+  if (acks & (1U << HW_IPCC_SIM_ZIGBEE_NOT))
+  {
+    TL_ZIGBEE_SendAckAfterAppliNotifFromM0();
+  }
+  if (acks & (1U << HW_IPCC_SIM_ZIGBEE_LOG))
+  {
+    TL_ZIGBEE_SendAckAfterAppliLoggingFromM0();
+  }
+
+  /* The system events and the traces are released with TL_MM_EvtDone(): with
+   * CFG_TL_MM_EVT_RELEASE_HWM, the last ones are sent back from the idle loop */
+  TL_MM_EvtFlush();
+}
+
+static void test_run(bool (*done)(void), const char *what)
+{
+  uint64_t deadline = test_deadline(TEST_TIMEOUT_MS);
+
+  for (;;)
+  {
+    test_poll();
+    if (done())
+    {
+      break;
+    }
+    test_wfi(deadline, what);
+  }
+  test_check_sim();
+}
+
+static bool test_idle(void)
+{
+  return !test_hci_evt && !test_shci_evt && (test_ack_pending == 0U) && (test_async_done == test_async_submitted)
+         && HW_IPCC_SIM_Idle();
+}
+
+static bool test_is_sys_ready(void)
+{
+  return test_sys_ready;
+}
+
+static bool test_is_ot_rsp(void)
+{
+  return test_ot_rsp;
+}
+
+static bool test_is_zb_rsp(void)
+{
+  return test_zb_rsp;
+}
+
+static bool test_is_async_done(void)
+{
+  return test_async_done == test_async_submitted;
+}
+
+static bool test_is_acl_ack(void)
+{
+  return test_acl_ack;
+}
+
+/* All the buffers of the pools are held by the CPU1 */
+static bool test_pools_held(void)
+{
+  TL_MM_Stats_t stats;
+
+  TL_MM_GetStats(&stats);
+  return stats.EvtOutstanding == TEST_SLOT_NBR;
+}
+
+static bool test_error_raised(void)
+{
+  HW_IPCC_SIM_Stats_t stats;
+
+  HW_IPCC_SIM_GetStats(&stats);
+  return stats.Errors == test_sim_errors;
+}
+
+/******************************************************************************
+ * Scenarios
+ ******************************************************************************/
+/* Same sequence as the applications: the BLE is initialized once the CPU2 is ready */
+static void test_boot(void)
+{
+  TL_MM_Config_t tl_mm_config;
+  SHCI_TL_HciInitConf_t shci_conf;
+  HCI_TL_HciInitConf_t hci_conf;
+
+  test_scenario = "boot";
+  test_sys_ready = false;
+  test_hci_resp = test_shci_resp = test_hci_evt = test_shci_evt = false;
+  test_ack_pending = 0U;
+  test_async_submitted = test_async_done = 0U;
+
+  TL_Init();
+
+  shci_conf.p_cmdbuffer = (uint8_t *)&test_sys_cmd_buffer;
+  shci_conf.StatusNotCallBack = test_shci_status;
+  shci_init(test_sys_user_evt, (void *)&shci_conf);
+
+  tl_mm_config.p_BleSpareEvtBuffer = test_ble_spare_buffer;
+  tl_mm_config.p_SystemSpareEvtBuffer = test_sys_spare_buffer;
+  tl_mm_config.p_AsynchEvtPool = test_evt_pool;
+  tl_mm_config.AsynchEvtPoolSize = sizeof(test_evt_pool);
+  tl_mm_config.p_TracesEvtPool = test_traces_pool;
+  tl_mm_config.TracesEvtPoolSize = sizeof(test_traces_pool);
+  TL_MM_Init(&tl_mm_config);
+
+  TL_TRACES_Init();
+
+  TL_Enable();
+
+  test_run(test_is_sys_ready, "no ready event");
+
+  hci_conf.p_cmdbuffer = (uint8_t *)&test_ble_cmd_buffer;
+  hci_conf.StatusNotCallBack = NULL;
+  hci_init(test_ble_user_evt, (void *)&hci_conf);
+}
+
+static void test_sys_cmd(uint32_t count)
+{
+  TL_EvtPacket_t *p_rsp = (TL_EvtPacket_t *)test_sys_rsp;
+  TL_CcEvt_t *p_cc = (TL_CcEvt_t *)p_rsp->evtserial.evt.payload;
+  uint8_t param[3];
+  uint32_t i;
+
+  test_scenario = "system commands";
+  for (i = 0U; i < count; i++)
+  {
+    param[0] = (uint8_t)i;
+    param[1] = (uint8_t)(i >> 8);
+    param[2] = 0xA5U;
+    memset(test_sys_rsp, 0xEE, sizeof(test_sys_rsp));
+    shci_send(TEST_SYS_OPCODE, sizeof(param), param, p_rsp);
+    if ((p_rsp->evtserial.type != TL_SYSRSP_PKT_TYPE) || (p_rsp->evtserial.evt.evtcode != TL_BLEEVT_CC_OPCODE)
+        || (p_rsp->evtserial.evt.plen != (TL_EVT_HDR_SIZE + 1U + sizeof(param))))
+    {
+      test_fail("system response header", p_rsp->evtserial.evt.plen);
+    }
+    if ((p_cc->cmdcode != TEST_SYS_OPCODE) || (p_cc->payload[0] != 0U) || (memcmp(&p_cc->payload[1], param, sizeof(param)) != 0))
+    {
+      test_fail("system response", i);
+    }
+  }
+  test_check_sim();
+}
+
+/* Synchronous command with hci_send_req() or built in place with hci_cmd_reserve() */
+static void test_ble_cmd(uint32_t index, bool in_place, bool cs)
+{
+  struct hci_request rq;
+  uint8_t cparam[4];
+  uint8_t rparam[8];
+  uint8_t *p_payload;
+
+  cparam[0] = (uint8_t)index;
+  cparam[1] = (uint8_t)(index >> 8);
+  cparam[2] = (uint8_t)~index;
+  cparam[3] = 0x5AU;
+  memset(rparam, 0xEE, sizeof(rparam));
+  memset(&rq, 0, sizeof(rq));
+  rq.ogf = 0x3FU;
+  rq.ocf = 0x123U;
+  rq.clen = sizeof(cparam);
+  rq.rparam = rparam;
+  rq.rlen = sizeof(rparam);
+  if (in_place)
+  {
+    p_payload = (uint8_t *)hci_cmd_reserve();
+    memcpy(p_payload, cparam, sizeof(cparam));
+    hci_cmd_commit(&rq);
+  }
+  else
+  {
+    rq.cparam = cparam;
+    hci_send_req(&rq, FALSE);
+  }
+
+  if (cs)
+  {
+    if (rparam[0] != 0U)
+    {
+      test_fail("command status", rparam[0]);
+    }
+  }
+  else if ((rq.rlen != (int)(1U + sizeof(cparam))) || (rparam[0] != 0U) || (memcmp(&rparam[1], cparam, sizeof(cparam)) != 0))
+  {
+    test_fail("command complete", index);
+  }
+}
+
+static void test_ble_sync(void)
+{
+  HW_IPCC_SIM_Stats_t stats;
+  uint64_t start;
+  uint32_t i;
+
+  test_scenario = "BLE commands, command complete";
+  test_config(0U, HW_IPCC_SIM_RSP_CC, 1U, 0U);
+  for (i = 0U; i < 200U; i++)
+  {
+    test_ble_cmd(i, (i & 1U) != 0U, false);
+  }
+
+  test_scenario = "BLE commands, command status";
+  test_config(50U, HW_IPCC_SIM_RSP_CS, 1U, 0U);
+  for (i = 0U; i < 50U; i++)
+  {
+    test_ble_cmd(i, (i & 1U) != 0U, true);
+  }
+
+  /* The command completes when the credit is given back */
+  test_scenario = "BLE commands, credit given back later";
+  HW_IPCC_SIM_GetStats(&stats);
+  test_config(0U, HW_IPCC_SIM_RSP_CC, 0U, 2000U);
+  for (i = 0U; i < 5U; i++)
+  {
+    start = HW_IPCC_SIM_TimeNs();
+    test_ble_cmd(i, false, false);
+    if ((HW_IPCC_SIM_TimeNs() - start) < 2000000U)
+    {
+      test_fail("command completed without credit", i);
+    }
+  }
+  i = stats.BleCredit;
+  HW_IPCC_SIM_GetStats(&stats);
+  if ((stats.BleCredit - i) != 5U)
+  {
+    test_fail("credits given back", stats.BleCredit - i);
+  }
+
+  /* A cancelled command does not reach the CPU2 */
+  test_scenario = "BLE command cancelled";
+  test_config(0U, HW_IPCC_SIM_RSP_CC, 1U, 0U);
+  i = stats.BleCmd;
+  (void)hci_cmd_reserve();
+  hci_cmd_cancel();
+  test_ble_cmd(0U, true, false);
+  HW_IPCC_SIM_GetStats(&stats);
+  if ((stats.BleCmd - i) != 1U)
+  {
+    test_fail("commands sent", stats.BleCmd - i);
+  }
+  test_run(test_idle, "BLE commands not completed");
+}
+
+static void test_async_cb(HCI_TL_AsyncCmd_t *p_async_cmd)
+{
+  uint32_t index = (uint32_t)(p_async_cmd - test_async);
+  uint8_t *p_rparam = test_async_rparam[index];
+
+  if ((p_rparam[0] != 0U) || (!test_async_cs && (memcmp(&p_rparam[1], test_async_cparam[index], 4U) != 0)))
+  {
+    test_fail("asynchronous command complete", index);
+  }
+  test_async_order[test_async_done++] = index;
+}
+
+static int test_async_submit(uint32_t index, void (*cb)(HCI_TL_AsyncCmd_t *p_async_cmd))
+{
+  HCI_TL_AsyncCmd_t *p_async = &test_async[index];
+  struct hci_request *p_rq = &test_async_req[index];
+  int ret;
+
+  test_async_cparam[index][0] = (uint8_t)index;
+  test_async_cparam[index][1] = (uint8_t)test_async_submitted;
+  test_async_cparam[index][2] = 0xC3U;
+  test_async_cparam[index][3] = (uint8_t)~index;
+  memset(test_async_rparam[index], 0xEE, sizeof(test_async_rparam[index]));
+  memset(p_rq, 0, sizeof(*p_rq));
+  p_rq->ogf = 0x3FU;
+  p_rq->ocf = 0x123U;
+  p_rq->cparam = test_async_cparam[index];
+  p_rq->clen = 4;
+  p_rq->rparam = test_async_rparam[index];
+  p_rq->rlen = sizeof(test_async_rparam[index]);
+  p_async->p_cmd = p_rq;
+  p_async->CmdRespCallBack = cb;
+  p_async->p_context = NULL;
+
+  ret = hci_send_req_async(p_async);
+  if (ret == 0)
+  {
+    test_async_submitted++;
+  }
+  return ret;
+}
+
+/* Asynchronous commands completed in the submission order */
+static void test_async_check(uint32_t count)
+{
+  uint32_t i;
+
+  if (test_async_done != count)
+  {
+    test_fail("asynchronous commands completed", test_async_done);
+  }
+  for (i = 0U; i < count; i++)
+  {
+    if (test_async_order[i] != i)
+    {
+      test_fail("asynchronous command order", i);
+    }
+  }
+}
+
+static void test_ble_async(void)
+{
+  HW_IPCC_SIM_Stats_t stats;
+  uint32_t accepted;
+  uint32_t i;
+
+  /* One command in flight and CFG_TLBLE_ASYNC_CMD_QUEUE_LENGTH waiting */
+  test_scenario = "BLE asynchronous commands";
+  test_config(2000U, HW_IPCC_SIM_RSP_CC, 1U, 0U);
+  test_async_submitted = test_async_done = 0U;
+  accepted = 0U;
+  for (i = 0U; i < TEST_ASYNC_NBR; i++)
+  {
+    if (test_async_submit(i, test_async_cb) == 0)
+    {
+      accepted++;
+    }
+  }
+  if (accepted != (CFG_TLBLE_ASYNC_CMD_QUEUE_LENGTH + 1U))
+  {
+    test_fail("asynchronous commands accepted", accepted);
+  }
+  test_run(test_idle, "asynchronous commands not completed");
+  test_async_check(accepted);
+
+  /* A synchronous command waits for the command in flight, the queued ones
+   * are sent once it has completed */
+  test_scenario = "BLE synchronous command between asynchronous ones";
+  test_async_submitted = test_async_done = 0U;
+  for (i = 0U; i < 3U; i++)
+  {
+    (void)test_async_submit(i, test_async_cb);
+  }
+  test_ble_cmd(7U, true, false);
+  if (test_async_done != 0U)
+  {
+    test_fail("asynchronous command reported before the background", test_async_done);
+  }
+  test_run(test_idle, "asynchronous commands not resumed");
+  test_async_check(3U);
+
+  /* The asynchronous commands wait for the credits */
+  test_scenario = "BLE asynchronous commands, credit given back later";
+  HW_IPCC_SIM_GetStats(&stats);
+  accepted = stats.BleCredit;
+  test_config(0U, HW_IPCC_SIM_RSP_CC, 0U, 500U);
+  test_async_submitted = test_async_done = 0U;
+  for (i = 0U; i < 4U; i++)
+  {
+    (void)test_async_submit(i, test_async_cb);
+  }
+  test_run(test_idle, "asynchronous commands without credit");
+  test_async_check(4U);
+  HW_IPCC_SIM_GetStats(&stats);
+  if ((stats.BleCredit - accepted) != 4U)
+  {
+    test_fail("credits given back", stats.BleCredit - accepted);
+  }
+
+  test_scenario = "BLE asynchronous commands, command status";
+  test_config(0U, HW_IPCC_SIM_RSP_CS, 1U, 0U);
+  test_async_cs = true;
+  test_async_submitted = test_async_done = 0U;
+  for (i = 0U; i < 4U; i++)
+  {
+    (void)test_async_submit(i, test_async_cb);
+  }
+  test_run(test_idle, "asynchronous commands not completed");
+  test_async_check(4U);
+  test_async_cs = false;
+  test_config(0U, HW_IPCC_SIM_RSP_CC, 1U, 0U);
+}
+
+/* Events of each stream received in order and all the buffers given back */
+static void test_streams(uint32_t ble, uint32_t sys, uint32_t traces, uint32_t period_us, uint8_t len)
+{
+  TL_MM_Stats_t mm_before, mm;
+  HW_IPCC_SIM_Stats_t before, stats;
+
+  TL_MM_GetStats(&mm_before);
+  HW_IPCC_SIM_GetStats(&before);
+
+  test_post(HW_IPCC_SIM_BLE_EVT, ble, period_us, len);
+  test_post(HW_IPCC_SIM_SYS_EVT, sys, period_us, len);
+  test_post(HW_IPCC_SIM_TRACES, traces, period_us, len);
+  test_run(test_idle, "events not received");
+
+  if ((test_rx[HW_IPCC_SIM_BLE_EVT] != ble) || (test_rx[HW_IPCC_SIM_SYS_EVT] != sys)
+      || (test_rx[HW_IPCC_SIM_TRACES] != traces))
+  {
+    test_fail("events received", test_rx[HW_IPCC_SIM_BLE_EVT]);
+  }
+  TL_MM_GetStats(&mm);
+  HW_IPCC_SIM_GetStats(&stats);
+  if ((mm.EvtOutstanding != 0U) || ((mm.EvtReleased - mm_before.EvtReleased) != (ble + sys + traces))
+      || ((stats.EvtReturned - before.EvtReturned) != (ble + sys + traces)))
+  {
+    test_fail("buffers given back", stats.EvtReturned - before.EvtReturned);
+  }
+  if ((mm.Doorbells - mm_before.Doorbells) != (stats.FreeBufDoorbells - before.FreeBufDoorbells))
+  {
+    test_fail("memory manager doorbells", mm.Doorbells - mm_before.Doorbells);
+  }
+}
+
+static void test_events(void)
+{
+  test_scenario = "BLE events, 16 bytes";
+  test_streams(2000U, 0U, 0U, 0U, 16U);
+  test_scenario = "BLE events, 255 bytes, every 20 us";
+  test_streams(500U, 0U, 0U, 20U, 255U);
+  test_scenario = "system events";
+  test_streams(0U, 300U, 0U, 0U, 40U);
+  test_scenario = "traces";
+  test_streams(0U, 0U, 300U, 0U, 100U);
+  test_scenario = "BLE, system events and traces";
+  test_streams(1000U, 300U, 300U, 0U, 64U);
+}
+
+/* Events and commands at the same time */
+static void test_interleaved(void)
+{
+  uint32_t i;
+
+  test_scenario = "events and commands";
+  test_config(20U, HW_IPCC_SIM_RSP_CC, 1U, 0U);
+  test_post(HW_IPCC_SIM_BLE_EVT, 3000U, 5U, 32U);
+  test_post(HW_IPCC_SIM_SYS_EVT, 500U, 30U, 20U);
+  test_post(HW_IPCC_SIM_TRACES, 500U, 30U, 200U);
+  test_async_submitted = test_async_done = 0U;
+  for (i = 0U; i < 100U; i++)
+  {
+    test_ble_cmd(i, (i % 3U) == 0U, false);
+    if ((i % 10U) == 0U)
+    {
+      test_sys_cmd(1U);
+      test_scenario = "events and commands";
+    }
+    if ((i % 20U) == 0U)
+    {
+      test_async_submitted = test_async_done = 0U;
+      (void)test_async_submit(0U, test_async_cb);
+      (void)test_async_submit(1U, test_async_cb);
+      test_run(test_is_async_done, "asynchronous commands among events");
+      test_async_check(2U);
+    }
+    test_poll();
+  }
+  test_run(test_idle, "events among commands");
+  if ((test_rx[HW_IPCC_SIM_SYS_EVT] != 500U) || (test_rx[HW_IPCC_SIM_TRACES] != 500U)
+      || (test_rx[HW_IPCC_SIM_BLE_EVT] != 3000U))
+  {
+    test_fail("events received among commands", test_rx[HW_IPCC_SIM_BLE_EVT]);
+  }
+  test_config(0U, HW_IPCC_SIM_RSP_CC, 1U, 0U);
+}
+
+/* The events stay in the queue while the flow is disabled. When it is
+ * resumed, up to CFG_TLBLE_EVT_DRAIN_MAX_NBR events are reported on each call */
+static void test_flow(void)
+{
+  TL_MM_Stats_t mm;
+  uint32_t i;
+
+  test_scenario = "BLE event flow";
+  TL_MM_ResetStats();
+  test_flow_disable_seq = 10U;
+  test_post(HW_IPCC_SIM_BLE_EVT, 200U, 0U, 24U);
+  test_run(test_pools_held, "pools not exhausted while the flow is disabled");
+  for (i = 0U; i < 20U; i++)
+  {
+    test_poll();
+    (void)HW_IPCC_SIM_WaitForInterrupt(TEST_WFI_US);
+  }
+  if (test_rx[HW_IPCC_SIM_BLE_EVT] != 10U)
+  {
+    test_fail("event reported while the flow is disabled", test_rx[HW_IPCC_SIM_BLE_EVT]);
+  }
+
+  test_evt_per_call_max = 0U;
+  hci_resume_flow();
+  test_run(test_idle, "events not received after the flow is resumed");
+  if (test_rx[HW_IPCC_SIM_BLE_EVT] != 200U)
+  {
+    test_fail("events received", test_rx[HW_IPCC_SIM_BLE_EVT]);
+  }
+  if (test_evt_per_call_max != MIN(CFG_TLBLE_EVT_DRAIN_MAX_NBR, TEST_SLOT_NBR))
+  {
+    test_fail("events reported on one call", test_evt_per_call_max);
+  }
+  TL_MM_GetStats(&mm);
+  if ((mm.EvtOutstandingPeak != TEST_SLOT_NBR) || (mm.MaxReleasesPerDoorbell < MIN(CFG_TLBLE_EVT_DRAIN_MAX_NBR, TEST_SLOT_NBR)))
+  {
+    test_fail("memory manager statistics", mm.MaxReleasesPerDoorbell);
+  }
+}
+
+/* ACL data of an application using TL_BLE_Init() directly (transparent mode) */
+static void test_acl(uint32_t count)
+{
+  TL_BLE_InitConf_t conf;
+  TL_AclDataPacket_t *p_acl = (TL_AclDataPacket_t *)test_acl_buffer;
+  HW_IPCC_SIM_Stats_t before, stats;
+  HCI_TL_HciInitConf_t hci_conf;
+  uint32_t i;
+  uint64_t bytes;
+
+  test_scenario = "ACL data";
+  conf.p_cmdbuffer = (uint8_t *)&test_ble_cmd_buffer;
+  conf.p_AclDataBuffer = test_acl_buffer;
+  conf.IoBusEvtCallBack = test_tm_evt;
+  conf.IoBusAclDataTxAck = test_tm_acl_ack;
+  TL_BLE_Init(&conf);
+
+  HW_IPCC_SIM_GetStats(&before);
+  test_post(HW_IPCC_SIM_BLE_EVT, count / 4U, 10U, 27U);
+  bytes = 0U;
+  for (i = 0U; i < count; i++)
+  {
+    p_acl->AclDataSerial.handle = 0x0801U;
+    p_acl->AclDataSerial.length = (uint16_t)(1U + (i % 251U));
+    memset(p_acl->AclDataSerial.acl_data, (int)i, p_acl->AclDataSerial.length);
+    bytes += p_acl->AclDataSerial.length;
+    test_acl_ack = false;
+    TL_BLE_SendAclData(NULL, 0U);
+    test_run(test_is_acl_ack, "no ACL data ack");
+  }
+  test_run(test_idle, "events among ACL data");
+  HW_IPCC_SIM_GetStats(&stats);
+  if (((stats.AclData - before.AclData) != count) || ((stats.AclBytes - before.AclBytes) != bytes)
+      || (test_rx[HW_IPCC_SIM_BLE_EVT] != (count / 4U)))
+  {
+    test_fail("ACL data sent", stats.AclData - before.AclData);
+  }
+
+  hci_conf.p_cmdbuffer = (uint8_t *)&test_ble_cmd_buffer;
+  hci_conf.StatusNotCallBack = NULL;
+  hci_init(test_ble_user_evt, (void *)&hci_conf);
+}
+
+static void test_thread(void)
+{
+  TL_TH_Config_t conf;
+  HW_IPCC_SIM_Stats_t before, stats;
+  uint32_t i;
+
+  test_scenario = "Thread";
+  conf.p_ThreadOtCmdRspBuffer = (uint8_t *)&test_ot_cmd_buffer;
+  conf.p_ThreadCliRspBuffer = (uint8_t *)&test_cli_buffer;
+  conf.p_ThreadNotAckBuffer = (uint8_t *)&test_not_buffer;
+  TL_THREAD_Init(&conf);
+
+  HW_IPCC_SIM_GetStats(&before);
+  test_config(10U, HW_IPCC_SIM_RSP_CC, 1U, 0U);
+  for (i = 0U; i < 100U; i++)
+  {
+    test_ot_rsp = false;
+    test_ot_cmd_buffer.cmdserial.cmd.cmdcode = (uint16_t)i;
+    TL_OT_SendCmd();
+    test_run(test_is_ot_rsp, "no Thread response");
+  }
+  for (i = 0U; i < 10U; i++)
+  {
+    test_cli_buffer.cmdserial.cmd.plen = 4U;
+    memcpy(test_cli_buffer.cmdserial.cmd.payload, "help", 4U);
+    TL_CLI_SendCmd();
+    test_run(test_idle, "CLI command not read");
+  }
+
+  test_post(HW_IPCC_SIM_THREAD_NOT, 500U, 0U, 100U);
+  test_post(HW_IPCC_SIM_THREAD_CLI_NOT, 100U, 10U, 60U);
+  test_post(HW_IPCC_SIM_BLE_EVT, 500U, 0U, 20U);
+  for (i = 0U; i < 20U; i++)
+  {
+    test_ot_rsp = false;
+    TL_OT_SendCmd();
+    test_run(test_is_ot_rsp, "no Thread response among notifications");
+  }
+  test_run(test_idle, "Thread notifications not received");
+  HW_IPCC_SIM_GetStats(&stats);
+  if ((test_rx[HW_IPCC_SIM_THREAD_NOT] != 500U) || (test_rx[HW_IPCC_SIM_THREAD_CLI_NOT] != 100U)
+      || (test_rx[HW_IPCC_SIM_BLE_EVT] != 500U) || ((stats.OtCmd - before.OtCmd) != 120U)
+      || ((stats.CliCmd - before.CliCmd) != 10U))
+  {
+    test_fail("Thread packets", test_rx[HW_IPCC_SIM_THREAD_NOT]);
+  }
+  test_config(0U, HW_IPCC_SIM_RSP_CC, 1U, 0U);
+}
+
+static void test_zigbee(void)
+{
+  TL_ZIGBEE_Config_t conf;
+  uint32_t i;
+
+  test_scenario = "Zigbee";
+  conf.p_ZigbeeOtCmdRspBuffer = (uint8_t *)&test_zb_cmd_buffer;
+  conf.p_ZigbeeNotAckBuffer = (uint8_t *)&test_zb_not_buffer;
+  conf.p_ZigbeeLoggingBuffer = (uint8_t *)&test_zb_log_buffer;
+  TL_ZIGBEE_Init(&conf);
+
+  test_post(HW_IPCC_SIM_ZIGBEE_NOT, 400U, 0U, 80U);
+  test_post(HW_IPCC_SIM_ZIGBEE_LOG, 200U, 0U, 120U);
+  test_post(HW_IPCC_SIM_SYS_EVT, 100U, 20U, 16U);
+  for (i = 0U; i < 50U; i++)
+  {
+    test_zb_rsp = false;
+    TL_ZIGBEE_SendAppliCmdToM0();
+    test_run(test_is_zb_rsp, "no Zigbee response");
+    if ((i % 10U) == 0U)
+    {
+      test_sys_cmd(1U);
+      test_scenario = "Zigbee";
+    }
+  }
+  test_run(test_idle, "Zigbee notifications not received");
+  if ((test_rx[HW_IPCC_SIM_ZIGBEE_NOT] != 400U) || (test_rx[HW_IPCC_SIM_ZIGBEE_LOG] != 200U)
+      || (test_rx[HW_IPCC_SIM_SYS_EVT] != 100U))
+  {
+    test_fail("Zigbee packets", test_rx[HW_IPCC_SIM_ZIGBEE_NOT]);
+  }
+}
+
+/* The CPU2 reports the misuses of the mailbox */
+static void test_errors(void)
+{
+  test_scenario = "buffer not allocated by the CPU2 given back";
+  test_sim_errors++;
+  TL_MM_EvtDone((TL_EvtPacket_t *)&test_zb_not_buffer);
+  TL_MM_EvtFlush();
+  test_run(test_error_raised, "buffer given back not reported");
+
+  test_scenario = "ack without notification";
+  test_sim_errors++;
+  TL_ZIGBEE_SendAckAfterAppliNotifFromM0();
+  test_run(test_error_raised, "ack not reported");
+}
+
+/******************************************************************************
+ * Benchmarks
+ ******************************************************************************/
+static void test_bench_events(uint32_t count, uint8_t len)
+{
+  HW_IPCC_SIM_Stats_t before, stats;
+  TL_MM_Stats_t mm_before, mm;
+  uint64_t start, elapsed;
+
+  HW_IPCC_SIM_GetStats(&before);
+  TL_MM_GetStats(&mm_before);
+  start = HW_IPCC_SIM_TimeNs();
+  test_post(HW_IPCC_SIM_BLE_EVT, count, 0U, len);
+  test_run(test_idle, "bench events");
+  elapsed = HW_IPCC_SIM_TimeNs() - start;
+  HW_IPCC_SIM_GetStats(&stats);
+  TL_MM_GetStats(&mm);
+  printf("BLE events of %3u bytes: %.0f events/s, %.2f events per doorbell, %.2f releases per doorbell, "
+         "latency %.1f us (max %.1f us), %lu stalls\n", len, count / (elapsed / 1e9),
+         (double)count / (stats.Doorbells[HW_IPCC_SIM_BLE_EVT] - before.Doorbells[HW_IPCC_SIM_BLE_EVT]),
+         (double)(mm.EvtReleased - mm_before.EvtReleased) / (mm.Doorbells - mm_before.Doorbells),
+         test_latency_sum[HW_IPCC_SIM_BLE_EVT] / 1e3 / count, test_latency_max[HW_IPCC_SIM_BLE_EVT] / 1e3,
+         (unsigned long)(stats.EvtStalls - before.EvtStalls));
+}
+
+static void test_bench_async_cb(HCI_TL_AsyncCmd_t *p_async_cmd)
+{
+  test_async_done++;
+  if (test_async_submitted < test_async_target)
+  {
+    (void)test_async_submit((uint32_t)(p_async_cmd - test_async), test_bench_async_cb);
+  }
+}
+
+static void test_bench_cmds(uint32_t count)
+{
+  uint64_t start, sync_ns, async_ns;
+  uint32_t i;
+
+  test_scenario = "bench commands";
+  start = HW_IPCC_SIM_TimeNs();
+  for (i = 0U; i < count; i++)
+  {
+    test_ble_cmd(i, true, false);
+  }
+  sync_ns = HW_IPCC_SIM_TimeNs() - start;
+
+  test_async_submitted = test_async_done = 0U;
+  test_async_target = count;
+  start = HW_IPCC_SIM_TimeNs();
+  for (i = 0U; i < CFG_TLBLE_ASYNC_CMD_QUEUE_LENGTH; i++)
+  {
+    (void)test_async_submit(i, test_bench_async_cb);
+  }
+  test_run(test_idle, "bench asynchronous commands");
+  async_ns = HW_IPCC_SIM_TimeNs() - start;
+  printf("BLE commands: synchronous %.1f us per command, asynchronous %.1f us per command\n",
+         sync_ns / 1e3 / count, async_ns / 1e3 / test_async_done);
+}
+
+static void test_bench_thread(uint32_t count)
+{
+  uint64_t start, elapsed;
+
+  start = HW_IPCC_SIM_TimeNs();
+  test_post(HW_IPCC_SIM_THREAD_NOT, count, 0U, 64U);
+  test_run(test_idle, "bench Thread notifications");
+  elapsed = HW_IPCC_SIM_TimeNs() - start;
+  printf("Thread notifications: %.0f notifications/s, latency %.1f us (max %.1f us)\n", count / (elapsed / 1e9),
+         test_latency_sum[HW_IPCC_SIM_THREAD_NOT] / 1e3 / count, test_latency_max[HW_IPCC_SIM_THREAD_NOT] / 1e3);
+}
+
+static void test_bench(void)
+{
+  uint64_t start, elapsed;
+
+  test_scenario = "bench";
+  test_boot();
+  test_scenario = "bench";
+  test_bench_events(100000U, 16U);
+  test_bench_events(50000U, 255U);
+  test_bench_cmds(20000U);
+
+  start = HW_IPCC_SIM_TimeNs();
+  test_acl(20000U);
+  elapsed = HW_IPCC_SIM_TimeNs() - start;
+  printf("ACL data: %.0f packets/s, with 5000 events\n", 20000U / (elapsed / 1e9));
+
+  test_thread();
+  test_bench_thread(50000U);
+  HW_IPCC_SIM_Stop();
+}
+
+int main(int argc, char *argv[])
+{
+  HW_IPCC_SIM_Stats_t stats;
+
+  test_boot();
+  test_sys_cmd(100U);
+  test_ble_sync();
+  test_ble_async();
+  test_events();
+  test_interleaved();
+  test_flow();
+  test_acl(500U);
+  test_thread();
+  HW_IPCC_SIM_Stop();
+
+  /* The CPU2 boots again with another protocol */
+  test_boot();
+  test_zigbee();
+  test_errors();
+  HW_IPCC_SIM_GetStats(&stats);
+  HW_IPCC_SIM_Stop();
+
+  printf("PASS: transport layer, drain %u, release HWM %u: %lu BLE commands, %lu system commands, %lu events, "
+         "%lu doorbells, %lu ACL packets, %lu Thread/Zigbee commands, %lu notifications (%lu overwritten by a CLI ack)\n",
+         CFG_TLBLE_EVT_DRAIN_MAX_NBR, CFG_TL_MM_EVT_RELEASE_HWM, (unsigned long)stats.BleCmd,
+         (unsigned long)stats.SysCmd,
+         (unsigned long)(stats.Posted[HW_IPCC_SIM_BLE_EVT] + stats.Posted[HW_IPCC_SIM_SYS_EVT] + stats.Posted[HW_IPCC_SIM_TRACES]),
+         (unsigned long)(stats.Doorbells[HW_IPCC_SIM_BLE_EVT] + stats.Doorbells[HW_IPCC_SIM_SYS_EVT] + stats.Doorbells[HW_IPCC_SIM_TRACES]),
+         (unsigned long)stats.AclData, (unsigned long)stats.OtCmd,
+         (unsigned long)(stats.Posted[HW_IPCC_SIM_THREAD_NOT] + stats.Posted[HW_IPCC_SIM_THREAD_CLI_NOT]
+                         + stats.Posted[HW_IPCC_SIM_ZIGBEE_NOT] + stats.Posted[HW_IPCC_SIM_ZIGBEE_LOG]),
+         (unsigned long)test_not_overwritten);
+
+  if ((argc > 1) && (strcmp(argv[1], "bench") == 0))
+  {
+    test_bench();
+  }
+  return 0;
+}
+
+/******************* (C) COPYRIGHT 2019 STMicroelectronics *****END OF FILE****/
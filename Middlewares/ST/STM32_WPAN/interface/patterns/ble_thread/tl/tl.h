@@ -61,6 +61,17 @@ extern "C" {
 #define TL_BLEEVT_CS_PACKET_SIZE       (TL_EVT_HDR_SIZE + sizeof(TL_CsEvt_t))
 #define TL_BLEEVT_CS_BUFFER_SIZE       (sizeof(TL_PacketHeader_t) + TL_BLEEVT_CS_PACKET_SIZE)
 
+#ifdef ZIGBEE_NOTIF_RING
+/**
+ * Size of one slot of the Zigbee M0 to M4 notification ring
+ * It is rounded up to a word so that all slots are aligned the same way
+ * The ring is built only when ZIGBEE_NOTIF_RING is defined, it requires a CPU2 wireless firmware implementing it
+ * The application then provides ZigbeeNotifRingDepth slots in p_ZigbeeNotAckBuffer, and may receive several
+ * notifications before Zigbee_CallBackProcessing() is called
+ */
+#define TL_ZIGBEE_NOTIF_SLOT_SIZE      ((sizeof(TL_PacketHeader_t) + TL_EVT_HDR_SIZE + 255U + 3U) & ~3U)
+#endif
+
 /* Exported types ------------------------------------------------------------*/
 /**< Packet header */
 typedef PACKED_STRUCT
@@ -203,8 +214,24 @@ typedef struct
   uint8_t *p_ZigbeeOtCmdRspBuffer;
   uint8_t *p_ZigbeeNotAckBuffer;
   uint8_t *p_ZigbeeLoggingBuffer;
+#ifdef ZIGBEE_NOTIF_RING
+  uint32_t ZigbeeNotifRingDepth;      /**< Number of slots of TL_ZIGBEE_NOTIF_SLOT_SIZE bytes in p_ZigbeeNotAckBuffer */
+#endif
 } TL_ZIGBEE_Config_t;
 
+/**
+ * @brief Memory manager statistics
+ * @{
+ */
+typedef struct
+{
+  uint32_t EvtOutstanding;          /**< Event buffers received from the CPU2 and not yet sent back */
+  uint32_t EvtOutstandingPeak;      /**< Highest value of EvtOutstanding */
+  uint32_t EvtReleased;             /**< Number of event buffers sent back to the CPU2 */
+  uint32_t Doorbells;               /**< Number of IPCC notifications used to send back the buffers */
+  uint32_t MaxReleasesPerDoorbell;  /**< Highest number of buffers sent back with a single notification */
+} TL_MM_Stats_t;
+
 /**
  * @brief Contain the BLE HCI Init Configuration
  * @{
@@ -280,6 +307,17 @@ void TL_LLDTESTS_SendM0CmdAck( void );
 void TL_MM_Init( TL_MM_Config_t *p_Config );
 void TL_MM_EvtDone( TL_EvtPacket_t * hcievt );
 
+/**
+ * TL_MM_EvtRelease() puts back the buffer in the local free list without notifying the CPU2.
+ * TL_MM_EvtFlush() sends to the CPU2 all buffers released so far with a single IPCC notification.
+ * TL_MM_EvtDone() releases the buffer and flushes the local free list when it holds
+ * CFG_TL_MM_EVT_RELEASE_HWM buffers.
+ */
+void TL_MM_EvtRelease( TL_EvtPacket_t * hcievt );
+void TL_MM_EvtFlush( void );
+void TL_MM_GetStats( TL_MM_Stats_t *p_stats );
+void TL_MM_ResetStats( void );
+
 /******************************************************************************
  * TRACES
  ******************************************************************************/
@@ -301,6 +339,10 @@ void TL_MAC_802_15_4_SendAck ( void );
 void TL_ZIGBEE_Init( TL_ZIGBEE_Config_t *p_Config );
 void TL_ZIGBEE_SendAppliCmdToM0( void );
 void TL_ZIGBEE_SendAckAfterAppliNotifFromM0 ( void );
+#ifdef ZIGBEE_NOTIF_RING
+TL_EvtPacket_t* TL_ZIGBEE_GetNotifFromM0 ( void );
+void TL_ZIGBEE_ReleaseNotifToM0 ( void );
+#endif
 void TL_ZIGBEE_NotReceived( TL_EvtPacket_t * Notbuffer );
 void TL_ZIGBEE_CmdEvtReceived( TL_EvtPacket_t * Otbuffer );
 void TL_ZIGBEE_LoggingReceived(TL_EvtPacket_t * Otbuffer );
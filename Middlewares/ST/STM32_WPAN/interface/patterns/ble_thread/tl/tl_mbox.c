@@ -21,6 +21,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "stm32_wpan_common.h"
 #include "hw.h"
+#include "app_conf.h"
 
 #include "stm_list.h"
 #include "tl.h"
@@ -28,6 +29,16 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private defines -----------------------------------------------------------*/
+/**
+ * Number of event buffers released with TL_MM_EvtDone() before they are sent back to the CPU2
+ * When set to 1, each buffer is sent back as soon as it is released (default behavior)
+ * When greater than 1, the application shall call TL_MM_EvtFlush() at the end of each scheduler pass
+ * so that the buffers below the high water mark are not kept by the CPU1
+ */
+#ifndef CFG_TL_MM_EVT_RELEASE_HWM
+#define CFG_TL_MM_EVT_RELEASE_HWM   (1)
+#endif
+
 /* Private macros ------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 
@@ -52,15 +63,24 @@ PLACE_IN_SECTION("MB_MEM2") ALIGN(4) static tListNode  SystemEvtQueue;
 
 
 static tListNode  LocalFreeBufQueue;
+static volatile uint32_t LocalFreeBufNbr;
+static TL_MM_Stats_t TL_MM_Stats;
 static void (* BLE_IoBusEvtCallBackFunction) (TL_EvtPacket_t *phcievt);
 static void (* BLE_IoBusAclDataTxAck) ( void );
 static void (* SYS_CMD_IoBusCallBackFunction) (TL_EvtPacket_t *phcievt);
 static void (* SYS_EVT_IoBusCallBackFunction) (TL_EvtPacket_t *phcievt);
+#if defined(ZIGBEE_WB) && defined(ZIGBEE_NOTIF_RING)
+static uint32_t ZigbeeNotifReadIndex;
+#endif
 
 
 /* Global variables ----------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 static void SendFreeBuf( void );
+static void OutstandingEvtInc( void );
+#if defined(ZIGBEE_WB) && defined(ZIGBEE_NOTIF_RING)
+static TL_EvtPacket_t* ZigbeeNotifSlot( uint32_t index );
+#endif
 
 /* Public Functions Definition ------------------------------------------------------*/
 
@@ -138,6 +158,14 @@ void HW_IPCC_BLE_RxEvtNot(void)
   {
     LST_remove_head (&EvtQueue, (tListNode **)&phcievt);
 
+    /**
+     * The command complete and command status events are not allocated from the memory manager pool
+     */
+    if ( ((phcievt->evtserial.evt.evtcode) != TL_BLEEVT_CS_OPCODE) && ((phcievt->evtserial.evt.evtcode) != TL_BLEEVT_CC_OPCODE ) )
+    {
+      OutstandingEvtInc( );
+    }
+
     BLE_IoBusEvtCallBackFunction(phcievt);
   }
 
@@ -211,6 +239,7 @@ void HW_IPCC_SYS_EvtNot( void )
   while(LST_is_empty(&SystemEvtQueue) == FALSE)
   {
     LST_remove_head (&SystemEvtQueue, (tListNode **)&p_evt);
+    OutstandingEvtInc( );
     SYS_EVT_IoBusCallBackFunction( p_evt );
   }
 
@@ -408,15 +437,41 @@ __WEAK void TL_MAC_802_15_4_NotReceived( TL_EvtPacket_t * Notbuffer ){};
 /******************************************************************************
  * ZIGBEE
  ******************************************************************************/
+/**
+ * When ZIGBEE_NOTIF_RING is defined, the M0 to M4 notifications are posted in a ring of notifM0toM4_ring_depth slots
+ * - The M0 writes the next slot, sets its type to TL_OTNOT_PKT_TYPE and sets the IPCC flag
+ * - The M4 processes the slots in order, writes the results in place and gives each slot back
+ *   by setting its type to TL_OTACK_PKT_TYPE. The IPCC flag is cleared once for all processed slots
+ * - The M0 may post in a slot as soon as it has been given back, without waiting for the IPCC flag
+ * When the depth is 1, the M0 does not mark the slot and waits for the IPCC flag to be cleared before
+ * posting the next notification
+ * The ring requires a CPU2 wireless firmware implementing it. Otherwise, a single notification is exchanged at a time
+ */
 void TL_ZIGBEE_Init( TL_ZIGBEE_Config_t *p_Config )
 {
 
     MB_ZigbeeTable_t  * p_zigbee_table;
+#ifdef ZIGBEE_NOTIF_RING
+    uint32_t index;
+#endif
 
     p_zigbee_table = TL_RefTable.p_zigbee_table;
     p_zigbee_table->appliCmdM4toM0_buffer = p_Config->p_ZigbeeOtCmdRspBuffer;
     p_zigbee_table->notifM0toM4_buffer = p_Config->p_ZigbeeNotAckBuffer;
     p_zigbee_table->loggingM0toM4_buffer = p_Config->p_ZigbeeLoggingBuffer;
+#ifdef ZIGBEE_NOTIF_RING
+    p_zigbee_table->notifM0toM4_ring_depth = p_Config->ZigbeeNotifRingDepth;
+    if(p_zigbee_table->notifM0toM4_ring_depth == 0)
+    {
+      p_zigbee_table->notifM0toM4_ring_depth = 1;
+    }
+
+    for(index = 0; index < p_zigbee_table->notifM0toM4_ring_depth; index++)
+    {
+      ZigbeeNotifSlot(index)->evtserial.type = TL_OTACK_PKT_TYPE;
+    }
+    ZigbeeNotifReadIndex = 0;
+#endif
 
     HW_IPCC_ZIGBEE_Init();
 
@@ -432,6 +487,69 @@ void TL_ZIGBEE_SendAppliCmdToM0( void )
   return;
 }
 
+#ifdef ZIGBEE_NOTIF_RING
+/* Return the next notification posted by the M0 or NULL when there is none */
+TL_EvtPacket_t* TL_ZIGBEE_GetNotifFromM0 ( void )
+{
+  TL_EvtPacket_t *p_notif;
+
+  p_notif = ZigbeeNotifSlot(ZigbeeNotifReadIndex);
+
+  if(*(volatile uint8_t *)&(p_notif->evtserial.type) != TL_OTNOT_PKT_TYPE)
+  {
+    return NULL;
+  }
+
+  __DMB();
+
+  return p_notif;
+}
+
+/* Give back to the M0 the notification returned by TL_ZIGBEE_GetNotifFromM0() */
+void TL_ZIGBEE_ReleaseNotifToM0 ( void )
+{
+  /**
+   * The results written in the slot shall be visible to the M0 before the slot is given back
+   */
+  __DMB();
+
+  ZigbeeNotifSlot(ZigbeeNotifReadIndex)->evtserial.type = TL_OTACK_PKT_TYPE;
+
+  ZigbeeNotifReadIndex++;
+  if(ZigbeeNotifReadIndex == TL_RefTable.p_zigbee_table->notifM0toM4_ring_depth)
+  {
+    ZigbeeNotifReadIndex = 0;
+  }
+
+  return;
+}
+
+/* Send an ACK to the M0 for all the notifications given back */
+void TL_ZIGBEE_SendAckAfterAppliNotifFromM0 ( void )
+{
+  if(TL_RefTable.p_zigbee_table->notifM0toM4_ring_depth == 1)
+  {
+    /**
+     * The notification may have been processed without being given back
+     */
+    ZigbeeNotifSlot(0)->evtserial.type = TL_OTACK_PKT_TYPE;
+    ZigbeeNotifReadIndex = 0;
+  }
+
+  HW_IPCC_ZIGBEE_SendAppliCmdAck();
+
+  /**
+   * A notification posted while the previous ones were processed is signaled by the IPCC flag
+   * that has just been cleared
+   */
+  if(TL_ZIGBEE_GetNotifFromM0() != NULL)
+  {
+    TL_ZIGBEE_NotReceived( ZigbeeNotifSlot(ZigbeeNotifReadIndex) );
+  }
+
+  return;
+}
+#else
 /* Send an ACK to the M0 */
 void TL_ZIGBEE_SendAckAfterAppliNotifFromM0 ( void )
 {
@@ -441,6 +559,7 @@ void TL_ZIGBEE_SendAckAfterAppliNotifFromM0 ( void )
 
   return;
 }
+#endif
 
 /* Used to receive an ACK from the M0 */
 void HW_IPCC_ZIGBEE_AppliCmdNotification(void)
@@ -453,7 +572,19 @@ void HW_IPCC_ZIGBEE_AppliCmdNotification(void)
 /* Zigbee callback */
 void HW_IPCC_ZIGBEE_AppliAsyncEvtNotification( void )
 {
+#ifdef ZIGBEE_NOTIF_RING
+  if(TL_RefTable.p_zigbee_table->notifM0toM4_ring_depth == 1)
+  {
+    /**
+     * The notification is only signaled by the IPCC flag
+     */
+    ZigbeeNotifSlot(0)->evtserial.type = TL_OTNOT_PKT_TYPE;
+  }
+
+  TL_ZIGBEE_NotReceived( ZigbeeNotifSlot(ZigbeeNotifReadIndex) );
+#else
   TL_ZIGBEE_NotReceived( (TL_EvtPacket_t*)(TL_RefTable.p_zigbee_table->notifM0toM4_buffer) );
+#endif
 
   return;
 }
@@ -476,6 +607,12 @@ void TL_ZIGBEE_SendAckAfterAppliLoggingFromM0 ( void )
   return;
 }
 
+#ifdef ZIGBEE_NOTIF_RING
+static TL_EvtPacket_t* ZigbeeNotifSlot( uint32_t index )
+{
+  return (TL_EvtPacket_t*)(TL_RefTable.p_zigbee_table->notifM0toM4_buffer + (index * TL_ZIGBEE_NOTIF_SLOT_SIZE));
+}
+#endif
 
 __WEAK void TL_ZIGBEE_CmdEvtReceived( TL_EvtPacket_t * Otbuffer  ){};
 __WEAK void TL_ZIGBEE_NotReceived( TL_EvtPacket_t * Notbuffer ){};
@@ -492,6 +629,8 @@ void TL_MM_Init( TL_MM_Config_t *p_Config )
 
   LST_init_head (&FreeBufQueue);
   LST_init_head (&LocalFreeBufQueue);
+  LocalFreeBufNbr = 0;
+  memset( (void *)&TL_MM_Stats, 0, sizeof(TL_MM_Stats) );
 
   p_mem_manager_table = TL_RefTable.p_mem_manager_table;
 
@@ -508,23 +647,128 @@ void TL_MM_Init( TL_MM_Config_t *p_Config )
 
 void TL_MM_EvtDone(TL_EvtPacket_t * phcievt)
 {
+  TL_MM_EvtRelease( phcievt );
+
+  if ( LocalFreeBufNbr >= CFG_TL_MM_EVT_RELEASE_HWM )
+  {
+    TL_MM_EvtFlush( );
+  }
+
+  return;
+}
+
+void TL_MM_EvtRelease(TL_EvtPacket_t * phcievt)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();  /**< backup PRIMASK bit */
+  __disable_irq();                  /**< Disable all interrupts by setting PRIMASK bit on Cortex*/
+
   LST_insert_tail(&LocalFreeBufQueue, (tListNode *)phcievt);
+  LocalFreeBufNbr++;
 
-  HW_IPCC_MM_SendFreeBuf( SendFreeBuf );
+  __set_PRIMASK(primask_bit);     /**< Restore PRIMASK bit*/
+
+  return;
+}
+
+void TL_MM_EvtFlush( void )
+{
+  if ( LocalFreeBufNbr != 0 )
+  {
+    HW_IPCC_MM_SendFreeBuf( SendFreeBuf );
+  }
+
+  return;
+}
+
+void TL_MM_GetStats( TL_MM_Stats_t *p_stats )
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();  /**< backup PRIMASK bit */
+  __disable_irq();                  /**< Disable all interrupts by setting PRIMASK bit on Cortex*/
+
+  *p_stats = TL_MM_Stats;
+
+  __set_PRIMASK(primask_bit);     /**< Restore PRIMASK bit*/
+
+  return;
+}
+
+void TL_MM_ResetStats( void )
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();  /**< backup PRIMASK bit */
+  __disable_irq();                  /**< Disable all interrupts by setting PRIMASK bit on Cortex*/
+
+  /**
+   * The number of buffers currently held by the CPU1 is kept
+   */
+  TL_MM_Stats.EvtOutstandingPeak = TL_MM_Stats.EvtOutstanding;
+  TL_MM_Stats.EvtReleased = 0;
+  TL_MM_Stats.Doorbells = 0;
+  TL_MM_Stats.MaxReleasesPerDoorbell = 0;
+
+  __set_PRIMASK(primask_bit);     /**< Restore PRIMASK bit*/
 
   return;
 }
 
 static void SendFreeBuf( void )
 {
-  tListNode *p_node;
+  uint32_t nbr_released;
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();  /**< backup PRIMASK bit */
+  __disable_irq();                  /**< Disable all interrupts by setting PRIMASK bit on Cortex*/
+
+  /**
+   * The whole local list is moved at once to the queue shared with the CPU2
+   */
+  LST_splice_tail( (tListNode*)(TL_RefTable.p_mem_manager_table->pevt_free_buffer_queue), &LocalFreeBufQueue );
+  nbr_released = LocalFreeBufNbr;
+  LocalFreeBufNbr = 0;
+
+  if ( TL_MM_Stats.EvtOutstanding >= nbr_released )
+  {
+    TL_MM_Stats.EvtOutstanding -= nbr_released;
+  }
+  else
+  {
+    /**
+     * Buffers released by the application that have not been counted on reception
+     */
+    TL_MM_Stats.EvtOutstanding = 0;
+  }
+  TL_MM_Stats.EvtReleased += nbr_released;
+  TL_MM_Stats.Doorbells++;
+  if ( nbr_released > TL_MM_Stats.MaxReleasesPerDoorbell )
+  {
+    TL_MM_Stats.MaxReleasesPerDoorbell = nbr_released;
+  }
+
+  __set_PRIMASK(primask_bit);     /**< Restore PRIMASK bit*/
+
+  return;
+}
+
+static void OutstandingEvtInc( void )
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();  /**< backup PRIMASK bit */
+  __disable_irq();                  /**< Disable all interrupts by setting PRIMASK bit on Cortex*/
 
-  while ( FALSE == LST_is_empty (&LocalFreeBufQueue) )
+  TL_MM_Stats.EvtOutstanding++;
+  if ( TL_MM_Stats.EvtOutstanding > TL_MM_Stats.EvtOutstandingPeak )
   {
-    LST_remove_head( &LocalFreeBufQueue, (tListNode **)&p_node );
-    LST_insert_tail( (tListNode*)(TL_RefTable.p_mem_manager_table->pevt_free_buffer_queue), p_node );
+    TL_MM_Stats.EvtOutstandingPeak = TL_MM_Stats.EvtOutstanding;
   }
 
+  __set_PRIMASK(primask_bit);     /**< Restore PRIMASK bit*/
+
   return;
 }
 
@@ -550,6 +794,7 @@ void HW_IPCC_TRACES_EvtNot(void)
   while(LST_is_empty(&TracesEvtQueue) == FALSE)
   {
     LST_remove_head (&TracesEvtQueue, (tListNode **)&phcievt);
+    OutstandingEvtInc( );
     TL_TRACES_EvtReceived( phcievt );
   }
 
@@ -52,3 +52,6 @@ __weak Zigbee_Cmd_Request_t* ZIGBEE_Get_OTCmdPayloadBuffer(void){return 0;}
 __weak Zigbee_Cmd_Request_t* ZIGBEE_Get_OTCmdRspPayloadBuffer(void){return 0;}
 __weak Zigbee_Cmd_Request_t* ZIGBEE_Get_NotificationPayloadBuffer(void){return 0;}
 __weak Zigbee_Cmd_Request_t* ZIGBEE_Get_LoggingPayloadBuffer(void){return 0;}
+__weak void ZIGBEE_TimerStart(uint32_t timeout_ms){return;}
+__weak void ZIGBEE_TimerStop(void){return;}
+__weak void ZIGBEE_LogPending(void){return;}
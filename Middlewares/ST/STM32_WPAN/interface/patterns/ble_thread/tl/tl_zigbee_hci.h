@@ -35,6 +35,9 @@ Zigbee_Cmd_Request_t* ZIGBEE_Get_OTCmdPayloadBuffer(void);
 Zigbee_Cmd_Request_t* ZIGBEE_Get_OTCmdRspPayloadBuffer(void);
 Zigbee_Cmd_Request_t* ZIGBEE_Get_NotificationPayloadBuffer(void);
 Zigbee_Cmd_Request_t * ZIGBEE_Get_LoggingPayloadBuffer(void);
+void ZIGBEE_TimerStart(uint32_t timeout_ms);
+void ZIGBEE_TimerStop(void);
+void ZIGBEE_LogPending(void);
 
 /* Exported defines -----------------------------------------------------------*/
 
@@ -30,10 +30,304 @@
 
 #include "thread.h"
 #include "coap.h"
+#include <string.h>
 
 
 #if OPENTHREAD_ENABLE_APPLICATION_COAP
 
+/* The CoAP header is built and parsed on the M4, in the otCoapHeader structure
+ * the M0 reads and fills, so that the header accessors don't each cost an IPCC
+ * transfer. Define OPENTHREAD_COAP_HEADER_LOCAL to 0 to go through the M0. */
+#ifndef OPENTHREAD_COAP_HEADER_LOCAL
+#define OPENTHREAD_COAP_HEADER_LOCAL 1
+#endif
+
+#if OPENTHREAD_COAP_HEADER_LOCAL
+
+/* RFC 7252 section 3 */
+#define COAP_VERSION                    1U
+#define COAP_VERSION_OFFSET             6U
+#define COAP_TYPE_MASK                  0x30U
+#define COAP_TOKEN_LENGTH_MASK          0x0fU
+#define COAP_MIN_HEADER_LENGTH          4U
+#define COAP_TOKEN_OFFSET               4U
+#define COAP_PAYLOAD_MARKER             0xffU
+
+/* RFC 7252 section 3.1, option delta and length nibbles */
+#define COAP_OPTION_DELTA_OFFSET        4U
+#define COAP_OPTION_1_BYTE_EXTENSION    13U
+#define COAP_OPTION_2_BYTE_EXTENSION    14U
+#define COAP_OPTION_1_BYTE_OFFSET       13U
+#define COAP_OPTION_2_BYTE_OFFSET       269U
+
+#define COAP_OBSERVE_MASK               0xffffffU
+
+/* Writes the extended option delta or length, returns its nibble */
+static uint8_t coapOptionExtEncode(uint8_t **aCur, uint16_t aValue)
+{
+    if (aValue < COAP_OPTION_1_BYTE_OFFSET)
+    {
+        return (uint8_t)aValue;
+    }
+    if (aValue < COAP_OPTION_2_BYTE_OFFSET)
+    {
+        *(*aCur)++ = (uint8_t)(aValue - COAP_OPTION_1_BYTE_OFFSET);
+        return COAP_OPTION_1_BYTE_EXTENSION;
+    }
+    aValue -= COAP_OPTION_2_BYTE_OFFSET;
+    *(*aCur)++ = (uint8_t)(aValue >> 8);
+    *(*aCur)++ = (uint8_t)aValue;
+    return COAP_OPTION_2_BYTE_EXTENSION;
+}
+
+static uint16_t coapOptionExtSize(uint16_t aValue)
+{
+    return (aValue < COAP_OPTION_1_BYTE_OFFSET) ? 0U : ((aValue < COAP_OPTION_2_BYTE_OFFSET) ? 1U : 2U);
+}
+
+/* Reads the extended option delta or length of a nibble. Returns false if the
+ * nibble is reserved or the header is too short. */
+static bool coapOptionExtDecode(const otCoapHeader *aHeader, uint16_t *aOffset, uint16_t *aValue)
+{
+    const uint8_t *bytes = aHeader->mHeader.mBytes;
+
+    if (*aValue == COAP_OPTION_1_BYTE_EXTENSION)
+    {
+        if (*aOffset + 1U > aHeader->mHeaderLength)
+        {
+            return false;
+        }
+        *aValue = (uint16_t)(COAP_OPTION_1_BYTE_OFFSET + bytes[*aOffset]);
+        *aOffset += 1U;
+    }
+    else if (*aValue == COAP_OPTION_2_BYTE_EXTENSION)
+    {
+        if (*aOffset + 2U > aHeader->mHeaderLength)
+        {
+            return false;
+        }
+        *aValue = (uint16_t)(COAP_OPTION_2_BYTE_OFFSET + (((uint16_t)bytes[*aOffset] << 8) | bytes[*aOffset + 1U]));
+        *aOffset += 2U;
+    }
+    else if (*aValue > COAP_OPTION_2_BYTE_EXTENSION)
+    {
+        return false;
+    }
+    return true;
+}
+
+void otCoapHeaderInit(otCoapHeader *aHeader, otCoapType aType, otCoapCode aCode)
+{
+    memset(aHeader, 0, sizeof(*aHeader));
+    aHeader->mHeader.mFields.mVersionTypeToken = (uint8_t)((COAP_VERSION << COAP_VERSION_OFFSET) | ((uint8_t)aType & COAP_TYPE_MASK));
+    aHeader->mHeader.mFields.mCode = (uint8_t)aCode;
+    aHeader->mHeaderLength = COAP_MIN_HEADER_LENGTH;
+}
+
+void otCoapHeaderSetToken(otCoapHeader *aHeader, const uint8_t *aToken, uint8_t aTokenLength)
+{
+    if (aTokenLength > OT_COAP_MAX_TOKEN_LENGTH)
+    {
+        aTokenLength = OT_COAP_MAX_TOKEN_LENGTH;
+    }
+    aHeader->mHeader.mFields.mVersionTypeToken =
+        (uint8_t)((aHeader->mHeader.mFields.mVersionTypeToken & ~COAP_TOKEN_LENGTH_MASK) | aTokenLength);
+    memcpy(&aHeader->mHeader.mBytes[COAP_TOKEN_OFFSET], aToken, aTokenLength);
+    aHeader->mHeaderLength += aTokenLength;
+}
+
+otError otCoapHeaderAppendOption(otCoapHeader *aHeader, const otCoapOption *aOption)
+{
+    uint8_t *buf = &aHeader->mHeader.mBytes[aHeader->mHeaderLength];
+    uint8_t *cur = buf + 1;
+    uint16_t delta;
+    uint32_t size; /* up to 65540, not truncated before the check */
+
+    /* Options are appended in increasing option number order */
+    if (aOption->mNumber < aHeader->mOptionLast)
+    {
+        return OT_ERROR_INVALID_ARGS;
+    }
+    delta = aOption->mNumber - aHeader->mOptionLast;
+
+    size = 1U + coapOptionExtSize(delta) + coapOptionExtSize(aOption->mLength) + aOption->mLength;
+    if ((aHeader->mHeaderLength + size) >= OT_COAP_HEADER_MAX_LENGTH)
+    {
+        return OT_ERROR_NO_BUFS;
+    }
+
+    *buf = (uint8_t)(coapOptionExtEncode(&cur, delta) << COAP_OPTION_DELTA_OFFSET);
+    *buf |= coapOptionExtEncode(&cur, aOption->mLength);
+    if (aOption->mLength > 0U)
+    {
+        /* Empty options may have no value */
+        memcpy(cur, aOption->mValue, aOption->mLength);
+    }
+
+    aHeader->mHeaderLength += (uint8_t)size;
+    aHeader->mOptionLast = aOption->mNumber;
+    return OT_ERROR_NONE;
+}
+
+otError otCoapHeaderAppendUintOption(otCoapHeader *aHeader, uint16_t aNumber, uint32_t aValue)
+{
+    uint8_t value[sizeof(uint32_t)];
+    otCoapOption option;
+
+    /* Big endian, without the leading zero bytes */
+    value[0] = (uint8_t)(aValue >> 24);
+    value[1] = (uint8_t)(aValue >> 16);
+    value[2] = (uint8_t)(aValue >> 8);
+    value[3] = (uint8_t)aValue;
+
+    option.mNumber = aNumber;
+    option.mLength = sizeof(value);
+    option.mValue = value;
+    while ((option.mLength > 0U) && (option.mValue[0] == 0U))
+    {
+        option.mValue++;
+        option.mLength--;
+    }
+    return otCoapHeaderAppendOption(aHeader, &option);
+}
+
+otError otCoapHeaderAppendContentFormatOption(otCoapHeader *aHeader, otCoapOptionContentFormat aContentFormat)
+{
+    return otCoapHeaderAppendUintOption(aHeader, OT_COAP_OPTION_CONTENT_FORMAT, (uint32_t)aContentFormat);
+}
+
+otError otCoapHeaderAppendObserveOption(otCoapHeader *aHeader, uint32_t aObserve)
+{
+    return otCoapHeaderAppendUintOption(aHeader, OT_COAP_OPTION_OBSERVE, aObserve & COAP_OBSERVE_MASK);
+}
+
+otError otCoapHeaderAppendUriPathOptions(otCoapHeader *aHeader, const char *aUriPath)
+{
+    const char *cur = aUriPath;
+    const char *end;
+    otCoapOption option;
+    otError error;
+
+    /* One Uri-Path option per path segment */
+    option.mNumber = OT_COAP_OPTION_URI_PATH;
+    while ((end = strchr(cur, '/')) != NULL)
+    {
+        option.mLength = (uint16_t)(end - cur);
+        option.mValue = (const uint8_t *)cur;
+        error = otCoapHeaderAppendOption(aHeader, &option);
+        if (error != OT_ERROR_NONE)
+        {
+            return error;
+        }
+        cur = end + 1;
+    }
+    option.mLength = (uint16_t)strlen(cur);
+    option.mValue = (const uint8_t *)cur;
+    return otCoapHeaderAppendOption(aHeader, &option);
+}
+
+otError otCoapHeaderAppendMaxAgeOption(otCoapHeader *aHeader, uint32_t aMaxAge)
+{
+    return otCoapHeaderAppendUintOption(aHeader, OT_COAP_OPTION_MAX_AGE, aMaxAge);
+}
+
+otError otCoapHeaderAppendUriQueryOption(otCoapHeader *aHeader, const char *aUriQuery)
+{
+    otCoapOption option;
+
+    option.mNumber = OT_COAP_OPTION_URI_QUERY;
+    option.mLength = (uint16_t)strlen(aUriQuery);
+    option.mValue = (const uint8_t *)aUriQuery;
+    return otCoapHeaderAppendOption(aHeader, &option);
+}
+
+otError otCoapHeaderSetPayloadMarker(otCoapHeader *aHeader)
+{
+    if (aHeader->mHeaderLength >= OT_COAP_HEADER_MAX_LENGTH)
+    {
+        return OT_ERROR_NO_BUFS;
+    }
+    aHeader->mHeader.mBytes[aHeader->mHeaderLength++] = COAP_PAYLOAD_MARKER;
+    return OT_ERROR_NONE;
+}
+
+void otCoapHeaderSetMessageId(otCoapHeader *aHeader, uint16_t aMessageId)
+{
+    /* Network byte order */
+    aHeader->mHeader.mBytes[2] = (uint8_t)(aMessageId >> 8);
+    aHeader->mHeader.mBytes[3] = (uint8_t)aMessageId;
+}
+
+otCoapType otCoapHeaderGetType(const otCoapHeader *aHeader)
+{
+    return (otCoapType)(aHeader->mHeader.mFields.mVersionTypeToken & COAP_TYPE_MASK);
+}
+
+otCoapCode otCoapHeaderGetCode(const otCoapHeader *aHeader)
+{
+    return (otCoapCode)aHeader->mHeader.mFields.mCode;
+}
+
+uint16_t otCoapHeaderGetMessageId(const otCoapHeader *aHeader)
+{
+    return (uint16_t)(((uint16_t)aHeader->mHeader.mBytes[2] << 8) | aHeader->mHeader.mBytes[3]);
+}
+
+uint8_t otCoapHeaderGetTokenLength(const otCoapHeader *aHeader)
+{
+    return (uint8_t)(aHeader->mHeader.mFields.mVersionTypeToken & COAP_TOKEN_LENGTH_MASK);
+}
+
+const uint8_t *otCoapHeaderGetToken(const otCoapHeader *aHeader)
+{
+    return &aHeader->mHeader.mBytes[COAP_TOKEN_OFFSET];
+}
+
+const otCoapOption *otCoapHeaderGetNextOption(otCoapHeader *aHeader)
+{
+    const uint8_t *bytes = aHeader->mHeader.mBytes;
+    uint16_t offset = aHeader->mNextOptionOffset;
+    uint16_t delta;
+    uint16_t length;
+
+    /* Stops at the end of the header or at the payload marker */
+    if (offset >= aHeader->mHeaderLength)
+    {
+        return NULL;
+    }
+    delta = bytes[offset] >> COAP_OPTION_DELTA_OFFSET;
+    length = bytes[offset] & 0x0fU;
+    offset++;
+    if (!coapOptionExtDecode(aHeader, &offset, &delta) || !coapOptionExtDecode(aHeader, &offset, &length))
+    {
+        return NULL;
+    }
+    if (length > (aHeader->mHeaderLength - offset))
+    {
+        return NULL;
+    }
+
+    aHeader->mOption.mNumber += delta;
+    aHeader->mOption.mLength = length;
+    aHeader->mOption.mValue = &bytes[offset];
+    aHeader->mNextOptionOffset = offset + length;
+    return &aHeader->mOption;
+}
+
+const otCoapOption *otCoapHeaderGetFirstOption(otCoapHeader *aHeader)
+{
+    memset(&aHeader->mOption, 0, sizeof(aHeader->mOption));
+    aHeader->mNextOptionOffset = aHeader->mFirstOptionOffset;
+    if (aHeader->mNextOptionOffset == 0U)
+    {
+        /* Header built on this side, options follow the token */
+        aHeader->mNextOptionOffset = COAP_TOKEN_OFFSET + otCoapHeaderGetTokenLength(aHeader);
+    }
+    return otCoapHeaderGetNextOption(aHeader);
+}
+
+#else /* OPENTHREAD_COAP_HEADER_LOCAL */
+
 void otCoapHeaderInit(otCoapHeader *aHeader, otCoapType aType, otCoapCode aCode)
 {
     Pre_OtCmdProcessing();
@@ -70,23 +364,6 @@ void otCoapHeaderSetToken(otCoapHeader *aHeader, const uint8_t *aToken, uint8_t
     p_ot_req = THREAD_Get_OTCmdRspPayloadBuffer();
 }
 
-void otCoapHeaderGenerateToken(otCoapHeader *aHeader, uint8_t aTokenLength)
-{
-    Pre_OtCmdProcessing();
-    /* prepare buffer */
-    Thread_OT_Cmd_Request_t* p_ot_req = THREAD_Get_OTCmdPayloadBuffer();
-
-    p_ot_req->ID = MSG_M4TOM0_OT_COAP_HEADER_GENERATE_TOKEN;
-
-    p_ot_req->Size=2;
-    p_ot_req->Data[0] = (uint32_t) aHeader;
-    p_ot_req->Data[1] = (uint32_t) aTokenLength;
-
-    Ot_Cmd_Transfer();
-
-    p_ot_req = THREAD_Get_OTCmdRspPayloadBuffer();
-}
-
 otError otCoapHeaderAppendContentFormatOption(otCoapHeader *aHeader, otCoapOptionContentFormat aContentFormat)
 {
     Pre_OtCmdProcessing();
@@ -367,6 +644,25 @@ const otCoapOption *otCoapHeaderGetNextOption(otCoapHeader *aHeader)
     return (otCoapOption *)p_ot_req->Data[0];
 }
 
+#endif /* OPENTHREAD_COAP_HEADER_LOCAL */
+
+void otCoapHeaderGenerateToken(otCoapHeader *aHeader, uint8_t aTokenLength)
+{
+    Pre_OtCmdProcessing();
+    /* prepare buffer */
+    Thread_OT_Cmd_Request_t* p_ot_req = THREAD_Get_OTCmdPayloadBuffer();
+
+    p_ot_req->ID = MSG_M4TOM0_OT_COAP_HEADER_GENERATE_TOKEN;
+
+    p_ot_req->Size=2;
+    p_ot_req->Data[0] = (uint32_t) aHeader;
+    p_ot_req->Data[1] = (uint32_t) aTokenLength;
+
+    Ot_Cmd_Transfer();
+
+    p_ot_req = THREAD_Get_OTCmdRspPayloadBuffer();
+}
+
 otMessage *otCoapNewMessage(otInstance *aInstance, const otCoapHeader *aHeader)
 {
     Pre_OtCmdProcessing();
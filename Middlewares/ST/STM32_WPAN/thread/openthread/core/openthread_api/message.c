@@ -30,6 +30,7 @@
 
 #include "thread.h"
 #include "message.h"
+#include <string.h>
 
 
 void otMessageFree(otMessage *aMessage)
@@ -228,6 +229,148 @@ int otMessageWrite(otMessage *aMessage, uint16_t aOffset, const void *aBuf, uint
     return (int)p_ot_req->Data[0];
 }
 
+/* Fragments are gathered in this buffer to be moved with a single transfer,
+ * the ones that don't fit are moved on their own. */
+#ifndef OT_MESSAGE_VECTOR_BUF_SIZE
+#define OT_MESSAGE_VECTOR_BUF_SIZE 256U
+#endif
+
+static uint8_t otMessageVectorBuf[OT_MESSAGE_VECTOR_BUF_SIZE];
+
+otError otMessageAppendVector(otMessage *aMessage, const otMessageIoVec *aIoVec, uint8_t aCount)
+{
+    uint32_t total = 0U;
+    uint16_t length = 0U;
+    uint16_t used = 0U;
+    uint8_t i;
+    otError error = OT_ERROR_NONE;
+
+    for (i = 0U; i < aCount; i++)
+    {
+        total += aIoVec[i].mLength;
+    }
+    if (total > 0xffffU)
+    {
+        return OT_ERROR_NO_BUFS;
+    }
+    if (total > OT_MESSAGE_VECTOR_BUF_SIZE)
+    {
+        /* Several transfers, remember the length to undo a partial append */
+        length = otMessageGetLength(aMessage);
+    }
+
+    for (i = 0U; (i < aCount) && (error == OT_ERROR_NONE); i++)
+    {
+        if ((used + aIoVec[i].mLength) <= OT_MESSAGE_VECTOR_BUF_SIZE)
+        {
+            memcpy(&otMessageVectorBuf[used], aIoVec[i].mBuf, aIoVec[i].mLength);
+            used += aIoVec[i].mLength;
+            continue;
+        }
+        if (used > 0U)
+        {
+            error = otMessageAppend(aMessage, otMessageVectorBuf, used);
+            used = 0U;
+        }
+        if (error != OT_ERROR_NONE)
+        {
+            break;
+        }
+        if (aIoVec[i].mLength >= OT_MESSAGE_VECTOR_BUF_SIZE)
+        {
+            error = otMessageAppend(aMessage, aIoVec[i].mBuf, aIoVec[i].mLength);
+        }
+        else
+        {
+            memcpy(otMessageVectorBuf, aIoVec[i].mBuf, aIoVec[i].mLength);
+            used = aIoVec[i].mLength;
+        }
+    }
+    if ((error == OT_ERROR_NONE) && (used > 0U))
+    {
+        error = otMessageAppend(aMessage, otMessageVectorBuf, used);
+    }
+
+    if ((error != OT_ERROR_NONE) && (total > OT_MESSAGE_VECTOR_BUF_SIZE))
+    {
+        (void)otMessageSetLength(aMessage, length);
+    }
+    return error;
+}
+
+/* Reads the fragments gathered from aFirst to aLast (excluded). Returns false
+ * at the end of the message. */
+static bool otMessageReadVectorFlush(otMessage *aMessage, uint16_t *aOffset, const otMessageIoVec *aIoVec,
+                                     uint8_t aFirst, uint8_t aLast, uint16_t aUsed, int *aTotal)
+{
+    int read = otMessageRead(aMessage, *aOffset, otMessageVectorBuf, aUsed);
+    uint16_t copied = 0U;
+    uint16_t n;
+    uint8_t i;
+
+    if (read < 0)
+    {
+        read = 0;
+    }
+    for (i = aFirst; (i < aLast) && (copied < (uint16_t)read); i++)
+    {
+        n = ((uint16_t)read - copied < aIoVec[i].mLength) ? ((uint16_t)read - copied) : aIoVec[i].mLength;
+        memcpy(aIoVec[i].mBuf, &otMessageVectorBuf[copied], n);
+        copied += n;
+    }
+    *aOffset += (uint16_t)read;
+    *aTotal += read;
+    return read == (int)aUsed;
+}
+
+int otMessageReadVector(otMessage *aMessage, uint16_t aOffset, const otMessageIoVec *aIoVec, uint8_t aCount)
+{
+    int total = 0;
+    int read;
+    uint16_t used = 0U;
+    uint8_t first = 0U;
+    uint8_t i;
+
+    for (i = 0U; i < aCount; i++)
+    {
+        if ((used + aIoVec[i].mLength) <= OT_MESSAGE_VECTOR_BUF_SIZE)
+        {
+            used += aIoVec[i].mLength;
+            continue;
+        }
+        if ((used > 0U) && !otMessageReadVectorFlush(aMessage, &aOffset, aIoVec, first, i, used, &total))
+        {
+            return total;
+        }
+        used = 0U;
+        first = i;
+        if (aIoVec[i].mLength >= OT_MESSAGE_VECTOR_BUF_SIZE)
+        {
+            read = otMessageRead(aMessage, aOffset, aIoVec[i].mBuf, aIoVec[i].mLength);
+            if (read <= 0)
+            {
+                return total;
+            }
+            aOffset += (uint16_t)read;
+            total += read;
+            if (read < (int)aIoVec[i].mLength)
+            {
+                return total;
+            }
+            first = i + 1U;
+        }
+        else
+        {
+            used = aIoVec[i].mLength;
+        }
+    }
+    if (used > 0U)
+    {
+        (void)otMessageReadVectorFlush(aMessage, &aOffset, aIoVec, first, aCount, used, &total);
+    }
+    return total;
+}
+
 void otMessageQueueInit(otMessageQueue *aQueue)
 {
     Pre_OtCmdProcessing();
@@ -30,6 +30,7 @@
 #include "openthread_api_wb.h"
 #include "dbg_trace.h"
 #include "shci.h"
+#include <string.h>
 
 /* INSTANCE */
 otStateChangedCallback otStateChangedCb = NULL;
@@ -70,7 +71,7 @@ otLinkRawTransmitDone otLinkRawTransmitDoneCb = NULL;
 otLinkRawEnergyScanDone otLinkRawEnergyScanDoneCb = NULL;
 
 /* UDP */
-otUdpReceive otUdpReceiveCb = NULL;
+extern void otUdpHandleReceive(void *aSocket, otMessage *aMessage, const otMessageInfo *aMessageInfo);
 
 /* COAP */
 typedef void (*CoapRequestHandlerCallback)(otCoapHeader *aHeader, otMessage *aMessage,
@@ -87,193 +88,457 @@ otJamDetectionCallback otJamDetectionCallbackCb = NULL;
 #endif
 
 
-/**
-  * @brief  This function is used to manage all the callbacks used by the
-  *         OpenThread interface. These callbacks are used for example to
-  *         notify the application as soon as the state of a device has been
-  *         modified.
-  *
-  *         Important Note: This function must be called each time a message
-  *         is sent from the M0 to the M4.
-  *
-  * @param  None
-  * @retval None
-  */
+/* Handlers of the notifications, they are the first subscribers of their ID */
+static void OpenThread_Notify_StateChange(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    if (otStateChangedCb != NULL)
+    {
+        otStateChangedCb((uint32_t) p_notification->Data[0],
+                (void*) p_notification->Data[1]);
+    }
+}
 
-HAL_StatusTypeDef OpenThread_CallBack_Processing(void)
+static void OpenThread_Notify_CoapRequest(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
 {
-    HAL_StatusTypeDef status = HAL_OK;
+    coapRequestHandlerCb = (CoapRequestHandlerCallback) p_notification->Data[0];
 
-    /* Get pointer on received event buffer from M0 */
-    Thread_OT_Cmd_Request_t* p_notification = THREAD_Get_NotificationPayloadBuffer();
+    if (coapRequestHandlerCb != NULL)
+    {
+        coapRequestHandlerCb( (otCoapHeader *) p_notification->Data[1],
+                (otMessage *) p_notification->Data[2],
+                (otMessageInfo *) p_notification->Data[3]);
+    }
+}
 
-    switch(p_notification->ID)
+static void OpenThread_Notify_CoapResponse(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    coapResponseHandlerCb = (CoapResponseHandlerCallback) p_notification->Data[0];
+    if (coapResponseHandlerCb != NULL)
     {
-    case MSG_M0TOM4_NOTIFY_STATE_CHANGE:
-        if (otStateChangedCb != NULL)
-        {
-            otStateChangedCb((uint32_t) p_notification->Data[0],
-                    (void*) p_notification->Data[1]);
-        }
-        break;
-    case MSG_M0TOM4_COAP_REQUEST_HANDLER:
-        coapRequestHandlerCb = (CoapRequestHandlerCallback) p_notification->Data[0];
+        coapResponseHandlerCb( (otCoapHeader *) p_notification->Data[1],
+                (otMessage *) p_notification->Data[2],
+                (otMessageInfo *) p_notification->Data[3],
+                (otError) p_notification->Data[4]);
+    }
+}
+
+static void OpenThread_Notify_StackReset(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    /* Store Thread NVM data in Flash*/
+    SHCI_C2_FLASH_StoreData(THREAD_IP);
+    /* Perform an NVIC Reset in order to reinitalize the device */
+    HAL_NVIC_SystemReset();
+}
+
+static void OpenThread_Notify_Ip6Receive(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    if (otIp6ReceiveCb != NULL)
+    {
+        otIp6ReceiveCb((otMessage*) p_notification->Data[0],
+                (void*) p_notification->Data[1]);
+    }
+}
+
+static void OpenThread_Notify_Ip6SlaacIidCreate(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    if (aIidCreateCb != NULL)
+    {
+        /* Not passing otInstance as first parameter, because created on M0, passing NULL instead */
+        aIidCreateCb(NULL, (otNetifAddress*) p_notification->Data[0],
+                (void*) p_notification->Data[1]);
+    }
+}
+
+static void OpenThread_Notify_ActiveScanResult(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    if (otHandleActiveScanResultCb != NULL)
+    {
+        otHandleActiveScanResultCb((otActiveScanResult*) p_notification->Data[0],
+                (void*) p_notification->Data[1]);
+    }
+}
+
+static void OpenThread_Notify_EnergyScanResult(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    if (otHandleEnergyScanResultCb != NULL)
+    {
+        otHandleEnergyScanResultCb((otEnergyScanResult*) p_notification->Data[0],
+                (void*) p_notification->Data[1]);
+    }
+}
+
+static void OpenThread_Notify_LinkPcap(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    if (otLinkPcapCb != NULL)
+    {
+        otLinkPcapCb((otRadioFrame*) p_notification->Data[0],
+                (void*) p_notification->Data[1]);
+    }
+}
+
+static void OpenThread_Notify_DiagnosticGet(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    if (otReceiveDiagnosticGetCb != NULL)
+    {
+        otReceiveDiagnosticGetCb((otMessage*) p_notification->Data[0],
+                (otMessageInfo*) p_notification->Data[1],
+                (void*) p_notification->Data[2]);
+    }
+}
 
-        if (coapRequestHandlerCb != NULL)
-        {
-            coapRequestHandlerCb( (otCoapHeader *) p_notification->Data[1],
-                    (otMessage *) p_notification->Data[2],
-                    (otMessageInfo *) p_notification->Data[3]);
-        }
-        break;
-    case MSG_M0TOM4_COAP_RESPONSE_HANDLER:
-        coapResponseHandlerCb = (CoapResponseHandlerCallback) p_notification->Data[0];
-        if (coapResponseHandlerCb != NULL)
-        {
-            coapResponseHandlerCb( (otCoapHeader *) p_notification->Data[1],
-                    (otMessage *) p_notification->Data[2],
-                    (otMessageInfo *) p_notification->Data[3],
-                    (otError) p_notification->Data[4]);
-        }
-        break;
-    case MSG_M0TOM4_NOTIFY_STACK_RESET:
-        /* Store Thread NVM data in Flash*/
-        SHCI_C2_FLASH_StoreData(THREAD_IP);
-        /* Perform an NVIC Reset in order to reinitalize the device */
-        HAL_NVIC_SystemReset();
-        break;
-    case MSG_M0TOM4_IP6_RECEIVE:
-        if (otIp6ReceiveCb != NULL)
-        {
-            otIp6ReceiveCb((otMessage*) p_notification->Data[0],
-                    (void*) p_notification->Data[1]);
-        }
-        break;
-    case MSG_M0TOM4_IP6_SLAAC_IID_CREATE:
-        if (aIidCreateCb != NULL)
-        {
-            /* Not passing otInstance as first parameter, because created on M0, passing NULL instead */
-            aIidCreateCb(NULL, (otNetifAddress*) p_notification->Data[0],
-                    (void*) p_notification->Data[1]);
-        }
-        break;
-    case MSG_M0TOM4_HANDLE_ACTIVE_SCAN_RESULT:
-        if (otHandleActiveScanResultCb != NULL)
-        {
-            otHandleActiveScanResultCb((otActiveScanResult*) p_notification->Data[0],
-                    (void*) p_notification->Data[1]);
-        }
-        break;
-    case MSG_M0TOM4_HANDLE_ENERGY_SCAN_RESULT:
-        if (otHandleEnergyScanResultCb != NULL)
-        {
-            otHandleEnergyScanResultCb((otEnergyScanResult*) p_notification->Data[0],
-                    (void*) p_notification->Data[1]);
-        }
-        break;
-    case MSG_M0TOM4_HANDLE_LINK_PCAP:
-        if (otLinkPcapCb != NULL)
-        {
-            otLinkPcapCb((otRadioFrame*) p_notification->Data[0],
-                    (void*) p_notification->Data[1]);
-        }
-        break;
-    case MSG_M0TOM4_RECEIVE_DIAGNOSTIC_GET_CALLBACK:
-        if (otReceiveDiagnosticGetCb != NULL)
-        {
-            otReceiveDiagnosticGetCb((otMessage*) p_notification->Data[0],
-                    (otMessageInfo*) p_notification->Data[1],
-                    (void*) p_notification->Data[2]);
-        }
-        break;
 #if OPENTHREAD_FTD
-    case MSG_M0TOM4_THREAD_FTD_CHILD_TABLE_CALLBACK:
-        if (otThreadChildTableCallbackCb != NULL)
-        {
-            otThreadChildTableCallbackCb((otThreadChildTableEvent) p_notification->Data[0],
-                    (const otChildInfo *) p_notification->Data[1]);
-        }
-        break;
+static void OpenThread_Notify_ChildTable(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    if (otThreadChildTableCallbackCb != NULL)
+    {
+        otThreadChildTableCallbackCb((otThreadChildTableEvent) p_notification->Data[0],
+                (const otChildInfo *) p_notification->Data[1]);
+    }
+}
 #endif
-    case MSG_M0TOM4_COMMISSIONER_ENERGY_REPORT_CALLBACK:
-        if (otCommissionerEnergyReportCb != NULL)
-        {
-            otCommissionerEnergyReportCb((uint32_t) p_notification->Data[0],
-                    (uint8_t*) p_notification->Data[1],
-                    (uint8_t) p_notification->Data[2],
-                    (void*) p_notification->Data[3]);
-        }
-        break;
-    case MSG_M0TOM4_DNS_RESPONSE_HANDLER:
-        if (otDnsResponseHandlerCb != NULL)
+
+static void OpenThread_Notify_EnergyReport(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    if (otCommissionerEnergyReportCb != NULL)
+    {
+        otCommissionerEnergyReportCb((uint32_t) p_notification->Data[0],
+                (uint8_t*) p_notification->Data[1],
+                (uint8_t) p_notification->Data[2],
+                (void*) p_notification->Data[3]);
+    }
+}
+
+static void OpenThread_Notify_DnsResponse(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    if (otDnsResponseHandlerCb != NULL)
+    {
+        otDnsResponseHandlerCb((void*) p_notification->Data[0],
+                (char*) p_notification->Data[1],
+                (otIp6Address*) p_notification->Data[2],
+                (uint32_t) p_notification->Data[3],
+                (otError) p_notification->Data[4]);
+    }
+}
+
+static void OpenThread_Notify_Icmp6Receive(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    if (otIcmp6ReceiveCb != NULL)
+    {
+        otIcmp6ReceiveCb((void*) p_notification->Data[0],
+                (otMessage*) p_notification->Data[1],
+                (otMessageInfo*) p_notification->Data[2],
+                (otIcmp6Header*) p_notification->Data[3]);
+    }
+}
+
+static void OpenThread_Notify_Joiner(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    if (otJoinerCb != NULL)
+    {
+        otJoinerCb((otError) p_notification->Data[0],
+                (void*) p_notification->Data[1]);
+    }
+}
+
+static void OpenThread_Notify_LinkRawReceiveDone(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    if (otLinkRawReceiveDoneCb != NULL)
+    {
+        otLinkRawReceiveDoneCb((otInstance*) p_notification->Data[0],
+                (otRadioFrame*) p_notification->Data[1],
+                (otError) p_notification->Data[2]);
+    }
+}
+
+static void OpenThread_Notify_LinkRawTransmitDone(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    if (otLinkRawTransmitDoneCb != NULL)
+    {
+        otLinkRawTransmitDoneCb((otInstance*) p_notification->Data[0],
+                (otRadioFrame*) p_notification->Data[1],
+                (otRadioFrame*) p_notification->Data[2],
+                (otError) p_notification->Data[3]);
+    }
+}
+
+static void OpenThread_Notify_LinkRawEnergyScanDone(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    if (otLinkRawEnergyScanDoneCb != NULL)
+    {
+        otLinkRawEnergyScanDoneCb((otInstance*) p_notification->Data[0],
+                (int8_t) p_notification->Data[1]);
+    }
+}
+
+static void OpenThread_Notify_UdpReceive(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    otUdpHandleReceive((void*) p_notification->Data[0],
+            (otMessage*) p_notification->Data[1],
+            (otMessageInfo*) p_notification->Data[2]);
+}
+
+#if OPENTHREAD_ENABLE_JAM_DETECTION
+static void OpenThread_Notify_JamDetection(const Thread_OT_Cmd_Request_t *p_notification, void *aContext)
+{
+    if (otJamDetectionCallbackCb != NULL)
+    {
+        otJamDetectionCallbackCb((bool) p_notification->Data[0],
+                (void *) p_notification->Data[1]);
+    }
+}
+#endif
+
+static OpenThread_NotificationSubscriber_t notificationBuiltinSubscribers[] =
+{
+    { NULL, OpenThread_Notify_StateChange, NULL, MSG_M0TOM4_NOTIFY_STATE_CHANGE, OT_NOTIFICATION_PRIORITY_DEFAULT },
+    { NULL, OpenThread_Notify_CoapRequest, NULL, MSG_M0TOM4_COAP_REQUEST_HANDLER, OT_NOTIFICATION_PRIORITY_DEFAULT },
+    { NULL, OpenThread_Notify_CoapResponse, NULL, MSG_M0TOM4_COAP_RESPONSE_HANDLER, OT_NOTIFICATION_PRIORITY_DEFAULT },
+    { NULL, OpenThread_Notify_StackReset, NULL, MSG_M0TOM4_NOTIFY_STACK_RESET, OT_NOTIFICATION_PRIORITY_DEFAULT },
+    { NULL, OpenThread_Notify_Ip6Receive, NULL, MSG_M0TOM4_IP6_RECEIVE, OT_NOTIFICATION_PRIORITY_DEFAULT },
+    { NULL, OpenThread_Notify_Ip6SlaacIidCreate, NULL, MSG_M0TOM4_IP6_SLAAC_IID_CREATE, OT_NOTIFICATION_PRIORITY_DEFAULT },
+    { NULL, OpenThread_Notify_ActiveScanResult, NULL, MSG_M0TOM4_HANDLE_ACTIVE_SCAN_RESULT, OT_NOTIFICATION_PRIORITY_DEFAULT },
+    { NULL, OpenThread_Notify_EnergyScanResult, NULL, MSG_M0TOM4_HANDLE_ENERGY_SCAN_RESULT, OT_NOTIFICATION_PRIORITY_DEFAULT },
+    { NULL, OpenThread_Notify_LinkPcap, NULL, MSG_M0TOM4_HANDLE_LINK_PCAP, OT_NOTIFICATION_PRIORITY_DEFAULT },
+    { NULL, OpenThread_Notify_DiagnosticGet, NULL, MSG_M0TOM4_RECEIVE_DIAGNOSTIC_GET_CALLBACK, OT_NOTIFICATION_PRIORITY_DEFAULT },
+#if OPENTHREAD_FTD
+    { NULL, OpenThread_Notify_ChildTable, NULL, MSG_M0TOM4_THREAD_FTD_CHILD_TABLE_CALLBACK, OT_NOTIFICATION_PRIORITY_DEFAULT },
+#endif
+    { NULL, OpenThread_Notify_EnergyReport, NULL, MSG_M0TOM4_COMMISSIONER_ENERGY_REPORT_CALLBACK, OT_NOTIFICATION_PRIORITY_DEFAULT },
+    { NULL, OpenThread_Notify_DnsResponse, NULL, MSG_M0TOM4_DNS_RESPONSE_HANDLER, OT_NOTIFICATION_PRIORITY_DEFAULT },
+    { NULL, OpenThread_Notify_Icmp6Receive, NULL, MSG_M0TOM4_ICMP6_RECEIVE_CALLBACK, OT_NOTIFICATION_PRIORITY_DEFAULT },
+    { NULL, OpenThread_Notify_Joiner, NULL, MSG_M0TOM4_JOINER_CALLBACK, OT_NOTIFICATION_PRIORITY_DEFAULT },
+    { NULL, OpenThread_Notify_LinkRawReceiveDone, NULL, MSG_M0TOM4_LINK_RAW_RECEIVE_DONE, OT_NOTIFICATION_PRIORITY_DEFAULT },
+    { NULL, OpenThread_Notify_LinkRawTransmitDone, NULL, MSG_M0TOM4_LINK_RAW_TRANSMIT_DONE, OT_NOTIFICATION_PRIORITY_DEFAULT },
+    { NULL, OpenThread_Notify_LinkRawEnergyScanDone, NULL, MSG_M0TOM4_LINK_RAW_ENERGY_SCAN_DONE, OT_NOTIFICATION_PRIORITY_DEFAULT },
+    { NULL, OpenThread_Notify_UdpReceive, NULL, MSG_M0TOM4_UDP_RECEIVE, OT_NOTIFICATION_PRIORITY_DEFAULT },
+#if OPENTHREAD_ENABLE_JAM_DETECTION
+    { NULL, OpenThread_Notify_JamDetection, NULL, MSG_M0TOM4_JAM_DETECTION_CALLBACK, OT_NOTIFICATION_PRIORITY_DEFAULT },
+#endif
+};
+
+/* Subscribers of each notification ID, sorted by priority */
+static OpenThread_NotificationSubscriber_t *notificationSubscribers[OT_NOTIFICATION_ID_COUNT];
+/* Next subscriber of the notification being dispatched, kept valid when a
+ * handler unsubscribes it */
+static OpenThread_NotificationSubscriber_t *notificationDispatchNext = NULL;
+/* ID being dispatched, and the subscribers to it added by its handlers: they
+ * are linked at the end of the dispatch, to be called from the next one */
+static uint32_t notificationDispatchId = OT_NOTIFICATION_ID_COUNT;
+static OpenThread_NotificationSubscriber_t *notificationPending = NULL;
+static bool notificationInitDone = false;
+
+static void OpenThread_Notification_Init(void)
+{
+    uint32_t i;
+
+    if (notificationInitDone)
+    {
+        return;
+    }
+    notificationInitDone = true;
+
+#if OPENTHREAD_NOTIFICATION_STATS
+    /* Start the cycle counter if the debugger didn't */
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0U)
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0U;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+#endif
+
+    for (i = 0U; i < (sizeof(notificationBuiltinSubscribers) / sizeof(notificationBuiltinSubscribers[0])); i++)
+    {
+        (void)OpenThread_Notification_Subscribe(&notificationBuiltinSubscribers[i]);
+    }
+}
+
+static void OpenThread_Notification_Link(OpenThread_NotificationSubscriber_t *aSubscriber)
+{
+    OpenThread_NotificationSubscriber_t **prev;
+
+    /* After the subscribers of the same priority */
+    for (prev = &notificationSubscribers[aSubscriber->mId]; *prev != NULL; prev = &(*prev)->mNext)
+    {
+        if ((*prev)->mPriority > aSubscriber->mPriority)
         {
-            otDnsResponseHandlerCb((void*) p_notification->Data[0],
-                    (char*) p_notification->Data[1],
-                    (otIp6Address*) p_notification->Data[2],
-                    (uint32_t) p_notification->Data[3],
-                    (otError) p_notification->Data[4]);
+            break;
         }
-        break;
-    case MSG_M0TOM4_ICMP6_RECEIVE_CALLBACK:
-        if (otIcmp6ReceiveCb != NULL)
+    }
+    aSubscriber->mNext = *prev;
+    *prev = aSubscriber;
+}
+
+HAL_StatusTypeDef OpenThread_Notification_Subscribe(OpenThread_NotificationSubscriber_t *aSubscriber)
+{
+    OpenThread_NotificationSubscriber_t **prev;
+
+    OpenThread_Notification_Init();
+
+    if ((aSubscriber == NULL) || (aSubscriber->mHandler == NULL) || (aSubscriber->mId >= OT_NOTIFICATION_ID_COUNT))
+    {
+        return HAL_ERROR;
+    }
+
+    for (prev = &notificationSubscribers[aSubscriber->mId]; *prev != NULL; prev = &(*prev)->mNext)
+    {
+        if (*prev == aSubscriber)
         {
-            otIcmp6ReceiveCb((void*) p_notification->Data[0],
-                    (otMessage*) p_notification->Data[1],
-                    (otMessageInfo*) p_notification->Data[2],
-                    (otIcmp6Header*) p_notification->Data[3]);
+            return HAL_ERROR;
         }
-        break;
-    case MSG_M0TOM4_JOINER_CALLBACK:
-        if (otJoinerCb != NULL)
+    }
+    for (prev = &notificationPending; *prev != NULL; prev = &(*prev)->mNext)
+    {
+        if (*prev == aSubscriber)
         {
-            otJoinerCb((otError) p_notification->Data[0],
-                    (void*) p_notification->Data[1]);
+            return HAL_ERROR;
         }
-        break;
-    case MSG_M0TOM4_LINK_RAW_RECEIVE_DONE:
-        if (otLinkRawReceiveDoneCb != NULL)
+    }
+
+    if (aSubscriber->mId == notificationDispatchId)
+    {
+        /* Not reachable by the dispatch in progress, whatever its priority */
+        aSubscriber->mNext = NULL;
+        *prev = aSubscriber;
+        return HAL_OK;
+    }
+    OpenThread_Notification_Link(aSubscriber);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef OpenThread_Notification_Unsubscribe(OpenThread_NotificationSubscriber_t *aSubscriber)
+{
+    OpenThread_NotificationSubscriber_t **prev;
+
+    if ((aSubscriber == NULL) || (aSubscriber->mId >= OT_NOTIFICATION_ID_COUNT))
+    {
+        return HAL_ERROR;
+    }
+
+    for (prev = &notificationSubscribers[aSubscriber->mId]; *prev != NULL; prev = &(*prev)->mNext)
+    {
+        if (*prev == aSubscriber)
         {
-            otLinkRawReceiveDoneCb((otInstance*) p_notification->Data[0],
-                    (otRadioFrame*) p_notification->Data[1],
-                    (otError) p_notification->Data[2]);
+            if (notificationDispatchNext == aSubscriber)
+            {
+                notificationDispatchNext = aSubscriber->mNext;
+            }
+            *prev = aSubscriber->mNext;
+            aSubscriber->mNext = NULL;
+            return HAL_OK;
         }
-        break;
-    case MSG_M0TOM4_LINK_RAW_TRANSMIT_DONE:
-        if (otLinkRawTransmitDoneCb != NULL)
+    }
+    for (prev = &notificationPending; *prev != NULL; prev = &(*prev)->mNext)
+    {
+        if (*prev == aSubscriber)
         {
-            otLinkRawTransmitDoneCb((otInstance*) p_notification->Data[0],
-                    (otRadioFrame*) p_notification->Data[1],
-                    (otRadioFrame*) p_notification->Data[2],
-                    (otError) p_notification->Data[3]);
+            *prev = aSubscriber->mNext;
+            aSubscriber->mNext = NULL;
+            return HAL_OK;
         }
-        break;
-    case MSG_M0TOM4_LINK_RAW_ENERGY_SCAN_DONE:
-        if (otLinkRawEnergyScanDoneCb != NULL)
+    }
+    return HAL_ERROR;
+}
+
+const OpenThread_NotificationSubscriber_t *OpenThread_Notification_GetFirst(uint32_t aId)
+{
+    OpenThread_Notification_Init();
+
+    if (aId >= OT_NOTIFICATION_ID_COUNT)
+    {
+        return NULL;
+    }
+    return notificationSubscribers[aId];
+}
+
+void OpenThread_Notification_ResetStats(void)
+{
+    OpenThread_NotificationSubscriber_t *subscriber;
+    uint32_t i;
+
+    for (i = 0U; i < OT_NOTIFICATION_ID_COUNT; i++)
+    {
+        for (subscriber = notificationSubscribers[i]; subscriber != NULL; subscriber = subscriber->mNext)
         {
-            otLinkRawEnergyScanDoneCb((otInstance*) p_notification->Data[0],
-                    (int8_t) p_notification->Data[1]);
+            subscriber->mCount = 0U;
+            (void)memset(subscriber->mCycles, 0, sizeof(subscriber->mCycles));
         }
-        break;
-    case MSG_M0TOM4_UDP_RECEIVE:
-        if (otUdpReceiveCb != NULL)
+    }
+}
+
+#if OPENTHREAD_NOTIFICATION_STATS
+static void OpenThread_Notification_Account(OpenThread_NotificationSubscriber_t *aSubscriber, uint32_t aCycles)
+{
+    /* Bin n counts the calls of 2^(n + OT_NOTIFICATION_HISTOGRAM_SHIFT) cycles
+     * and more, bin 0 also the shorter ones and the last bin the longer ones. */
+    int32_t bin = (aCycles == 0U) ? 0 : ((31 - (int32_t)__CLZ(aCycles)) - (int32_t)OT_NOTIFICATION_HISTOGRAM_SHIFT);
+
+    if (bin < 0)
+    {
+        bin = 0;
+    }
+    else if (bin >= (int32_t)OT_NOTIFICATION_HISTOGRAM_BINS)
+    {
+        bin = (int32_t)OT_NOTIFICATION_HISTOGRAM_BINS - 1;
+    }
+    aSubscriber->mCount++;
+    aSubscriber->mCycles[bin]++;
+}
+#endif
+
+/**
+  * @brief  This function is used to manage all the callbacks used by the
+  *         OpenThread interface. These callbacks are used for example to
+  *         notify the application as soon as the state of a device has been
+  *         modified. The notification is given to the subscribers of its ID,
+  *         by order of priority.
+  *
+  *         Important Note: This function must be called each time a message
+  *         is sent from the M0 to the M4.
+  *
+  * @param  None
+  * @retval HAL_ERROR if the notification has no subscriber
+  */
+
+HAL_StatusTypeDef OpenThread_CallBack_Processing(void)
+{
+    HAL_StatusTypeDef status = HAL_ERROR;
+    OpenThread_NotificationSubscriber_t *subscriber;
+    OpenThread_NotificationSubscriber_t *pending;
+
+    /* Get pointer on received event buffer from M0 */
+    Thread_OT_Cmd_Request_t* p_notification = THREAD_Get_NotificationPayloadBuffer();
+
+    OpenThread_Notification_Init();
+
+    if (p_notification->ID < OT_NOTIFICATION_ID_COUNT)
+    {
+        notificationDispatchId = p_notification->ID;
+        for (subscriber = notificationSubscribers[p_notification->ID]; subscriber != NULL; subscriber = notificationDispatchNext)
         {
-            otUdpReceiveCb((void*) p_notification->Data[0],
-                    (otMessage*) p_notification->Data[1],
-                    (otMessageInfo*) p_notification->Data[2]);
+#if OPENTHREAD_NOTIFICATION_STATS
+            uint32_t start = DWT->CYCCNT;
+#endif
+            /* The handler may unsubscribe any subscriber, itself included */
+            notificationDispatchNext = subscriber->mNext;
+            subscriber->mHandler(p_notification, subscriber->mContext);
+#if OPENTHREAD_NOTIFICATION_STATS
+            OpenThread_Notification_Account(subscriber, DWT->CYCCNT - start);
+#else
+            subscriber->mCount++;
+#endif
+            status = HAL_OK;
         }
-        break;
-#if OPENTHREAD_ENABLE_JAM_DETECTION
-    case MSG_M0TOM4_JAM_DETECTION_CALLBACK:
-        if (otJamDetectionCallbackCb != NULL)
+        notificationDispatchNext = NULL;
+        notificationDispatchId = OT_NOTIFICATION_ID_COUNT;
+
+        /* In subscription order */
+        while (notificationPending != NULL)
         {
-            otJamDetectionCallbackCb((bool) p_notification->Data[0],
-                    (void *) p_notification->Data[1]);
+            pending = notificationPending;
+            notificationPending = pending->mNext;
+            OpenThread_Notification_Link(pending);
         }
-        break;
-#endif
-    default:
-        status = HAL_ERROR;
-        break;
     }
 
     TL_THREAD_SendAck();
@@ -55,6 +55,64 @@
 #include "dbg_trace.h"
 
 
+/* Notification dispatch -----------------------------------------------------*/
+#define OT_NOTIFICATION_ID_COUNT            ((uint32_t)MSG_M0TOM4_TRACE_SEND + 1U)
+
+/* Subscribers of a same notification ID are called by increasing priority
+ * value, the handlers of the OpenThread callbacks have the default one. */
+#define OT_NOTIFICATION_PRIORITY_DEFAULT    128U
+
+/* Dispatch time of each subscriber, measured with the DWT cycle counter */
+#ifndef OPENTHREAD_NOTIFICATION_STATS
+#define OPENTHREAD_NOTIFICATION_STATS       1
+#endif
+#define OT_NOTIFICATION_HISTOGRAM_BINS      8U
+#define OT_NOTIFICATION_HISTOGRAM_SHIFT     8U /* bin 1 starts at 512 cycles */
+
+typedef void (*OpenThread_NotificationHandler_t)(const Thread_OT_Cmd_Request_t *aNotification, void *aContext);
+
+/* Allocated by the application. mId, mHandler, mContext and mPriority are set
+ * before the subscription, mCount and mCycles can be read at any time. */
+typedef struct OpenThread_NotificationSubscriber
+{
+    struct OpenThread_NotificationSubscriber *mNext; /* internal use only */
+    OpenThread_NotificationHandler_t mHandler;
+    void *mContext;
+    uint8_t mId;        /* MsgId_M0toM4_Enum_t */
+    uint8_t mPriority;
+    uint32_t mCount;    /* number of calls */
+    uint32_t mCycles[OT_NOTIFICATION_HISTOGRAM_BINS]; /* calls by duration, log2 bins */
+} OpenThread_NotificationSubscriber_t;
+
+/**
+  * @brief  Adds a subscriber to the notifications of aSubscriber->mId. It can
+  *         be called from a handler, the subscriber is then called from the
+  *         next notification.
+  *
+  * @param  aSubscriber: the subscriber, it must stay valid while subscribed
+  * @retval HAL_ERROR if the parameters are invalid or already subscribed
+  */
+HAL_StatusTypeDef OpenThread_Notification_Subscribe(OpenThread_NotificationSubscriber_t *aSubscriber);
+
+/**
+  * @brief  Removes a subscriber. It can be called from a handler, for any
+  *         subscriber: a subscriber removed before its turn is not called.
+  *
+  * @param  aSubscriber: the subscriber
+  * @retval HAL_ERROR if the subscriber is not subscribed
+  */
+HAL_StatusTypeDef OpenThread_Notification_Unsubscribe(OpenThread_NotificationSubscriber_t *aSubscriber);
+
+/**
+  * @brief  Returns the first subscriber of a notification ID, the others
+  *         follow through mNext. Used to read the dispatch statistics.
+  *         The subscribers added by the handlers of a notification are
+  *         listed once its dispatch is over.
+  */
+const OpenThread_NotificationSubscriber_t *OpenThread_Notification_GetFirst(uint32_t aId);
+
+void OpenThread_Notification_ResetStats(void);
+
 /**
   * @brief  This function is used to manage all the callbacks used by the
   *         OpenThread interface. These callbacks are used for example to
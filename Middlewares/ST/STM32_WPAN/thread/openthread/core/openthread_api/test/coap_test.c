@@ -0,0 +1,406 @@
+/**
+ ******************************************************************************
+ * @file    coap_test.c
+ * @author  MCD Application Team
+ * @brief   Host test of the CoAP header built and parsed on the M4 in coap.c
+ *          (OPENTHREAD_COAP_HEADER_LOCAL): RFC 7252 encodings, size limits
+ *          and malformed headers.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stm32wbxx_hal.h"
+#include OPENTHREAD_CONFIG_FILE
+#include "coap.h"
+#include "ot_test_stub.h"
+
+#define TEST_ITERATIONS                     20000UL
+#define TEST_MAX_OPTIONS                    OT_COAP_HEADER_MAX_LENGTH
+#define TEST_VALUE_SIZE                     65535U
+
+typedef struct
+{
+    uint16_t       number;
+    uint16_t       length;
+    const uint8_t *value;
+} test_option_t;
+
+static uint8_t test_value[TEST_VALUE_SIZE];
+
+static void test_fail(const char *msg, unsigned long arg)
+{
+    printf("FAIL: %s (%lu)\n", msg, arg);
+    exit(1);
+}
+
+static void test_check_bytes(const char *msg, const otCoapHeader *header, const uint8_t *expected, unsigned int len)
+{
+    if ((header->mHeaderLength != len) || (memcmp(header->mHeader.mBytes, expected, len) != 0))
+    {
+        test_fail(msg, header->mHeaderLength);
+    }
+}
+
+/* The options of the header are the expected ones, then the parsing stops */
+static void test_check_options(const char *msg, otCoapHeader *header, const test_option_t *expected, unsigned int nbr)
+{
+    const otCoapOption *option;
+    unsigned int i;
+
+    option = otCoapHeaderGetFirstOption(header);
+    for (i = 0U; i < nbr; i++)
+    {
+        if ((option == NULL) || (option->mNumber != expected[i].number) || (option->mLength != expected[i].length)
+            || ((expected[i].length != 0U) && (memcmp(option->mValue, expected[i].value, expected[i].length) != 0)))
+        {
+            test_fail(msg, i);
+        }
+        option = otCoapHeaderGetNextOption(header);
+    }
+    if (option != NULL)
+    {
+        test_fail(msg, nbr);
+    }
+}
+
+/* Reference encoding of an option, RFC 7252 section 3.1 */
+static unsigned int test_ext_encode(uint8_t *ext, unsigned int *ext_len, unsigned int value)
+{
+    if (value < 13U)
+    {
+        return value;
+    }
+    if (value < 269U)
+    {
+        ext[(*ext_len)++] = (uint8_t)(value - 13U);
+        return 13U;
+    }
+    ext[(*ext_len)++] = (uint8_t)((value - 269U) >> 8);
+    ext[(*ext_len)++] = (uint8_t)(value - 269U);
+    return 14U;
+}
+
+static unsigned int test_option_encode(uint8_t *out, unsigned int delta, const test_option_t *option)
+{
+    uint8_t ext[4];
+    unsigned int ext_len = 0U, nibbles;
+
+    nibbles = test_ext_encode(ext, &ext_len, delta) << 4;
+    nibbles |= test_ext_encode(ext, &ext_len, option->length);
+    out[0] = (uint8_t)nibbles;
+    memcpy(&out[1], ext, ext_len);
+    if (option->length != 0U)
+    {
+        memcpy(&out[1 + ext_len], option->value, option->length);
+    }
+    return 1U + ext_len + option->length;
+}
+
+/* Encodings worked out from RFC 7252 sections 3 and 3.1 */
+static void test_coap_vectors(void)
+{
+    static const uint8_t get[] = {
+        0x40, 0x01, 0x7d, 0x34, 0xbb, 't', 'e', 'm', 'p', 'e', 'r', 'a', 't', 'u', 'r', 'e'
+    };
+    static const uint8_t post[] = {
+        0x54, 0x02, 0xbe, 0xef, 0x01, 0x02, 0x03, 0x04,
+        0x63, 0x34, 0x56, 0x78,         /* Observe 0x12345678, on 24 bits */
+        0x51, 'a', 0x01, 'b',           /* Uri-Path a/b */
+        0x11, 0x32,                     /* Content-Format 50 (json) */
+        0x20,                           /* Max-Age 0, empty */
+        0x13, 'q', '=', '1',            /* Uri-Query */
+        0xff
+    };
+    static const uint8_t ext[] = {
+        0x60, 0x45, 0x00, 0x01,
+        0x1d, 0x00, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13,             /* 1, length 13 */
+        0xd0, 0x00,                                                         /* 14, delta 13 */
+        0xe0, 0x00, 0x00,                                                   /* 283, delta 269 */
+        0xed, 0x00, 0x1f, 0x07,                                             /* 583, delta 300, length 20 */
+        1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20
+    };
+    static const uint8_t token[] = { 0x01, 0x02, 0x03, 0x04 };
+    static const uint8_t bytes[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20 };
+    static const uint8_t observe[] = { 0x34, 0x56, 0x78 };
+    static const uint8_t json[] = { 0x32 };
+    const test_option_t get_options[] = { { OT_COAP_OPTION_URI_PATH, 11U, &get[5] } };
+    const test_option_t post_options[] = {
+        { OT_COAP_OPTION_OBSERVE, 3U, observe },
+        { OT_COAP_OPTION_URI_PATH, 1U, (const uint8_t *)"a" },
+        { OT_COAP_OPTION_URI_PATH, 1U, (const uint8_t *)"b" },
+        { OT_COAP_OPTION_CONTENT_FORMAT, 1U, json },
+        { OT_COAP_OPTION_MAX_AGE, 0U, NULL },
+        { OT_COAP_OPTION_URI_QUERY, 3U, (const uint8_t *)"q=1" }
+    };
+    const test_option_t ext_options[] = {
+        { 1U, 13U, bytes },
+        { 14U, 0U, NULL },
+        { 283U, 0U, NULL },
+        { 583U, 20U, bytes }
+    };
+    otCoapHeader header;
+    otCoapOption option;
+    unsigned int i;
+
+    /* CON GET /temperature, message ID 0x7d34 */
+    otCoapHeaderInit(&header, OT_COAP_TYPE_CONFIRMABLE, OT_COAP_CODE_GET);
+    otCoapHeaderSetMessageId(&header, 0x7d34U);
+    if (otCoapHeaderAppendUriPathOptions(&header, "temperature") != OT_ERROR_NONE)
+    {
+        test_fail("GET vector, Uri-Path", 0U);
+    }
+    test_check_bytes("GET vector", &header, get, sizeof(get));
+    if ((otCoapHeaderGetType(&header) != OT_COAP_TYPE_CONFIRMABLE) || (otCoapHeaderGetCode(&header) != OT_COAP_CODE_GET)
+        || (otCoapHeaderGetMessageId(&header) != 0x7d34U) || (otCoapHeaderGetTokenLength(&header) != 0U))
+    {
+        test_fail("GET vector, fields", 0U);
+    }
+    test_check_options("GET vector, options", &header, get_options, 1U);
+
+    /* NON POST with a token and the uint options, then the payload marker */
+    otCoapHeaderInit(&header, OT_COAP_TYPE_NON_CONFIRMABLE, OT_COAP_CODE_POST);
+    otCoapHeaderSetMessageId(&header, 0xbeefU);
+    otCoapHeaderSetToken(&header, token, sizeof(token));
+    if ((otCoapHeaderAppendObserveOption(&header, 0x12345678UL) != OT_ERROR_NONE)
+        || (otCoapHeaderAppendUriPathOptions(&header, "a/b") != OT_ERROR_NONE)
+        || (otCoapHeaderAppendContentFormatOption(&header, OT_COAP_OPTION_CONTENT_FORMAT_JSON) != OT_ERROR_NONE)
+        || (otCoapHeaderAppendMaxAgeOption(&header, 0U) != OT_ERROR_NONE)
+        || (otCoapHeaderAppendUriQueryOption(&header, "q=1") != OT_ERROR_NONE)
+        || (otCoapHeaderSetPayloadMarker(&header) != OT_ERROR_NONE))
+    {
+        test_fail("POST vector, append", 0U);
+    }
+    test_check_bytes("POST vector", &header, post, sizeof(post));
+    if ((otCoapHeaderGetType(&header) != OT_COAP_TYPE_NON_CONFIRMABLE) || (otCoapHeaderGetCode(&header) != OT_COAP_CODE_POST)
+        || (otCoapHeaderGetMessageId(&header) != 0xbeefU) || (otCoapHeaderGetTokenLength(&header) != sizeof(token))
+        || (memcmp(otCoapHeaderGetToken(&header), token, sizeof(token)) != 0))
+    {
+        test_fail("POST vector, fields", 0U);
+    }
+    /* The parsing stops at the payload marker */
+    test_check_options("POST vector, options", &header, post_options, 6U);
+
+    /* Extended option deltas and lengths, on 1 and 2 bytes */
+    otCoapHeaderInit(&header, OT_COAP_TYPE_ACKNOWLEDGMENT, OT_COAP_CODE_CONTENT);
+    otCoapHeaderSetMessageId(&header, 1U);
+    for (i = 0U; i < 4U; i++)
+    {
+        option.mNumber = ext_options[i].number;
+        option.mLength = ext_options[i].length;
+        option.mValue = ext_options[i].value;
+        if (otCoapHeaderAppendOption(&header, &option) != OT_ERROR_NONE)
+        {
+            test_fail("extended vector, append", i);
+        }
+    }
+    test_check_bytes("extended vector", &header, ext, sizeof(ext));
+    test_check_options("extended vector, options", &header, ext_options, 4U);
+}
+
+static void test_coap_limits(void)
+{
+    static const uint16_t lengths[] = { 256U, 300U, 65530U, 65533U, 65534U, 65535U };
+    otCoapHeader header, saved;
+    otCoapOption option;
+    unsigned int i;
+
+    /* The header is at most OT_COAP_HEADER_MAX_LENGTH - 1 bytes before the
+     * payload marker: 4 + 2 + 121 bytes fit, not 4 + 2 + 122 */
+    option.mNumber = OT_COAP_OPTION_URI_PATH;
+    option.mValue = test_value;
+    for (i = 121U; i <= 122U; i++)
+    {
+        otCoapHeaderInit(&header, OT_COAP_TYPE_CONFIRMABLE, OT_COAP_CODE_PUT);
+        saved = header;
+        option.mLength = (uint16_t)i;
+        if (otCoapHeaderAppendOption(&header, &option) != ((i == 121U) ? OT_ERROR_NONE : OT_ERROR_NO_BUFS))
+        {
+            test_fail("header size limit", i);
+        }
+    }
+    otCoapHeaderInit(&header, OT_COAP_TYPE_CONFIRMABLE, OT_COAP_CODE_PUT);
+    option.mLength = 121U;
+    (void)otCoapHeaderAppendOption(&header, &option);
+    if ((otCoapHeaderSetPayloadMarker(&header) != OT_ERROR_NONE)
+        || (otCoapHeaderSetPayloadMarker(&header) != OT_ERROR_NO_BUFS) || (header.mHeaderLength != OT_COAP_HEADER_MAX_LENGTH))
+    {
+        test_fail("payload marker at the size limit", header.mHeaderLength);
+    }
+
+    /* Option values too long for the header, including the lengths whose
+     * encoded size does not fit on 16 bits: the header is not changed */
+    for (i = 0U; i < (sizeof(lengths) / sizeof(lengths[0])); i++)
+    {
+        otCoapHeaderInit(&header, OT_COAP_TYPE_CONFIRMABLE, OT_COAP_CODE_PUT);
+        otCoapHeaderSetToken(&header, test_value, 2U);
+        saved = header;
+        option.mNumber = OT_COAP_OPTION_PROXY_URI;
+        option.mLength = lengths[i];
+        if ((otCoapHeaderAppendOption(&header, &option) != OT_ERROR_NO_BUFS) || (memcmp(&header, &saved, sizeof(header)) != 0))
+        {
+            test_fail("long option value", lengths[i]);
+        }
+    }
+
+    /* Options out of order */
+    otCoapHeaderInit(&header, OT_COAP_TYPE_CONFIRMABLE, OT_COAP_CODE_PUT);
+    (void)otCoapHeaderAppendUriPathOptions(&header, "a");
+    saved = header;
+    if ((otCoapHeaderAppendObserveOption(&header, 1U) != OT_ERROR_INVALID_ARGS) || (memcmp(&header, &saved, sizeof(header)) != 0))
+    {
+        test_fail("option out of order", 0U);
+    }
+
+    /* Tokens are at most OT_COAP_MAX_TOKEN_LENGTH bytes */
+    otCoapHeaderInit(&header, OT_COAP_TYPE_CONFIRMABLE, OT_COAP_CODE_PUT);
+    otCoapHeaderSetToken(&header, test_value, 15U);
+    if ((otCoapHeaderGetTokenLength(&header) != OT_COAP_MAX_TOKEN_LENGTH)
+        || (header.mHeaderLength != (4U + OT_COAP_MAX_TOKEN_LENGTH)))
+    {
+        test_fail("token length", otCoapHeaderGetTokenLength(&header));
+    }
+}
+
+/* Headers received with reserved nibbles or truncated options */
+static void test_coap_malformed(void)
+{
+    static const struct
+    {
+        uint8_t      bytes[12];
+        uint8_t      length;
+        unsigned int options; /* Options parsed before the error */
+    } headers[] = {
+        { { 0x40, 0x01, 0x00, 0x01, 0xf0 }, 5U, 0U },                         /* Reserved delta */
+        { { 0x40, 0x01, 0x00, 0x01, 0x0f }, 5U, 0U },                         /* Reserved length */
+        { { 0x40, 0x01, 0x00, 0x01, 0x10, 0xd0 }, 6U, 1U },                   /* Missing 1 byte delta */
+        { { 0x40, 0x01, 0x00, 0x01, 0xe0, 0x00 }, 6U, 0U },                   /* Missing 2 byte delta */
+        { { 0x40, 0x01, 0x00, 0x01, 0x0e, 0x00 }, 6U, 0U },                   /* Missing 2 byte length */
+        { { 0x40, 0x01, 0x00, 0x01, 0x13, 'a', 'b' }, 7U, 0U },               /* Value past the end */
+        { { 0x40, 0x01, 0x00, 0x01, 0x0d, 0x00, 'a', 'b' }, 8U, 0U },         /* Value past the end */
+        { { 0x42, 0x01, 0x00, 0x01, 0xaa, 0xbb, 0x11, 'a', 0xff, 0x11 }, 10U, 1U } /* Payload */
+    };
+    otCoapHeader header;
+    const otCoapOption *option;
+    unsigned int i, nbr;
+
+    for (i = 0U; i < (sizeof(headers) / sizeof(headers[0])); i++)
+    {
+        memset(&header, 0, sizeof(header));
+        memcpy(header.mHeader.mBytes, headers[i].bytes, headers[i].length);
+        header.mHeaderLength = headers[i].length;
+        nbr = 0U;
+        for (option = otCoapHeaderGetFirstOption(&header); option != NULL; option = otCoapHeaderGetNextOption(&header))
+        {
+            if ((option->mValue + option->mLength) > &header.mHeader.mBytes[header.mHeaderLength])
+            {
+                test_fail("option past the end of the header", i);
+            }
+            nbr++;
+        }
+        if (nbr != headers[i].options)
+        {
+            test_fail("malformed header", i);
+        }
+    }
+}
+
+/* Random headers, checked against the reference encoding, then parsed back */
+static void test_coap_random(void)
+{
+    static test_option_t options[TEST_MAX_OPTIONS];
+    uint8_t expected[OT_COAP_HEADER_MAX_LENGTH + 320U]; /* With the option not appended */
+    unsigned int nbr, len, size;
+    uint16_t number;
+    unsigned long it;
+    otCoapHeader header, saved;
+    otCoapOption option;
+    otError error;
+
+    for (it = 0UL; it < TEST_ITERATIONS; it++)
+    {
+        otCoapHeaderInit(&header, OT_COAP_TYPE_CONFIRMABLE, OT_COAP_CODE_POST);
+        otCoapHeaderSetMessageId(&header, (uint16_t)it);
+        len = (unsigned int)rand() % (OT_COAP_MAX_TOKEN_LENGTH + 1U);
+        otCoapHeaderSetToken(&header, test_value, (uint8_t)len);
+        memcpy(expected, header.mHeader.mBytes, header.mHeaderLength);
+        len = header.mHeaderLength;
+        number = 0U;
+        for (nbr = 0U; nbr < TEST_MAX_OPTIONS; nbr++)
+        {
+            switch (rand() % 4)
+            {
+                case 0:
+                    break;
+                case 1:
+                    number += (uint16_t)(rand() % 13);
+                    break;
+                case 2:
+                    number += (uint16_t)(10 + (rand() % 260));
+                    break;
+                default:
+                    number += (uint16_t)(260 + (rand() % 800));
+                    break;
+            }
+            options[nbr].number = number;
+            options[nbr].length = (uint16_t)(((rand() % 8) == 0) ? (rand() % 300) : (rand() % 20));
+            options[nbr].value = &test_value[rand() % 1000];
+            size = test_option_encode(&expected[len], number - ((nbr == 0U) ? 0U : options[nbr - 1U].number), &options[nbr]);
+
+            option.mNumber = options[nbr].number;
+            option.mLength = options[nbr].length;
+            option.mValue = options[nbr].value;
+            saved = header;
+            error = otCoapHeaderAppendOption(&header, &option);
+            if ((len + size) < OT_COAP_HEADER_MAX_LENGTH)
+            {
+                if (error != OT_ERROR_NONE)
+                {
+                    test_fail("random option not appended", it);
+                }
+                len += size;
+            }
+            else
+            {
+                if ((error != OT_ERROR_NO_BUFS) || (memcmp(&header, &saved, sizeof(header)) != 0))
+                {
+                    test_fail("random option too long", it);
+                }
+                break;
+            }
+        }
+        test_check_bytes("random header", &header, expected, len);
+        test_check_options("random header, options", &header, options, nbr);
+    }
+}
+
+int main(void)
+{
+    unsigned int i;
+
+    srand(1);
+    for (i = 0U; i < TEST_VALUE_SIZE; i++)
+    {
+        test_value[i] = (uint8_t)rand();
+    }
+    test_coap_vectors();
+    test_coap_limits();
+    test_coap_malformed();
+    test_coap_random();
+    printf("PASS: CoAP header, %lu random headers\n", TEST_ITERATIONS);
+    return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,340 @@
+/**
+ ******************************************************************************
+ * @file    message_test.c
+ * @author  MCD Application Team
+ * @brief   Host test of the vectored message append and read of message.c,
+ *          against a model of the M0 messages, and count of the transfers
+ *          per KB moved (make bench).
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stm32wbxx_hal.h"
+#include OPENTHREAD_CONFIG_FILE
+#include "message.h"
+#include "ot_test_stub.h"
+
+#define TEST_ITERATIONS                     20000UL
+#define TEST_MESSAGE_SIZE                   1280U
+#define TEST_FRAGMENT_NBR                   40U
+#define TEST_FRAGMENT_SPACE                 4096U
+#define TEST_SENTINEL                       0xa5U
+
+/* Bounce buffer size of message.c */
+#ifndef OT_MESSAGE_VECTOR_BUF_SIZE
+#define OT_MESSAGE_VECTOR_BUF_SIZE          256U
+#endif
+
+/* Message of the M0: the M4 only sees its address */
+typedef struct
+{
+    uint8_t  data[TEST_MESSAGE_SIZE];
+    uint16_t length;
+    uint16_t capacity; /* Appends beyond fail with OT_ERROR_NO_BUFS */
+} test_message_t;
+
+static test_message_t test_message;
+static unsigned long test_appends, test_reads;
+
+/* Fragments and their copy, static to be addressed on 32 bits */
+static uint8_t test_space[TEST_FRAGMENT_SPACE];
+static uint8_t test_expected[TEST_MESSAGE_SIZE + TEST_FRAGMENT_SPACE];
+static otMessageIoVec test_iovec[TEST_FRAGMENT_NBR];
+
+static void test_fail(const char *msg, unsigned long arg)
+{
+    printf("FAIL: %s (%lu)\n", msg, arg);
+    exit(1);
+}
+
+static test_message_t * test_m0_message(uint32_t value)
+{
+    if ((test_message_t *)ot_test_ptr(value) != &test_message)
+    {
+        test_fail("unknown message", value);
+    }
+    return &test_message;
+}
+
+static void test_m0_cmd(const Thread_OT_Cmd_Request_t *req, Thread_OT_Cmd_Request_t *rsp)
+{
+    test_message_t *msg;
+    uint32_t offset, length;
+
+    switch (req->ID)
+    {
+    case MSG_M4TOM0_OT_MESSAGE_GET_LENGTH:
+        msg = test_m0_message(req->Data[0]);
+        rsp->Data[0] = msg->length;
+        break;
+
+    case MSG_M4TOM0_OT_MESSAGE_SET_LENGTH:
+        msg = test_m0_message(req->Data[0]);
+        if (req->Data[1] > msg->capacity)
+        {
+            rsp->Data[0] = OT_ERROR_NO_BUFS;
+            break;
+        }
+        msg->length = (uint16_t)req->Data[1];
+        rsp->Data[0] = OT_ERROR_NONE;
+        break;
+
+    case MSG_M4TOM0_OT_MESSAGE_APPEND:
+        msg = test_m0_message(req->Data[0]);
+        length = req->Data[2];
+        test_appends++;
+        if ((msg->length + length) > msg->capacity)
+        {
+            rsp->Data[0] = OT_ERROR_NO_BUFS;
+            break;
+        }
+        memcpy(&msg->data[msg->length], ot_test_ptr(req->Data[1]), length);
+        msg->length += (uint16_t)length;
+        rsp->Data[0] = OT_ERROR_NONE;
+        break;
+
+    case MSG_M4TOM0_OT_MESSAGE_READ:
+        msg = test_m0_message(req->Data[0]);
+        offset = req->Data[1];
+        length = req->Data[3];
+        test_reads++;
+        if (offset >= msg->length)
+        {
+            length = 0U;
+        }
+        else if (length > (msg->length - offset))
+        {
+            length = msg->length - offset;
+        }
+        if (length != 0U)
+        {
+            memcpy(ot_test_ptr(req->Data[2]), &msg->data[offset], length);
+        }
+        rsp->Data[0] = length;
+        break;
+
+    default:
+        test_fail("unexpected command", req->ID);
+        break;
+    }
+}
+
+/* Random fragments: mostly small, some around and above the bounce buffer
+ * size, some empty */
+static uint8_t test_random_iovec(uint32_t *total)
+{
+    uint32_t used = 0U;
+    uint16_t length;
+    uint8_t count, i;
+
+    count = (uint8_t)(rand() % (TEST_FRAGMENT_NBR + 1U));
+    for (i = 0U; i < count; i++)
+    {
+        switch (rand() % 8)
+        {
+        case 0:
+            length = 0U;
+            break;
+        case 1:
+            length = (uint16_t)(OT_MESSAGE_VECTOR_BUF_SIZE - 2U + (rand() % 5));
+            break;
+        case 2:
+            length = (uint16_t)(rand() % (3U * OT_MESSAGE_VECTOR_BUF_SIZE));
+            break;
+        default:
+            length = (uint16_t)(rand() % 40);
+            break;
+        }
+        if ((used + length) > TEST_FRAGMENT_SPACE)
+        {
+            break;
+        }
+        test_iovec[i].mBuf = &test_space[used];
+        test_iovec[i].mLength = length;
+        used += length;
+    }
+    *total = used;
+    return i;
+}
+
+static void test_message_append(void)
+{
+    unsigned long it;
+    uint32_t total, i;
+    uint16_t length;
+    uint8_t count;
+    otError error;
+
+    for (it = 0UL; it < TEST_ITERATIONS; it++)
+    {
+        /* Message with some data, and room for about half of the appends */
+        test_message.length = (uint16_t)(rand() % 200);
+        test_message.capacity = (uint16_t)(test_message.length + (rand() % (TEST_MESSAGE_SIZE - 200U)));
+        for (i = 0U; i < test_message.length; i++)
+        {
+            test_message.data[i] = (uint8_t)rand();
+        }
+        for (i = 0U; i < TEST_FRAGMENT_SPACE; i++)
+        {
+            test_space[i] = (uint8_t)rand();
+        }
+        count = test_random_iovec(&total);
+        length = test_message.length;
+        memcpy(test_expected, test_message.data, length);
+        memcpy(&test_expected[length], test_space, total);
+
+        error = otMessageAppendVector((otMessage *)&test_message, test_iovec, count);
+        if ((length + total) <= test_message.capacity)
+        {
+            if ((error != OT_ERROR_NONE) || (test_message.length != (length + total)))
+            {
+                test_fail("vector not appended", it);
+            }
+        }
+        else if ((error != OT_ERROR_NO_BUFS) || (test_message.length != length))
+        {
+            test_fail("message changed by a failed append", it);
+        }
+        if (memcmp(test_message.data, test_expected, test_message.length) != 0)
+        {
+            test_fail("appended data", it);
+        }
+    }
+}
+
+static void test_message_read(void)
+{
+    unsigned long it;
+    uint32_t total, i, expected;
+    uint16_t offset;
+    uint8_t count;
+    int read;
+
+    for (it = 0UL; it < TEST_ITERATIONS; it++)
+    {
+        test_message.length = (uint16_t)(rand() % TEST_MESSAGE_SIZE);
+        test_message.capacity = TEST_MESSAGE_SIZE;
+        for (i = 0U; i < test_message.length; i++)
+        {
+            test_message.data[i] = (uint8_t)rand();
+        }
+        offset = (uint16_t)(rand() % (test_message.length + 10U));
+        count = test_random_iovec(&total);
+        memset(test_space, TEST_SENTINEL, sizeof(test_space));
+
+        expected = (offset >= test_message.length) ? 0U : (uint32_t)(test_message.length - offset);
+        if (expected > total)
+        {
+            expected = total;
+        }
+        read = otMessageReadVector((otMessage *)&test_message, offset, test_iovec, count);
+        if (read != (int)expected)
+        {
+            test_fail("bytes read", it);
+        }
+        /* The fragments are contiguous in test_space: the bytes read, then
+         * nothing written past them */
+        if ((expected != 0U) && (memcmp(test_space, &test_message.data[offset], expected) != 0))
+        {
+            test_fail("data read", it);
+        }
+        for (i = expected; i < total; i++)
+        {
+            if (test_space[i] != TEST_SENTINEL)
+            {
+                test_fail("fragment written past the message", it);
+            }
+        }
+    }
+}
+
+/* Transfers per KB moved for fragments of 1 to max_length bytes, with the
+ * vectored functions and with one call per fragment */
+static void test_message_bench(uint16_t max_length)
+{
+    unsigned long it, bytes = 0UL, vector = 0UL, single = 0UL, start;
+    uint16_t offset;
+    uint8_t count, i;
+
+    for (it = 0UL; it < 2000UL; it++)
+    {
+        count = (uint8_t)(4 + (rand() % 12));
+        offset = 0U;
+        for (i = 0U; i < count; i++)
+        {
+            test_iovec[i].mBuf = &test_space[offset];
+            test_iovec[i].mLength = (uint16_t)(1 + (rand() % max_length));
+            if ((offset + test_iovec[i].mLength) > TEST_MESSAGE_SIZE)
+            {
+                break;
+            }
+            offset += test_iovec[i].mLength;
+        }
+        count = i;
+        bytes += 2UL * offset;
+
+        test_message.length = 0U;
+        test_message.capacity = TEST_MESSAGE_SIZE;
+        start = ot_test_m0_cmd_count;
+        (void)otMessageAppendVector((otMessage *)&test_message, test_iovec, count);
+        (void)otMessageReadVector((otMessage *)&test_message, 0U, test_iovec, count);
+        vector += ot_test_m0_cmd_count - start;
+
+        test_message.length = 0U;
+        start = ot_test_m0_cmd_count;
+        for (i = 0U; i < count; i++)
+        {
+            (void)otMessageAppend((otMessage *)&test_message, test_iovec[i].mBuf, test_iovec[i].mLength);
+        }
+        offset = 0U;
+        for (i = 0U; i < count; i++)
+        {
+            offset += (uint16_t)otMessageRead((otMessage *)&test_message, offset, test_iovec[i].mBuf, test_iovec[i].mLength);
+        }
+        single += ot_test_m0_cmd_count - start;
+    }
+    /* At most one more transfer per append, to get the message length */
+    if (vector > (single + it))
+    {
+        test_fail("more transfers with the vectored functions", vector);
+    }
+    printf("fragments of 1 to %3u bytes: %5.1f transfers/KB vectored, %5.1f transfers/KB one call per fragment\n",
+           max_length, (vector * 1024.0) / bytes, (single * 1024.0) / bytes);
+}
+
+int main(int argc, char *argv[])
+{
+    srand(1);
+    ot_test_m0_cmd = test_m0_cmd;
+    test_message_append();
+    test_message_read();
+    if ((test_appends == 0UL) || (test_reads == 0UL))
+    {
+        test_fail("no transfer", 0U);
+    }
+    test_message_bench(16U);
+    test_message_bench(64U);
+    if ((argc > 1) && (strcmp(argv[1], "bench") == 0))
+    {
+        test_message_bench(8U);
+        test_message_bench(128U);
+        test_message_bench(512U);
+    }
+    printf("PASS: vectored message append and read, bounce buffer of %u bytes\n", (unsigned int)OT_MESSAGE_VECTOR_BUF_SIZE);
+    return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
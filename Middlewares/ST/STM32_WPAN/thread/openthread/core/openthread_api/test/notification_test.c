@@ -0,0 +1,347 @@
+/**
+ ******************************************************************************
+ * @file    notification_test.c
+ * @author  MCD Application Team
+ * @brief   Host test of the notification dispatch of openthread_api_wb.c:
+ *          random notification sequences, with handlers that subscribe and
+ *          unsubscribe, replayed against a model of the documented order.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "openthread_api_wb.h"
+#include "ot_test_stub.h"
+
+#define TEST_SUBSCRIBER_NBR                 24U
+#define TEST_ID_NBR                         3U
+#define TEST_NOTIFICATIONS                  300000UL
+#define TEST_BUILTIN                        TEST_SUBSCRIBER_NBR /* Index of the built-in subscriber */
+
+/* Notification IDs of the test: one with the built-in handler of the state
+ * changes, two without built-in handler */
+static const uint8_t test_ids[TEST_ID_NBR] = {
+    MSG_M0TOM4_NOTIFY_STATE_CHANGE, MSG_M0TOM4_TMF_PROXY_STREAM_HANDLER, MSG_M0TOM4_COMMISSIONER_PANID_CONFLICT_CALLBACK
+};
+static const uint8_t test_priorities[] = { 0U, 100U, OT_NOTIFICATION_PRIORITY_DEFAULT, 200U, 255U };
+
+/* Model of a subscriber */
+typedef struct
+{
+    bool     subscribed;
+    bool     removed;   /* Unsubscribed during the current dispatch */
+    uint32_t seq;       /* Subscription order, for the same priority */
+    uint32_t count;     /* Expected mCount */
+} test_model_t;
+
+static OpenThread_NotificationSubscriber_t test_subscribers[TEST_SUBSCRIBER_NBR];
+static uint32_t test_indexes[TEST_SUBSCRIBER_NBR];
+static test_model_t test_model[TEST_SUBSCRIBER_NBR + 1U];
+static uint32_t test_seq;
+
+/* Subscribers of the notification being dispatched, in the expected order */
+static uint32_t test_dispatch[TEST_SUBSCRIBER_NBR + 1U];
+static uint32_t test_dispatch_nbr, test_dispatch_pos;
+static bool test_dispatching;
+static const OpenThread_NotificationSubscriber_t *test_builtin;
+static unsigned long test_calls, test_handler_subscribes, test_handler_unsubscribes;
+
+static void test_fail(const char *msg, unsigned long arg)
+{
+    printf("FAIL: %s (%lu)\n", msg, arg);
+    exit(1);
+}
+
+static uint8_t test_model_id(uint32_t k)
+{
+    return (k == TEST_BUILTIN) ? (uint8_t)MSG_M0TOM4_NOTIFY_STATE_CHANGE : test_subscribers[k].mId;
+}
+
+static uint8_t test_model_priority(uint32_t k)
+{
+    return (k == TEST_BUILTIN) ? (uint8_t)OT_NOTIFICATION_PRIORITY_DEFAULT : test_subscribers[k].mPriority;
+}
+
+/* Subscribers of an ID in the model, by priority then subscription order */
+static uint32_t test_model_list(uint8_t id, uint32_t *list)
+{
+    uint32_t k, i, nbr = 0U;
+
+    for (k = 0U; k <= TEST_SUBSCRIBER_NBR; k++)
+    {
+        if (!test_model[k].subscribed || (test_model_id(k) != id))
+        {
+            continue;
+        }
+        for (i = nbr; i > 0U; i--)
+        {
+            uint32_t prev = list[i - 1U];
+
+            if ((test_model_priority(prev) < test_model_priority(k))
+                || ((test_model_priority(prev) == test_model_priority(k)) && (test_model[prev].seq < test_model[k].seq)))
+            {
+                break;
+            }
+            list[i] = prev;
+        }
+        list[i] = k;
+        nbr++;
+    }
+    return nbr;
+}
+
+/* Next subscriber the dispatch must call: subscribed when the dispatch
+ * started, and not unsubscribed since */
+static uint32_t test_dispatch_next(void)
+{
+    while (test_dispatch_pos < test_dispatch_nbr)
+    {
+        uint32_t k = test_dispatch[test_dispatch_pos++];
+
+        if (test_model[k].subscribed && !test_model[k].removed)
+        {
+            if (k != TEST_BUILTIN)
+            {
+                return k;
+            }
+            /* The built-in handler is not seen, only its count */
+            test_model[k].count++;
+        }
+    }
+    return TEST_SUBSCRIBER_NBR + 1U;
+}
+
+static void test_subscribe(uint32_t k)
+{
+    HAL_StatusTypeDef status = OpenThread_Notification_Subscribe(&test_subscribers[k]);
+
+    if (status != (test_model[k].subscribed ? HAL_ERROR : HAL_OK))
+    {
+        test_fail("subscribe status", k);
+    }
+    if (status == HAL_OK)
+    {
+        test_model[k].subscribed = true;
+        test_model[k].seq = ++test_seq;
+        test_model[k].count = 0U;
+        test_subscribers[k].mCount = 0U;
+    }
+}
+
+static void test_unsubscribe(uint32_t k)
+{
+    HAL_StatusTypeDef status = OpenThread_Notification_Unsubscribe(&test_subscribers[k]);
+
+    if (status != (test_model[k].subscribed ? HAL_OK : HAL_ERROR))
+    {
+        test_fail("unsubscribe status", k);
+    }
+    if (test_model[k].subscribed && test_dispatching)
+    {
+        test_model[k].removed = true;
+    }
+    test_model[k].subscribed = false;
+}
+
+/* A subscriber not subscribed gets a new ID and priority */
+static void test_change(uint32_t k)
+{
+    if (!test_model[k].subscribed)
+    {
+        test_subscribers[k].mId = test_ids[(uint32_t)rand() % TEST_ID_NBR];
+        test_subscribers[k].mPriority = test_priorities[(uint32_t)rand() % sizeof(test_priorities)];
+    }
+}
+
+static void test_handler(const Thread_OT_Cmd_Request_t *aNotification, void *aContext)
+{
+    uint32_t k = *(uint32_t *)aContext;
+    uint32_t other;
+
+    if ((aNotification != &ot_test_notif_buffer) || !test_dispatching)
+    {
+        test_fail("handler called out of a dispatch", k);
+    }
+    if (test_dispatch_next() != k)
+    {
+        test_fail("subscriber called out of order", k);
+    }
+    test_model[k].count++;
+    test_calls++;
+
+    /* Subscribe or unsubscribe any subscriber, this one included */
+    other = (uint32_t)rand() % TEST_SUBSCRIBER_NBR;
+    switch (rand() % 8)
+    {
+    case 0:
+        test_unsubscribe(((rand() % 4) == 0) ? k : other);
+        test_handler_unsubscribes++;
+        break;
+    case 1:
+    case 2:
+        test_change(other);
+        test_subscribe(other);
+        test_handler_subscribes++;
+        break;
+    default:
+        break;
+    }
+}
+
+/* The lists of the dispatcher are the ones of the model */
+static void test_check_lists(void)
+{
+    const OpenThread_NotificationSubscriber_t *subscriber;
+    uint32_t list[TEST_SUBSCRIBER_NBR + 1U];
+    uint32_t i, j, nbr;
+
+    for (i = 0U; i < TEST_ID_NBR; i++)
+    {
+        nbr = test_model_list(test_ids[i], list);
+        subscriber = OpenThread_Notification_GetFirst(test_ids[i]);
+        for (j = 0U; j < nbr; j++)
+        {
+            if (subscriber != ((list[j] == TEST_BUILTIN) ? test_builtin : &test_subscribers[list[j]]))
+            {
+                test_fail("subscriber list", test_ids[i]);
+            }
+            if (subscriber->mCount != test_model[list[j]].count)
+            {
+                test_fail("subscriber count", list[j]);
+            }
+            subscriber = subscriber->mNext;
+        }
+        if (subscriber != NULL)
+        {
+            test_fail("subscriber list end", test_ids[i]);
+        }
+    }
+}
+
+static void test_notify(uint8_t id)
+{
+    unsigned long acks = ot_test_notif_ack_count;
+    HAL_StatusTypeDef status;
+    uint32_t k;
+
+    for (k = 0U; k <= TEST_SUBSCRIBER_NBR; k++)
+    {
+        test_model[k].removed = false;
+    }
+    test_dispatch_nbr = test_model_list(id, test_dispatch);
+    test_dispatch_pos = 0U;
+    test_dispatching = true;
+
+    memset(&ot_test_notif_buffer, 0, sizeof(ot_test_notif_buffer));
+    ot_test_notif_buffer.ID = id;
+    status = OpenThread_CallBack_Processing();
+
+    test_dispatching = false;
+    if (test_dispatch_next() != (TEST_SUBSCRIBER_NBR + 1U))
+    {
+        test_fail("subscriber not called", id);
+    }
+    if (status != ((test_dispatch_nbr != 0U) ? HAL_OK : HAL_ERROR))
+    {
+        test_fail("dispatch status", id);
+    }
+    if (ot_test_notif_ack_count != (acks + 1U))
+    {
+        test_fail("notification not acknowledged", id);
+    }
+}
+
+/* Invalid subscriptions and notifications */
+static void test_invalid(void)
+{
+    OpenThread_NotificationSubscriber_t subscriber;
+    unsigned long acks = ot_test_notif_ack_count;
+
+    memset(&subscriber, 0, sizeof(subscriber));
+    subscriber.mId = MSG_M0TOM4_TRACE_SEND;
+    if ((OpenThread_Notification_Subscribe(NULL) != HAL_ERROR)
+        || (OpenThread_Notification_Subscribe(&subscriber) != HAL_ERROR)
+        || (OpenThread_Notification_Unsubscribe(&subscriber) != HAL_ERROR))
+    {
+        test_fail("subscriber without handler", 0U);
+    }
+    subscriber.mHandler = test_handler;
+    subscriber.mId = (uint8_t)OT_NOTIFICATION_ID_COUNT;
+    if (OpenThread_Notification_Subscribe(&subscriber) != HAL_ERROR)
+    {
+        test_fail("subscriber of an unknown ID", subscriber.mId);
+    }
+    ot_test_notif_buffer.ID = OT_NOTIFICATION_ID_COUNT;
+    if ((OpenThread_CallBack_Processing() != HAL_ERROR) || (ot_test_notif_ack_count != (acks + 1U)))
+    {
+        test_fail("unknown notification", OT_NOTIFICATION_ID_COUNT);
+    }
+}
+
+int main(void)
+{
+    unsigned long n;
+    uint32_t k;
+
+    srand(1);
+    test_builtin = OpenThread_Notification_GetFirst(MSG_M0TOM4_NOTIFY_STATE_CHANGE);
+    if ((test_builtin == NULL) || (test_builtin->mNext != NULL))
+    {
+        test_fail("built-in subscriber", MSG_M0TOM4_NOTIFY_STATE_CHANGE);
+    }
+    test_model[TEST_BUILTIN].subscribed = true;
+    for (k = 0U; k < TEST_SUBSCRIBER_NBR; k++)
+    {
+        test_indexes[k] = k;
+        test_subscribers[k].mHandler = test_handler;
+        test_subscribers[k].mContext = &test_indexes[k];
+        test_change(k);
+    }
+    test_invalid();
+
+    for (n = 0UL; n < TEST_NOTIFICATIONS; n++)
+    {
+        k = (uint32_t)rand() % TEST_SUBSCRIBER_NBR;
+        switch (rand() % 8)
+        {
+        case 0:
+            test_unsubscribe(k);
+            break;
+        case 1:
+            test_change(k);
+            test_subscribe(k);
+            break;
+        case 2:
+            OpenThread_Notification_ResetStats();
+            for (k = 0U; k <= TEST_SUBSCRIBER_NBR; k++)
+            {
+                test_model[k].count = 0U;
+            }
+            break;
+        default:
+            test_notify(test_ids[(uint32_t)rand() % TEST_ID_NBR]);
+            break;
+        }
+        test_check_lists();
+    }
+    if ((test_handler_subscribes == 0UL) || (test_handler_unsubscribes == 0UL))
+    {
+        test_fail("no subscription change in a handler", 0U);
+    }
+    printf("PASS: notification dispatch, %lu notifications, %lu handler calls\n", TEST_NOTIFICATIONS, test_calls);
+    return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
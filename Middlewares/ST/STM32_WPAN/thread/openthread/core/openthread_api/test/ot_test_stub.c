@@ -0,0 +1,101 @@
+/**
+ ******************************************************************************
+ * @file    ot_test_stub.c
+ * @author  MCD Application Team
+ * @brief   Application and M0 side of the host tests of the OpenThread API:
+ *          the IPCC buffers, with the M0 replaced by a function call.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#include <string.h>
+#include "ot_test_stub.h"
+#include "tl_thread_hci.h"
+#include "tl.h"
+#include "shci.h"
+
+/* Objects on the stack are at most this far above the frame of the M0 */
+#define OT_TEST_STACK_RANGE                 (1024U * 1024U)
+
+void (*ot_test_m0_cmd)(const Thread_OT_Cmd_Request_t *req, Thread_OT_Cmd_Request_t *rsp);
+unsigned long ot_test_m0_cmd_count;
+
+static Thread_OT_Cmd_Request_t ot_test_cmd_buffer;
+static Thread_OT_Cmd_Request_t ot_test_rsp_buffer;
+Thread_OT_Cmd_Request_t ot_test_notif_buffer;
+unsigned long ot_test_notif_ack_count;
+
+void * ot_test_ptr(uint32_t value)
+{
+    uintptr_t frame = (uintptr_t)__builtin_frame_address(0);
+    uint32_t offset;
+
+    /* Offset from this frame, modulo 2^32: small for the stack of the callers */
+    offset = value - (uint32_t)frame;
+    if (offset < OT_TEST_STACK_RANGE)
+    {
+        return (void *)(frame + offset);
+    }
+    return (void *)(uintptr_t)value;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return 0U;
+}
+
+void Pre_OtCmdProcessing(void)
+{
+}
+
+void Ot_Cmd_Transfer(void)
+{
+    ot_test_m0_cmd_count++;
+    memset(&ot_test_rsp_buffer, 0, sizeof(ot_test_rsp_buffer));
+    ot_test_rsp_buffer.Size = 1U;
+    if (ot_test_m0_cmd != NULL)
+    {
+        ot_test_m0_cmd(&ot_test_cmd_buffer, &ot_test_rsp_buffer);
+    }
+}
+
+Thread_OT_Cmd_Request_t* THREAD_Get_OTCmdPayloadBuffer(void)
+{
+    return &ot_test_cmd_buffer;
+}
+
+Thread_OT_Cmd_Request_t* THREAD_Get_OTCmdRspPayloadBuffer(void)
+{
+    return &ot_test_rsp_buffer;
+}
+
+Thread_OT_Cmd_Request_t* THREAD_Get_NotificationPayloadBuffer(void)
+{
+    return &ot_test_notif_buffer;
+}
+
+void TL_THREAD_SendAck(void)
+{
+    ot_test_notif_ack_count++;
+}
+
+SHCI_CmdStatus_t SHCI_C2_FLASH_StoreData(SHCI_C2_FLASH_Ip_t Ip)
+{
+    return SHCI_Success;
+}
+
+void HAL_NVIC_SystemReset(void)
+{
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
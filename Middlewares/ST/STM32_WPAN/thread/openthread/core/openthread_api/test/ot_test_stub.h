@@ -0,0 +1,44 @@
+/**
+ ******************************************************************************
+ * @file    ot_test_stub.h
+ * @author  MCD Application Team
+ * @brief   Application and M0 side of the host tests of the OpenThread API
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#ifndef OT_TEST_STUB_H
+#define OT_TEST_STUB_H
+
+#include <stdint.h>
+#include "stm32wbxx_core_interface_def.h"
+
+/* Called by Ot_Cmd_Transfer() in place of the M0. The answer is written to
+ * rsp. Without a handler, the commands return 0. */
+extern void (*ot_test_m0_cmd)(const Thread_OT_Cmd_Request_t *req, Thread_OT_Cmd_Request_t *rsp);
+
+/* Number of commands sent to the M0 */
+extern unsigned long ot_test_m0_cmd_count;
+
+/* Notification of the M0, and number of notifications acknowledged */
+extern Thread_OT_Cmd_Request_t ot_test_notif_buffer;
+extern unsigned long ot_test_notif_ack_count;
+
+/* The API passes the pointers to the M0 on 32 bits. Returns the host pointer
+ * for such a value: an object on the stack of the caller, or a static object
+ * (the tests are linked without PIE). */
+void * ot_test_ptr(uint32_t value);
+
+#endif /* OT_TEST_STUB_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,52 @@
+/**
+ ******************************************************************************
+ * @file    stm32wbxx_hal_conf.h
+ * @author  MCD Application Team
+ * @brief   HAL configuration of the host tests of the OpenThread API. Only the
+ *          HAL headers the API needs are included, no HAL driver is built.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#ifndef STM32WBxx_HAL_CONF_H
+#define STM32WBxx_HAL_CONF_H
+
+#define HAL_MODULE_ENABLED
+#define HAL_CORTEX_MODULE_ENABLED
+#define HAL_RCC_MODULE_ENABLED
+
+#define HSE_VALUE                           32000000U
+#define HSE_STARTUP_TIMEOUT                 100U
+#define MSI_VALUE                           4000000U
+#define HSI_VALUE                           16000000U
+#define LSI1_VALUE                          32000U
+#define LSI2_VALUE                          32000U
+#define LSE_VALUE                           32768U
+#define LSE_STARTUP_TIMEOUT                 5000U
+#define HSI48_VALUE                         48000000U
+#define EXTERNAL_SAI1_CLOCK_VALUE           48000U
+#define VDD_VALUE                           3300U
+#define TICK_INT_PRIORITY                   0U
+#define USE_RTOS                            0U
+#define PREFETCH_ENABLE                     1U
+#define INSTRUCTION_CACHE_ENABLE            1U
+#define DATA_CACHE_ENABLE                   1U
+
+#include "stm32wbxx_hal_rcc.h"
+#include "stm32wbxx_hal_cortex.h"
+
+#define assert_param(expr)                  ((void)0U)
+
+#endif /* STM32WBxx_HAL_CONF_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,266 @@
+/**
+ ******************************************************************************
+ * @file    udp_test.c
+ * @author  MCD Application Team
+ * @brief   Host test of the UDP receive dispatch of udp.c: random opens,
+ *          failed opens, closes and receive notifications on many sockets,
+ *          checked against a model of the M0 and of the application.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#include "../udp.c"
+#include <stdio.h>
+#include <stdlib.h>
+#include "openthread_api_wb.h"
+#include "ot_test_stub.h"
+
+#define TEST_SOCKET_NBR                     200U
+#define TEST_CALLBACK_NBR                   3U
+#define TEST_STEPS                          1000000UL
+
+typedef struct
+{
+    bool     open;        /* Open for the application: the M4 dispatches */
+    uint32_t callback;    /* Callback index and context it was opened with */
+    uint32_t context;
+    bool     m0_open;     /* Open on the M0 */
+    uint32_t m0_context;  /* Receive context given to the M0 */
+} test_socket_t;
+
+static otUdpSocket test_sockets[TEST_SOCKET_NBR];
+static test_socket_t test_model[TEST_SOCKET_NBR];
+static uint32_t test_contexts[TEST_SOCKET_NBR];
+static uint32_t test_open_nbr;
+static otError test_m0_error;   /* Error of the next M0 open */
+static otMessage *test_message;
+static otMessageInfo test_message_info;
+
+/* Last receive callback */
+static uint32_t test_rx_callback, test_rx_count;
+static void *test_rx_context;
+
+static void test_fail(const char *msg, unsigned long arg)
+{
+    printf("FAIL: %s (%lu)\n", msg, arg);
+    exit(1);
+}
+
+static void test_receive(uint32_t callback, void *aContext, otMessage *aMessage, const otMessageInfo *aMessageInfo)
+{
+    if ((aMessage != test_message) || (aMessageInfo != &test_message_info))
+    {
+        test_fail("received message", callback);
+    }
+    test_rx_callback = callback;
+    test_rx_context = aContext;
+    test_rx_count++;
+}
+
+static void test_receive_0(void *aContext, otMessage *aMessage, const otMessageInfo *aMessageInfo)
+{
+    test_receive(0U, aContext, aMessage, aMessageInfo);
+}
+
+static void test_receive_1(void *aContext, otMessage *aMessage, const otMessageInfo *aMessageInfo)
+{
+    test_receive(1U, aContext, aMessage, aMessageInfo);
+}
+
+static void test_receive_2(void *aContext, otMessage *aMessage, const otMessageInfo *aMessageInfo)
+{
+    test_receive(2U, aContext, aMessage, aMessageInfo);
+}
+
+static const otUdpReceive test_callbacks[TEST_CALLBACK_NBR] = { test_receive_0, test_receive_1, test_receive_2 };
+
+static uint32_t test_socket_index(uint32_t value)
+{
+    otUdpSocket *socket = (otUdpSocket *)ot_test_ptr(value);
+
+    if ((socket < test_sockets) || (socket >= &test_sockets[TEST_SOCKET_NBR]))
+    {
+        test_fail("unknown socket", value);
+    }
+    return (uint32_t)(socket - test_sockets);
+}
+
+static void test_m0_cmd(const Thread_OT_Cmd_Request_t *req, Thread_OT_Cmd_Request_t *rsp)
+{
+    uint32_t i;
+
+    switch (req->ID)
+    {
+    case MSG_M4TOM0_OT_UDP_OPEN:
+        i = test_socket_index(req->Data[0]);
+        rsp->Data[0] = test_m0_error;
+        if (test_m0_error == OT_ERROR_NONE)
+        {
+            test_model[i].m0_open = true;
+            test_model[i].m0_context = req->Data[1];
+        }
+        break;
+
+    case MSG_M4TOM0_OT_UDP_CLOSE:
+        i = test_socket_index(req->Data[0]);
+        test_model[i].m0_open = false;
+        rsp->Data[0] = OT_ERROR_NONE;
+        break;
+
+    default:
+        test_fail("unexpected command", req->ID);
+        break;
+    }
+}
+
+/* The M0 receives a datagram for socket i: a notification with the context
+ * of the socket, if it is open on the M0 or (stale) if it was open before */
+static void test_deliver(uint32_t i, bool stale)
+{
+    uint32_t count = test_rx_count;
+
+    if (!test_model[i].m0_open && !stale)
+    {
+        return;
+    }
+    ot_test_notif_buffer.ID = MSG_M0TOM4_UDP_RECEIVE;
+    ot_test_notif_buffer.Size = 3U;
+    ot_test_notif_buffer.Data[0] = stale ? (uint32_t)&test_sockets[i] : test_model[i].m0_context;
+    ot_test_notif_buffer.Data[1] = (uint32_t)test_message;
+    ot_test_notif_buffer.Data[2] = (uint32_t)&test_message_info;
+    (void)OpenThread_CallBack_Processing();
+
+    if (test_model[i].open)
+    {
+        if ((test_rx_count != (count + 1U)) || (test_rx_callback != test_model[i].callback)
+            || (test_rx_context != &test_contexts[test_model[i].context]))
+        {
+            test_fail("datagram not received by the callback of its socket", i);
+        }
+    }
+    else if (test_rx_count != count)
+    {
+        test_fail("datagram received on a closed socket", i);
+    }
+}
+
+/* Every socket of the table is found from its home slot, and only once */
+static void test_table_check(void)
+{
+    uint32_t i, nbr = 0U;
+
+    for (i = 0U; i < OT_UDP_SOCKET_TABLE_SIZE; i++)
+    {
+        if (otUdpSocketTable[i].mSocket != NULL)
+        {
+            nbr++;
+            if (otUdpSocketSlot(otUdpSocketTable[i].mSocket) != &otUdpSocketTable[i])
+            {
+                test_fail("socket not reachable", i);
+            }
+        }
+    }
+    if ((nbr != otUdpSocketCount) || (nbr != test_open_nbr))
+    {
+        test_fail("socket count", nbr);
+    }
+}
+
+static void test_open(uint32_t i)
+{
+    uint32_t callback = (uint32_t)rand() % TEST_CALLBACK_NBR;
+    uint32_t context = (uint32_t)rand() % TEST_SOCKET_NBR;
+    unsigned long cmds = ot_test_m0_cmd_count;
+    otError error, expected;
+
+    test_m0_error = ((rand() % 8) == 0) ? OT_ERROR_FAILED : OT_ERROR_NONE;
+    expected = test_m0_error;
+    if (!test_model[i].open && (test_open_nbr >= OT_UDP_SOCKET_MAX))
+    {
+        expected = OT_ERROR_NO_BUFS;
+    }
+
+    error = otUdpOpen(NULL, &test_sockets[i], test_callbacks[callback], &test_contexts[context]);
+    if (error != expected)
+    {
+        test_fail("open error", error);
+    }
+    if ((expected == OT_ERROR_NO_BUFS) && (ot_test_m0_cmd_count != cmds))
+    {
+        test_fail("open sent to the M0 with the table full", i);
+    }
+    if (error == OT_ERROR_NONE)
+    {
+        if (!test_model[i].open)
+        {
+            test_open_nbr++;
+        }
+        test_model[i].open = true;
+        test_model[i].callback = callback;
+        test_model[i].context = context;
+    }
+}
+
+static void test_close(uint32_t i)
+{
+    (void)otUdpClose(&test_sockets[i]);
+    if (test_model[i].open)
+    {
+        test_open_nbr--;
+    }
+    test_model[i].open = false;
+}
+
+int main(void)
+{
+    unsigned long step;
+    uint32_t i, nbr;
+
+    srand(1);
+    ot_test_m0_cmd = test_m0_cmd;
+    test_message = (otMessage *)&test_contexts[0];
+
+    for (step = 0UL; step < TEST_STEPS; step++)
+    {
+        /* Sockets picked among a few ones, most of the time, to keep some of
+         * them open for long */
+        nbr = ((step / 10000UL) % 2UL == 0UL) ? 24U : TEST_SOCKET_NBR;
+        i = (uint32_t)rand() % nbr;
+        switch (rand() % 8)
+        {
+        case 0:
+        case 1:
+            test_open(i);
+            break;
+        case 2:
+            test_close(i);
+            break;
+        case 3:
+            test_deliver(i, true);
+            break;
+        default:
+            test_deliver(i, false);
+            break;
+        }
+        test_table_check();
+    }
+    if (ot_test_notif_ack_count == 0UL)
+    {
+        test_fail("no notification", 0U);
+    }
+    printf("PASS: UDP receive dispatch, %lu steps on %u sockets, table of %u\n", TEST_STEPS,
+           (unsigned int)TEST_SOCKET_NBR, (unsigned int)OT_UDP_SOCKET_TABLE_SIZE);
+    return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -30,7 +30,99 @@
 
 #include "udp.h"
 
-extern otUdpReceive otUdpReceiveCb;
+/* The callback of each open socket is kept on the M4, in a table indexed by the
+ * socket address (open addressing, linear probing). The socket is given to the
+ * M0 as the receive context, so the receive notification hands it back and the
+ * datagram reaches the callback the socket was opened with. */
+#ifndef OT_UDP_SOCKET_TABLE_SIZE
+#define OT_UDP_SOCKET_TABLE_SIZE 16U /* power of 2 */
+#endif
+
+/* The table is kept at most 3/4 full to keep the probe sequences short */
+#define OT_UDP_SOCKET_MAX ((OT_UDP_SOCKET_TABLE_SIZE * 3U) / 4U)
+
+typedef struct
+{
+    otUdpSocket *mSocket;
+    otUdpReceive mCallback;
+    void *       mContext;
+} otUdpSocketEntry;
+
+static otUdpSocketEntry otUdpSocketTable[OT_UDP_SOCKET_TABLE_SIZE];
+static uint32_t otUdpSocketCount = 0;
+
+static uint32_t otUdpSocketHash(const otUdpSocket *aSocket)
+{
+    /* Fibonacci hashing, the two low bits of the address are always 0 */
+    return (((uint32_t)aSocket >> 2) * 2654435769U) >> 16;
+}
+
+/* Returns the entry of aSocket, or the free entry ending its probe sequence */
+static otUdpSocketEntry *otUdpSocketSlot(const otUdpSocket *aSocket)
+{
+    uint32_t i = otUdpSocketHash(aSocket);
+
+    while (1)
+    {
+        otUdpSocketEntry *entry = &otUdpSocketTable[i & (OT_UDP_SOCKET_TABLE_SIZE - 1U)];
+
+        if ((entry->mSocket == aSocket) || (entry->mSocket == NULL))
+        {
+            return entry;
+        }
+        i++;
+    }
+}
+
+static void otUdpSocketRemove(const otUdpSocket *aSocket)
+{
+    otUdpSocketEntry *hole = otUdpSocketSlot(aSocket);
+    uint32_t          i;
+
+    if (hole->mSocket == NULL)
+    {
+        return;
+    }
+    hole->mSocket = NULL;
+    otUdpSocketCount--;
+
+    /* Move back the entries of the probe sequence that can't be reached
+     * anymore through the hole, so that no tombstone is needed. */
+    i = (uint32_t)(hole - otUdpSocketTable);
+    while (1)
+    {
+        otUdpSocketEntry *entry;
+        uint32_t          home;
+
+        i = (i + 1U) & (OT_UDP_SOCKET_TABLE_SIZE - 1U);
+        entry = &otUdpSocketTable[i];
+        if (entry->mSocket == NULL)
+        {
+            break;
+        }
+        home = otUdpSocketHash(entry->mSocket) & (OT_UDP_SOCKET_TABLE_SIZE - 1U);
+        /* The entry stays if its home is cyclically in (hole, entry] */
+        if (((i - home) & (OT_UDP_SOCKET_TABLE_SIZE - 1U)) <
+            ((i - (uint32_t)(hole - otUdpSocketTable)) & (OT_UDP_SOCKET_TABLE_SIZE - 1U)))
+        {
+            continue;
+        }
+        *hole = *entry;
+        entry->mSocket = NULL;
+        hole = entry;
+    }
+}
+
+/* Called on the MSG_M0TOM4_UDP_RECEIVE notification */
+void otUdpHandleReceive(void *aSocket, otMessage *aMessage, const otMessageInfo *aMessageInfo)
+{
+    otUdpSocketEntry *entry = otUdpSocketSlot((otUdpSocket *)aSocket);
+
+    if ((entry->mSocket != NULL) && (entry->mCallback != NULL))
+    {
+        entry->mCallback(entry->mContext, aMessage, aMessageInfo);
+    }
+}
 
 
 otMessage *otUdpNewMessage(otInstance *aInstance, bool aLinkSecurityEnabled)
@@ -52,8 +144,26 @@ otMessage *otUdpNewMessage(otInstance *aInstance, bool aLinkSecurityEnabled)
 
 otError otUdpOpen(otInstance *aInstance, otUdpSocket *aSocket, otUdpReceive aCallback, void *aContext)
 {
+    otUdpSocketEntry *entry = otUdpSocketSlot(aSocket);
+    otUdpReceive oldCallback = entry->mCallback;
+    void *oldContext = entry->mContext;
+    bool created = false;
+    otError error;
+
+    if (entry->mSocket == NULL)
+    {
+        if (otUdpSocketCount >= OT_UDP_SOCKET_MAX)
+        {
+            return OT_ERROR_NO_BUFS;
+        }
+        entry->mSocket = aSocket;
+        otUdpSocketCount++;
+        created = true;
+    }
+    entry->mCallback = aCallback;
+    entry->mContext = aContext;
+
     Pre_OtCmdProcessing();
-    otUdpReceiveCb = aCallback;
     /* prepare buffer */
     Thread_OT_Cmd_Request_t* p_ot_req = THREAD_Get_OTCmdPayloadBuffer();
 
@@ -61,12 +171,27 @@ otError otUdpOpen(otInstance *aInstance, otUdpSocket *aSocket, otUdpReceive aCal
 
     p_ot_req->Size=2;
     p_ot_req->Data[0] = (uint32_t)aSocket;
-    p_ot_req->Data[1] = (uint32_t)aContext;
+    p_ot_req->Data[1] = (uint32_t)aSocket; /* context handed back on receive */
 
     Ot_Cmd_Transfer();
 
     p_ot_req = THREAD_Get_OTCmdRspPayloadBuffer();
-    return (otError)p_ot_req->Data[0];
+    error = (otError)p_ot_req->Data[0];
+    if (error != OT_ERROR_NONE)
+    {
+        /* A socket already open keeps receiving on its previous callback */
+        if (created)
+        {
+            otUdpSocketRemove(aSocket);
+        }
+        else
+        {
+            entry = otUdpSocketSlot(aSocket);
+            entry->mCallback = oldCallback;
+            entry->mContext = oldContext;
+        }
+    }
+    return error;
 }
 
 otError otUdpClose(otUdpSocket *aSocket)
@@ -82,6 +207,8 @@ otError otUdpClose(otUdpSocket *aSocket)
 
     Ot_Cmd_Transfer();
 
+    otUdpSocketRemove(aSocket);
+
     p_ot_req = THREAD_Get_OTCmdRspPayloadBuffer();
     return (otError)p_ot_req->Data[0];
 }
@@ -274,6 +274,53 @@ int otMessageRead(otMessage *aMessage, uint16_t aOffset, void *aBuf, uint16_t aL
  */
 int otMessageWrite(otMessage *aMessage, uint16_t aOffset, const void *aBuf, uint16_t aLength);
 
+/**
+ * This structure represents one fragment of a vectored message append or read.
+ *
+ */
+typedef struct otMessageIoVec
+{
+    void *   mBuf;    ///< A pointer to the fragment data.
+    uint16_t mLength; ///< The fragment length in bytes.
+} otMessageIoVec;
+
+/**
+ * Append a list of fragments to a message.
+ *
+ * The small fragments are gathered on the application core, so that the whole list usually costs a single
+ * transfer to the stack. The message is left unchanged on failure.
+ *
+ * @param[in]  aMessage  A pointer to a message buffer.
+ * @param[in]  aIoVec    A pointer to the fragments to append, in order.
+ * @param[in]  aCount    Number of fragments.
+ *
+ * @retval OT_ERROR_NONE     Successfully appended to the message
+ * @retval OT_ERROR_NO_BUFS  No available buffers to grow the message.
+ *
+ * @sa otMessageAppend
+ * @sa otMessageReadVector
+ *
+ */
+otError otMessageAppendVector(otMessage *aMessage, const otMessageIoVec *aIoVec, uint8_t aCount);
+
+/**
+ * Read bytes from a message into a list of fragments.
+ *
+ * The fragments are filled in order from @p aOffset, with the same transfer saving as otMessageAppendVector().
+ *
+ * @param[in]  aMessage  A pointer to a message buffer.
+ * @param[in]  aOffset   An offset in bytes.
+ * @param[in]  aIoVec    A pointer to the fragments that message bytes are read to.
+ * @param[in]  aCount    Number of fragments.
+ *
+ * @returns The total number of bytes read.
+ *
+ * @sa otMessageRead
+ * @sa otMessageAppendVector
+ *
+ */
+int otMessageReadVector(otMessage *aMessage, uint16_t aOffset, const otMessageIoVec *aIoVec, uint8_t aCount);
+
 /**
  * This structure represents an OpenThread message queue.
  */
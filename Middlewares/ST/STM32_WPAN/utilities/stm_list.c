@@ -25,6 +25,13 @@
 
 #include "stm_list.h"
 
+/******************************************************************************
+ * Local Function Prototypes
+ ******************************************************************************/
+static tListNode * QueueExchange (tListNode * volatile * p_node, tListNode * node);
+static void QueueSizeAdd (volatile uint32_t * p_size, int32_t value);
+static void QueuePush (tListQueue * queue, tListNode * node);
+
 /******************************************************************************
  * Function Definitions 
  ******************************************************************************/
@@ -34,14 +41,14 @@ void LST_init_head (tListNode * listHead)
   listHead->prev = listHead;
 }
 
+/**
+ * Reading the next pointer is a single word access so there is no need to disable the interrupts.
+ */
 uint8_t LST_is_empty (tListNode * listHead)
 {
-  uint32_t primask_bit;
   uint8_t return_value;
 
-  primask_bit = __get_PRIMASK();  /**< backup PRIMASK bit */
-  __disable_irq();                  /**< Disable all interrupts by setting PRIMASK bit on Cortex*/
-  if(listHead->next == listHead)
+  if(*((tListNode * volatile *)&listHead->next) == listHead)
   {
     return_value = TRUE;
   }
@@ -49,7 +56,6 @@ uint8_t LST_is_empty (tListNode * listHead)
   {
     return_value = FALSE;
   }
-  __set_PRIMASK(primask_bit);     /**< Restore PRIMASK bit*/
 
   return return_value;
 }
@@ -206,3 +212,147 @@ void LST_get_prev_node (tListNode * ref_node, tListNode ** node)
   __set_PRIMASK(primask_bit);      /**< Restore PRIMASK bit*/
 }
 
+/**
+ * Move all nodes of list at the tail of listHead in one step. list is left empty.
+ */
+void LST_splice_tail (tListNode * listHead, tListNode * list)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();  /**< backup PRIMASK bit */
+  __disable_irq();                  /**< Disable all interrupts by setting PRIMASK bit on Cortex*/
+
+  if(list->next != list)
+  {
+    (list->next)->prev = listHead->prev;
+    (listHead->prev)->next = list->next;
+    (list->prev)->next = listHead;
+    listHead->prev = list->prev;
+
+    list->next = list;
+    list->prev = list;
+  }
+
+  __set_PRIMASK(primask_bit);     /**< Restore PRIMASK bit*/
+}
+
+/**
+ * The queue is a singly linked list where the producers insert at head with an atomic exchange and the
+ * consumer removes at tail. The stub node keeps the list never empty so that producers and consumer
+ * do not share any node pointer to be updated together.
+ */
+void LST_queue_init (tListQueue * queue)
+{
+  queue->stub.next = NULL;
+  queue->head = &queue->stub;
+  queue->tail = &queue->stub;
+  queue->size = 0;
+}
+
+/**
+ * May be called from any context
+ */
+void LST_queue_insert_tail (tListQueue * queue, tListNode * node)
+{
+  QueuePush(queue, node);
+  QueueSizeAdd(&queue->size, 1);
+}
+
+/**
+ * Shall be called only by the consumer, typically to put back a node that has just been removed
+ */
+void LST_queue_insert_head (tListQueue * queue, tListNode * node)
+{
+  node->next = queue->tail;
+  queue->tail = node;
+  QueueSizeAdd(&queue->size, 1);
+}
+
+/**
+ * Shall be called only by the consumer
+ * It returns NULL when the queue is empty. It may also return NULL when a producer has been interrupted
+ * while inserting a node. In that case, the producer notifies the consumer once the node is inserted.
+ */
+tListNode * LST_queue_remove_head (tListQueue * queue)
+{
+  tListNode * tail;
+  tListNode * next;
+
+  tail = queue->tail;
+  next = *((tListNode * volatile *)&tail->next);
+
+  if(tail == &queue->stub)
+  {
+    if(next == NULL)
+    {
+      return NULL;
+    }
+    queue->tail = next;
+    tail = next;
+    next = *((tListNode * volatile *)&tail->next);
+  }
+
+  if(next == NULL)
+  {
+    if(tail != queue->head)
+    {
+      return NULL;
+    }
+
+    /**
+     * tail is the last node of the queue. The stub is inserted behind it so that it can be removed
+     */
+    QueuePush(queue, &queue->stub);
+    next = *((tListNode * volatile *)&tail->next);
+    if(next == NULL)
+    {
+      return NULL;
+    }
+  }
+
+  queue->tail = next;
+  QueueSizeAdd(&queue->size, -1);
+
+  return tail;
+}
+
+uint32_t LST_queue_get_size (tListQueue * queue)
+{
+  return queue->size;
+}
+
+/******************************************************************************
+ * Local Function Definitions
+ ******************************************************************************/
+static tListNode * QueueExchange (tListNode * volatile * p_node, tListNode * node)
+{
+  tListNode * previous;
+
+  do
+  {
+    previous = (tListNode *)__LDREXW((volatile uint32_t *)p_node);
+  } while(__STREXW((uint32_t)node, (volatile uint32_t *)p_node) != 0);
+
+  return previous;
+}
+
+static void QueueSizeAdd (volatile uint32_t * p_size, int32_t value)
+{
+  uint32_t size;
+
+  do
+  {
+    size = __LDREXW(p_size);
+  } while(__STREXW(size + value, p_size) != 0);
+}
+
+static void QueuePush (tListQueue * queue, tListNode * node)
+{
+  tListNode * previous;
+
+  node->next = NULL;
+  __DMB();
+  previous = QueueExchange(&queue->head, node);
+  *((tListNode * volatile *)&previous->next) = node;
+  __DMB();
+}
@@ -28,6 +28,19 @@ typedef  struct _tListNode {
     struct _tListNode * prev;
 } tListNode;
 
+/**
+ * Lock free queue of tListNode
+ * Any number of producers may insert nodes from any context (thread or interrupt) while a single consumer
+ * removes them. No interrupt is disabled. Only the next field of the node is used.
+ * The size is tracked so that it is read in O(1).
+ */
+typedef struct _tListQueue {
+    tListNode * volatile head;   /**< Last node inserted by the producers */
+    tListNode * tail;            /**< Next node to be removed by the consumer */
+    tListNode stub;
+    volatile uint32_t size;
+} tListQueue;
+
 void LST_init_head (tListNode * listHead);
 
 uint8_t LST_is_empty (tListNode * listHead);
@@ -52,4 +65,16 @@ void LST_get_next_node (tListNode * ref_node, tListNode ** node);
 
 void LST_get_prev_node (tListNode * ref_node, tListNode ** node);
 
+void LST_splice_tail (tListNode * listHead, tListNode * list);
+
+void LST_queue_init (tListQueue * queue);
+
+void LST_queue_insert_tail (tListQueue * queue, tListNode * node);
+
+void LST_queue_insert_head (tListQueue * queue, tListNode * node);
+
+tListNode * LST_queue_remove_head (tListQueue * queue);
+
+uint32_t LST_queue_get_size (tListQueue * queue);
+
 #endif /* _STM_LIST_H_ */
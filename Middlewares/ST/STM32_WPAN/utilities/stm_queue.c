@@ -33,7 +33,45 @@
 /* Global variables ----------------------------------------------------------*/
 /* Extern variables ----------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
+static uint8_t* QueueAddFixed(queue_t *q, uint8_t* x, uint32_t nbElements);
+
 /* Private functions ---------------------------------------------------------*/
+/**
+  * @brief   Add fixed size elements to a queue without option.
+  * @note    The elements are stored contiguously modulo the queue size so they are copied with at most two memcpy
+  * @param  q: pointer on queue structure   to be handled
+  * @param  X; pointer on element(s) to be added, NULL when already written in place
+  * @param  nbElements:  number of elements in the in buffer pointed by x
+  * @retval  pointer on last element just added to the queue, NULL if the elements do not fit in the queue
+  */
+static uint8_t* QueueAddFixed(queue_t *q, uint8_t* x, uint32_t nbElements)
+{
+  uint32_t NbBytes = q->elementSize * nbElements;
+  uint32_t NbBytesToCopy;
+  uint32_t curBuffPosition;
+
+  if ((q->byteCount + NbBytes) > q->queueMaxSize)
+  {
+    return NULL;
+  }
+
+  /* the first element is added after the last one, or at q->last when the queue is empty */
+  curBuffPosition = (q->byteCount) ? MOD((q->last + q->elementSize), q->queueMaxSize) : q->last;
+
+  if (x != NULL)
+  {
+    NbBytesToCopy = MIN((q->queueMaxSize - curBuffPosition), NbBytes);
+    memcpy(&q->qBuff[curBuffPosition], x, NbBytesToCopy);
+    memcpy(q->qBuff, &x[NbBytesToCopy], NbBytes - NbBytesToCopy);
+  }
+
+  q->last = MOD((curBuffPosition + NbBytes - q->elementSize), q->queueMaxSize);
+  q->byteCount += NbBytes;
+  q->elementCount += nbElements;
+
+  return q->qBuff + q->last;
+}
+
 /* Public functions ----------------------------------------------------------*/
 
 /**
@@ -68,7 +106,8 @@ int CircularQueue_Init(queue_t *q, uint8_t* queueBuffer, uint32_t queueSize, uin
   * @brief   Add  element to the queue .
   * @note   This function is used to add one or more  element(s) to the Circular Queue .  
   * @param  q: pointer on queue structure   to be handled
-  * @param  X; pointer on element(s) to be added 
+  * @param  X; pointer on element(s) to be added. When NULL, the elements are added without being copied
+  *           (they have already been written in place, see CircularQueue_Reserve)
   * @param  elementSize:  Size of element to be added to the queue. Only used if the queue manage variable size elements
   * @param  nbElements:  number of elements in the in buffer pointed by x
   * @retval  pointer on last element just added to the queue, NULL if the element to be added do not fit in the queue (too big)
@@ -89,6 +128,12 @@ uint8_t* CircularQueue_Add(queue_t *q, uint8_t* x, uint16_t elementSize, uint32_
                                                      indcate the size overhead that will be generated by adding the element with wrap management (split or no wrap ) */ 
   
   
+  /* fixed size elements without option are stored as a plain byte ring: copy all elements at once */
+  if ((q->elementSize > 0) && (q->optionFlags == CIRCULAR_QUEUE_NO_FLAG) && (nbElements > 0))
+  {
+    return QueueAddFixed(q, x, nbElements);
+  }
+
   elemSizeStorageRoom  = (q->elementSize == 0) ? 2 : 0;
   /* retrieve the size of last element sored: the value stored at the beginning of the queue element if element size is variable otherwise take it from fixed element Size member */
   if (q->byteCount)
@@ -138,7 +183,10 @@ uint8_t* CircularQueue_Add(queue_t *q, uint8_t* x, uint16_t elementSize, uint32_
       if ((NbBytesToCopy == elementSize) || ((NbBytesToCopy < elementSize) && (q->optionFlags == CIRCULAR_QUEUE_NO_FLAG)))
       {
         /* Copy First part (or emtire buffer ) from current position up to the end of the buffer queue (or before if enough room)  */
-        memcpy(&q->qBuff[curBuffPosition],&x[i*elementSize],NbBytesToCopy);
+        if (x != NULL)
+        {
+          memcpy(&q->qBuff[curBuffPosition],&x[i*elementSize],NbBytesToCopy);
+        }
         /* Adjust bytes count */
         q->byteCount += NbBytesToCopy;
         /* Wrap */
@@ -186,7 +234,10 @@ uint8_t* CircularQueue_Add(queue_t *q, uint8_t* x, uint16_t elementSize, uint32_
              q->qBuff[curBuffPosition-2] = NbBytesToCopy & 0xFF;
              q->qBuff[curBuffPosition-1] = (NbBytesToCopy & 0xFF00) >> 8 ;
              /* copy the bytes */ 
-             memcpy(&q->qBuff[curBuffPosition],&x[i*elementSize],NbBytesToCopy);
+             if (x != NULL)
+             {
+               memcpy(&q->qBuff[curBuffPosition],&x[i*elementSize],NbBytesToCopy);
+             }
              q->byteCount += NbBytesToCopy; 
              /* set the number of copied bytes */
              NbCopiedBytes = NbBytesToCopy;             
@@ -214,11 +265,11 @@ uint8_t* CircularQueue_Add(queue_t *q, uint8_t* x, uint16_t elementSize, uint32_
       }  
       
       /* some remaning byte to copy */
-      if (NbBytesToCopy)      
+      if (NbBytesToCopy && (x != NULL))
       {
         memcpy(&q->qBuff[curBuffPosition],&x[(i*elementSize)+NbCopiedBytes],NbBytesToCopy);
-        q->byteCount += NbBytesToCopy;
-      }      
+      }
+      q->byteCount += NbBytesToCopy;
       
       /* One more element */
       q->elementCount++;
@@ -245,7 +296,16 @@ uint8_t* CircularQueue_Add(queue_t *q, uint8_t* x, uint16_t elementSize, uint32_
   */
 uint8_t* CircularQueue_Remove_Copy(queue_t *q, uint16_t* elementSize, uint8_t* buffer)
 {
-   return NULL;
+  uint16_t size;
+  uint8_t* ptr;
+
+  /* copy before removing so that the element can not be overwritten in the meantime */
+  ptr = CircularQueue_Sense_Copy(q, elementSize, buffer);
+  if (ptr != NULL)
+  {
+    CircularQueue_Remove(q, &size);
+  }
+  return ptr;
 }
 
 
@@ -311,7 +371,19 @@ uint8_t* CircularQueue_Remove(queue_t *q, uint16_t* elementSize)
 
 uint8_t* CircularQueue_Sense_Copy(queue_t *q, uint16_t* elementSize, uint8_t* buffer)
 {
-    return NULL;
+  uint8_t* ptr;
+  uint32_t NbBytesToCopy;
+
+  ptr = CircularQueue_Sense(q, elementSize);
+  if (ptr != NULL)
+  {
+    /* without option, the element may wrap at the end of the queue buffer */
+    NbBytesToCopy = MIN((q->queueMaxSize - (ptr - q->qBuff)), *elementSize);
+    memcpy(buffer, ptr, NbBytesToCopy);
+    memcpy(&buffer[NbBytesToCopy], q->qBuff, *elementSize - NbBytesToCopy);
+    ptr = buffer;
+  }
+  return ptr;
 }
 
 
@@ -374,3 +446,125 @@ int CircularQueue_NbElement(queue_t *q)
 {
   return q->elementCount;
 }
+
+/**
+  * @brief  Reserve room for one element to be written in place.
+  * @note   The element is not in the queue until CircularQueue_Commit() is called with the same size.
+  *         No other element shall be added in between. Elements may be removed in between.
+  *         The room is always contiguous: NULL is returned when the element would wrap at the end of
+  *         the queue buffer (only possible without CIRCULAR_QUEUE_NO_WRAP_FLAG)
+  * @param  q: pointer on queue structure  to be handled
+  * @param  elementSize:  Size of element to be added to the queue. Only used if the queue manage variable size elements
+  * @retval Pointer where the element shall be written. NULL if there is no room
+  */
+uint8_t* CircularQueue_Reserve(queue_t *q, uint16_t elementSize)
+{
+  queue_t next_q = *q;
+  uint8_t* ptr;
+
+  /* the placement of the element is computed on a copy of the queue, only the buffer is shared */
+  ptr = CircularQueue_Add(&next_q, NULL, elementSize, 1);
+  if (ptr != NULL)
+  {
+    elementSize = (q->elementSize > 0) ? q->elementSize : elementSize;
+    if (((ptr - q->qBuff) + elementSize > q->queueMaxSize) || (next_q.elementCount != (q->elementCount + 1)))
+    {
+      ptr = NULL;
+    }
+  }
+  return ptr;
+}
+
+/**
+  * @brief  Add to the queue the element written in place after CircularQueue_Reserve().
+  * @param  q: pointer on queue structure  to be handled
+  * @param  elementSize:  Size given to CircularQueue_Reserve()
+  * @retval 0 when the element has been added, -1 otherwise
+  */
+int CircularQueue_Commit(queue_t *q, uint16_t elementSize)
+{
+  return (CircularQueue_Add(q, NULL, elementSize, 1) != NULL) ? 0 : -1;
+}
+
+/**
+  * @brief  "Sense" all elements of the queue, without removing them, as up to two contiguous spans.
+  * @note   This is intended to send the queue content with a DMA. Only queues of fixed size elements are supported.
+  *         Once sent, the elements are removed with CircularQueue_Remove_Bulk()
+  * @param  q: pointer on queue structure  to be handled
+  * @param  span: returns the first span in span[0] and the second one, if the data wraps, in span[1].
+  *         The size of an unused span is 0
+  * @retval Number of elements in the spans. 0 if queue was empty or has variable size elements
+  */
+uint32_t CircularQueue_Sense_Bulk(queue_t *q, queue_span_t span[2])
+{
+  uint32_t NbBytes;
+
+  span[0].ptr = q->qBuff + q->first;
+  span[0].size = 0;
+  span[1].ptr = q->qBuff;
+  span[1].size = 0;
+
+  if ((q->byteCount == 0) || (q->elementSize == 0))
+  {
+    return 0;
+  }
+
+  if (q->optionFlags & CIRCULAR_QUEUE_NO_WRAP_FLAG)
+  {
+    if (q->first <= q->last)
+    {
+      span[0].size = q->last + q->elementSize - q->first;
+    }
+    else
+    {
+      /* the end of the buffer that can not hold a full element is not part of the data */
+      NbBytes = q->queueMaxSize - q->first;
+      span[0].size = NbBytes - (NbBytes % q->elementSize);
+      span[1].size = q->last + q->elementSize;
+    }
+  }
+  else
+  {
+    span[0].size = MIN((q->queueMaxSize - q->first), q->byteCount);
+    span[1].size = q->byteCount - span[0].size;
+  }
+
+  return q->elementCount;
+}
+
+/**
+  * @brief  Remove several elements from the queue.
+  * @note   Only queues of fixed size elements are supported.
+  * @param  q: pointer on queue structure  to be handled
+  * @param  nbElements: Number of elements to be removed
+  * @retval Number of elements removed
+  */
+uint32_t CircularQueue_Remove_Bulk(queue_t *q, uint32_t nbElements)
+{
+  uint32_t i;
+  uint16_t elementSize;
+
+  if (q->elementSize == 0)
+  {
+    return 0;
+  }
+
+  nbElements = MIN(nbElements, q->elementCount);
+
+  if ((q->optionFlags == CIRCULAR_QUEUE_NO_FLAG) && (nbElements > 0))
+  {
+    q->byteCount -= nbElements * q->elementSize;
+    q->elementCount -= nbElements;
+    /* as with CircularQueue_Remove(), q->first is left on the last element when the queue gets empty */
+    q->first = (q->byteCount > 0) ? MOD((q->first + (nbElements * q->elementSize)), q->queueMaxSize) : q->last;
+  }
+  else
+  {
+    for (i = 0; i < nbElements; i++)
+    {
+      CircularQueue_Remove(q, &elementSize);
+    }
+  }
+
+  return nbElements;
+}
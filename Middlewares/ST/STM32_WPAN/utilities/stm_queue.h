@@ -43,6 +43,11 @@ typedef struct {
    uint8_t  optionFlags;     /* option to enable specific features */
 } queue_t;
 
+typedef struct {
+   uint8_t* ptr;            /* start of the span in the queue buffer */
+   uint32_t size;           /* size of the span in bytes */
+} queue_span_t;
+
 /* Exported constants --------------------------------------------------------*/
 
 /* Exported macro ------------------------------------------------------------*/
@@ -55,6 +60,10 @@ int CircularQueue_Empty(queue_t *q);
 int CircularQueue_NbElement(queue_t *q);
 uint8_t* CircularQueue_Remove_Copy(queue_t *q, uint16_t* elementSize, uint8_t* buffer);
 uint8_t* CircularQueue_Sense_Copy(queue_t *q, uint16_t* elementSize, uint8_t* buffer);
+uint8_t* CircularQueue_Reserve(queue_t *q, uint16_t elementSize);
+int CircularQueue_Commit(queue_t *q, uint16_t elementSize);
+uint32_t CircularQueue_Sense_Bulk(queue_t *q, queue_span_t span[2]);
+uint32_t CircularQueue_Remove_Bulk(queue_t *q, uint32_t nbElements);
 
 /******************* (C) COPYRIGHT 2010 STMicroelectronics *****END OF FILE****/
 #endif /* __STM_QUEUE_H */
@@ -0,0 +1,522 @@
+/**
+  ******************************************************************************
+  * @file    queue_test.c
+  * @author  MCD Application Team
+  * @brief   Host test of stm_queue.c: random operations on queues of fixed and
+  *          variable size elements, with each option, replayed on the queue
+  *          before the copy variants (stm_queue_ref.c) and on a model of the
+  *          bytes queued.
+  *          make test : differential test
+  *          make bench: bytes per second of a UART trace queue
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "utilities_common.h"
+#include "stm_queue.h"
+#include "stm_queue_ref.h"
+
+#define TEST_OPS                            200000UL
+#define TEST_ELEMENT_MAX                    96U
+#define TEST_STREAM_SIZE                    0x10000U    /* Model of the bytes queued */
+#define TEST_SIZES_NBR                      0x1000U     /* Model of the element sizes */
+
+typedef struct
+{
+  const char *name;
+  uint16_t    elementSize;
+  uint8_t     optionFlags;
+  uint32_t    queueSize;
+} test_config_t;
+
+static const test_config_t test_configs[] = {
+  { "fixed 1 byte",              1U, CIRCULAR_QUEUE_NO_FLAG,                64U },
+  { "fixed 3 bytes",             3U, CIRCULAR_QUEUE_NO_FLAG,                64U },
+  { "fixed 8 bytes",             8U, CIRCULAR_QUEUE_NO_FLAG,                61U },
+  { "fixed 16 bytes",           16U, CIRCULAR_QUEUE_NO_FLAG,               256U },
+  { "fixed 3 bytes, no wrap",    3U, CIRCULAR_QUEUE_NO_WRAP_FLAG,           64U },
+  { "fixed 8 bytes, no wrap",    8U, CIRCULAR_QUEUE_NO_WRAP_FLAG,           61U },
+  { "fixed 13 bytes, no wrap",  13U, CIRCULAR_QUEUE_NO_WRAP_FLAG,          100U },
+  { "variable",                  0U, CIRCULAR_QUEUE_NO_FLAG,               200U },
+  { "variable, no wrap",         0U, CIRCULAR_QUEUE_NO_WRAP_FLAG,          200U },
+  { "variable, split",           0U, CIRCULAR_QUEUE_SPLIT_IF_WRAPPING_FLAG, 200U },
+};
+
+/* Queue under test, reference queue, and model of the bytes and elements */
+static const test_config_t *test_config;
+static queue_t test_q, test_ref;
+static uint8_t *test_buffer, *test_ref_buffer, *test_scratch_buffer;
+static uint8_t test_stream[TEST_STREAM_SIZE];
+static uint32_t test_stream_head, test_stream_tail;
+static uint16_t test_sizes[TEST_SIZES_NBR];
+static uint32_t test_sizes_head, test_sizes_tail;
+static unsigned long test_counts[8];
+
+static void test_fail(const char *msg, unsigned long arg)
+{
+  printf("FAIL: %s (%lu), queue %s\n", msg, arg, test_config->name);
+  exit(1);
+}
+
+static void test_model_add(const uint8_t *data, uint16_t size)
+{
+  uint32_t i;
+
+  for (i = 0U; i < size; i++)
+  {
+    test_stream[test_stream_tail++ % TEST_STREAM_SIZE] = data[i];
+  }
+  test_sizes[test_sizes_tail++ % TEST_SIZES_NBR] = size;
+}
+
+/* The next bytes of the model: an element that wrapped is split in two with
+ * CIRCULAR_QUEUE_SPLIT_IF_WRAPPING_FLAG, the size is not checked */
+static void test_model_check(const uint8_t *data, uint16_t size, bool remove)
+{
+  uint32_t i;
+
+  if ((test_stream_tail - test_stream_head) < size)
+  {
+    test_fail("element not in the model", size);
+  }
+  for (i = 0U; i < size; i++)
+  {
+    if (data[i] != test_stream[(test_stream_head + i) % TEST_STREAM_SIZE])
+    {
+      test_fail("element data", i);
+    }
+  }
+  if (!(test_config->optionFlags & CIRCULAR_QUEUE_SPLIT_IF_WRAPPING_FLAG)
+      && (size != test_sizes[test_sizes_head % TEST_SIZES_NBR]))
+  {
+    test_fail("element size", size);
+  }
+  if (remove)
+  {
+    test_stream_head += size;
+    test_sizes_head++;
+  }
+}
+
+/* Element read as the consumers of the queue buffer do: without option, it
+ * may wrap at the end of the buffer */
+static void test_read(const queue_t *q, const uint8_t *ptr, uint16_t size, uint8_t *data)
+{
+  uint32_t offset = (uint32_t)(ptr - q->qBuff);
+  uint32_t i;
+
+  if (offset >= q->queueMaxSize)
+  {
+    test_fail("element out of the queue buffer", offset);
+  }
+  for (i = 0U; i < size; i++)
+  {
+    data[i] = q->qBuff[(offset + i) % q->queueMaxSize];
+  }
+}
+
+static void test_check_fields(const queue_t *q, const queue_t *ref)
+{
+  if ((q->first != ref->first) || (q->last != ref->last) || (q->byteCount != ref->byteCount)
+      || (q->elementCount != ref->elementCount))
+  {
+    test_fail("queue state", q->byteCount);
+  }
+}
+
+/* Both queues hold the same elements, stored the same way, and the bytes of
+ * the model */
+static void test_check(void)
+{
+  queue_t q = test_q, ref = test_ref;
+  uint8_t data[TEST_ELEMENT_MAX], ref_data[TEST_ELEMENT_MAX];
+  uint32_t stream = test_stream_head, sizes = test_sizes_head;
+  uint8_t *ptr, *ref_ptr;
+  uint16_t size, ref_size;
+
+  test_check_fields(&q, &ref);
+  if ((CircularQueue_Empty(&test_q) != RefQueue_Empty(&test_ref))
+      || (CircularQueue_NbElement(&test_q) != RefQueue_NbElement(&test_ref)))
+  {
+    test_fail("queue empty or number of elements", test_q.elementCount);
+  }
+  while (ref.byteCount > 0U)
+  {
+    ptr = RefQueue_Remove(&q, &size);
+    ref_ptr = RefQueue_Remove(&ref, &ref_size);
+    if ((size != ref_size) || ((ptr - q.qBuff) != (ref_ptr - ref.qBuff)) || (size > TEST_ELEMENT_MAX))
+    {
+      test_fail("element position or size", size);
+    }
+    test_check_fields(&q, &ref);
+    test_read(&q, ptr, size, data);
+    test_read(&ref, ref_ptr, ref_size, ref_data);
+    if (memcmp(data, ref_data, size) != 0)
+    {
+      test_fail("element data of the reference", size);
+    }
+    test_model_check(data, size, true);
+  }
+  if (test_stream_head != test_stream_tail)
+  {
+    test_fail("bytes of the model not in the queue", test_stream_tail - test_stream_head);
+  }
+  test_stream_head = stream;
+  test_sizes_head = sizes;
+}
+
+static uint16_t test_element_size(void)
+{
+  if (test_config->elementSize != 0U)
+  {
+    return test_config->elementSize;
+  }
+  /* Now and then a size of 0, that can not be added */
+  return (uint16_t)((uint32_t)rand() % (((rand() % 4) == 0) ? 8U : TEST_ELEMENT_MAX));
+}
+
+static void test_fill(uint8_t *data, uint32_t size)
+{
+  uint32_t i;
+
+  for (i = 0U; i < size; i++)
+  {
+    data[i] = (uint8_t)rand();
+  }
+}
+
+static void test_add(void)
+{
+  uint8_t data[4U * TEST_ELEMENT_MAX];
+  uint16_t size = test_element_size();
+  uint32_t nb = 1U + ((uint32_t)rand() % 4U);
+  uint8_t *ptr, *ref_ptr;
+  uint32_t i;
+
+  test_fill(data, nb * size);
+  ptr = CircularQueue_Add(&test_q, data, size, nb);
+  ref_ptr = RefQueue_Add(&test_ref, data, size, nb);
+  if ((ptr == NULL) != (ref_ptr == NULL))
+  {
+    test_fail("add status", ref_ptr == NULL);
+  }
+  if (ptr != NULL)
+  {
+    if ((ptr - test_buffer) != (ref_ptr - test_ref_buffer))
+    {
+      test_fail("added element position", (unsigned long)(ptr - test_buffer));
+    }
+    for (i = 0U; i < nb; i++)
+    {
+      test_model_add(&data[i * size], size);
+    }
+  }
+  test_counts[0]++;
+}
+
+/* One element written in place: the reference adds it with a copy */
+static void test_reserve(void)
+{
+  uint8_t data[TEST_ELEMENT_MAX];
+  uint16_t size = test_element_size();
+  queue_t scratch = test_ref;
+  uint8_t *ptr, *ref_ptr;
+  bool fits;
+
+  /* The reference adds it to a copy of the queue: it must be one contiguous
+   * element */
+  test_fill(data, size);
+  memcpy(test_scratch_buffer, test_ref_buffer, test_config->queueSize);
+  scratch.qBuff = test_scratch_buffer;
+  ref_ptr = RefQueue_Add(&scratch, data, size, 1U);
+  fits = (ref_ptr != NULL) && (scratch.elementCount == (test_ref.elementCount + 1U))
+      && (((uint32_t)(ref_ptr - test_scratch_buffer) + size) <= test_config->queueSize);
+
+  ptr = CircularQueue_Reserve(&test_q, size);
+  if ((ptr != NULL) != fits)
+  {
+    test_fail("reserve status", fits);
+  }
+  test_check_fields(&test_q, &test_ref);
+  if (ptr == NULL)
+  {
+    test_counts[1]++;
+    return;
+  }
+  if ((ptr - test_buffer) != (ref_ptr - test_scratch_buffer))
+  {
+    test_fail("reserved element position", (unsigned long)(ptr - test_buffer));
+  }
+  memcpy(ptr, data, size);
+  if ((CircularQueue_Commit(&test_q, size) != 0) || (RefQueue_Add(&test_ref, data, size, 1U) == NULL))
+  {
+    test_fail("commit status", size);
+  }
+  test_model_add(data, size);
+  test_counts[2]++;
+}
+
+static void test_remove(bool sense, bool copy)
+{
+  uint8_t data[TEST_ELEMENT_MAX], ref_data[TEST_ELEMENT_MAX];
+  uint16_t size = 0xFFFFU, ref_size;
+  uint8_t *ptr, *ref_ptr;
+
+  if (copy)
+  {
+    memset(data, 0xA5, sizeof(data));
+    ptr = sense ? CircularQueue_Sense_Copy(&test_q, &size, data) : CircularQueue_Remove_Copy(&test_q, &size, data);
+    if ((ptr != NULL) && (ptr != data))
+    {
+      test_fail("copy not returned", size);
+    }
+  }
+  else
+  {
+    ptr = sense ? CircularQueue_Sense(&test_q, &size) : CircularQueue_Remove(&test_q, &size);
+  }
+  ref_ptr = sense ? RefQueue_Sense(&test_ref, &ref_size) : RefQueue_Remove(&test_ref, &ref_size);
+  if (((ptr == NULL) != (ref_ptr == NULL)) || (size != ref_size))
+  {
+    test_fail("removed element size", size);
+  }
+  if (ptr == NULL)
+  {
+    return;
+  }
+  test_read(&test_ref, ref_ptr, ref_size, ref_data);
+  if (copy)
+  {
+    if (memcmp(data, ref_data, size) != 0)
+    {
+      test_fail("copied element", size);
+    }
+    if ((size < sizeof(data)) && (data[size] != 0xA5U))
+    {
+      test_fail("copy past the element", size);
+    }
+  }
+  else if ((ptr - test_buffer) != (ref_ptr - test_ref_buffer))
+  {
+    test_fail("removed element position", size);
+  }
+  test_model_check(ref_data, size, !sense);
+  test_counts[3U + (sense ? 1U : 0U)]++;
+}
+
+/* The content of the queue for a DMA, then some elements sent */
+static void test_bulk(void)
+{
+  queue_span_t span[2];
+  uint8_t data[TEST_STREAM_SIZE];
+  uint16_t size;
+  uint32_t nb, removed, i, count;
+
+  count = CircularQueue_Sense_Bulk(&test_q, span);
+  if (test_config->elementSize == 0U)
+  {
+    if ((count != 0U) || (span[0].size != 0U) || (span[1].size != 0U))
+    {
+      test_fail("bulk of variable size elements", count);
+    }
+    if (CircularQueue_Remove_Bulk(&test_q, 1U) != 0U)
+    {
+      test_fail("bulk remove of variable size elements", 0U);
+    }
+    return;
+  }
+  if ((count != test_ref.elementCount) || (span[0].ptr != (test_buffer + test_q.first)) || (span[1].ptr != test_buffer)
+      || ((span[0].ptr + span[0].size) > (test_buffer + test_config->queueSize))
+      || ((span[1].size != 0U) && ((span[1].size > test_q.first) || (span[0].ptr + span[0].size) < (test_buffer + test_q.first))))
+  {
+    test_fail("bulk spans", count);
+  }
+  if (((span[0].size + span[1].size) != (count * test_config->elementSize)))
+  {
+    test_fail("bulk size", span[0].size + span[1].size);
+  }
+  memcpy(data, span[0].ptr, span[0].size);
+  memcpy(&data[span[0].size], span[1].ptr, span[1].size);
+  for (i = 0U; i < count; i++)
+  {
+    test_model_check(&data[i * test_config->elementSize], test_config->elementSize, true);
+  }
+  test_stream_head -= count * test_config->elementSize;
+  test_sizes_head -= count;
+
+  nb = ((rand() % 4) == 0) ? ((uint32_t)rand() % 1000U) : ((uint32_t)rand() % (count + 1U));
+  removed = CircularQueue_Remove_Bulk(&test_q, nb);
+  if (removed != MIN(nb, count))
+  {
+    test_fail("bulk remove count", removed);
+  }
+  for (i = 0U; i < removed; i++)
+  {
+    (void)RefQueue_Remove(&test_ref, &size);
+  }
+  test_stream_head += removed * test_config->elementSize;
+  test_sizes_head += removed;
+  test_counts[5]++;
+}
+
+static void test_queue(const test_config_t *config)
+{
+  unsigned long n;
+
+  test_config = config;
+  /* Exact sizes, so that the sanitizer sees any access out of the queue */
+  test_buffer = malloc(config->queueSize);
+  test_ref_buffer = malloc(config->queueSize);
+  test_scratch_buffer = malloc(config->queueSize);
+  memset(test_buffer, 0, config->queueSize);
+  memset(test_ref_buffer, 0, config->queueSize);
+  test_stream_head = test_stream_tail = 0U;
+  test_sizes_head = test_sizes_tail = 0U;
+
+  if ((CircularQueue_Init(&test_q, test_buffer, config->queueSize, config->elementSize, config->optionFlags) != 0)
+      || (RefQueue_Init(&test_ref, test_ref_buffer, config->queueSize, config->elementSize, config->optionFlags) != 0))
+  {
+    test_fail("init", config->optionFlags);
+  }
+  for (n = 0UL; n < TEST_OPS; n++)
+  {
+    /* More adds than removes half of the time: the queue is often full */
+    switch (rand() % (((n / 1000UL) % 2UL) ? 10 : 12))
+    {
+    case 0:
+    case 1:
+    case 2:
+      test_add();
+      break;
+    case 3:
+    case 4:
+    case 5:
+      test_reserve();
+      break;
+    case 6:
+      test_remove(true, (rand() % 2) == 0);
+      break;
+    case 7:
+    case 8:
+      test_remove(false, (rand() % 2) == 0);
+      break;
+    default:
+      if ((rand() % 2) == 0)
+      {
+        test_bulk();
+      }
+      else
+      {
+        test_remove(false, (rand() % 2) == 0);
+      }
+      break;
+    }
+    test_check();
+  }
+  free(test_buffer);
+  free(test_ref_buffer);
+  free(test_scratch_buffer);
+}
+
+/* A trace queue of bytes, drained as a UART DMA would */
+static double test_bench(bool ref)
+{
+  static uint8_t buffer[1024];
+  static uint8_t line[80];
+  uint8_t out[sizeof(buffer)];
+  queue_span_t span[2];
+  queue_t q;
+  uint16_t size;
+  unsigned long bytes = 0UL, n, nb;
+  uint8_t *ptr;
+  clock_t start;
+
+  memset(line, 'x', sizeof(line));
+  if (ref)
+  {
+    RefQueue_Init(&q, buffer, sizeof(buffer), 1U, CIRCULAR_QUEUE_NO_FLAG);
+  }
+  else
+  {
+    CircularQueue_Init(&q, buffer, sizeof(buffer), 1U, CIRCULAR_QUEUE_NO_FLAG);
+  }
+  start = clock();
+  for (n = 0UL; n < 400000UL; n++)
+  {
+    size = (uint16_t)(16U + (n % 64U));
+    ptr = ref ? RefQueue_Add(&q, line, 1U, size) : CircularQueue_Add(&q, line, 1U, size);
+    if (ptr != NULL)
+    {
+      bytes += size;
+    }
+    if ((n % 8UL) == 7UL)
+    {
+      if (ref)
+      {
+        /* One byte at a time */
+        for (nb = 0UL; (ptr = RefQueue_Remove(&q, &size)) != NULL; nb++)
+        {
+          out[nb] = *ptr;
+        }
+      }
+      else
+      {
+        nb = CircularQueue_Sense_Bulk(&q, span);
+        memcpy(out, span[0].ptr, span[0].size);
+        memcpy(&out[span[0].size], span[1].ptr, span[1].size);
+        (void)CircularQueue_Remove_Bulk(&q, nb);
+      }
+    }
+  }
+  return (double)bytes / ((double)(clock() - start) / CLOCKS_PER_SEC);
+}
+
+int main(int argc, char *argv[])
+{
+  queue_t q;
+  uint8_t buffer[16];
+  uint32_t i;
+  unsigned long ops = 0UL;
+
+  srand(1);
+  if (CircularQueue_Init(&q, buffer, sizeof(buffer), 4U, CIRCULAR_QUEUE_SPLIT_IF_WRAPPING_FLAG) != -1)
+  {
+    test_config = &test_configs[0];
+    test_fail("split of fixed size elements", 0U);
+  }
+  for (i = 0U; i < (sizeof(test_configs) / sizeof(test_configs[0])); i++)
+  {
+    test_queue(&test_configs[i]);
+    ops += TEST_OPS;
+  }
+  if ((test_counts[1] == 0UL) || (test_counts[2] == 0UL) || (test_counts[5] == 0UL))
+  {
+    test_fail("operation never done", 0U);
+  }
+  printf("PASS: queue, %lu operations, %lu adds, %lu reserves (%lu refused), %lu removes, %lu senses, %lu bulks\n",
+         ops, test_counts[0], test_counts[2], test_counts[1], test_counts[3], test_counts[4], test_counts[5]);
+
+  if ((argc > 1) && (strcmp(argv[1], "bench") == 0))
+  {
+    printf("trace queue of bytes, added by line: reference (one byte removed at a time) %.1f MB/s, "
+           "bulk %.1f MB/s\n", test_bench(true) / 1e6, test_bench(false) / 1e6);
+  }
+  return 0;
+}
+
+/******************* (C) COPYRIGHT 2019 STMicroelectronics *****END OF FILE****/
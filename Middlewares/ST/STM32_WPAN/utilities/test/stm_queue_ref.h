@@ -0,0 +1,41 @@
+/**
+  ******************************************************************************
+  * @file    stm_queue_ref.h
+  * @author  MCD Application Team
+  * @brief   Header for stm_queue_ref.c, the reference of the queue host test
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM_QUEUE_REF_H
+#define __STM_QUEUE_REF_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm_queue.h"
+
+/* Exported functions ------------------------------------------------------- */
+/* The functions of stm_queue.c before the copy variants, the in place add and
+ * the bulk operations (the copy variants returned NULL) */
+int RefQueue_Init(queue_t *q, uint8_t* queueBuffer, uint32_t queueSize, uint16_t elementSize, uint8_t optionlags);
+uint8_t* RefQueue_Add(queue_t *q, uint8_t* x, uint16_t elementSize, uint32_t nbElements);
+uint8_t* RefQueue_Remove(queue_t *q, uint16_t* elementSize);
+uint8_t* RefQueue_Sense(queue_t *q, uint16_t* elementSize);
+int RefQueue_Empty(queue_t *q);
+int RefQueue_NbElement(queue_t *q);
+uint8_t* RefQueue_Remove_Copy(queue_t *q, uint16_t* elementSize, uint8_t* buffer);
+uint8_t* RefQueue_Sense_Copy(queue_t *q, uint16_t* elementSize, uint8_t* buffer);
+
+#endif /* __STM_QUEUE_REF_H */
+
+/******************* (C) COPYRIGHT 2019 STMicroelectronics *****END OF FILE****/
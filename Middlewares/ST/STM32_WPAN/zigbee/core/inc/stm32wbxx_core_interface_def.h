@@ -338,6 +338,9 @@ typedef enum {
 
 HAL_StatusTypeDef Zigbee_CallBackProcessing(void);
 HAL_StatusTypeDef Zigbee_LoggingProcessing(void);
+void Zigbee_TimerProcessing(void);
+void Zigbee_LogProcessing(void);
+unsigned int Zigbee_LogRead(uint32_t *timestamp, char *buf, unsigned int size);
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -20,6 +20,8 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
 #include <assert.h>
 
 #include "zigbee_errors.h"
@@ -129,6 +131,9 @@ static struct zb_ipc_globals zb_ipc_globals;
 struct cli_app;
 extern void cli_port_print_msg(struct cli_app *cli_p, const char *msg);
 
+static void zb_nwk_addr_cache_flush(void);
+static void zb_aps_cache_flush(void);
+
 int zcl_cluster_data_ind(ZbApsdeDataIndT *dataIndPtr, void *arg);
 int zcl_cluster_alarm_data_ind(ZbApsdeDataIndT *data_ind, void *arg);
 
@@ -171,9 +176,9 @@ zb_ipc_m4_cb_info_alloc(void *callback, void *arg)
 {
     struct zb_ipc_m4_cb_info *info;
 
-    info = malloc(sizeof(struct zb_ipc_m4_cb_info));
+    info = ZbHeapAlloc(NULL, sizeof(struct zb_ipc_m4_cb_info));
     if (info != NULL) {
-        memset(info, 0, sizeof(struct zb_ipc_m4_cb_info));
+        (void)memset(info, 0, sizeof(struct zb_ipc_m4_cb_info));
         info->callback = callback;
         info->arg = arg;
     }
@@ -183,7 +188,7 @@ zb_ipc_m4_cb_info_alloc(void *callback, void *arg)
 static void
 zb_ipc_m4_cb_info_free(struct zb_ipc_m4_cb_info *info)
 {
-    free(info);
+    ZbHeapFree(NULL, info);
 } /* zb_ipc_m4_cb_info_free */
 
 static uint32_t
@@ -288,6 +293,7 @@ ZbInit(uint64_t extAddr, ZbInitTblSizesT *tblSizes, ZbInitSetLoggingT *setLoggin
         /* Save the log mask */
         zb_ipc_globals.log_mask = setLogging->mask;
     }
+    zb_aps_cache_flush();
     return zb_ipc_globals.zb;
 } /* ZbInit */
 
@@ -299,6 +305,8 @@ ZbDestroy(struct ZigBeeT *zb)
     if (zb_ipc_globals.zb == NULL) {
         return;
     }
+    zb_nwk_addr_cache_flush();
+    zb_aps_cache_flush();
     Pre_ZigbeeCmdProcessing();
     ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
     ipcc_req->ID = MSG_M4TOM0_ZB_DESTROY;
@@ -438,6 +446,8 @@ ZbStartup(struct ZigBeeT *zb, struct ZbStartupT *configPtr, void (*callback)(enu
     if (info == NULL) {
         return ZB_STATUS_ALLOC_FAIL;
     }
+    zb_nwk_addr_cache_flush();
+    zb_aps_cache_flush();
     Pre_ZigbeeCmdProcessing();
     ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
     ipcc_req->ID = MSG_M4TOM0_STARTUP_REQ;
@@ -459,6 +469,7 @@ ZbStartupRejoin(struct ZigBeeT *zb, void (*callback)(ZbNlmeJoinConfT *conf, void
     if (info == NULL) {
         return ZB_STATUS_ALLOC_FAIL;
     }
+    zb_nwk_addr_cache_flush();
     Pre_ZigbeeCmdProcessing();
     ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
     ipcc_req->ID = MSG_M4TOM0_STARTUP_REJOIN;
@@ -474,6 +485,8 @@ ZbStartupPersist(struct ZigBeeT *zb, const void *pdata, unsigned int plen, struc
 {
     Zigbee_Cmd_Request_t *ipcc_req;
 
+    zb_nwk_addr_cache_flush();
+    zb_aps_cache_flush();
     Pre_ZigbeeCmdProcessing();
     ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
     ipcc_req->ID = MSG_M4TOM0_STARTUP_PERSIST;
@@ -570,6 +583,7 @@ ZbTrustCenterRejoin(struct ZigBeeT *zb, void (*callback)(enum ZbStatusCodeT stat
     if (info == NULL) {
         return ZB_STATUS_ALLOC_FAIL;
     }
+    zb_nwk_addr_cache_flush();
     Pre_ZigbeeCmdProcessing();
     ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
     ipcc_req->ID = MSG_M4TOM0_STARTUP_TC_REJOIN;
@@ -629,6 +643,8 @@ ZbLeaveReq(struct ZigBeeT *zb, void (*callback)(struct ZbNlmeLeaveConfT *conf, v
     if (info == NULL) {
         return ZB_STATUS_ALLOC_FAIL;
     }
+    zb_nwk_addr_cache_flush();
+    zb_aps_cache_flush();
     Pre_ZigbeeCmdProcessing();
     ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
     ipcc_req->ID = MSG_M4TOM0_ZB_LEAVE_REQ;
@@ -644,6 +660,8 @@ ZbReset(struct ZigBeeT *zb)
 {
     Zigbee_Cmd_Request_t *ipcc_req;
 
+    zb_nwk_addr_cache_flush();
+    zb_aps_cache_flush();
     Pre_ZigbeeCmdProcessing();
     ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
     ipcc_req->ID = MSG_M4TOM0_ZB_RESET_REQ;
@@ -775,6 +793,338 @@ ZbApsdeDataReqCallback(struct ZigBeeT *zb, ZbApsdeDataReqT *req, void (*callback
     /* If success, followed up in MSG_M0TOM4_APSDE_DATA_REQ_CB handler */
 } /* ZbApsdeDataReqCallback */
 
+/******************************************************************************
+ * APS group and endpoint cache
+ ******************************************************************************
+ */
+/* M4 copy of the APS group table and of the endpoints, so that the group and
+ * endpoint checks done for every multicast don't each cost an IPCC transfer (or
+ * one per group table entry). The group table is read from the M0 on first use,
+ * then kept up to date by ZbApsmeAddGroupReq and ZbApsmeRemoveGroupReq. It is
+ * read again after any change the M4 can't follow (startup, leave, reset, writes
+ * of the table, removal of an endpoint or of all the groups). If the table of
+ * the M0 doesn't fit, the requests go to the M0 as before. Endpoints are learned
+ * from ZbApsmeAddEndpoint and from the answers of the M0. */
+#ifndef ZB_APS_GROUP_CACHE_SIZE
+#define ZB_APS_GROUP_CACHE_SIZE             64U /* must be a power of 2 */
+#endif
+#ifndef ZB_APS_EP_CACHE_SIZE
+#define ZB_APS_EP_CACHE_SIZE                16U
+#endif
+
+#if (ZB_APS_GROUP_CACHE_SIZE > 128U)
+#error "ZB_APS_GROUP_CACHE_SIZE is too large"
+#endif
+
+#define ZB_APS_CACHE_NONE                   0xffU
+
+/* With CONFIG_ZB_APS_CACHE_DEBUG, the cache is compared to the tables of the M0
+ * after every update. This costs the IPCC transfers the cache saves. */
+#if defined(CONFIG_ZB_APS_CACHE_DEBUG)
+#define ZB_APS_CACHE_CHECK(_zb_)            assert(ZbApsCacheCheck(_zb_))
+#else
+#define ZB_APS_CACHE_CHECK(_zb_)
+#endif
+
+struct zb_aps_group_cache_entry {
+    uint16_t group_addr;
+    uint8_t endpoint; /* Entry is free if == ZB_ENDPOINT_BCAST */
+    uint8_t next; /* Hash chain, or free list */
+};
+
+struct zb_aps_ep_cache_entry {
+    uint16_t profile_id;
+    uint8_t endpoint; /* Entry is free if == ZB_ENDPOINT_BCAST */
+};
+
+static struct {
+    struct zb_aps_group_cache_entry group[ZB_APS_GROUP_CACHE_SIZE];
+    uint8_t group_head[ZB_APS_GROUP_CACHE_SIZE];
+    uint8_t group_free;
+    uint8_t group_count;
+    bool group_loaded;
+    bool group_overflow;
+    /* Endpoints the M0 was asked about, and the ones that exist (bitmaps) */
+    uint32_t ep_known[8];
+    uint32_t ep_present[8];
+    struct zb_aps_ep_cache_entry ep[ZB_APS_EP_CACHE_SIZE];
+    bool bypass;
+} zb_aps_cache;
+
+static unsigned int
+zb_aps_group_cache_hash(uint16_t group_addr)
+{
+    return ((unsigned int)group_addr ^ ((unsigned int)group_addr >> 8)) & (ZB_APS_GROUP_CACHE_SIZE - 1U);
+} /* zb_aps_group_cache_hash */
+
+static void
+zb_aps_group_cache_reset(void)
+{
+    unsigned int i;
+
+    for (i = 0U; i < ZB_APS_GROUP_CACHE_SIZE; i++) {
+        zb_aps_cache.group[i].endpoint = ZB_ENDPOINT_BCAST;
+        zb_aps_cache.group[i].next = ((i + 1U) < ZB_APS_GROUP_CACHE_SIZE) ? (uint8_t)(i + 1U) : ZB_APS_CACHE_NONE;
+        zb_aps_cache.group_head[i] = ZB_APS_CACHE_NONE;
+    }
+    zb_aps_cache.group_free = 0U;
+    zb_aps_cache.group_count = 0U;
+    zb_aps_cache.group_overflow = false;
+} /* zb_aps_group_cache_reset */
+
+static void
+zb_aps_cache_flush(void)
+{
+    unsigned int i;
+
+    zb_aps_cache.group_loaded = false;
+    zb_aps_cache.group_overflow = false;
+    (void)memset(zb_aps_cache.ep_known, 0, sizeof(zb_aps_cache.ep_known));
+    (void)memset(zb_aps_cache.ep_present, 0, sizeof(zb_aps_cache.ep_present));
+    for (i = 0U; i < ZB_APS_EP_CACHE_SIZE; i++) {
+        zb_aps_cache.ep[i].endpoint = ZB_ENDPOINT_BCAST;
+    }
+} /* zb_aps_cache_flush */
+
+/* Returns the index of the entry, or ZB_APS_CACHE_NONE. With endpoint ==
+ * ZB_ENDPOINT_BCAST, returns the first entry of the group. */
+static uint8_t
+zb_aps_group_cache_find(uint16_t group_addr, uint8_t endpoint)
+{
+    struct zb_aps_group_cache_entry *entry;
+    uint8_t idx;
+
+    idx = zb_aps_cache.group_head[zb_aps_group_cache_hash(group_addr)];
+    while (idx != ZB_APS_CACHE_NONE) {
+        entry = &zb_aps_cache.group[idx];
+        if ((entry->group_addr == group_addr)
+            && ((endpoint == ZB_ENDPOINT_BCAST) || (entry->endpoint == endpoint))) {
+            break;
+        }
+        idx = entry->next;
+    }
+    return idx;
+} /* zb_aps_group_cache_find */
+
+static void
+zb_aps_group_cache_insert(uint16_t group_addr, uint8_t endpoint)
+{
+    struct zb_aps_group_cache_entry *entry;
+    unsigned int hash;
+    uint8_t idx;
+
+    if ((endpoint == ZB_ENDPOINT_BCAST) || (zb_aps_group_cache_find(group_addr, endpoint) != ZB_APS_CACHE_NONE)) {
+        return;
+    }
+    idx = zb_aps_cache.group_free;
+    if (idx == ZB_APS_CACHE_NONE) {
+        /* Doesn't fit, stop using the cache until it is reloaded */
+        zb_aps_cache.group_overflow = true;
+        return;
+    }
+    entry = &zb_aps_cache.group[idx];
+    zb_aps_cache.group_free = entry->next;
+    entry->group_addr = group_addr;
+    entry->endpoint = endpoint;
+    hash = zb_aps_group_cache_hash(group_addr);
+    entry->next = zb_aps_cache.group_head[hash];
+    zb_aps_cache.group_head[hash] = idx;
+    zb_aps_cache.group_count++;
+} /* zb_aps_group_cache_insert */
+
+static void
+zb_aps_group_cache_remove(uint16_t group_addr, uint8_t endpoint)
+{
+    uint8_t *link;
+    uint8_t idx;
+
+    link = &zb_aps_cache.group_head[zb_aps_group_cache_hash(group_addr)];
+    while (*link != ZB_APS_CACHE_NONE) {
+        idx = *link;
+        if ((zb_aps_cache.group[idx].group_addr == group_addr) && (zb_aps_cache.group[idx].endpoint == endpoint)) {
+            *link = zb_aps_cache.group[idx].next;
+            zb_aps_cache.group[idx].endpoint = ZB_ENDPOINT_BCAST;
+            zb_aps_cache.group[idx].next = zb_aps_cache.group_free;
+            zb_aps_cache.group_free = idx;
+            zb_aps_cache.group_count--;
+            return;
+        }
+        link = &zb_aps_cache.group[idx].next;
+    }
+} /* zb_aps_group_cache_remove */
+
+/* Reads the group table of the M0 if needed. Returns false if the requests
+ * must go to the M0. */
+static bool
+zb_aps_group_cache_load(struct ZigBeeT *zb)
+{
+    ZbApsmeGroupT group;
+    unsigned int i;
+    enum ZbStatusCodeT status;
+
+    if (zb_aps_cache.bypass || zb_aps_cache.group_overflow) {
+        return false;
+    }
+    if (zb_aps_cache.group_loaded) {
+        return true;
+    }
+    zb_aps_group_cache_reset();
+    ZbEnterCritical(zb);
+    for (i = 0;; i++) {
+        status = ZbApsGetIndex(zb, ZB_APS_IB_ID_GROUP_TABLE, &group, sizeof(group), i);
+        if (status != ZB_APS_STATUS_SUCCESS) {
+            break;
+        }
+        zb_aps_group_cache_insert(group.groupAddr, group.endpoint);
+    } /* for */
+    ZbExitCritical(zb);
+    zb_aps_cache.group_loaded = true;
+    return !zb_aps_cache.group_overflow;
+} /* zb_aps_group_cache_load */
+
+static bool
+zb_aps_ep_bit(const uint32_t *bitmap, uint8_t endpoint)
+{
+    return (bitmap[endpoint >> 5] & (1UL << (endpoint & 0x1fU))) != 0U;
+} /* zb_aps_ep_bit */
+
+static uint8_t
+zb_aps_ep_cache_find(uint8_t endpoint)
+{
+    uint8_t i;
+
+    if (endpoint == ZB_ENDPOINT_BCAST) {
+        return ZB_APS_CACHE_NONE;
+    }
+    for (i = 0U; i < ZB_APS_EP_CACHE_SIZE; i++) {
+        if (zb_aps_cache.ep[i].endpoint == endpoint) {
+            return i;
+        }
+    }
+    return ZB_APS_CACHE_NONE;
+} /* zb_aps_ep_cache_find */
+
+static void
+zb_aps_ep_cache_update(uint8_t endpoint, bool present)
+{
+    uint32_t mask = 1UL << (endpoint & 0x1fU);
+    uint8_t idx;
+
+    zb_aps_cache.ep_known[endpoint >> 5] |= mask;
+    if (present) {
+        zb_aps_cache.ep_present[endpoint >> 5] |= mask;
+    }
+    else {
+        zb_aps_cache.ep_present[endpoint >> 5] &= ~mask;
+        idx = zb_aps_ep_cache_find(endpoint);
+        if (idx != ZB_APS_CACHE_NONE) {
+            zb_aps_cache.ep[idx].endpoint = ZB_ENDPOINT_BCAST;
+        }
+    }
+} /* zb_aps_ep_cache_update */
+
+static void
+zb_aps_ep_cache_profile(uint8_t endpoint, uint16_t profile_id)
+{
+    uint8_t idx;
+
+    if (endpoint == ZB_ENDPOINT_BCAST) {
+        return;
+    }
+    idx = zb_aps_ep_cache_find(endpoint);
+    if (idx == ZB_APS_CACHE_NONE) {
+        for (idx = 0U; idx < ZB_APS_EP_CACHE_SIZE; idx++) {
+            if (zb_aps_cache.ep[idx].endpoint == ZB_ENDPOINT_BCAST) {
+                break;
+            }
+        }
+        if (idx == ZB_APS_EP_CACHE_SIZE) {
+            /* Not cached, ZbApsEndpointProfile asks the M0 */
+            return;
+        }
+    }
+    zb_aps_cache.ep[idx].endpoint = endpoint;
+    zb_aps_cache.ep[idx].profile_id = profile_id;
+} /* zb_aps_ep_cache_profile */
+
+static bool
+zb_aps_ep_exists_ipc(struct ZigBeeT *zb, uint8_t endpoint)
+{
+    Zigbee_Cmd_Request_t *ipcc_req;
+
+    Pre_ZigbeeCmdProcessing();
+    ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
+    ipcc_req->ID = MSG_M4TOM0_APS_EP_EXISTS;
+    ipcc_req->Size = 1;
+    ipcc_req->Data[0] = (uint32_t)endpoint;
+    ZIGBEE_CmdTransfer();
+    return zb_ipc_m4_get_retval() != 0U ? true : false;
+} /* zb_aps_ep_exists_ipc */
+
+static uint16_t
+zb_aps_ep_profile_ipc(struct ZigBeeT *zb, uint8_t endpoint)
+{
+    Zigbee_Cmd_Request_t *ipcc_req;
+
+    Pre_ZigbeeCmdProcessing();
+    ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
+    ipcc_req->ID = MSG_M4TOM0_APS_EP_GET_PROFILE;
+    ipcc_req->Size = 1;
+    ipcc_req->Data[0] = (uint32_t)endpoint;
+    ZIGBEE_CmdTransfer();
+    return (uint16_t)zb_ipc_m4_get_retval();
+} /* zb_aps_ep_profile_ipc */
+
+void
+ZbApsCacheBypass(struct ZigBeeT *zb, bool bypass)
+{
+    zb_aps_cache.bypass = bypass;
+    zb_aps_cache_flush();
+} /* ZbApsCacheBypass */
+
+bool
+ZbApsCacheCheck(struct ZigBeeT *zb)
+{
+    ZbApsmeGroupT group;
+    unsigned int i, num_found = 0;
+    enum ZbStatusCodeT status;
+    bool consistent = true;
+
+    if (zb_aps_cache.group_loaded && !zb_aps_cache.group_overflow) {
+        ZbEnterCritical(zb);
+        for (i = 0;; i++) {
+            status = ZbApsGetIndex(zb, ZB_APS_IB_ID_GROUP_TABLE, &group, sizeof(group), i);
+            if (status != ZB_APS_STATUS_SUCCESS) {
+                break;
+            }
+            if (group.endpoint == ZB_ENDPOINT_BCAST) {
+                continue;
+            }
+            num_found++;
+            if (zb_aps_group_cache_find(group.groupAddr, group.endpoint) == ZB_APS_CACHE_NONE) {
+                consistent = false;
+            }
+        } /* for */
+        ZbExitCritical(zb);
+        if (num_found != zb_aps_cache.group_count) {
+            consistent = false;
+        }
+    }
+    for (i = 0U; i <= 0xffU; i++) {
+        if (zb_aps_ep_bit(zb_aps_cache.ep_known, (uint8_t)i)
+            && (zb_aps_ep_exists_ipc(zb, (uint8_t)i) != zb_aps_ep_bit(zb_aps_cache.ep_present, (uint8_t)i))) {
+            consistent = false;
+        }
+    }
+    for (i = 0U; i < ZB_APS_EP_CACHE_SIZE; i++) {
+        if ((zb_aps_cache.ep[i].endpoint != ZB_ENDPOINT_BCAST)
+            && (zb_aps_ep_profile_ipc(zb, zb_aps_cache.ep[i].endpoint) != zb_aps_cache.ep[i].profile_id)) {
+            consistent = false;
+        }
+    }
+    return consistent;
+} /* ZbApsCacheCheck */
+
 void
 ZbApsmeAddEndpoint(struct ZigBeeT *zb, ZbApsmeAddEndpointReqT *r, ZbApsmeAddEndpointConfT *c)
 {
@@ -787,6 +1137,11 @@ ZbApsmeAddEndpoint(struct ZigBeeT *zb, ZbApsmeAddEndpointReqT *r, ZbApsmeAddEndp
     ipcc_req->Data[0] = (uint32_t)r;
     ipcc_req->Data[1] = (uint32_t)c;
     ZIGBEE_CmdTransfer();
+    if (c->status == ZB_APS_STATUS_SUCCESS) {
+        zb_aps_ep_cache_update(r->endpoint, true);
+        zb_aps_ep_cache_profile(r->endpoint, r->profileId);
+        ZB_APS_CACHE_CHECK(zb);
+    }
 } /* ZbApsmeAddEndpoint */
 
 void
@@ -801,6 +1156,12 @@ ZbApsmeRemoveEndpoint(struct ZigBeeT *zb, ZbApsmeRemoveEndpointReqT *r, ZbApsmeR
     ipcc_req->Data[0] = (uint32_t)r;
     ipcc_req->Data[1] = (uint32_t)c;
     ZIGBEE_CmdTransfer();
+    if (c->status == ZB_APS_STATUS_SUCCESS) {
+        zb_aps_ep_cache_update(r->endpoint, false);
+        /* The groups of the endpoint may be gone too */
+        zb_aps_cache.group_loaded = false;
+        ZB_APS_CACHE_CHECK(zb);
+    }
 } /* ZbApsmeRemoveEndpoint */
 
 struct ZbApsFilterT *
@@ -812,7 +1173,7 @@ ZbApsFilterEndpointAdd(struct ZigBeeT *zb, uint8_t endpoint, uint16_t profileId,
     struct ZbApsFilterT *filter;
 
     /* FIXME - track these allocations so they can be freed later? */
-    aps_filter_cb = malloc(sizeof(struct aps_filter_cb));
+    aps_filter_cb = ZbHeapAlloc(NULL, sizeof(struct aps_filter_cb));
     if (aps_filter_cb == NULL) {
         return NULL;
     }
@@ -829,7 +1190,7 @@ ZbApsFilterEndpointAdd(struct ZigBeeT *zb, uint8_t endpoint, uint16_t profileId,
     ZIGBEE_CmdTransfer();
     filter = (struct ZbApsFilterT *)zb_ipc_m4_get_retval();
     if (filter == NULL) {
-        free(aps_filter_cb);
+        ZbHeapFree(NULL, aps_filter_cb);
     }
     /* Callbacks go to MSG_M0TOM4_APS_FILTER_ENDPOINT_CB handler */
     return filter;
@@ -844,7 +1205,7 @@ ZbApsmeEndpointConfigNoMatchCallback(struct ZigBeeT *zb, uint8_t endpoint,
     bool retval;
 
     /* FIXME - track these allocations so they can be freed later? */
-    aps_filter_cb = malloc(sizeof(struct aps_filter_cb));
+    aps_filter_cb = ZbHeapAlloc(NULL, sizeof(struct aps_filter_cb));
     if (aps_filter_cb == NULL) {
         return false;
     }
@@ -860,7 +1221,7 @@ ZbApsmeEndpointConfigNoMatchCallback(struct ZigBeeT *zb, uint8_t endpoint,
     ZIGBEE_CmdTransfer();
     retval = zb_ipc_m4_get_retval() != 0U ? true : false;
     if (!retval) {
-        free(aps_filter_cb);
+        ZbHeapFree(NULL, aps_filter_cb);
     }
     /* Callbacks go to MSG_M0TOM4_APS_FILTER_ENDPOINT_CB handler */
     return retval;
@@ -875,7 +1236,7 @@ ZbApsFilterClusterAdd(struct ZigBeeT *zb, uint8_t endpoint, uint16_t clusterId,
     struct ZbApsFilterT *filter;
 
     /* FIXME - track these allocations so they can be freed later. */
-    aps_filter_cb = malloc(sizeof(struct aps_filter_cb));
+    aps_filter_cb = ZbHeapAlloc(NULL, sizeof(struct aps_filter_cb));
     if (aps_filter_cb == NULL) {
         return NULL;
     }
@@ -893,7 +1254,7 @@ ZbApsFilterClusterAdd(struct ZigBeeT *zb, uint8_t endpoint, uint16_t clusterId,
     ZIGBEE_CmdTransfer();
     filter = (struct ZbApsFilterT *)zb_ipc_m4_get_retval();
     if (filter == NULL) {
-        free(aps_filter_cb);
+        ZbHeapFree(NULL, aps_filter_cb);
     }
     /* Callbacks go to MSG_M0TOM4_APS_FILTER_CLUSTER_CB handler */
     return filter;
@@ -918,29 +1279,36 @@ ZbApsmeEndpointClusterListAppend(struct ZigBeeT *zb, uint8_t endpoint, uint16_t
 bool
 ZbApsEndpointExists(struct ZigBeeT *zb, uint8_t endpoint)
 {
-    Zigbee_Cmd_Request_t *ipcc_req;
+    bool exists;
 
-    Pre_ZigbeeCmdProcessing();
-    ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
-    ipcc_req->ID = MSG_M4TOM0_APS_EP_EXISTS;
-    ipcc_req->Size = 1;
-    ipcc_req->Data[0] = (uint32_t)endpoint;
-    ZIGBEE_CmdTransfer();
-    return zb_ipc_m4_get_retval() != 0U ? true : false;
+    if (!zb_aps_cache.bypass && zb_aps_ep_bit(zb_aps_cache.ep_known, endpoint)) {
+        return zb_aps_ep_bit(zb_aps_cache.ep_present, endpoint);
+    }
+    exists = zb_aps_ep_exists_ipc(zb, endpoint);
+    if (!zb_aps_cache.bypass) {
+        zb_aps_ep_cache_update(endpoint, exists);
+    }
+    return exists;
 } /* ZbApsEndpointExists */
 
 uint16_t
 ZbApsEndpointProfile(struct ZigBeeT *zb, uint8_t endpoint)
 {
-    Zigbee_Cmd_Request_t *ipcc_req;
+    uint16_t profile_id;
+    uint8_t idx;
 
-    Pre_ZigbeeCmdProcessing();
-    ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
-    ipcc_req->ID = MSG_M4TOM0_APS_EP_GET_PROFILE;
-    ipcc_req->Size = 1;
-    ipcc_req->Data[0] = (uint32_t)endpoint;
-    ZIGBEE_CmdTransfer();
-    return (uint16_t)zb_ipc_m4_get_retval();
+    if (zb_aps_cache.bypass) {
+        return zb_aps_ep_profile_ipc(zb, endpoint);
+    }
+    idx = zb_aps_ep_cache_find(endpoint);
+    if (idx != ZB_APS_CACHE_NONE) {
+        return zb_aps_cache.ep[idx].profile_id;
+    }
+    profile_id = zb_aps_ep_profile_ipc(zb, endpoint);
+    if (zb_aps_ep_bit(zb_aps_cache.ep_present, endpoint)) {
+        zb_aps_ep_cache_profile(endpoint, profile_id);
+    }
+    return profile_id;
 } /* ZbApsEndpointProfile */
 
 bool
@@ -1017,6 +1385,9 @@ ZbApsSetIndex(struct ZigBeeT *zb, enum ZbApsmeIbAttrIdT attrId, const void *attr
     ipcc_req->Data[0] = (uint32_t)&apsmeSetReq;
     ipcc_req->Data[1] = (uint32_t)&apsmeSetConf;
     ZIGBEE_CmdTransfer();
+    if (attrId == ZB_APS_IB_ID_GROUP_TABLE) {
+        zb_aps_cache.group_loaded = false;
+    }
     return apsmeSetConf.status;
 } /* ZbApsSetIndex */
 
@@ -1032,6 +1403,14 @@ ZbApsmeAddGroupReq(struct ZigBeeT *zb, ZbApsmeAddGroupReqT *r, ZbApsmeAddGroupCo
     ipcc_req->Data[0] = (uint32_t)r;
     ipcc_req->Data[1] = (uint32_t)c;
     ZIGBEE_CmdTransfer();
+    if (r->endpt == ZB_ENDPOINT_BCAST) {
+        /* May have been done for some of the endpoints only */
+        zb_aps_cache.group_loaded = false;
+    }
+    else if ((c->status == ZB_APS_STATUS_SUCCESS) && zb_aps_cache.group_loaded) {
+        zb_aps_group_cache_insert(r->groupAddr, r->endpt);
+    }
+    ZB_APS_CACHE_CHECK(zb);
 } /* ZbApsmeAddGroupReq */
 
 void
@@ -1046,6 +1425,14 @@ ZbApsmeRemoveGroupReq(struct ZigBeeT *zb, ZbApsmeRemoveGroupReqT *r, ZbApsmeRemo
     ipcc_req->Data[0] = (uint32_t)r;
     ipcc_req->Data[1] = (uint32_t)c;
     ZIGBEE_CmdTransfer();
+    if (r->endpt == ZB_ENDPOINT_BCAST) {
+        /* May have been done for some of the endpoints only */
+        zb_aps_cache.group_loaded = false;
+    }
+    else if ((c->status == ZB_APS_STATUS_SUCCESS) && zb_aps_cache.group_loaded) {
+        zb_aps_group_cache_remove(r->groupAddr, r->endpt);
+    }
+    ZB_APS_CACHE_CHECK(zb);
 } /* ZbApsmeRemoveGroupReq */
 
 void
@@ -1060,6 +1447,7 @@ ZbApsmeRemoveAllGroupsReq(struct ZigBeeT *zb, ZbApsmeRemoveAllGroupsReqT *r, ZbA
     ipcc_req->Data[0] = (uint32_t)r;
     ipcc_req->Data[1] = (uint32_t)c;
     ZIGBEE_CmdTransfer();
+    zb_aps_cache.group_loaded = false;
 } /* ZbApsmeRemoveAllGroupsReq */
 
 bool
@@ -1069,6 +1457,9 @@ ZbApsGroupIsMember(struct ZigBeeT *zb, uint16_t groupAddr, uint8_t endpoint)
     unsigned int i;
     enum ZbStatusCodeT status;
 
+    if (zb_aps_group_cache_load(zb)) {
+        return zb_aps_group_cache_find(groupAddr, endpoint) != ZB_APS_CACHE_NONE;
+    }
     ZbEnterCritical(zb);
     for (i = 0;; i++) {
         status = ZbApsGetIndex(zb, ZB_APS_IB_ID_GROUP_TABLE, &group, sizeof(group), i);
@@ -1125,6 +1516,14 @@ ZbApsGroupsGetMembership(struct ZigBeeT *zb, uint8_t endpoint, uint16_t *group_l
     unsigned int i, len = 0;
     enum ZbStatusCodeT status;
 
+    if (zb_aps_group_cache_load(zb)) {
+        for (i = 0U; (i < ZB_APS_GROUP_CACHE_SIZE) && (len < max_len); i++) {
+            if ((zb_aps_cache.group[i].endpoint == endpoint) && (endpoint != ZB_ENDPOINT_BCAST)) {
+                group_list[len++] = zb_aps_cache.group[i].group_addr;
+            }
+        }
+        return (uint8_t)len;
+    }
     ZbEnterCritical(zb);
     for (i = 0;; i++) {
         status = ZbApsGetIndex(zb, ZB_APS_IB_ID_GROUP_TABLE, &group, sizeof(group), i);
@@ -1369,14 +1768,48 @@ ZbMsgFilterRemove(struct ZigBeeT *zb, struct ZbMsgFilterT *filter)
  ******************************************************************************
  */
 
-/* M4 version of 'struct ZbTimerT'. It allows us to wrap up callback and arg into
- * a single arg pointer when communicating with the M0. */
+/* M4 version of 'struct ZbTimerT'. The timers allocated by the M4 run on the
+ * M4: they are kept in a list sorted by expiry time and the application only
+ * provides a single one-shot timer through ZIGBEE_TimerStart(), for the head
+ * of the list. */
 struct ZbTimerT {
+    struct ZbTimerT *next;
+    struct ZigBeeT *zb;
     void (*callback)(struct ZigBeeT *zb, void *data);
     void *arg;
-    void *m0_timer; /* Handle */
+    ZbUptimeT expire_time;
+    bool running;
 };
 
+/* Running M4 timers, sorted by expiry time */
+static struct ZbTimerT *zb_timer_list = NULL;
+
+static void
+zb_timer_unlink(struct ZbTimerT *timer)
+{
+    struct ZbTimerT **pp;
+
+    for (pp = &zb_timer_list; *pp != NULL; pp = &(*pp)->next) {
+        if (*pp == timer) {
+            *pp = timer->next;
+            break;
+        }
+    }
+    timer->next = NULL;
+    timer->running = false;
+} /* zb_timer_unlink */
+
+static void
+zb_timer_schedule(void)
+{
+    if (zb_timer_list == NULL) {
+        ZIGBEE_TimerStop();
+    }
+    else {
+        ZIGBEE_TimerStart(ZbTimeoutRemaining(ZbUptime(), zb_timer_list->expire_time));
+    }
+} /* zb_timer_schedule */
+
 struct ZbTimerT *
 ZbTimerAlloc(struct ZigBeeT *zb, void (*callback)(struct ZigBeeT *zb, void *cn_arg), void *arg)
 {
@@ -1384,24 +1817,10 @@ ZbTimerAlloc(struct ZigBeeT *zb, void (*callback)(struct ZigBeeT *zb, void *cn_a
 
     timer = ZbHeapAlloc(NULL, sizeof(struct ZbTimerT));
     if (timer != NULL) {
-        Zigbee_Cmd_Request_t *ipcc_req;
-
-        /* Configure the callback struct */
+        (void)memset(timer, 0, sizeof(struct ZbTimerT));
+        timer->zb = zb;
         timer->callback = callback;
         timer->arg = arg;
-
-        /* Pass this to the M0 (stack) */
-        Pre_ZigbeeCmdProcessing();
-        ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
-        ipcc_req->ID = MSG_M4TOM0_TIMER_ALLOC;
-        ipcc_req->Size = 1;
-        ipcc_req->Data[0] = (uint32_t)timer;
-        ZIGBEE_CmdTransfer();
-        timer->m0_timer = (void *)zb_ipc_m4_get_retval();
-        if (timer->m0_timer == NULL) {
-            ZbHeapFree(NULL, timer);
-            timer = NULL;
-        }
     }
     return timer;
 } /* ZbTimerAlloc */
@@ -1417,77 +1836,106 @@ ZbTimerChangeCallback(struct ZbTimerT *timer, void (*callback)(struct ZigBeeT *z
 void
 ZbTimerFree(struct ZbTimerT *timer)
 {
-    Zigbee_Cmd_Request_t *ipcc_req;
-
-    /* Stop and free the timer on the M0 */
-    Pre_ZigbeeCmdProcessing();
-    ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
-    ipcc_req->ID = MSG_M4TOM0_TIMER_FREE;
-    ipcc_req->Size = 1;
-    ipcc_req->Data[0] = (uint32_t)timer->m0_timer;
-    ZIGBEE_CmdTransfer();
-
-    /* Free the timer struct on the M4 */
+    ZbTimerStop(timer);
     ZbHeapFree(NULL, timer);
 } /* ZbTimerFree */
 
 bool
 ZbTimerRunning(struct ZbTimerT *timer)
 {
-    Zigbee_Cmd_Request_t *ipcc_req;
-    uint32_t retval;
-
-    Pre_ZigbeeCmdProcessing();
-    ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
-    ipcc_req->ID = MSG_M4TOM0_TIMER_RUNNING;
-    ipcc_req->Size = 1;
-    ipcc_req->Data[0] = (uint32_t)timer->m0_timer;
-    ZIGBEE_CmdTransfer();
-    retval = zb_ipc_m4_get_retval();
-    return retval != 0 ? true : false;
+    return timer->running;
 } /* ZbTimerRunning */
 
 unsigned int
 ZbTimerRemaining(struct ZbTimerT *timer)
 {
-    Zigbee_Cmd_Request_t *ipcc_req;
-
-    Pre_ZigbeeCmdProcessing();
-    ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
-    ipcc_req->ID = MSG_M4TOM0_TIMER_REMAINING;
-    ipcc_req->Size = 1;
-    ipcc_req->Data[0] = (uint32_t)timer->m0_timer;
-    ZIGBEE_CmdTransfer();
-    return (unsigned int)zb_ipc_m4_get_retval();
+    if (!timer->running) {
+        return 0;
+    }
+    return ZbTimeoutRemaining(ZbUptime(), timer->expire_time);
 } /* ZbTimerRemaining */
 
 void
 ZbTimerStop(struct ZbTimerT *timer)
 {
-    Zigbee_Cmd_Request_t *ipcc_req;
-
-    Pre_ZigbeeCmdProcessing();
-    ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
-    ipcc_req->ID = MSG_M4TOM0_TIMER_STOP;
-    ipcc_req->Size = 1;
-    ipcc_req->Data[0] = (uint32_t)timer->m0_timer;
-    ZIGBEE_CmdTransfer();
+    if (timer->running) {
+        /* The application timer is left running. If the timer was the next
+         * one to expire, Zigbee_TimerProcessing() only reschedules it. */
+        zb_timer_unlink(timer);
+    }
 } /* ZbTimerStop */
 
 void
 ZbTimerReset(struct ZbTimerT *timer, unsigned int timeout)
 {
-    Zigbee_Cmd_Request_t *ipcc_req;
+    struct ZbTimerT **pp;
+    ZbUptimeT now;
+    unsigned int remaining;
 
-    Pre_ZigbeeCmdProcessing();
-    ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
-    ipcc_req->ID = MSG_M4TOM0_TIMER_RESET;
-    ipcc_req->Size = 2;
-    ipcc_req->Data[0] = (uint32_t)timer->m0_timer;
-    ipcc_req->Data[1] = (uint32_t)timeout;
-    ZIGBEE_CmdTransfer();
+    if (timer->running) {
+        zb_timer_unlink(timer);
+    }
+
+    now = ZbUptime();
+    timer->expire_time = now + timeout;
+    timer->running = true;
+
+    /* Insert after the timers expiring at the same time or earlier */
+    remaining = ZbTimeoutRemaining(now, timer->expire_time);
+    for (pp = &zb_timer_list; *pp != NULL; pp = &(*pp)->next) {
+        if (ZbTimeoutRemaining(now, (*pp)->expire_time) > remaining) {
+            break;
+        }
+    }
+    timer->next = *pp;
+    *pp = timer;
+
+    if (zb_timer_list == timer) {
+        zb_timer_schedule();
+    }
 } /* ZbTimerReset */
 
+/**
+  * @brief  Process the M4 timers that have expired. This function shall be
+  *         called from a task when the timer started with ZIGBEE_TimerStart()
+  *         expires.
+  *
+  * @param  None
+  * @retval None
+  */
+void
+Zigbee_TimerProcessing(void)
+{
+    struct ZbTimerT *timer;
+    ZbUptimeT now;
+    unsigned int nbr_expired = 0;
+
+    /* Only the timers expired on entry are processed, so that a timer
+     * restarted with a null timeout from its callback does not loop here */
+    now = ZbUptime();
+    for (timer = zb_timer_list; timer != NULL; timer = timer->next) {
+        if (ZbTimeoutRemaining(now, timer->expire_time) != 0U) {
+            break;
+        }
+        nbr_expired++;
+    }
+
+    while ((nbr_expired != 0U) && (zb_timer_list != NULL)
+           && (ZbTimeoutRemaining(now, zb_timer_list->expire_time) == 0U)) {
+        timer = zb_timer_list;
+        zb_timer_list = timer->next;
+        timer->next = NULL;
+        timer->running = false;
+        nbr_expired--;
+
+        if (timer->callback != NULL) {
+            timer->callback(timer->zb, timer->arg);
+        }
+    }
+
+    zb_timer_schedule();
+} /* Zigbee_TimerProcessing */
+
 unsigned int
 ZbTimeoutRemaining(ZbUptimeT now, ZbUptimeT expire_time)
 {
@@ -1524,16 +1972,269 @@ ZbTimeoutRemaining(ZbUptimeT now, ZbUptimeT expire_time)
  * NWK
  ******************************************************************************
  */
-enum ZbStatusCodeT
-ZbNwkGetIndex(struct ZigBeeT *zb, enum ZbNwkNibAttrIdT attrId, void *attrPtr,
-    unsigned int attrSz, unsigned int attrIndex)
-{
-    Zigbee_Cmd_Request_t *ipcc_req;
-    ZbNlmeGetReqT nlmeGetReq;
-    ZbNlmeGetConfT nlmeGetConf;
+/* M4 cache of the NWK <-> extended address translations, so that the lookups
+ * done for every APS indication or ZCL request don't each cost an IPCC transfer.
+ * The M0 doesn't notify the M4 when a translation changes, so an entry is only
+ * trusted for ZB_NWK_ADDR_CACHE_TTL ms. Device announcements seen by the M4
+ * refresh it, and the whole cache is flushed when the network state changes
+ * (startup, leave, reset, NIB writes). */
+#ifndef ZB_NWK_ADDR_CACHE_SIZE
+#define ZB_NWK_ADDR_CACHE_SIZE              32U /* must be a power of 2, 0 to disable */
+#endif
+#ifndef ZB_NWK_ADDR_CACHE_TTL
+#define ZB_NWK_ADDR_CACHE_TTL               (60U * 1000U)
+#endif
 
-    /* Form the NLME-GET.request */
-    nlmeGetReq.attrId = attrId;
+#if (ZB_NWK_ADDR_CACHE_SIZE > 128U)
+#error "ZB_NWK_ADDR_CACHE_SIZE is too large"
+#endif
+
+#if (ZB_NWK_ADDR_CACHE_SIZE != 0U)
+#define ZB_NWK_ADDR_CACHE_NONE              0xffU
+
+struct zb_nwk_addr_cache_entry {
+    uint64_t ext_addr;
+    ZbUptimeT expire_time;
+    uint16_t nwk_addr; /* Entry is empty if == ZB_NWK_ADDR_UNDEFINED */
+    uint8_t nwk_next;
+    uint8_t ext_next;
+};
+
+static struct {
+    struct zb_nwk_addr_cache_entry entry[ZB_NWK_ADDR_CACHE_SIZE];
+    /* Hash chains, by network and by extended address */
+    uint8_t nwk_head[ZB_NWK_ADDR_CACHE_SIZE];
+    uint8_t ext_head[ZB_NWK_ADDR_CACHE_SIZE];
+    uint8_t victim;
+    bool init;
+    bool bypass;
+    uint32_t hits;
+    uint32_t misses;
+} zb_nwk_addr_cache;
+
+static unsigned int
+zb_nwk_addr_cache_hash_nwk(uint16_t nwk_addr)
+{
+    return ((unsigned int)nwk_addr ^ ((unsigned int)nwk_addr >> 8)) & (ZB_NWK_ADDR_CACHE_SIZE - 1U);
+} /* zb_nwk_addr_cache_hash_nwk */
+
+static unsigned int
+zb_nwk_addr_cache_hash_ext(uint64_t ext_addr)
+{
+    uint32_t h = (uint32_t)ext_addr ^ (uint32_t)(ext_addr >> 32);
+
+    h ^= h >> 16;
+    return ((unsigned int)h ^ ((unsigned int)h >> 8)) & (ZB_NWK_ADDR_CACHE_SIZE - 1U);
+} /* zb_nwk_addr_cache_hash_ext */
+
+static void
+zb_nwk_addr_cache_flush(void)
+{
+    unsigned int i;
+
+    for (i = 0U; i < ZB_NWK_ADDR_CACHE_SIZE; i++) {
+        zb_nwk_addr_cache.entry[i].nwk_addr = ZB_NWK_ADDR_UNDEFINED;
+        zb_nwk_addr_cache.nwk_head[i] = ZB_NWK_ADDR_CACHE_NONE;
+        zb_nwk_addr_cache.ext_head[i] = ZB_NWK_ADDR_CACHE_NONE;
+    }
+    zb_nwk_addr_cache.victim = 0U;
+    zb_nwk_addr_cache.init = true;
+} /* zb_nwk_addr_cache_flush */
+
+static void
+zb_nwk_addr_cache_unlink(uint8_t idx)
+{
+    struct zb_nwk_addr_cache_entry *entry = &zb_nwk_addr_cache.entry[idx];
+    uint8_t *link;
+
+    if (entry->nwk_addr == ZB_NWK_ADDR_UNDEFINED) {
+        return;
+    }
+    link = &zb_nwk_addr_cache.nwk_head[zb_nwk_addr_cache_hash_nwk(entry->nwk_addr)];
+    while (*link != idx) {
+        link = &zb_nwk_addr_cache.entry[*link].nwk_next;
+    }
+    *link = entry->nwk_next;
+    link = &zb_nwk_addr_cache.ext_head[zb_nwk_addr_cache_hash_ext(entry->ext_addr)];
+    while (*link != idx) {
+        link = &zb_nwk_addr_cache.entry[*link].ext_next;
+    }
+    *link = entry->ext_next;
+    entry->nwk_addr = ZB_NWK_ADDR_UNDEFINED;
+} /* zb_nwk_addr_cache_unlink */
+
+/* Returns the index of a valid entry, or ZB_NWK_ADDR_CACHE_NONE. Expired entries
+ * met on the way are dropped. */
+static uint8_t
+zb_nwk_addr_cache_find(bool by_nwk, uint16_t nwk_addr, uint64_t ext_addr)
+{
+    struct zb_nwk_addr_cache_entry *entry;
+    ZbUptimeT now = ZbUptime();
+    uint8_t idx, next;
+
+    if (!zb_nwk_addr_cache.init) {
+        zb_nwk_addr_cache_flush();
+    }
+    if (by_nwk) {
+        idx = zb_nwk_addr_cache.nwk_head[zb_nwk_addr_cache_hash_nwk(nwk_addr)];
+    }
+    else {
+        idx = zb_nwk_addr_cache.ext_head[zb_nwk_addr_cache_hash_ext(ext_addr)];
+    }
+    while (idx != ZB_NWK_ADDR_CACHE_NONE) {
+        entry = &zb_nwk_addr_cache.entry[idx];
+        next = by_nwk ? entry->nwk_next : entry->ext_next;
+        if (ZbTimeoutRemaining(now, entry->expire_time) == 0U) {
+            zb_nwk_addr_cache_unlink(idx);
+        }
+        else if (by_nwk ? (entry->nwk_addr == nwk_addr) : (entry->ext_addr == ext_addr)) {
+            return idx;
+        }
+        idx = next;
+    }
+    return ZB_NWK_ADDR_CACHE_NONE;
+} /* zb_nwk_addr_cache_find */
+
+static void
+zb_nwk_addr_cache_add(uint16_t nwk_addr, uint64_t ext_addr)
+{
+    struct zb_nwk_addr_cache_entry *entry;
+    unsigned int hash;
+    uint8_t idx;
+
+    if (zb_nwk_addr_cache.bypass || (nwk_addr >= ZB_NWK_ADDR_USE_EXT) || (ext_addr == 0U)) {
+        return;
+    }
+    /* Keep the translation one to one */
+    idx = zb_nwk_addr_cache_find(true, nwk_addr, 0U);
+    if (idx != ZB_NWK_ADDR_CACHE_NONE) {
+        zb_nwk_addr_cache_unlink(idx);
+    }
+    idx = zb_nwk_addr_cache_find(false, 0U, ext_addr);
+    if (idx != ZB_NWK_ADDR_CACHE_NONE) {
+        zb_nwk_addr_cache_unlink(idx);
+    }
+
+    /* Replace entries in round robin */
+    idx = zb_nwk_addr_cache.victim;
+    zb_nwk_addr_cache.victim = (uint8_t)((idx + 1U) & (ZB_NWK_ADDR_CACHE_SIZE - 1U));
+    zb_nwk_addr_cache_unlink(idx);
+
+    entry = &zb_nwk_addr_cache.entry[idx];
+    entry->nwk_addr = nwk_addr;
+    entry->ext_addr = ext_addr;
+    entry->expire_time = ZbUptime() + ZB_NWK_ADDR_CACHE_TTL;
+    hash = zb_nwk_addr_cache_hash_nwk(nwk_addr);
+    entry->nwk_next = zb_nwk_addr_cache.nwk_head[hash];
+    zb_nwk_addr_cache.nwk_head[hash] = idx;
+    hash = zb_nwk_addr_cache_hash_ext(ext_addr);
+    entry->ext_next = zb_nwk_addr_cache.ext_head[hash];
+    zb_nwk_addr_cache.ext_head[hash] = idx;
+} /* zb_nwk_addr_cache_add */
+
+static bool
+zb_nwk_addr_cache_lookup_ext(uint16_t nwk_addr, uint64_t *ext_addr)
+{
+    uint8_t idx;
+
+    if (zb_nwk_addr_cache.bypass) {
+        return false;
+    }
+    idx = zb_nwk_addr_cache_find(true, nwk_addr, 0U);
+    if (idx == ZB_NWK_ADDR_CACHE_NONE) {
+        zb_nwk_addr_cache.misses++;
+        return false;
+    }
+    zb_nwk_addr_cache.hits++;
+    *ext_addr = zb_nwk_addr_cache.entry[idx].ext_addr;
+    return true;
+} /* zb_nwk_addr_cache_lookup_ext */
+
+static bool
+zb_nwk_addr_cache_lookup_nwk(uint64_t ext_addr, uint16_t *nwk_addr)
+{
+    uint8_t idx;
+
+    if (zb_nwk_addr_cache.bypass) {
+        return false;
+    }
+    idx = zb_nwk_addr_cache_find(false, 0U, ext_addr);
+    if (idx == ZB_NWK_ADDR_CACHE_NONE) {
+        zb_nwk_addr_cache.misses++;
+        return false;
+    }
+    zb_nwk_addr_cache.hits++;
+    *nwk_addr = zb_nwk_addr_cache.entry[idx].nwk_addr;
+    return true;
+} /* zb_nwk_addr_cache_lookup_nwk */
+
+void
+ZbNwkAddrCacheBypass(struct ZigBeeT *zb, bool bypass)
+{
+    zb_nwk_addr_cache.bypass = bypass;
+    zb_nwk_addr_cache_flush();
+} /* ZbNwkAddrCacheBypass */
+
+void
+ZbNwkAddrCacheStats(struct ZigBeeT *zb, uint32_t *hits, uint32_t *misses)
+{
+    if (hits != NULL) {
+        *hits = zb_nwk_addr_cache.hits;
+    }
+    if (misses != NULL) {
+        *misses = zb_nwk_addr_cache.misses;
+    }
+} /* ZbNwkAddrCacheStats */
+#else
+static void
+zb_nwk_addr_cache_flush(void)
+{
+} /* zb_nwk_addr_cache_flush */
+
+static void
+zb_nwk_addr_cache_add(uint16_t nwk_addr, uint64_t ext_addr)
+{
+} /* zb_nwk_addr_cache_add */
+
+static bool
+zb_nwk_addr_cache_lookup_ext(uint16_t nwk_addr, uint64_t *ext_addr)
+{
+    return false;
+} /* zb_nwk_addr_cache_lookup_ext */
+
+static bool
+zb_nwk_addr_cache_lookup_nwk(uint64_t ext_addr, uint16_t *nwk_addr)
+{
+    return false;
+} /* zb_nwk_addr_cache_lookup_nwk */
+
+void
+ZbNwkAddrCacheBypass(struct ZigBeeT *zb, bool bypass)
+{
+} /* ZbNwkAddrCacheBypass */
+
+void
+ZbNwkAddrCacheStats(struct ZigBeeT *zb, uint32_t *hits, uint32_t *misses)
+{
+    if (hits != NULL) {
+        *hits = 0U;
+    }
+    if (misses != NULL) {
+        *misses = 0U;
+    }
+} /* ZbNwkAddrCacheStats */
+#endif
+
+enum ZbStatusCodeT
+ZbNwkGetIndex(struct ZigBeeT *zb, enum ZbNwkNibAttrIdT attrId, void *attrPtr,
+    unsigned int attrSz, unsigned int attrIndex)
+{
+    Zigbee_Cmd_Request_t *ipcc_req;
+    ZbNlmeGetReqT nlmeGetReq;
+    ZbNlmeGetConfT nlmeGetConf;
+
+    /* Form the NLME-GET.request */
+    nlmeGetReq.attrId = attrId;
     nlmeGetReq.attr = attrPtr;
     nlmeGetReq.attrLength = attrSz;
     nlmeGetReq.attrIndex = attrIndex;
@@ -1562,6 +2263,7 @@ ZbNwkSetIndex(struct ZigBeeT *zb, enum ZbNwkNibAttrIdT attrId, void *attrPtr,
     nlmeSetReq.attrLength = attrSz;
     nlmeSetReq.attrIndex = attrIndex;
 
+    zb_nwk_addr_cache_flush();
     Pre_ZigbeeCmdProcessing();
     ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
     ipcc_req->ID = MSG_M4TOM0_NWK_SET_INDEX;
@@ -1621,16 +2323,20 @@ ZbNwkAddrLookupExt(struct ZigBeeT *zb, uint16_t nwkAddr)
     Zigbee_Cmd_Request_t *ipcc_req;
     uint64_t ext_addr;
 
+    if (zb_nwk_addr_cache_lookup_ext(nwkAddr, &ext_addr)) {
+        return ext_addr;
+    }
     Pre_ZigbeeCmdProcessing();
     ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
     ipcc_req->ID = MSG_M4TOM0_NWK_ADDR_LOOKUP_EXT;
     ipcc_req->Size = 1;
     ipcc_req->Data[0] = (uint32_t)nwkAddr;
     ZIGBEE_CmdTransfer();
-    /* Parse return value */
+    /* Parse return value, the extended address is split across two words */
     ipcc_req = ZIGBEE_Get_OTCmdRspPayloadBuffer();
     assert(ipcc_req->Size == 2);
-    zb_ipc_m4_memcpy2(&ext_addr, &ipcc_req->Data[0], 8);
+    ext_addr = ((uint64_t)ipcc_req->Data[1] << 32) | (uint64_t)ipcc_req->Data[0];
+    zb_nwk_addr_cache_add(nwkAddr, ext_addr);
     return ext_addr;
 } /* ZbNwkAddrLookupExt */
 
@@ -1638,7 +2344,11 @@ uint16_t
 ZbNwkAddrLookupNwk(struct ZigBeeT *zb, uint64_t extAddr)
 {
     Zigbee_Cmd_Request_t *ipcc_req;
+    uint16_t nwk_addr;
 
+    if (zb_nwk_addr_cache_lookup_nwk(extAddr, &nwk_addr)) {
+        return nwk_addr;
+    }
     Pre_ZigbeeCmdProcessing();
     ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
     ipcc_req->ID = MSG_M4TOM0_NWK_ADDR_LOOKUP_NWK;
@@ -1646,7 +2356,9 @@ ZbNwkAddrLookupNwk(struct ZigBeeT *zb, uint64_t extAddr)
     ipcc_req->Size = 2;
     zb_ipc_m4_memcpy2(ipcc_req->Data, &extAddr, 8);
     ZIGBEE_CmdTransfer();
-    return (uint16_t)zb_ipc_m4_get_retval();
+    nwk_addr = (uint16_t)zb_ipc_m4_get_retval();
+    zb_nwk_addr_cache_add(nwk_addr, extAddr);
+    return nwk_addr;
 } /* ZbNwkAddrLookupNwk */
 
 bool
@@ -1662,7 +2374,13 @@ ZbNwkAddrIsChildExt(struct ZigBeeT *zb, uint64_t extAddr, uint16_t *nwkAddrPtr)
     zb_ipc_m4_memcpy2(ipcc_req->Data, &extAddr, 8);
     ipcc_req->Data[2] = (uint32_t)nwkAddrPtr;
     ZIGBEE_CmdTransfer();
-    return zb_ipc_m4_get_retval() != 0U ? true : false;
+    if (zb_ipc_m4_get_retval() == 0U) {
+        return false;
+    }
+    if (nwkAddrPtr != NULL) {
+        zb_nwk_addr_cache_add(*nwkAddrPtr, extAddr);
+    }
+    return true;
 } /* ZbNwkAddrIsChildExt */
 
 bool
@@ -1677,7 +2395,13 @@ ZbNwkAddrIsChildNwk(struct ZigBeeT *zb, uint16_t nwkAddr, uint64_t *extAddrPtr)
     ipcc_req->Data[0] = (uint32_t)nwkAddr;
     ipcc_req->Data[1] = (uint32_t)extAddrPtr;
     ZIGBEE_CmdTransfer();
-    return zb_ipc_m4_get_retval() != 0U ? true : false;
+    if (zb_ipc_m4_get_retval() == 0U) {
+        return false;
+    }
+    if (extAddrPtr != NULL) {
+        zb_nwk_addr_cache_add(nwkAddr, *extAddrPtr);
+    }
+    return true;
 } /* ZbNwkAddrIsChildNwk */
 
 bool
@@ -1728,6 +2452,8 @@ ZbNlmeLeaveReq(struct ZigBeeT *zb, struct ZbNlmeLeaveReqT *req,
     if (info == NULL) {
         return ZB_STATUS_ALLOC_FAIL;
     }
+    zb_nwk_addr_cache_flush();
+    zb_aps_cache_flush();
     Pre_ZigbeeCmdProcessing();
     ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
     ipcc_req->ID = MSG_M4TOM0_NLME_LEAVE;
@@ -2394,6 +3120,8 @@ ZbZdoLeaveReq(struct ZigBeeT *zb, ZbZdoLeaveReqT *req,
     if (info == NULL) {
         return ZB_STATUS_ALLOC_FAIL;
     }
+    zb_nwk_addr_cache_flush();
+    zb_aps_cache_flush();
     Pre_ZigbeeCmdProcessing();
     ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
     ipcc_req->ID = MSG_M4TOM0_ZDO_MGMT_LEAVE;
@@ -3056,6 +3784,152 @@ ZbApsFragDropTxClear(struct ZigBeeT *zb)
  * AES & Hashing
  ******************************************************************************
  */
+/* The AES-MMO hash is computed on the M4. The AES1 peripheral is used when
+ * the CRYP HAL module is enabled in the application, the software AES below
+ * otherwise. */
+#if defined(HAL_CRYP_MODULE_ENABLED) && defined(AES1)
+static CRYP_HandleTypeDef zb_aes_hcryp;
+static uint32_t zb_aes_key[AES_BLOCK_SIZE / 4U];
+
+static void
+zb_aes_encrypt(const uint8_t *key, const uint8_t *in, uint8_t *out)
+{
+    uint32_t in_words[AES_BLOCK_SIZE / 4U];
+    uint32_t out_words[AES_BLOCK_SIZE / 4U];
+    unsigned int i;
+
+    /* The key registers expect the first key byte as the most significant
+     * byte of the first word */
+    for (i = 0; i < (AES_BLOCK_SIZE / 4U); i++) {
+        zb_aes_key[i] = ((uint32_t)key[4U * i] << 24) | ((uint32_t)key[(4U * i) + 1U] << 16)
+            | ((uint32_t)key[(4U * i) + 2U] << 8) | (uint32_t)key[(4U * i) + 3U];
+    }
+
+    if (zb_aes_hcryp.Instance == NULL) {
+        __HAL_RCC_AES1_CLK_ENABLE();
+        zb_aes_hcryp.Instance = AES1;
+        zb_aes_hcryp.Init.DataType = CRYP_DATATYPE_8B;
+        zb_aes_hcryp.Init.KeySize = CRYP_KEYSIZE_128B;
+        zb_aes_hcryp.Init.pKey = zb_aes_key;
+        zb_aes_hcryp.Init.Algorithm = CRYP_AES_ECB;
+        zb_aes_hcryp.Init.DataWidthUnit = CRYP_DATAWIDTHUNIT_BYTE;
+        zb_aes_hcryp.Init.KeyIVConfigSkip = CRYP_KEYIVCONFIG_ALWAYS;
+        (void)HAL_CRYP_Init(&zb_aes_hcryp);
+    }
+
+    (void)memcpy(in_words, in, AES_BLOCK_SIZE);
+    (void)HAL_CRYP_Encrypt(&zb_aes_hcryp, in_words, AES_BLOCK_SIZE, out_words, HAL_MAX_DELAY);
+    (void)memcpy(out, out_words, AES_BLOCK_SIZE);
+} /* zb_aes_encrypt */
+
+#else
+static const uint8_t zb_aes_sbox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
+
+static uint8_t
+zb_aes_xtime(uint8_t x)
+{
+    return (uint8_t)((x << 1) ^ (((x & 0x80U) != 0U) ? 0x1bU : 0x00U));
+} /* zb_aes_xtime */
+
+static void
+zb_aes_encrypt(const uint8_t *key, const uint8_t *in, uint8_t *out)
+{
+    uint8_t round_key[AES_BLOCK_SIZE];
+    uint8_t state[AES_BLOCK_SIZE];
+    uint8_t tmp[4];
+    uint8_t rcon = 0x01U;
+    unsigned int round, i;
+
+    (void)memcpy(round_key, key, AES_BLOCK_SIZE);
+    for (i = 0; i < AES_BLOCK_SIZE; i++) {
+        state[i] = in[i] ^ round_key[i];
+    }
+
+    for (round = 1; round <= 10U; round++) {
+        /* SubBytes and ShiftRows. The state is stored column by column. */
+        for (i = 0; i < AES_BLOCK_SIZE; i++) {
+            state[i] = zb_aes_sbox[state[i]];
+        }
+        tmp[0] = state[1];
+        state[1] = state[5];
+        state[5] = state[9];
+        state[9] = state[13];
+        state[13] = tmp[0];
+        tmp[0] = state[2];
+        tmp[1] = state[6];
+        state[2] = state[10];
+        state[6] = state[14];
+        state[10] = tmp[0];
+        state[14] = tmp[1];
+        tmp[0] = state[15];
+        state[15] = state[11];
+        state[11] = state[7];
+        state[7] = state[3];
+        state[3] = tmp[0];
+
+        /* MixColumns, except in the last round */
+        if (round != 10U) {
+            for (i = 0; i < AES_BLOCK_SIZE; i += 4U) {
+                uint8_t all = state[i] ^ state[i + 1U] ^ state[i + 2U] ^ state[i + 3U];
+
+                tmp[0] = state[i];
+                state[i] ^= all ^ zb_aes_xtime(state[i] ^ state[i + 1U]);
+                state[i + 1U] ^= all ^ zb_aes_xtime(state[i + 1U] ^ state[i + 2U]);
+                state[i + 2U] ^= all ^ zb_aes_xtime(state[i + 2U] ^ state[i + 3U]);
+                state[i + 3U] ^= all ^ zb_aes_xtime(state[i + 3U] ^ tmp[0]);
+            }
+        }
+
+        /* Next round key, computed on the fly */
+        round_key[0] ^= zb_aes_sbox[round_key[13]] ^ rcon;
+        round_key[1] ^= zb_aes_sbox[round_key[14]];
+        round_key[2] ^= zb_aes_sbox[round_key[15]];
+        round_key[3] ^= zb_aes_sbox[round_key[12]];
+        for (i = 4; i < AES_BLOCK_SIZE; i++) {
+            round_key[i] ^= round_key[i - 4U];
+        }
+        rcon = zb_aes_xtime(rcon);
+
+        /* AddRoundKey */
+        for (i = 0; i < AES_BLOCK_SIZE; i++) {
+            state[i] ^= round_key[i];
+        }
+    }
+
+    (void)memcpy(out, state, AES_BLOCK_SIZE);
+} /* zb_aes_encrypt */
+#endif
+
+/* Matyas-Meyer-Oseas compression of the current block: H = E(H, M) ^ M */
+static void
+zb_hash_block(struct ZbHash *h)
+{
+    uint8_t cipher[AES_BLOCK_SIZE];
+    unsigned int i;
+
+    zb_aes_encrypt(h->hash, h->m, cipher);
+    for (i = 0; i < AES_BLOCK_SIZE; i++) {
+        h->hash[i] = cipher[i] ^ h->m[i];
+    }
+} /* zb_hash_block */
+
 void
 ZbAesMmoHash(uint8_t const *data, const unsigned int length, uint8_t *hash)
 {
@@ -3077,62 +3951,354 @@ ZbHashInit(struct ZbHash *h)
 void
 ZbHashAdd(struct ZbHash *h, const void *data, uint32_t len)
 {
-    Zigbee_Cmd_Request_t *ipcc_req;
+    const uint8_t *ptr = data;
+    uint32_t offset;
+    uint32_t chunk;
 
-    Pre_ZigbeeCmdProcessing();
-    ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
-    ipcc_req->ID = MSG_M4TOM0_ZB_HASH_ADD;
-    ipcc_req->Size = 3;
-    ipcc_req->Data[0] = (uint32_t)h;
-    ipcc_req->Data[1] = (uint32_t)data;
-    ipcc_req->Data[2] = (uint32_t)len;
-    ZIGBEE_CmdTransfer();
+    while (len > 0U) {
+        offset = h->length % AES_BLOCK_SIZE;
+        chunk = AES_BLOCK_SIZE - offset;
+        if (chunk > len) {
+            chunk = len;
+        }
+        (void)memcpy(&h->m[offset], ptr, chunk);
+        h->length += chunk;
+        ptr += chunk;
+        len -= chunk;
+        if ((offset + chunk) == AES_BLOCK_SIZE) {
+            zb_hash_block(h);
+        }
+    }
 } /* ZbHashAdd */
 
 void
 ZbHashByte(struct ZbHash *h, uint8_t byte)
 {
-    Zigbee_Cmd_Request_t *ipcc_req;
-
-    Pre_ZigbeeCmdProcessing();
-    ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
-    ipcc_req->ID = MSG_M4TOM0_ZB_HASH_BYTE;
-    ipcc_req->Size = 2;
-    ipcc_req->Data[0] = (uint32_t)h;
-    ipcc_req->Data[1] = (uint32_t)byte;
-    ZIGBEE_CmdTransfer();
+    ZbHashAdd(h, &byte, 1U);
 } /* ZbHashByte */
 
 void
 ZbHashDigest(struct ZbHash *h, void *digest)
 {
-    Zigbee_Cmd_Request_t *ipcc_req;
+    uint32_t offset = h->length % AES_BLOCK_SIZE;
+    uint32_t bit_len = h->length * 8U;
+    uint32_t len_offset;
 
-    Pre_ZigbeeCmdProcessing();
-    ipcc_req = ZIGBEE_Get_OTCmdPayloadBuffer();
-    ipcc_req->ID = MSG_M4TOM0_ZB_HASH_DIGEST;
-    ipcc_req->Size = 2;
-    ipcc_req->Data[0] = (uint32_t)h;
-    ipcc_req->Data[1] = (uint32_t)digest;
-    ZIGBEE_CmdTransfer();
+    /* Padding: a '1' bit, zero bits and the message length in bits. The
+     * length is written on 16 bits for messages shorter than 2^16 bits, on
+     * 32 bits followed by 16 zero bits otherwise. */
+    len_offset = (bit_len < 0x10000U) ? (AES_BLOCK_SIZE - 2U) : (AES_BLOCK_SIZE - 6U);
+
+    h->m[offset++] = 0x80U;
+    if (offset > len_offset) {
+        (void)memset(&h->m[offset], 0, AES_BLOCK_SIZE - offset);
+        zb_hash_block(h);
+        offset = 0;
+    }
+    (void)memset(&h->m[offset], 0, AES_BLOCK_SIZE - offset);
+    if (bit_len < 0x10000U) {
+        h->m[len_offset] = (uint8_t)(bit_len >> 8);
+        h->m[len_offset + 1U] = (uint8_t)bit_len;
+    }
+    else {
+        h->m[len_offset] = (uint8_t)(bit_len >> 24);
+        h->m[len_offset + 1U] = (uint8_t)(bit_len >> 16);
+        h->m[len_offset + 2U] = (uint8_t)(bit_len >> 8);
+        h->m[len_offset + 3U] = (uint8_t)bit_len;
+    }
+    zb_hash_block(h);
+
+    (void)memcpy(digest, h->hash, AES_BLOCK_SIZE);
 } /* ZbHashDigest */
 
 /******************************************************************************
  * Memory Helpers
  ******************************************************************************
  */
+/* Small blocks (IPC callback info, APS filters, blocks requested by the M0, ...)
+ * are taken from fixed-size slab classes with O(1) alloc and free. Requests larger
+ * than the biggest class, or hitting an exhausted class, fall back to malloc.
+ * A malloc block starts with a header holding its size, so that ZbHeapUsed and
+ * ZbHeapHighWaterMark count it too.
+ * ZB_SLAB_CLASS(block size, number of blocks) entries must be listed by increasing
+ * size, and sizes must be multiples of 8 bytes. */
+#ifndef ZB_SLAB_CLASS_LIST
+#define ZB_SLAB_CLASS_LIST \
+    ZB_SLAB_CLASS(16U, 48U) \
+    ZB_SLAB_CLASS(32U, 24U) \
+    ZB_SLAB_CLASS(64U, 12U) \
+    ZB_SLAB_CLASS(128U, 6U)
+#endif
+
+enum {
+#define ZB_SLAB_CLASS(_sz_, _nbr_)          + ((_sz_) * (_nbr_))
+    ZB_SLAB_POOL_SIZE = 0U ZB_SLAB_CLASS_LIST,
+#undef ZB_SLAB_CLASS
+#define ZB_SLAB_CLASS(_sz_, _nbr_)          + (_nbr_)
+    ZB_SLAB_BLOCK_NBR = 0U ZB_SLAB_CLASS_LIST
+#undef ZB_SLAB_CLASS
+};
+
+struct zb_slab_class {
+    uint8_t *base;
+    uint8_t *end;
+    void *free_list;
+    uint16_t size;
+    uint16_t first_block;
+    uint16_t in_use;
+    uint16_t high_water;
+    uint32_t fail;
+};
+
+#if defined(CONFIG_ZB_MEMORY_DEBUG)
+/* Allocation site of each slab block */
+struct zb_slab_site {
+    const char *funcname;
+    unsigned int linenum;
+};
+#endif
+
+static const struct {
+    uint16_t size;
+    uint16_t nbr;
+} zb_slab_cfg[] = {
+#define ZB_SLAB_CLASS(_sz_, _nbr_)          {(_sz_), (_nbr_)},
+    ZB_SLAB_CLASS_LIST
+#undef ZB_SLAB_CLASS
+};
+
+#define ZB_SLAB_CLASS_NBR                   (sizeof(zb_slab_cfg) / sizeof(zb_slab_cfg[0]))
+
+static struct {
+    bool init;
+    struct zb_slab_class class_tbl[ZB_SLAB_CLASS_NBR];
+    unsigned long used;
+    unsigned long high_water;
+    /* Blocks served by malloc (also counted in used) */
+    unsigned int heap_in_use;
+    unsigned long heap_used;
+    unsigned int heap_alloc_fail;
+#if defined(CONFIG_ZB_MEMORY_DEBUG)
+    struct zb_slab_site site[ZB_SLAB_BLOCK_NBR];
+#endif
+} zb_slab;
+
+/* uint64_t to get the blocks 8-byte aligned */
+static uint64_t zb_slab_pool[ZB_SLAB_POOL_SIZE / sizeof(uint64_t)];
+
+static void
+zb_slab_init(void)
+{
+    struct zb_slab_class *cls;
+    uint8_t *base = (uint8_t *)zb_slab_pool;
+    uint16_t first_block = 0U;
+    unsigned int i, j;
+
+    for (i = 0U; i < ZB_SLAB_CLASS_NBR; i++) {
+        cls = &zb_slab.class_tbl[i];
+        cls->base = base;
+        cls->end = base + ((uint32_t)zb_slab_cfg[i].size * zb_slab_cfg[i].nbr);
+        cls->size = zb_slab_cfg[i].size;
+        cls->first_block = first_block;
+        /* Thread the free list through the blocks themselves */
+        cls->free_list = NULL;
+        for (j = zb_slab_cfg[i].nbr; j > 0U; j--) {
+            void **block = (void **)(void *)(base + ((j - 1U) * cls->size));
+
+            *block = cls->free_list;
+            cls->free_list = block;
+        }
+        base = cls->end;
+        first_block += zb_slab_cfg[i].nbr;
+    }
+    zb_slab.init = true;
+} /* zb_slab_init */
+
+static struct zb_slab_class *
+zb_slab_class_from_ptr(void *ptr)
+{
+    unsigned int i;
+
+    if (((uint8_t *)ptr < (uint8_t *)zb_slab_pool)
+        || ((uint8_t *)ptr >= ((uint8_t *)zb_slab_pool + ZB_SLAB_POOL_SIZE))) {
+        return NULL;
+    }
+    for (i = 0U; i < ZB_SLAB_CLASS_NBR; i++) {
+        if ((uint8_t *)ptr < zb_slab.class_tbl[i].end) {
+            return &zb_slab.class_tbl[i];
+        }
+    }
+    return NULL;
+} /* zb_slab_class_from_ptr */
+
 void *
-zb_heap_alloc(struct ZigBeeT *zb, size_t sz, const char *filename, unsigned int line)
+zb_heap_alloc(struct ZigBeeT *zb, size_t sz, const char *funcname, unsigned int linenum)
 {
-    /* The M4 has access to malloc */
-    return malloc(sz);
-}
+    struct zb_slab_class *cls;
+    void **block;
+    uint64_t *hdr;
+    unsigned int i;
+
+    if (!zb_slab.init) {
+        zb_slab_init();
+    }
+
+    for (i = 0U; i < ZB_SLAB_CLASS_NBR; i++) {
+        cls = &zb_slab.class_tbl[i];
+        if (sz > cls->size) {
+            continue;
+        }
+        block = cls->free_list;
+        if (block == NULL) {
+            /* Class exhausted. Don't spill into the bigger classes, they are
+             * sized for their own users. */
+            cls->fail++;
+            break;
+        }
+        cls->free_list = *block;
+        cls->in_use++;
+        if (cls->in_use > cls->high_water) {
+            cls->high_water = cls->in_use;
+        }
+        zb_slab.used += cls->size;
+        if (zb_slab.used > zb_slab.high_water) {
+            zb_slab.high_water = zb_slab.used;
+        }
+#if defined(CONFIG_ZB_MEMORY_DEBUG)
+        {
+            unsigned int idx = cls->first_block + (((uint8_t *)block - cls->base) / cls->size);
+
+            zb_slab.site[idx].funcname = funcname;
+            zb_slab.site[idx].linenum = linenum;
+        }
+#endif
+        return block;
+    }
+
+    /* The M4 has access to malloc. The uint64_t header keeps the block
+     * 8-byte aligned. */
+    hdr = NULL;
+    if (sz <= (SIZE_MAX - sizeof(*hdr))) {
+        hdr = malloc(sizeof(*hdr) + sz);
+    }
+    if (hdr == NULL) {
+        zb_slab.heap_alloc_fail++;
+        return NULL;
+    }
+    *hdr = sz;
+    zb_slab.heap_in_use++;
+    zb_slab.heap_used += sz;
+    zb_slab.used += sz;
+    if (zb_slab.used > zb_slab.high_water) {
+        zb_slab.high_water = zb_slab.used;
+    }
+    return hdr + 1;
+} /* zb_heap_alloc */
 
 void
-zb_heap_free(struct ZigBeeT *zb, void *ptr, const char *filename, unsigned int line)
+zb_heap_free(struct ZigBeeT *zb, void *ptr, const char *funcname, unsigned int linenum)
 {
-    free(ptr);
-}
+    struct zb_slab_class *cls;
+    void **block = ptr;
+    uint64_t *hdr;
+
+    if (ptr == NULL) {
+        return;
+    }
+    cls = zb_slab_class_from_ptr(ptr);
+    if (cls == NULL) {
+        hdr = (uint64_t *)ptr - 1;
+        assert(zb_slab.heap_in_use > 0U);
+        assert(zb_slab.heap_used >= *hdr);
+        zb_slab.heap_in_use--;
+        zb_slab.heap_used -= (unsigned long)*hdr;
+        zb_slab.used -= (unsigned long)*hdr;
+        free(hdr);
+        return;
+    }
+    assert((((uint8_t *)ptr - cls->base) % cls->size) == 0U);
+    assert(cls->in_use > 0U);
+#if defined(CONFIG_ZB_MEMORY_DEBUG)
+    {
+        unsigned int idx = cls->first_block + (((uint8_t *)block - cls->base) / cls->size);
+
+        zb_slab.site[idx].funcname = NULL;
+        zb_slab.site[idx].linenum = 0U;
+    }
+#endif
+    *block = cls->free_list;
+    cls->free_list = block;
+    cls->in_use--;
+    zb_slab.used -= cls->size;
+} /* zb_heap_free */
+
+bool
+ZbHeapSlabStats(unsigned int class_idx, struct ZbHeapSlabStatsT *stats)
+{
+    const struct zb_slab_class *cls;
+
+    if ((class_idx >= ZB_SLAB_CLASS_NBR) || (stats == NULL)) {
+        return false;
+    }
+    if (!zb_slab.init) {
+        zb_slab_init();
+    }
+    cls = &zb_slab.class_tbl[class_idx];
+    stats->block_size = cls->size;
+    stats->block_nbr = zb_slab_cfg[class_idx].nbr;
+    stats->in_use = cls->in_use;
+    stats->high_water = cls->high_water;
+    stats->fail = cls->fail;
+    return true;
+} /* ZbHeapSlabStats */
+
+unsigned long
+ZbHeapUsed(struct ZigBeeT *zb)
+{
+    return zb_slab.used;
+} /* ZbHeapUsed */
+
+unsigned long
+ZbHeapHighWaterMark(struct ZigBeeT *zb)
+{
+    return zb_slab.high_water;
+} /* ZbHeapHighWaterMark */
+
+static void
+zb_heap_dump_print(void *cbarg, const char *fmt, ...)
+{
+    static char dump_str[96];
+    va_list ap;
+
+    va_start(ap, fmt);
+    (void)vsnprintf(dump_str, sizeof(dump_str), fmt, ap);
+    va_end(ap);
+    cli_port_print_msg(NULL, dump_str);
+} /* zb_heap_dump_print */
+
+void
+ZbHeapDumpMemAllocTbl(struct ZigBeeT *zb, ZbHeapDumpCallbackT callback, void *cbarg)
+{
+    struct ZbHeapSlabStatsT stats;
+    unsigned int i;
+
+    if (callback == NULL) {
+        callback = zb_heap_dump_print;
+    }
+    for (i = 0U; ZbHeapSlabStats(i, &stats); i++) {
+        callback(cbarg, "slab %3u bytes: %u/%u in use, high water %u, fail %u\r\n",
+            stats.block_size, stats.in_use, stats.block_nbr, stats.high_water, stats.fail);
+    }
+    callback(cbarg, "heap: %u blocks (%lu bytes) in use, alloc fail %u\r\n",
+        zb_slab.heap_in_use, zb_slab.heap_used, zb_slab.heap_alloc_fail);
+#if defined(CONFIG_ZB_MEMORY_DEBUG)
+    for (i = 0U; i < ZB_SLAB_BLOCK_NBR; i++) {
+        if (zb_slab.site[i].funcname != NULL) {
+            callback(cbarg, "  block %u: %s:%u\r\n", i, zb_slab.site[i].funcname, zb_slab.site[i].linenum);
+        }
+    }
+#endif
+} /* ZbHeapDumpMemAllocTbl */
 
 /******************************************************************************
  * CRC (required for ZCL reporting (hash)
@@ -3182,10 +4348,9 @@ const uint16_t wpanCrcTable[256] = {
     0x7BC7, 0x6A4E, 0x58D5, 0x495C, 0x3DE3, 0x2C6A, 0x1EF1, 0x0F78
 };
 
-uint16_t
-WpanCrc(uint16_t crc, const void *dataPtr, unsigned int dataLen)
+static uint16_t
+zb_crc_bytewise(uint16_t crc, const uint8_t *p, unsigned int dataLen)
 {
-    const uint8_t *p = dataPtr;
     /*
      * Reflected CRC for dummies:
      *
@@ -3202,29 +4367,140 @@ WpanCrc(uint16_t crc, const void *dataPtr, unsigned int dataLen)
         crc = (crc >> 8) ^ wpanCrcTable[(crc & 0xff) ^ *p++];
     } /* while */
     return crc;
+} /* zb_crc_bytewise */
+
+/* WpanCrc engines. The CRC peripheral is used for buffers of at least
+ * ZB_CRC_HW_MIN_LEN bytes when the CRC HAL module is enabled in the
+ * application. Otherwise, ZB_CRC_SLICE_BY_8 selects the slicing-by-8 software
+ * CRC (4 KB of tables in RAM, meant for host builds), and the byte-wise table
+ * CRC above is used by default. */
+#ifndef ZB_CRC_HW_MIN_LEN
+#define ZB_CRC_HW_MIN_LEN                   16U
+#endif
+
+#if defined(HAL_CRC_MODULE_ENABLED) && defined(CRC)
+static CRC_HandleTypeDef zb_crc_hcrc;
+
+static uint16_t
+zb_crc_hw(uint16_t crc, const uint8_t *p, unsigned int dataLen)
+{
+    uint32_t saved_cr, saved_init, saved_pol, saved_idr, saved_dr;
+    uint16_t init = 0U, result;
+    bool clk_enabled;
+    unsigned int i;
+
+    /* The peripheral runs the non reflected algorithm on reversed input and
+     * output, so the running CRC is loaded bit reversed. */
+    for (i = 0U; i < 16U; i++) {
+        if ((crc & (1U << i)) != 0U) {
+            init |= (uint16_t)(1U << (15U - i));
+        }
+    }
+
+    /* The application may use the peripheral too: save its configuration and
+     * its running CRC (read without output reversal), and put them back once
+     * done. Not to be mixed with an application CRC computed from an
+     * interrupt. */
+    clk_enabled = (__HAL_RCC_CRC_IS_CLK_ENABLED() != 0U);
+    __HAL_RCC_CRC_CLK_ENABLE();
+    saved_cr = CRC->CR;
+    saved_init = CRC->INIT;
+    saved_pol = CRC->POL;
+    saved_idr = CRC->IDR;
+    CRC->CR = saved_cr & ~CRC_CR_REV_OUT;
+    saved_dr = CRC->DR;
+
+    zb_crc_hcrc.Instance = CRC;
+    zb_crc_hcrc.Init.DefaultPolynomialUse = DEFAULT_POLYNOMIAL_DISABLE;
+    zb_crc_hcrc.Init.GeneratingPolynomial = 0x1021U;
+    zb_crc_hcrc.Init.CRCLength = CRC_POLYLENGTH_16B;
+    zb_crc_hcrc.Init.DefaultInitValueUse = DEFAULT_INIT_VALUE_DISABLE;
+    zb_crc_hcrc.Init.InitValue = init;
+    zb_crc_hcrc.Init.InputDataInversionMode = CRC_INPUTDATA_INVERSION_BYTE;
+    zb_crc_hcrc.Init.OutputDataInversionMode = CRC_OUTPUTDATA_INVERSION_ENABLE;
+    zb_crc_hcrc.InputDataFormat = CRC_INPUTDATA_FORMAT_BYTES;
+    (void)HAL_CRC_Init(&zb_crc_hcrc);
+    result = (uint16_t)HAL_CRC_Calculate(&zb_crc_hcrc, (uint32_t *)(void *)p, dataLen);
+
+    /* The running CRC is reloaded through INIT, with a reset */
+    CRC->POL = saved_pol;
+    CRC->INIT = saved_dr;
+    CRC->CR = saved_cr | CRC_CR_RESET;
+    CRC->INIT = saved_init;
+    CRC->IDR = saved_idr;
+    if (!clk_enabled) {
+        __HAL_RCC_CRC_CLK_DISABLE();
+    }
+    return result;
+} /* zb_crc_hw */
+#endif
+
+#if defined(ZB_CRC_SLICE_BY_8)
+static uint16_t zb_crc_slice_table[8][256];
+static bool zb_crc_slice_init;
+
+static uint16_t
+zb_crc_slice_by_8(uint16_t crc, const uint8_t *p, unsigned int dataLen)
+{
+    unsigned int i, j;
+
+    if (!zb_crc_slice_init) {
+        /* Table j gives the CRC of a byte followed by j zero bytes */
+        for (i = 0U; i < 256U; i++) {
+            zb_crc_slice_table[0][i] = wpanCrcTable[i];
+        }
+        for (j = 1U; j < 8U; j++) {
+            for (i = 0U; i < 256U; i++) {
+                uint16_t prev = zb_crc_slice_table[j - 1U][i];
+
+                zb_crc_slice_table[j][i] = (prev >> 8) ^ wpanCrcTable[prev & 0xffU];
+            }
+        }
+        zb_crc_slice_init = true;
+    }
+
+    while (dataLen >= 8U) {
+        crc = zb_crc_slice_table[7][(p[0] ^ crc) & 0xffU]
+            ^ zb_crc_slice_table[6][(p[1] ^ (crc >> 8)) & 0xffU]
+            ^ zb_crc_slice_table[5][p[2]] ^ zb_crc_slice_table[4][p[3]]
+            ^ zb_crc_slice_table[3][p[4]] ^ zb_crc_slice_table[2][p[5]]
+            ^ zb_crc_slice_table[1][p[6]] ^ zb_crc_slice_table[0][p[7]];
+        p += 8;
+        dataLen -= 8U;
+    }
+    return zb_crc_bytewise(crc, p, dataLen);
+} /* zb_crc_slice_by_8 */
+#endif
+
+uint16_t
+WpanCrc(uint16_t crc, const void *dataPtr, unsigned int dataLen)
+{
+    const uint8_t *p = dataPtr;
+
+#if defined(HAL_CRC_MODULE_ENABLED) && defined(CRC)
+    if (dataLen >= ZB_CRC_HW_MIN_LEN) {
+        return zb_crc_hw(crc, p, dataLen);
+    }
+#endif
+#if defined(ZB_CRC_SLICE_BY_8)
+    return zb_crc_slice_by_8(crc, p, dataLen);
+#else
+    return zb_crc_bytewise(crc, p, dataLen);
+#endif
 } /* WpanCrc */
 
 /**
-  * @brief  This function is used to manage all the callbacks used by the
-  *         OpenThread interface. These callbacks are used for example to
-  *         notify the application as soon as the state of a device has been
-  *         modified.
-  *
-  *         Important Note: This function must be called each time a message
-  *         is sent from the M0 to the M4.
+  * @brief  Process one notification received from the M0. The return values
+  *         are written back in the notification buffer.
   *
-  * @param  None
-  * @retval None
+  * @param  p_notification: notification payload received from the M0
+  * @retval HAL_ERROR when the notification is unknown
   */
-HAL_StatusTypeDef
-Zigbee_CallBackProcessing(void)
+static HAL_StatusTypeDef
+Zigbee_NotifProcessing(Zigbee_Cmd_Request_t *p_notification)
 {
     HAL_StatusTypeDef status = HAL_OK;
     struct zb_ipc_m4_cb_info *info = NULL;
-    Zigbee_Cmd_Request_t *p_notification;
-
-    /* Get pointer on received event buffer from M0 */
-    p_notification = ZIGBEE_Get_NotificationPayloadBuffer();
 
     switch (p_notification->ID) {
         case MSG_M0TOM4_ZB_MALLOC:
@@ -3232,7 +4508,7 @@ Zigbee_CallBackProcessing(void)
             void *ptr;
 
              assert(p_notification->Size == 1);
-             ptr = malloc((uint32_t)p_notification->Data[0]);
+             ptr = ZbHeapAlloc(NULL, (uint32_t)p_notification->Data[0]);
 
              /* Return ptr in second argument */
              p_notification->Data[1] = (uint32_t) ptr;
@@ -3242,7 +4518,7 @@ Zigbee_CallBackProcessing(void)
 
         case MSG_M0TOM4_ZB_FREE:
             assert(p_notification->Size == 1);
-            free((void *)p_notification->Data[0]);
+            ZbHeapFree(NULL, (void *)p_notification->Data[0]);
             break;
 
         case MSG_M0TOM4_FILTER_MSG_CB:
@@ -3438,6 +4714,11 @@ Zigbee_CallBackProcessing(void)
             unsigned int i;
 
             assert(p_notification->Size == 2);
+            {
+                ZbZdoDeviceAnnceT *annce = (ZbZdoDeviceAnnceT *)p_notification->Data[0];
+
+                zb_nwk_addr_cache_add(annce->nwkAddr, annce->extAddr);
+            }
             for (i = 0; i < ZB_IPC_ZDO_DEVICE_ANNCE_CB_LIST_MAX; i++) {
                 cb_info = &zdo_device_annce_cb_list[i];
                 if (cb_info->handle != NULL) {
@@ -3745,10 +5026,163 @@ Zigbee_CallBackProcessing(void)
         zb_ipc_m4_cb_info_free(info);
     }
 
+    return status;
+} /* Zigbee_NotifProcessing */
+
+/**
+  * @brief  This function is used to manage all the callbacks used by the
+  *         OpenThread interface. These callbacks are used for example to
+  *         notify the application as soon as the state of a device has been
+  *         modified.
+  *
+  *         Important Note: This function must be called each time a message
+  *         is sent from the M0 to the M4. With ZIGBEE_NOTIF_RING, all the
+  *         notifications posted by the M0 are processed and acknowledged at once.
+  *
+  * @param  None
+  * @retval HAL_ERROR when one of the notifications is unknown
+  */
+HAL_StatusTypeDef
+Zigbee_CallBackProcessing(void)
+{
+    HAL_StatusTypeDef status;
+#ifdef ZIGBEE_NOTIF_RING
+    TL_EvtPacket_t *p_notif;
+
+    status = HAL_OK;
+    while ((p_notif = TL_ZIGBEE_GetNotifFromM0()) != NULL) {
+        if (Zigbee_NotifProcessing((Zigbee_Cmd_Request_t *)p_notif->evtserial.evt.payload) != HAL_OK) {
+            status = HAL_ERROR;
+        }
+        TL_ZIGBEE_ReleaseNotifToM0();
+    }
+#else
+    /* Get pointer on received event buffer from M0 */
+    status = Zigbee_NotifProcessing(ZIGBEE_Get_NotificationPayloadBuffer());
+#endif
+
     TL_ZIGBEE_SendAckAfterAppliNotifFromM0();
     return status;
 } /* Zigbee_CallBackProcessing */
 
+/* Deferred logging. With ZB_LOG_RING_SIZE != 0, the log messages from the M0 are
+ * copied with a timestamp in a ring buffer and acked right away, so the M0 doesn't
+ * wait for the UART on every line. ZIGBEE_LogPending() is called when a record is
+ * queued, and the application then calls Zigbee_LogProcessing() from a low
+ * priority task to print the records, or Zigbee_LogRead() to get them raw.
+ * With ZB_LOG_RING_SIZE == 0, the messages are printed before the ack. */
+#ifndef ZB_LOG_RING_SIZE
+#define ZB_LOG_RING_SIZE                    0U
+#endif
+
+#if (ZB_LOG_RING_SIZE != 0U)
+struct zb_log_rec_hdr {
+    uint32_t timestamp;
+    uint16_t len;
+};
+
+static struct {
+    uint8_t ring[ZB_LOG_RING_SIZE];
+    uint32_t head; /* write index */
+    uint32_t tail; /* read index */
+    uint32_t used;
+    uint32_t dropped;
+} zb_log;
+
+static void
+zb_log_ring_copy_in(const void *data, uint32_t len)
+{
+    const uint8_t *src = data;
+    uint32_t chunk;
+
+    while (len > 0U) {
+        chunk = ZB_LOG_RING_SIZE - zb_log.head;
+        if (chunk > len) {
+            chunk = len;
+        }
+        zb_ipc_m4_memcpy2(&zb_log.ring[zb_log.head], (void *)src, chunk);
+        zb_log.head = (zb_log.head + chunk) % ZB_LOG_RING_SIZE;
+        src += chunk;
+        len -= chunk;
+    }
+} /* zb_log_ring_copy_in */
+
+static void
+zb_log_ring_copy_out(void *data, uint32_t len)
+{
+    uint8_t *dst = data;
+    uint32_t chunk;
+
+    while (len > 0U) {
+        chunk = ZB_LOG_RING_SIZE - zb_log.tail;
+        if (chunk > len) {
+            chunk = len;
+        }
+        if (dst != NULL) {
+            zb_ipc_m4_memcpy2(dst, &zb_log.ring[zb_log.tail], chunk);
+            dst += chunk;
+        }
+        zb_log.tail = (zb_log.tail + chunk) % ZB_LOG_RING_SIZE;
+        len -= chunk;
+    }
+} /* zb_log_ring_copy_out */
+
+/**
+  * @brief  Pops the oldest deferred log record
+  * @param  timestamp: ZbUptime() when the record was received
+  * @param  buf: text of the record, NUL terminated and truncated to size
+  * @param  size: size of buf
+  * @retval Length of the text of the record, 0 if there is no record
+  */
+unsigned int
+Zigbee_LogRead(uint32_t *timestamp, char *buf, unsigned int size)
+{
+    struct zb_log_rec_hdr hdr;
+    uint32_t copy_len;
+
+    if (zb_log.used == 0U) {
+        return 0U;
+    }
+    zb_log_ring_copy_out(&hdr, sizeof(hdr));
+    copy_len = (size > hdr.len) ? hdr.len : ((size > 0U) ? (size - 1U) : 0U);
+    zb_log_ring_copy_out(buf, copy_len);
+    zb_log_ring_copy_out(NULL, hdr.len - copy_len);
+    zb_log.used -= sizeof(hdr) + hdr.len;
+
+    if (size > 0U) {
+        buf[copy_len] = '\0';
+    }
+    if (timestamp != NULL) {
+        *timestamp = hdr.timestamp;
+    }
+    return hdr.len;
+} /* Zigbee_LogRead */
+
+/**
+  * @brief  Prints the deferred log records
+  * @param  None
+  * @retval None
+  */
+void
+Zigbee_LogProcessing(void)
+{
+    static char log_msg[240];
+    static char log_str[256];
+    uint32_t timestamp;
+
+    if (zb_log.dropped != 0U) {
+        (void)snprintf(log_str, sizeof(log_str), "%u log messages dropped\r\n", (unsigned int)zb_log.dropped);
+        zb_log.dropped = 0U;
+        cli_port_print_msg(NULL, log_str);
+    }
+
+    while (Zigbee_LogRead(&timestamp, log_msg, sizeof(log_msg)) != 0U) {
+        (void)snprintf(log_str, sizeof(log_str), "%u %s", (unsigned int)timestamp, log_msg);
+        cli_port_print_msg(NULL, log_str);
+    }
+} /* Zigbee_LogProcessing */
+#endif
+
 HAL_StatusTypeDef
 Zigbee_LoggingProcessing(void)
 {
@@ -3757,7 +5191,33 @@ Zigbee_LoggingProcessing(void)
 
     assert(p_logging->Size == 1);
     log_str = (const char *)p_logging->Data[0];
+#if (ZB_LOG_RING_SIZE != 0U)
+    {
+        struct zb_log_rec_hdr hdr;
+        size_t len;
+
+        len = strlen(log_str);
+        if (len > UINT16_MAX) {
+            len = UINT16_MAX;
+        }
+        hdr.timestamp = ZbUptime();
+        hdr.len = (uint16_t)len;
+        if (len == 0U) {
+            /* Nothing to print */
+        }
+        else if ((ZB_LOG_RING_SIZE - zb_log.used) < (sizeof(hdr) + len)) {
+            zb_log.dropped++;
+        }
+        else {
+            zb_log_ring_copy_in(&hdr, sizeof(hdr));
+            zb_log_ring_copy_in(log_str, (uint32_t)len);
+            zb_log.used += sizeof(hdr) + len;
+            ZIGBEE_LogPending();
+        }
+    }
+#else
     cli_port_print_msg(NULL, log_str);
+#endif
 
     TL_ZIGBEE_SendAckAfterAppliLoggingFromM0();
     return HAL_OK;
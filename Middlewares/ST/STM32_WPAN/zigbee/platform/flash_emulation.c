@@ -5,6 +5,7 @@
 #include "stm32wbxx_hal_conf.h"
 #include "stm32_wpan_common.h"
 #include "flash_emulation.h"
+#include "persist_store.h"
 
 static inline uint32_t
 mapAddress(uint32_t aAddress)
@@ -76,3 +77,44 @@ utilsFlashRead(uint32_t aAddress, uint8_t *aData, uint32_t aSize)
 
     return nbOfBytesToRead;
 } /* utilsFlashRead */
+
+static int
+utilsFlashPersistRead(uint32_t aAddress, void *aData, uint32_t aSize)
+{
+    return (utilsFlashRead(aAddress, aData, aSize) == aSize) ? 0 : -1;
+} /* utilsFlashPersistRead */
+
+static int
+utilsFlashPersistWrite(uint32_t aAddress, const void *aData, uint32_t aSize)
+{
+    return (utilsFlashWrite(aAddress, (uint8_t *)aData, aSize) == aSize) ? 0 : -1;
+} /* utilsFlashPersistWrite */
+
+static int
+utilsFlashPersistErase(uint32_t aPage)
+{
+    memset((uint8_t *)mapAddress(aPage * FLASH_EMULATION_PAGE_SIZE), 0xff, FLASH_EMULATION_PAGE_SIZE);
+    return 0;
+} /* utilsFlashPersistErase */
+
+/**
+ * Persistent store backend on the emulated flash.
+ *
+ * The emulated flash is in RAM: the store is kept across a stack reset,
+ * not across a power cycle.
+ *
+ * @returns The backend to give to persistStoreInit().
+ */
+const struct persistStoreBackend *
+utilsFlashPersistBackend(void)
+{
+    static const struct persistStoreBackend backend = {
+        FLASH_EMULATION_PAGE_SIZE,
+        TMP_STORAGE_BUF_SIZE / FLASH_EMULATION_PAGE_SIZE,
+        utilsFlashPersistRead,
+        utilsFlashPersistWrite,
+        utilsFlashPersistErase
+    };
+
+    return &backend;
+} /* utilsFlashPersistBackend */
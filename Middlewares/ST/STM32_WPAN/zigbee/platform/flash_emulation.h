@@ -44,5 +44,10 @@ uint32_t utilsFlashGetSize(void);
 uint32_t utilsFlashWrite(uint32_t aAddress, uint8_t *aData, uint32_t aSize);
 uint32_t utilsFlashRead(uint32_t aAddress, uint8_t *aData, uint32_t aSize);
 
+/* Backend to mount the persist_store.h store on the emulated flash */
+#define FLASH_EMULATION_PAGE_SIZE     1024U
+struct persistStoreBackend;
+const struct persistStoreBackend * utilsFlashPersistBackend(void);
+
 #endif //__FLASH_EMULATION_H
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,591 @@
+/**
+ ******************************************************************************
+ * @file    persist_store.c
+ * @author  MCD Application Team
+ * @brief   Log structured key/record store for the persistent data.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "persist_store.h"
+
+/* Page layout: page header, then records appended up to the end of the page.
+ * Record layout: record header, then the data padded to PERSIST_ALIGN. */
+#define PERSIST_PAGE_MAGIC                  0x50535431U /* "PST1" */
+#define PERSIST_SEQ_NONE                    0xffffffffU
+#define PERSIST_OFFSET_NONE                 0xffffffffU
+#define PERSIST_KEY_ERASED                  0xffffU
+#define PERSIST_ALIGN                       8U
+#define PERSIST_ALIGN_UP(_x_)               (((_x_) + (PERSIST_ALIGN - 1U)) & ~(PERSIST_ALIGN - 1U))
+#define PERSIST_CHUNK_SIZE                  64U
+
+#define PERSIST_REC_FULL                    0x0001U
+#define PERSIST_REC_DELTA                   0x0002U
+#define PERSIST_REC_DELETE                  0x0003U
+
+/* The header is checked so that a page torn by a reset during its erase, or
+ * during the write of the header, is never taken for a page in use. */
+struct persist_page_hdr {
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t seq_inv;  /* ~seq */
+    uint16_t crc;      /* over magic, seq and seq_inv */
+    uint16_t reserved; /* 0xffff */
+};
+
+/* Each double word of the header has its own CRC, so that the length is known
+ * and the record can be skipped if the reset happened between the two. */
+struct persist_rec_hdr {
+    uint16_t key;
+    uint16_t len;
+    uint16_t total;
+    uint16_t crc0; /* over key, len and total */
+    uint16_t type;
+    uint16_t offset;
+    uint16_t data_crc;
+    uint16_t crc1; /* over type, offset and data_crc */
+};
+
+#define PERSIST_PAGE_HDR_SIZE               PERSIST_ALIGN_UP(sizeof(struct persist_page_hdr))
+#define PERSIST_REC_HDR_SIZE                PERSIST_ALIGN_UP(sizeof(struct persist_rec_hdr))
+
+/* Source of the data of an appended record: a buffer, or the current value of a
+ * key when a value is moved out of the page being reclaimed. Offsets are from
+ * the start of the record data. */
+struct persist_src {
+    const uint8_t *buf;
+    uint16_t key;
+};
+
+static struct {
+    const struct persistStoreBackend *backend;
+    uint32_t seq[PERSIST_STORE_MAX_PAGES];
+    /* Pages in use, oldest first. The last one is the active page. */
+    uint8_t order[PERSIST_STORE_MAX_PAGES];
+    uint8_t nb_used;
+    uint32_t write_offset;
+    /* Offset of the record being written in the active page. A copy reads its
+     * source value while the record is written, and must not see it. */
+    uint32_t busy_offset;
+} persist;
+
+static uint16_t
+persist_crc(uint16_t crc, const void *data, uint32_t len)
+{
+    const uint8_t *p = data;
+    unsigned int i;
+
+    /* CRC-16/CCITT, reflected (same as the 802.15.4 FCS) */
+    while (len-- > 0U) {
+        crc ^= *p++;
+        for (i = 0; i < 8U; i++) {
+            crc = ((crc & 1U) != 0U) ? (uint16_t)((crc >> 1) ^ 0x8408U) : (uint16_t)(crc >> 1);
+        }
+    }
+    return crc;
+} /* persist_crc */
+
+static uint32_t
+persist_page_addr(uint8_t page)
+{
+    return (uint32_t)page * persist.backend->pageSize;
+} /* persist_page_addr */
+
+/* Reads the record header at offset in the page. Returns false at the end of
+ * the records of the page: erased space, or a header torn by a reset. */
+static bool
+persist_rec_get(uint8_t page, uint32_t offset, struct persist_rec_hdr *hdr)
+{
+    if ((offset + PERSIST_REC_HDR_SIZE) > persist.backend->pageSize) {
+        return false;
+    }
+    if (persist.backend->read(persist_page_addr(page) + offset, hdr, sizeof(*hdr)) != 0) {
+        return false;
+    }
+    if (hdr->key == PERSIST_KEY_ERASED) {
+        return false;
+    }
+    if (hdr->crc0 != persist_crc(0xffffU, &hdr->key, offsetof(struct persist_rec_hdr, crc0))) {
+        return false;
+    }
+    if ((offset + PERSIST_REC_HDR_SIZE + PERSIST_ALIGN_UP((uint32_t)hdr->len)) > persist.backend->pageSize) {
+        return false;
+    }
+    return true;
+} /* persist_rec_get */
+
+static uint32_t
+persist_rec_next(uint32_t offset, const struct persist_rec_hdr *hdr)
+{
+    return offset + PERSIST_REC_HDR_SIZE + PERSIST_ALIGN_UP((uint32_t)hdr->len);
+} /* persist_rec_next */
+
+/* Checks the record was completely written */
+static bool
+persist_rec_valid(uint8_t page, uint32_t offset, const struct persist_rec_hdr *hdr)
+{
+    uint8_t chunk[PERSIST_CHUNK_SIZE];
+    uint32_t addr = persist_page_addr(page) + offset + PERSIST_REC_HDR_SIZE;
+    uint32_t len = hdr->len;
+    uint32_t n;
+    uint16_t crc = 0xffffU;
+
+    if (hdr->crc1 != persist_crc(0xffffU, &hdr->type, sizeof(*hdr) - offsetof(struct persist_rec_hdr, type) - sizeof(hdr->crc1))) {
+        return false;
+    }
+    while (len > 0U) {
+        n = (len > sizeof(chunk)) ? sizeof(chunk) : len;
+        if (persist.backend->read(addr, chunk, n) != 0) {
+            return false;
+        }
+        crc = persist_crc(crc, chunk, n);
+        addr += n;
+        len -= n;
+    }
+    return crc == hdr->data_crc;
+} /* persist_rec_valid */
+
+static uint16_t
+persist_page_hdr_crc(const struct persist_page_hdr *page_hdr)
+{
+    return persist_crc(0xffffU, page_hdr, offsetof(struct persist_page_hdr, crc));
+} /* persist_page_hdr_crc */
+
+static bool
+persist_page_hdr_valid(const struct persist_page_hdr *page_hdr)
+{
+    return (page_hdr->magic == PERSIST_PAGE_MAGIC) && (page_hdr->seq != PERSIST_SEQ_NONE)
+        && (page_hdr->seq_inv == ~page_hdr->seq) && (page_hdr->crc == persist_page_hdr_crc(page_hdr));
+} /* persist_page_hdr_valid */
+
+static bool
+persist_page_hdr_erased(const struct persist_page_hdr *page_hdr)
+{
+    const uint8_t *p = (const uint8_t *)page_hdr;
+    unsigned int i;
+
+    for (i = 0; i < sizeof(*page_hdr); i++) {
+        if (p[i] != 0xffU) {
+            return false;
+        }
+    }
+    return true;
+} /* persist_page_hdr_erased */
+
+static int
+persist_page_erase(uint8_t page)
+{
+    persist.seq[page] = PERSIST_SEQ_NONE;
+    return (persist.backend->erase(page) == 0) ? PERSIST_STORE_OK : PERSIST_STORE_ERR_IO;
+} /* persist_page_erase */
+
+/* Clears the header of a page in use before it is erased, an erase interrupted
+ * by a reset can leave any value in the page. */
+static int
+persist_page_retire(uint8_t page)
+{
+    static const uint8_t zero[PERSIST_ALIGN] = { 0 };
+
+    if (persist.backend->write(persist_page_addr(page), zero, sizeof(zero)) != 0) {
+        return PERSIST_STORE_ERR_IO;
+    }
+    return persist_page_erase(page);
+} /* persist_page_retire */
+
+static int
+persist_src_read(const struct persist_src *src, uint32_t offset, void *data, uint32_t len)
+{
+    if (src->buf != NULL) {
+        (void)memcpy(data, &src->buf[offset], len);
+        return PERSIST_STORE_OK;
+    }
+    return (persistStoreRead(src->key, offset, data, len) >= 0) ? PERSIST_STORE_OK : PERSIST_STORE_ERR_IO;
+} /* persist_src_read */
+
+/* Appends a record in the active page, the caller has checked it fits */
+static int
+persist_rec_write(uint16_t key, uint16_t type, uint32_t offset, const struct persist_src *src,
+    uint32_t len, uint32_t total)
+{
+    uint8_t chunk[PERSIST_CHUNK_SIZE];
+    struct persist_rec_hdr hdr;
+    uint32_t addr = persist_page_addr(persist.order[persist.nb_used - 1U]) + persist.write_offset;
+    uint32_t done, n;
+    uint16_t crc = 0xffffU;
+
+    /* First pass for the data CRC */
+    for (done = 0U; done < len; done += n) {
+        n = ((len - done) > sizeof(chunk)) ? sizeof(chunk) : (len - done);
+        if (persist_src_read(src, done, chunk, n) != PERSIST_STORE_OK) {
+            return PERSIST_STORE_ERR_IO;
+        }
+        crc = persist_crc(crc, chunk, n);
+    }
+
+    (void)memset(&hdr, 0, sizeof(hdr));
+    hdr.key = key;
+    hdr.type = type;
+    hdr.offset = (uint16_t)offset;
+    hdr.len = (uint16_t)len;
+    hdr.total = (uint16_t)total;
+    hdr.data_crc = crc;
+    hdr.crc0 = persist_crc(0xffffU, &hdr.key, offsetof(struct persist_rec_hdr, crc0));
+    hdr.crc1 = persist_crc(0xffffU, &hdr.type, sizeof(hdr) - offsetof(struct persist_rec_hdr, type) - sizeof(hdr.crc1));
+
+    /* The space is consumed even if the write fails half way */
+    persist.busy_offset = persist.write_offset;
+    persist.write_offset += PERSIST_REC_HDR_SIZE + PERSIST_ALIGN_UP(len);
+    if (persist.backend->write(addr, &hdr, sizeof(hdr)) != 0) {
+        persist.busy_offset = PERSIST_OFFSET_NONE;
+        return PERSIST_STORE_ERR_IO;
+    }
+    addr += PERSIST_REC_HDR_SIZE;
+
+    for (done = 0U; done < len; done += n) {
+        n = ((len - done) > sizeof(chunk)) ? sizeof(chunk) : (len - done);
+        if (persist_src_read(src, done, chunk, n) != PERSIST_STORE_OK) {
+            break;
+        }
+        if ((n % PERSIST_ALIGN) != 0U) {
+            /* Last chunk, pad it */
+            (void)memset(&chunk[n], 0xff, PERSIST_ALIGN_UP(n) - n);
+        }
+        if (persist.backend->write(addr + done, chunk, PERSIST_ALIGN_UP(n)) != 0) {
+            break;
+        }
+    }
+    persist.busy_offset = PERSIST_OFFSET_NONE;
+    return (done >= len) ? PERSIST_STORE_OK : PERSIST_STORE_ERR_IO;
+} /* persist_rec_write */
+
+/* Finds where the next record goes in the active page */
+static void
+persist_active_scan(void)
+{
+    struct persist_rec_hdr hdr;
+    uint8_t page = persist.order[persist.nb_used - 1U];
+    uint32_t offset = PERSIST_PAGE_HDR_SIZE;
+    uint8_t erased[PERSIST_REC_HDR_SIZE];
+    unsigned int i;
+
+    while (persist_rec_get(page, offset, &hdr)) {
+        offset = persist_rec_next(offset, &hdr);
+    }
+    /* A torn header can't be skipped, don't write after it */
+    if ((offset + PERSIST_REC_HDR_SIZE) <= persist.backend->pageSize) {
+        if (persist.backend->read(persist_page_addr(page) + offset, erased, sizeof(erased)) != 0) {
+            offset = persist.backend->pageSize;
+        }
+        for (i = 0; i < sizeof(erased); i++) {
+            if (erased[i] != 0xffU) {
+                offset = persist.backend->pageSize;
+                break;
+            }
+        }
+    }
+    persist.write_offset = offset;
+} /* persist_active_scan */
+
+/* Checks if a newer page holds a record that replaces the whole value of the key */
+static bool
+persist_key_replaced(uint16_t key)
+{
+    struct persist_rec_hdr hdr;
+    uint32_t offset;
+    unsigned int i;
+    uint8_t page;
+
+    for (i = 1U; i < persist.nb_used; i++) {
+        page = persist.order[i];
+        offset = PERSIST_PAGE_HDR_SIZE;
+        while (persist_rec_get(page, offset, &hdr)) {
+            if ((i == (persist.nb_used - 1U)) && (offset >= persist.busy_offset)) {
+                break;
+            }
+            if ((hdr.key == key) && (hdr.type != PERSIST_REC_DELTA) && persist_rec_valid(page, offset, &hdr)) {
+                return true;
+            }
+            offset = persist_rec_next(offset, &hdr);
+        }
+    }
+    return false;
+} /* persist_key_replaced */
+
+/* Copies the values living in the oldest page to the active page, then erases it.
+ * A value already copied, or rewritten since, isn't copied again, so a reclaim
+ * interrupted by a reset can be resumed. */
+static int
+persist_reclaim_oldest(void)
+{
+    struct persist_rec_hdr hdr;
+    uint8_t old = persist.order[0];
+    uint32_t offset;
+    int size;
+    int rc;
+    unsigned int i;
+
+    offset = PERSIST_PAGE_HDR_SIZE;
+    while (persist_rec_get(old, offset, &hdr)) {
+        if (!persist_key_replaced(hdr.key)) {
+            size = persistStoreRead(hdr.key, 0U, NULL, 0U);
+            if (size >= 0) {
+                struct persist_src src = { NULL, hdr.key };
+
+                if ((persist.write_offset + PERSIST_REC_HDR_SIZE + PERSIST_ALIGN_UP((uint32_t)size))
+                    > persist.backend->pageSize) {
+                    return PERSIST_STORE_ERR_NO_SPACE;
+                }
+                rc = persist_rec_write(hdr.key, PERSIST_REC_FULL, 0U, &src, (uint32_t)size, (uint32_t)size);
+                if (rc != PERSIST_STORE_OK) {
+                    return rc;
+                }
+            }
+        }
+        offset = persist_rec_next(offset, &hdr);
+    }
+
+    for (i = 1U; i < persist.nb_used; i++) {
+        persist.order[i - 1U] = persist.order[i];
+    }
+    persist.nb_used--;
+    return persist_page_retire(old);
+} /* persist_reclaim_oldest */
+
+/* Opens a new active page, reclaiming the oldest page if it was the last free one */
+static int
+persist_rotate(void)
+{
+    struct persist_page_hdr page_hdr;
+    uint32_t page, start;
+    int rc;
+
+    /* Pages are used in turn */
+    start = (persist.nb_used > 0U) ? (persist.order[persist.nb_used - 1U] + 1U) : 0U;
+    for (page = 0U; page < persist.backend->pageCount; page++) {
+        if (persist.seq[(start + page) % persist.backend->pageCount] == PERSIST_SEQ_NONE) {
+            break;
+        }
+    }
+    if (page == persist.backend->pageCount) {
+        return PERSIST_STORE_ERR_NO_SPACE;
+    }
+    page = (start + page) % persist.backend->pageCount;
+
+    rc = persist_page_erase((uint8_t)page);
+    if (rc != PERSIST_STORE_OK) {
+        return rc;
+    }
+    page_hdr.magic = PERSIST_PAGE_MAGIC;
+    page_hdr.seq = (persist.nb_used > 0U) ? (persist.seq[persist.order[persist.nb_used - 1U]] + 1U) : 0U;
+    page_hdr.seq_inv = ~page_hdr.seq;
+    page_hdr.crc = persist_page_hdr_crc(&page_hdr);
+    page_hdr.reserved = 0xffffU;
+    if (persist.backend->write(persist_page_addr((uint8_t)page), &page_hdr, sizeof(page_hdr)) != 0) {
+        return PERSIST_STORE_ERR_IO;
+    }
+    persist.seq[page] = page_hdr.seq;
+    persist.order[persist.nb_used++] = (uint8_t)page;
+    persist.write_offset = PERSIST_PAGE_HDR_SIZE;
+
+    /* Always keep a free page for the next rotation */
+    if (persist.nb_used == persist.backend->pageCount) {
+        rc = persist_reclaim_oldest();
+    }
+    return rc;
+} /* persist_rotate */
+
+static int
+persist_append(uint16_t key, uint16_t type, uint32_t offset, const uint8_t *data, uint32_t len, uint32_t total)
+{
+    struct persist_src src = { data, key };
+    uint32_t need = PERSIST_REC_HDR_SIZE + PERSIST_ALIGN_UP(len);
+    unsigned int i;
+    int rc;
+
+    if (persist.backend == NULL) {
+        return PERSIST_STORE_ERR_PARAM;
+    }
+    if (need > (persist.backend->pageSize - PERSIST_PAGE_HDR_SIZE)) {
+        return PERSIST_STORE_ERR_NO_SPACE;
+    }
+    for (i = 0U; (persist.write_offset + need) > persist.backend->pageSize; i++) {
+        if (i == persist.backend->pageCount) {
+            return PERSIST_STORE_ERR_NO_SPACE;
+        }
+        rc = persist_rotate();
+        if (rc != PERSIST_STORE_OK) {
+            return rc;
+        }
+    }
+    return persist_rec_write(key, type, offset, &src, len, total);
+} /* persist_append */
+
+int
+persistStoreInit(const struct persistStoreBackend *aBackend)
+{
+    struct persist_page_hdr page_hdr;
+    unsigned int i, j;
+    uint8_t tmp;
+
+    if ((aBackend == NULL) || (aBackend->pageCount < 2U) || (aBackend->pageCount > PERSIST_STORE_MAX_PAGES)
+        || ((aBackend->pageSize % PERSIST_ALIGN) != 0U) || (aBackend->pageSize > 0x10000U)) {
+        return PERSIST_STORE_ERR_PARAM;
+    }
+    (void)memset(&persist, 0, sizeof(persist));
+    persist.backend = aBackend;
+    persist.busy_offset = PERSIST_OFFSET_NONE;
+
+    for (i = 0; i < aBackend->pageCount; i++) {
+        persist.seq[i] = PERSIST_SEQ_NONE;
+        if (aBackend->read(persist_page_addr((uint8_t)i), &page_hdr, sizeof(page_hdr)) != 0) {
+            return PERSIST_STORE_ERR_IO;
+        }
+        if (persist_page_hdr_valid(&page_hdr)) {
+            persist.seq[i] = page_hdr.seq;
+            persist.order[persist.nb_used++] = (uint8_t)i;
+        }
+        else if (!persist_page_hdr_erased(&page_hdr)) {
+            /* Retired, or torn by a reset during its erase: free */
+            if (persist_page_erase((uint8_t)i) != PERSIST_STORE_OK) {
+                return PERSIST_STORE_ERR_IO;
+            }
+        }
+    }
+    /* Oldest first */
+    for (i = 1U; i < persist.nb_used; i++) {
+        for (j = i; (j > 0U) && (persist.seq[persist.order[j - 1U]] > persist.seq[persist.order[j]]); j--) {
+            tmp = persist.order[j];
+            persist.order[j] = persist.order[j - 1U];
+            persist.order[j - 1U] = tmp;
+        }
+    }
+
+    if (persist.nb_used == 0U) {
+        return persist_rotate();
+    }
+    persist_active_scan();
+    if (persist.nb_used == aBackend->pageCount) {
+        /* Reset while the oldest page was reclaimed, finish it */
+        return persist_reclaim_oldest();
+    }
+    return PERSIST_STORE_OK;
+} /* persistStoreInit */
+
+int
+persistStoreRead(uint16_t aKey, uint32_t aOffset, void *aData, uint32_t aSize)
+{
+    struct persist_rec_hdr hdr;
+    uint32_t offset, start, end;
+    unsigned int i;
+    uint8_t page;
+    int size = PERSIST_STORE_ERR_NOT_FOUND;
+
+    if (persist.backend == NULL) {
+        return PERSIST_STORE_ERR_PARAM;
+    }
+    if (aData == NULL) {
+        aSize = 0U;
+    }
+    /* Replay the records of the key, oldest first */
+    for (i = 0; i < persist.nb_used; i++) {
+        page = persist.order[i];
+        offset = PERSIST_PAGE_HDR_SIZE;
+        while (persist_rec_get(page, offset, &hdr)) {
+            if ((i == (persist.nb_used - 1U)) && (offset >= persist.busy_offset)) {
+                break;
+            }
+            if ((hdr.key == aKey) && persist_rec_valid(page, offset, &hdr)) {
+                if (hdr.type == PERSIST_REC_DELETE) {
+                    size = PERSIST_STORE_ERR_NOT_FOUND;
+                }
+                else {
+                    size = (int)hdr.total;
+                    start = (aOffset > hdr.offset) ? aOffset : hdr.offset;
+                    end = ((aOffset + aSize) < ((uint32_t)hdr.offset + hdr.len)) ? (aOffset + aSize) : ((uint32_t)hdr.offset + hdr.len);
+                    if ((start < end) && (persist.backend->read(persist_page_addr(page) + offset
+                            + PERSIST_REC_HDR_SIZE + (start - hdr.offset),
+                            (uint8_t *)aData + (start - aOffset), end - start) != 0)) {
+                        return PERSIST_STORE_ERR_IO;
+                    }
+                }
+            }
+            offset = persist_rec_next(offset, &hdr);
+        }
+    }
+    return size;
+} /* persistStoreRead */
+
+int
+persistStoreWrite(uint16_t aKey, const void *aData, uint32_t aSize)
+{
+    const uint8_t *data = aData;
+    uint8_t chunk[PERSIST_CHUNK_SIZE];
+    uint32_t first = aSize, last = 0U;
+    uint32_t offset, n, i;
+    int size;
+
+    if ((aKey == PERSIST_KEY_ERASED) || (aSize > 0xffffU) || ((aData == NULL) && (aSize != 0U))) {
+        return PERSIST_STORE_ERR_PARAM;
+    }
+    size = persistStoreRead(aKey, 0U, NULL, 0U);
+    if ((size < 0) || ((uint32_t)size != aSize)) {
+        return persist_append(aKey, PERSIST_REC_FULL, 0U, data, aSize, aSize);
+    }
+
+    /* Same size, only write the range that changed */
+    for (offset = 0U; offset < aSize; offset += n) {
+        n = ((aSize - offset) > sizeof(chunk)) ? sizeof(chunk) : (aSize - offset);
+        if (persistStoreRead(aKey, offset, chunk, n) < 0) {
+            return PERSIST_STORE_ERR_IO;
+        }
+        for (i = 0U; i < n; i++) {
+            if (chunk[i] != data[offset + i]) {
+                if (first == aSize) {
+                    first = offset + i;
+                }
+                last = offset + i;
+            }
+        }
+    }
+    if (first == aSize) {
+        return PERSIST_STORE_OK;
+    }
+    if (((last - first) + 1U) > (aSize / 2U)) {
+        return persist_append(aKey, PERSIST_REC_FULL, 0U, data, aSize, aSize);
+    }
+    return persist_append(aKey, PERSIST_REC_DELTA, first, &data[first], (last - first) + 1U, aSize);
+} /* persistStoreWrite */
+
+int
+persistStoreDelete(uint16_t aKey)
+{
+    if (persistStoreRead(aKey, 0U, NULL, 0U) < 0) {
+        return PERSIST_STORE_ERR_NOT_FOUND;
+    }
+    return persist_append(aKey, PERSIST_REC_DELETE, 0U, NULL, 0U, 0U);
+} /* persistStoreDelete */
+
+void
+persistStoreMaintain(void)
+{
+    if (persist.backend == NULL) {
+        return;
+    }
+    if (persist.write_offset > ((persist.backend->pageSize / 4U) * 3U)) {
+        (void)persist_rotate();
+    }
+} /* persistStoreMaintain */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,78 @@
+/**
+ ******************************************************************************
+ * @file    persist_store.h
+ * @author  MCD Application Team
+ * @brief   Log structured key/record store for the persistent data.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PERSIST_STORE_H
+#define __PERSIST_STORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Records are appended to the active page, a rewrite only appends the range of
+ * bytes that changed. When the active page is full, the next page is erased and
+ * becomes the active one, and once all the pages are in use the values still
+ * living in the oldest page are copied to the active page before it is erased.
+ * Pages are used in turn, which levels the wear. Each record is CRC protected,
+ * a record torn by a reset is ignored and the previous value is kept. The page
+ * header is CRC protected too and is cleared before the page is erased, a page
+ * torn by a reset during its erase is erased again at mount. */
+
+#ifndef PERSIST_STORE_MAX_PAGES
+#define PERSIST_STORE_MAX_PAGES             16U
+#endif
+
+/* Return values */
+#define PERSIST_STORE_OK                    0
+#define PERSIST_STORE_ERR_NOT_FOUND         (-1)
+#define PERSIST_STORE_ERR_NO_SPACE          (-2)
+#define PERSIST_STORE_ERR_IO                (-3)
+#define PERSIST_STORE_ERR_PARAM             (-4)
+
+/* Storage backend. Addresses start at 0 at the beginning of the first page.
+ * write() is called with an address and a size multiple of 8 bytes (STM32WB
+ * flash double word), on erased (0xFF) locations, or to clear a double word to
+ * 0 (allowed by the STM32WB flash). The functions return 0 on success. */
+struct persistStoreBackend {
+    uint32_t pageSize;
+    uint32_t pageCount;
+    int (*read)(uint32_t aAddress, void *aData, uint32_t aSize);
+    int (*write)(uint32_t aAddress, const void *aData, uint32_t aSize);
+    int (*erase)(uint32_t aPage);
+};
+
+/* Mounts the store, erasing the backend if it holds no valid page */
+int persistStoreInit(const struct persistStoreBackend *aBackend);
+
+/* Reads aSize bytes of the value of aKey from aOffset. aData may be NULL to get
+ * the size only. Returns the size of the value, or PERSIST_STORE_ERR_NOT_FOUND. */
+int persistStoreRead(uint16_t aKey, uint32_t aOffset, void *aData, uint32_t aSize);
+
+/* Stores a value of up to 65535 bytes. Nothing is written if the value is
+ * unchanged, and only the changed range is written if the size is unchanged. */
+int persistStoreWrite(uint16_t aKey, const void *aData, uint32_t aSize);
+
+int persistStoreDelete(uint16_t aKey);
+
+/* Moves to the next page ahead of time when the active page is mostly used, so
+ * that the compaction isn't paid by a later write. Call it from a low priority
+ * task. */
+void persistStoreMaintain(void);
+
+#endif /* __PERSIST_STORE_H */
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,138 @@
+/**
+ ******************************************************************************
+ * @file    persist_store_file.c
+ * @author  MCD Application Team
+ * @brief   File backend of the persistent store, for host builds.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "persist_store.h"
+#include "persist_store_file.h"
+
+#define PERSIST_FILE_CHUNK                  64U
+
+static FILE *persist_file;
+static struct persistStoreBackend persist_file_backend;
+
+static int
+persist_file_access(uint32_t addr, uint32_t size)
+{
+    if ((persist_file == NULL) || (addr > (persist_file_backend.pageSize * persist_file_backend.pageCount))
+        || (size > ((persist_file_backend.pageSize * persist_file_backend.pageCount) - addr))) {
+        return -1;
+    }
+    return (fseek(persist_file, (long)addr, SEEK_SET) == 0) ? 0 : -1;
+} /* persist_file_access */
+
+static int
+persist_file_read(uint32_t aAddress, void *aData, uint32_t aSize)
+{
+    if (persist_file_access(aAddress, aSize) != 0) {
+        return -1;
+    }
+    return (fread(aData, 1, aSize, persist_file) == aSize) ? 0 : -1;
+} /* persist_file_read */
+
+static int
+persist_file_write(uint32_t aAddress, const void *aData, uint32_t aSize)
+{
+    const uint8_t *data = aData;
+    uint8_t chunk[PERSIST_FILE_CHUNK];
+    uint32_t n, i;
+
+    while (aSize > 0U) {
+        n = (aSize < sizeof(chunk)) ? aSize : sizeof(chunk);
+        if (persist_file_read(aAddress, chunk, n) != 0) {
+            return -1;
+        }
+        for (i = 0; i < n; i++) {
+            chunk[i] &= data[i];
+        }
+        if ((persist_file_access(aAddress, n) != 0) || (fwrite(chunk, 1, n, persist_file) != n)) {
+            return -1;
+        }
+        aAddress += n;
+        data += n;
+        aSize -= n;
+    }
+    return (fflush(persist_file) == 0) ? 0 : -1;
+} /* persist_file_write */
+
+static int
+persist_file_erase(uint32_t aPage)
+{
+    uint8_t chunk[PERSIST_FILE_CHUNK];
+    uint32_t addr = aPage * persist_file_backend.pageSize;
+    uint32_t end = addr + persist_file_backend.pageSize;
+    uint32_t n;
+
+    if ((aPage >= persist_file_backend.pageCount) || (persist_file_access(addr, persist_file_backend.pageSize) != 0)) {
+        return -1;
+    }
+    (void)memset(chunk, 0xff, sizeof(chunk));
+    for (; addr < end; addr += n) {
+        n = ((end - addr) < sizeof(chunk)) ? (end - addr) : sizeof(chunk);
+        if (fwrite(chunk, 1, n, persist_file) != n) {
+            return -1;
+        }
+    }
+    return (fflush(persist_file) == 0) ? 0 : -1;
+} /* persist_file_erase */
+
+const struct persistStoreBackend *
+persistStoreFileOpen(const char *aPath, uint32_t aPageSize, uint32_t aPageCount)
+{
+    long size;
+    uint32_t i;
+
+    persistStoreFileClose();
+    persist_file = fopen(aPath, "r+b");
+    if (persist_file == NULL) {
+        persist_file = fopen(aPath, "w+b");
+    }
+    if (persist_file == NULL) {
+        return NULL;
+    }
+    persist_file_backend.pageSize = aPageSize;
+    persist_file_backend.pageCount = aPageCount;
+    persist_file_backend.read = persist_file_read;
+    persist_file_backend.write = persist_file_write;
+    persist_file_backend.erase = persist_file_erase;
+
+    /* Pages missing from the file are erased */
+    if ((fseek(persist_file, 0, SEEK_END) != 0) || ((size = ftell(persist_file)) < 0)) {
+        persistStoreFileClose();
+        return NULL;
+    }
+    for (i = (uint32_t)size / aPageSize; i < aPageCount; i++) {
+        if (persist_file_erase(i) != 0) {
+            persistStoreFileClose();
+            return NULL;
+        }
+    }
+    return &persist_file_backend;
+} /* persistStoreFileOpen */
+
+void
+persistStoreFileClose(void)
+{
+    if (persist_file != NULL) {
+        (void)fclose(persist_file);
+        persist_file = NULL;
+    }
+} /* persistStoreFileClose */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
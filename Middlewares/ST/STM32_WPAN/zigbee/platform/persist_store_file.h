@@ -0,0 +1,37 @@
+/**
+ ******************************************************************************
+ * @file    persist_store_file.h
+ * @author  MCD Application Team
+ * @brief   File backend of the persistent store, for host builds.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PERSIST_STORE_FILE_H
+#define __PERSIST_STORE_FILE_H
+
+#include <stdint.h>
+
+struct persistStoreBackend;
+
+/* Opens aPath as a flash of aPageCount pages of aPageSize bytes, the file is
+ * created erased (0xFF) if it is missing or too short. Like NOR flash, a write
+ * only clears bits: the stored value is the AND of the old and the new data.
+ * Only one file is open at a time. Returns NULL on error. */
+const struct persistStoreBackend * persistStoreFileOpen(const char *aPath, uint32_t aPageSize, uint32_t aPageCount);
+
+void persistStoreFileClose(void);
+
+#endif /* __PERSIST_STORE_FILE_H */
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,314 @@
+/**
+ ******************************************************************************
+ * @file    persist_store_test.c
+ * @author  MCD Application Team
+ * @brief   Host test of the persistent store, with resets during the writes
+ *          and the erases of the flash.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "persist_store.h"
+#include "persist_store_file.h"
+
+#define TEST_PAGE_SIZE                      1024U
+#define TEST_PAGE_COUNT                     4U
+#define TEST_KEYS                           6U
+#define TEST_VALUE_MAX                      120U
+#define TEST_ITERATIONS                     100000UL
+
+/* Flash with the resets: the backend operation that finds the budget at 0 is
+ * left half done, and the test goes back to the mount with longjmp() */
+static const struct persistStoreBackend *test_file;
+static struct persistStoreBackend test_backend;
+static long test_budget = -1;
+static jmp_buf test_reset;
+static unsigned long test_resets;
+
+/* Model: the values of the completed operations, and the value of the
+ * operation a reset interrupted, which may or may not be stored */
+static uint8_t test_value[TEST_KEYS][TEST_VALUE_MAX];
+static int test_len[TEST_KEYS];
+static int test_pending_key = -1;
+static uint8_t test_pending_value[TEST_VALUE_MAX];
+static int test_pending_len;
+
+static void
+test_fail(const char *msg, unsigned long it)
+{
+    printf("FAIL: %s (iteration %lu)\n", msg, it);
+    persistStoreFileClose();
+    exit(1);
+} /* test_fail */
+
+static bool
+test_cut(void)
+{
+    if (test_budget < 0) {
+        return false;
+    }
+    return test_budget-- == 0;
+} /* test_cut */
+
+static int
+test_read(uint32_t aAddress, void *aData, uint32_t aSize)
+{
+    return test_file->read(aAddress, aData, aSize);
+} /* test_read */
+
+static int
+test_write(uint32_t aAddress, const void *aData, uint32_t aSize)
+{
+    const uint8_t *data = aData;
+    uint8_t old[8], part[8];
+    uint32_t i;
+    int k, erased, zero;
+
+    if (((aAddress % 8U) != 0U) || ((aSize % 8U) != 0U)) {
+        test_fail("unaligned write", 0);
+    }
+    for (i = 0; i < aSize; i += 8U) {
+        if (test_read(aAddress + i, old, sizeof(old)) != 0) {
+            return -1;
+        }
+        erased = 1;
+        zero = 1;
+        for (k = 0; k < 8; k++) {
+            erased &= (old[k] == 0xffU);
+            zero &= (data[i + k] == 0U);
+        }
+        if (!erased && !zero) {
+            test_fail("write over programmed flash", 0);
+        }
+        if (test_cut()) {
+            /* Some of the bits of the double word are programmed */
+            for (k = 0; k < 8; k++) {
+                part[k] = data[i + k] | (uint8_t)rand();
+            }
+            (void)test_file->write(aAddress + i, part, sizeof(part));
+            longjmp(test_reset, 1);
+        }
+        if (test_file->write(aAddress + i, data + i, 8U) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+} /* test_write */
+
+static int
+test_erase(uint32_t aPage)
+{
+    uint8_t page[TEST_PAGE_SIZE];
+    uint32_t i;
+
+    if (test_cut()) {
+        /* Each byte is erased, untouched, or somewhere in between */
+        if (test_read(aPage * TEST_PAGE_SIZE, page, sizeof(page)) != 0) {
+            return -1;
+        }
+        for (i = 0; i < sizeof(page); i++) {
+            switch (rand() % 3) {
+            case 0:
+                page[i] = 0xffU;
+                break;
+            case 1:
+                page[i] |= (uint8_t)rand();
+                break;
+            default:
+                break;
+            }
+        }
+        (void)test_file->erase(aPage);
+        (void)test_file->write(aPage * TEST_PAGE_SIZE, page, sizeof(page));
+        longjmp(test_reset, 1);
+    }
+    return test_file->erase(aPage);
+} /* test_erase */
+
+/* Mounts the store, with resets during the mount too */
+static void
+test_mount(unsigned long it)
+{
+    int rc;
+
+    for (;;) {
+        if (setjmp(test_reset) == 0) {
+            test_budget = ((rand() % 4) == 0) ? (rand() % 8) : -1;
+            rc = persistStoreInit(&test_backend);
+            test_budget = -1;
+            if (rc != PERSIST_STORE_OK) {
+                test_fail("mount", it);
+            }
+            return;
+        }
+        test_resets++;
+    }
+} /* test_mount */
+
+static void
+test_check(unsigned long it)
+{
+    uint8_t buf[TEST_VALUE_MAX + 8U];
+    unsigned int k;
+    int rc;
+    bool ok;
+
+    for (k = 0; k < TEST_KEYS; k++) {
+        rc = persistStoreRead((uint16_t)(k + 1U), 0, buf, sizeof(buf));
+        ok = (rc == test_len[k]) && ((rc <= 0) || (memcmp(buf, test_value[k], (size_t)rc) == 0));
+        if (!ok && ((int)k == test_pending_key)) {
+            ok = (rc == test_pending_len) && ((rc <= 0) || (memcmp(buf, test_pending_value, (size_t)rc) == 0));
+            if (ok) {
+                test_len[k] = rc;
+                (void)memcpy(test_value[k], test_pending_value, (size_t)((rc > 0) ? rc : 0));
+            }
+        }
+        if (!ok) {
+            printf("key %u: read %d, expected %d\n", k + 1U, rc, test_len[k]);
+            test_fail("value lost", it);
+        }
+    }
+    test_pending_key = -1;
+} /* test_check */
+
+static void
+test_open(const char *path)
+{
+    test_file = persistStoreFileOpen(path, TEST_PAGE_SIZE, TEST_PAGE_COUNT);
+    if (test_file == NULL) {
+        test_fail("cannot open the flash file", 0);
+    }
+    test_backend = *test_file;
+    test_backend.read = test_read;
+    test_backend.write = test_write;
+    test_backend.erase = test_erase;
+} /* test_open */
+
+/* A reset during the erase of a page can leave a page header with the magic
+ * and any sequence number: the page must not be taken for the newest one */
+static void
+test_torn_header(const char *path)
+{
+    static const uint8_t value[] = "torn header";
+    uint32_t hdr[4] = { 0x50535431U, 0xde00236dU, 0x00000000U, 0xffffffffU };
+    uint8_t buf[sizeof(value)];
+    unsigned int i;
+    uint32_t page;
+
+    (void)remove(path);
+    test_open(path);
+    test_mount(0);
+    if (persistStoreWrite(1U, value, sizeof(value)) != PERSIST_STORE_OK) {
+        test_fail("write", 0);
+    }
+    for (page = 0; page < TEST_PAGE_COUNT; page++) {
+        if ((test_file->read(page * TEST_PAGE_SIZE, buf, 4U) == 0) && (buf[0] == 0xffU)) {
+            break;
+        }
+    }
+    if ((page == TEST_PAGE_COUNT) || (test_file->write(page * TEST_PAGE_SIZE, hdr, sizeof(hdr)) != 0)) {
+        test_fail("no free page", 0);
+    }
+    test_mount(0);
+    if ((test_file->read(page * TEST_PAGE_SIZE, buf, 8U) != 0) || (memcmp(buf, hdr, 8U) == 0)) {
+        test_fail("torn header: page in use", 0);
+    }
+    if ((persistStoreRead(1U, 0, buf, sizeof(buf)) != (int)sizeof(value)) || (memcmp(buf, value, sizeof(value)) != 0)) {
+        test_fail("torn header: value lost", 0);
+    }
+    for (i = 0; i < 1000U; i++) {
+        buf[0] = (uint8_t)i;
+        if (persistStoreWrite(2U, buf, sizeof(buf)) != PERSIST_STORE_OK) {
+            test_fail("torn header: write", i);
+        }
+    }
+    persistStoreFileClose();
+} /* test_torn_header */
+
+static void
+test_resets_random(const char *path, unsigned long iterations)
+{
+    uint8_t value[TEST_VALUE_MAX];
+    unsigned long it;
+    unsigned int k;
+    volatile int len;
+    int rc, i;
+
+    (void)remove(path);
+    test_open(path);
+    for (k = 0; k < TEST_KEYS; k++) {
+        test_len[k] = PERSIST_STORE_ERR_NOT_FOUND;
+    }
+    test_mount(0);
+
+    for (it = 0; it < iterations; it++) {
+        k = (unsigned int)rand() % TEST_KEYS;
+        if ((rand() % 20) == 0) {
+            len = -1;
+        }
+        else {
+            /* Mostly small changes of the same size, to go through the deltas */
+            len = ((test_len[k] > 0) && ((rand() % 3) != 0)) ? test_len[k] : (rand() % (int)TEST_VALUE_MAX);
+            (void)memcpy(value, test_value[k], sizeof(value));
+            for (i = rand() % 4; (i > 0) && (len > 0); i--) {
+                value[rand() % len] = (uint8_t)rand();
+            }
+        }
+        test_pending_key = (int)k;
+        test_pending_len = (len < 0) ? PERSIST_STORE_ERR_NOT_FOUND : len;
+        (void)memcpy(test_pending_value, value, sizeof(value));
+
+        if (setjmp(test_reset) == 0) {
+            test_budget = ((rand() % 30) == 0) ? (rand() % 40) : -1;
+            rc = (len < 0) ? persistStoreDelete((uint16_t)(k + 1U)) : persistStoreWrite((uint16_t)(k + 1U), value, (uint32_t)len);
+            if ((rand() % 7) == 0) {
+                persistStoreMaintain();
+            }
+            test_budget = -1;
+            if ((rc != PERSIST_STORE_OK) && !((len < 0) && (rc == PERSIST_STORE_ERR_NOT_FOUND))) {
+                printf("rc %d\n", rc);
+                test_fail("write", it);
+            }
+            test_len[k] = test_pending_len;
+            (void)memcpy(test_value[k], value, sizeof(value));
+            test_pending_key = -1;
+        }
+        else {
+            test_resets++;
+            test_mount(it);
+        }
+        test_check(it);
+    }
+    persistStoreFileClose();
+} /* test_resets_random */
+
+int
+main(int argc, char *argv[])
+{
+    const char *path = (argc > 1) ? argv[1] : "persist_store_test.bin";
+    unsigned long iterations = (argc > 2) ? strtoul(argv[2], NULL, 0) : TEST_ITERATIONS;
+
+    srand(1);
+    test_torn_header(path);
+    test_resets_random(path, iterations);
+    (void)remove(path);
+    printf("PASS: %lu iterations, %lu resets\n", iterations, test_resets);
+    return 0;
+} /* main */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
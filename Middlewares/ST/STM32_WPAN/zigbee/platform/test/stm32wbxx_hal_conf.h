@@ -0,0 +1,73 @@
+/**
+ ******************************************************************************
+ * @file    stm32wbxx_hal_conf.h
+ * @author  MCD Application Team
+ * @brief   HAL configuration of the host tests of zigbee_core_wb.c. Only the
+ *          HAL headers the core needs are included, no HAL driver is built.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#ifndef STM32WBxx_HAL_CONF_H
+#define STM32WBxx_HAL_CONF_H
+
+#define HAL_MODULE_ENABLED
+#define HAL_CORTEX_MODULE_ENABLED
+#define HAL_RCC_MODULE_ENABLED
+#if defined(ZB_TEST_CRC_HW)
+#define HAL_CRC_MODULE_ENABLED
+#endif
+
+#define HSE_VALUE                           32000000U
+#define HSE_STARTUP_TIMEOUT                 100U
+#define MSI_VALUE                           4000000U
+#define HSI_VALUE                           16000000U
+#define LSI1_VALUE                          32000U
+#define LSI2_VALUE                          32000U
+#define LSE_VALUE                           32768U
+#define LSE_STARTUP_TIMEOUT                 5000U
+#define HSI48_VALUE                         48000000U
+#define EXTERNAL_SAI1_CLOCK_VALUE           48000U
+#define VDD_VALUE                           3300U
+#define TICK_INT_PRIORITY                   0U
+#define USE_RTOS                            0U
+#define PREFETCH_ENABLE                     1U
+#define INSTRUCTION_CACHE_ENABLE            1U
+#define DATA_CACHE_ENABLE                   1U
+
+#include "stm32wbxx_hal_rcc.h"
+#include "stm32wbxx_hal_cortex.h"
+#if defined(HAL_CRC_MODULE_ENABLED)
+#include "stm32wbxx_hal_crc.h"
+#endif
+
+#define assert_param(expr)                  ((void)0U)
+
+#if defined(HAL_CRC_MODULE_ENABLED)
+/* The CRC peripheral and its clock are the model of zb_crc_test.c */
+CRC_TypeDef * zb_test_crc_access(void);
+extern uint32_t zb_test_crc_clk;
+
+#undef CRC
+#define CRC                                 (zb_test_crc_access())
+#undef __HAL_RCC_CRC_CLK_ENABLE
+#define __HAL_RCC_CRC_CLK_ENABLE()          (zb_test_crc_clk = 1U)
+#undef __HAL_RCC_CRC_CLK_DISABLE
+#define __HAL_RCC_CRC_CLK_DISABLE()         (zb_test_crc_clk = 0U)
+#undef __HAL_RCC_CRC_IS_CLK_ENABLED
+#define __HAL_RCC_CRC_IS_CLK_ENABLED()      (zb_test_crc_clk)
+#endif
+
+#endif /* STM32WBxx_HAL_CONF_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,29 @@
+/**
+ ******************************************************************************
+ * @file    stm_logging.h
+ * @author  MCD Application Team
+ * @brief   Logging of the host tests of zigbee_core_wb.c
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#ifndef STM_LOGGING_H_
+#define STM_LOGGING_H_
+
+#include <stdio.h>
+
+#define APP_DBG(...)                        (void)printf(__VA_ARGS__)
+
+#endif /* STM_LOGGING_H_ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,515 @@
+/**
+ ******************************************************************************
+ * @file    zb_aps_cache_test.c
+ * @author  MCD Application Team
+ * @brief   Randomized host test of the M4 cache of the APS group table and of
+ *          the endpoints of zigbee_core_wb.c, against a simulated M0.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#include "../../core/src/zigbee_core_wb.c"
+#include "zb_test_stub.h"
+
+/* The group table of the M0 is larger than the cache, so that it overflows */
+#define TEST_M0_GROUP_TABLE_SIZE            (ZB_APS_GROUP_CACHE_SIZE + 16U)
+#define TEST_M0_EP_TABLE_SIZE               (ZB_APS_EP_CACHE_SIZE + 4U)
+#define TEST_EP_RANGE                       (TEST_M0_EP_TABLE_SIZE + 4U)
+#define TEST_GROUP_RANGE                    (ZB_APS_GROUP_CACHE_SIZE * 2U)
+#define TEST_STEPS                          200000UL
+#define TEST_PHASE_STEPS                    2000UL
+
+/* Simulated M0 tables. A free group entry has the endpoint ZB_ENDPOINT_BCAST,
+ * a free endpoint entry has the endpoint 0. */
+static ZbApsmeGroupT test_m0_group[TEST_M0_GROUP_TABLE_SIZE];
+static struct {
+    uint8_t endpoint;
+    uint16_t profile_id;
+} test_m0_ep[TEST_M0_EP_TABLE_SIZE];
+static unsigned long test_step;
+/* The table is filled up, then emptied, in turn */
+static bool test_emptying;
+
+static void
+test_fail(const char *msg, unsigned long arg)
+{
+    printf("FAIL: %s (%lu, step %lu)\n", msg, arg, test_step);
+    exit(1);
+} /* test_fail */
+
+static int
+test_m0_ep_find(uint8_t endpoint)
+{
+    unsigned int i;
+
+    for (i = 0U; i < TEST_M0_EP_TABLE_SIZE; i++) {
+        if ((endpoint != 0U) && (test_m0_ep[i].endpoint == endpoint)) {
+            return (int)i;
+        }
+    }
+    return -1;
+} /* test_m0_ep_find */
+
+static int
+test_m0_group_find(uint16_t group_addr, uint8_t endpoint)
+{
+    unsigned int i;
+
+    for (i = 0U; i < TEST_M0_GROUP_TABLE_SIZE; i++) {
+        if ((test_m0_group[i].endpoint != ZB_ENDPOINT_BCAST) && (test_m0_group[i].groupAddr == group_addr)
+            && ((endpoint == ZB_ENDPOINT_BCAST) || (test_m0_group[i].endpoint == endpoint))) {
+            return (int)i;
+        }
+    }
+    return -1;
+} /* test_m0_group_find */
+
+static enum ZbStatusCodeT
+test_m0_group_add(uint16_t group_addr, uint8_t endpoint)
+{
+    int i;
+
+    if (test_m0_ep_find(endpoint) < 0) {
+        return ZB_APS_STATUS_INVALID_PARAMETER;
+    }
+    if (test_m0_group_find(group_addr, endpoint) >= 0) {
+        return ZB_APS_STATUS_SUCCESS;
+    }
+    for (i = 0; i < (int)TEST_M0_GROUP_TABLE_SIZE; i++) {
+        if (test_m0_group[i].endpoint == ZB_ENDPOINT_BCAST) {
+            test_m0_group[i].groupAddr = group_addr;
+            test_m0_group[i].endpoint = endpoint;
+            return ZB_APS_STATUS_SUCCESS;
+        }
+    }
+    return ZB_APS_STATUS_TABLE_FULL;
+} /* test_m0_group_add */
+
+/* Removes the entries of a group (any group if all), of one endpoint or of
+ * all of them. Returns the number of entries removed. */
+static unsigned int
+test_m0_group_remove(uint16_t group_addr, bool all, uint8_t endpoint)
+{
+    unsigned int i, count = 0U;
+
+    for (i = 0U; i < TEST_M0_GROUP_TABLE_SIZE; i++) {
+        if ((test_m0_group[i].endpoint != ZB_ENDPOINT_BCAST)
+            && (all || (test_m0_group[i].groupAddr == group_addr))
+            && ((endpoint == ZB_ENDPOINT_BCAST) || (test_m0_group[i].endpoint == endpoint))) {
+            test_m0_group[i].endpoint = ZB_ENDPOINT_BCAST;
+            count++;
+        }
+    }
+    return count;
+} /* test_m0_group_remove */
+
+static void
+test_m0_retval(Zigbee_Cmd_Request_t *rsp, uint32_t retval)
+{
+    rsp->Size = 1U;
+    rsp->Data[0] = retval;
+} /* test_m0_retval */
+
+/* M0 side of the IPCC commands used by the cache */
+static void
+test_m0_cmd(const Zigbee_Cmd_Request_t *req, Zigbee_Cmd_Request_t *rsp)
+{
+    int idx, j;
+
+    switch (req->ID) {
+        case MSG_M4TOM0_APS_GET_REQ:
+        {
+            ZbApsmeGetReqT *r = zb_test_ptr(req->Data[0]);
+            ZbApsmeGetConfT *c = zb_test_ptr(req->Data[1]);
+
+            c->attrId = r->attrId;
+            if ((r->attrId != ZB_APS_IB_ID_GROUP_TABLE) || (r->attrLength != sizeof(ZbApsmeGroupT))) {
+                c->status = ZB_APS_STATUS_UNSUPPORTED_ATTRIBUTE;
+            }
+            else if (r->attrIndex >= TEST_M0_GROUP_TABLE_SIZE) {
+                c->status = ZB_APS_STATUS_INVALID_INDEX;
+            }
+            else {
+                (void)memcpy(r->attr, &test_m0_group[r->attrIndex], sizeof(ZbApsmeGroupT));
+                c->status = ZB_APS_STATUS_SUCCESS;
+            }
+            break;
+        }
+
+        case MSG_M4TOM0_APS_SET_REQ:
+        {
+            ZbApsmeSetReqT *r = zb_test_ptr(req->Data[0]);
+            ZbApsmeSetConfT *c = zb_test_ptr(req->Data[1]);
+
+            c->attrId = r->attrId;
+            if ((r->attrId != ZB_APS_IB_ID_GROUP_TABLE) || (r->attrLength != sizeof(ZbApsmeGroupT))) {
+                c->status = ZB_APS_STATUS_UNSUPPORTED_ATTRIBUTE;
+            }
+            else if (r->attrIndex >= TEST_M0_GROUP_TABLE_SIZE) {
+                c->status = ZB_APS_STATUS_INVALID_INDEX;
+            }
+            else {
+                (void)memcpy(&test_m0_group[r->attrIndex], r->attr, sizeof(ZbApsmeGroupT));
+                c->status = ZB_APS_STATUS_SUCCESS;
+            }
+            break;
+        }
+
+        case MSG_M4TOM0_APSME_ADD_GROUP:
+        {
+            ZbApsmeAddGroupReqT *r = zb_test_ptr(req->Data[0]);
+            ZbApsmeAddGroupConfT *c = zb_test_ptr(req->Data[1]);
+
+            c->groupAddr = r->groupAddr;
+            c->endpt = r->endpt;
+            if (r->endpt != ZB_ENDPOINT_BCAST) {
+                c->status = test_m0_group_add(r->groupAddr, r->endpt);
+                break;
+            }
+            /* Added to all the endpoints */
+            c->status = ZB_APS_STATUS_SUCCESS;
+            for (j = 0; j < (int)TEST_M0_EP_TABLE_SIZE; j++) {
+                if ((test_m0_ep[j].endpoint != 0U)
+                    && (test_m0_group_add(r->groupAddr, test_m0_ep[j].endpoint) != ZB_APS_STATUS_SUCCESS)) {
+                    c->status = ZB_APS_STATUS_TABLE_FULL;
+                }
+            }
+            break;
+        }
+
+        case MSG_M4TOM0_APSME_REMOVE_GROUP:
+        {
+            ZbApsmeRemoveGroupReqT *r = zb_test_ptr(req->Data[0]);
+            ZbApsmeRemoveGroupConfT *c = zb_test_ptr(req->Data[1]);
+
+            c->groupAddr = r->groupAddr;
+            c->endpt = r->endpt;
+            c->status = (test_m0_group_remove(r->groupAddr, false, r->endpt) != 0U)
+                ? ZB_APS_STATUS_SUCCESS : ZB_APS_STATUS_INVALID_GROUP;
+            break;
+        }
+
+        case MSG_M4TOM0_APSME_REMOVE_ALL_GROUPS:
+        {
+            ZbApsmeRemoveAllGroupsReqT *r = zb_test_ptr(req->Data[0]);
+            ZbApsmeRemoveAllGroupsConfT *c = zb_test_ptr(req->Data[1]);
+
+            (void)test_m0_group_remove(0U, true, r->endpt);
+            c->endpt = r->endpt;
+            c->status = ZB_APS_STATUS_SUCCESS;
+            break;
+        }
+
+        case MSG_M4TOM0_APS_ENDPOINT_ADD:
+        {
+            ZbApsmeAddEndpointReqT *r = zb_test_ptr(req->Data[0]);
+            ZbApsmeAddEndpointConfT *c = zb_test_ptr(req->Data[1]);
+
+            c->status = ZB_APS_STATUS_INVALID_PARAMETER;
+            if ((r->endpoint == 0U) || (r->endpoint == ZB_ENDPOINT_BCAST) || (test_m0_ep_find(r->endpoint) >= 0)) {
+                break;
+            }
+            for (j = 0; j < (int)TEST_M0_EP_TABLE_SIZE; j++) {
+                if (test_m0_ep[j].endpoint == 0U) {
+                    test_m0_ep[j].endpoint = r->endpoint;
+                    test_m0_ep[j].profile_id = r->profileId;
+                    c->status = ZB_APS_STATUS_SUCCESS;
+                    break;
+                }
+            }
+            break;
+        }
+
+        case MSG_M4TOM0_APS_ENDPOINT_DEL:
+        {
+            ZbApsmeRemoveEndpointReqT *r = zb_test_ptr(req->Data[0]);
+            ZbApsmeRemoveEndpointConfT *c = zb_test_ptr(req->Data[1]);
+
+            idx = test_m0_ep_find(r->endpoint);
+            if (idx < 0) {
+                c->status = ZB_APS_STATUS_INVALID_PARAMETER;
+                break;
+            }
+            /* The groups of the endpoint go with it */
+            test_m0_ep[idx].endpoint = 0U;
+            (void)test_m0_group_remove(0U, true, r->endpoint);
+            c->status = ZB_APS_STATUS_SUCCESS;
+            break;
+        }
+
+        case MSG_M4TOM0_APS_EP_EXISTS:
+            test_m0_retval(rsp, (test_m0_ep_find((uint8_t)req->Data[0]) >= 0) ? 1U : 0U);
+            break;
+
+        case MSG_M4TOM0_APS_EP_GET_PROFILE:
+            idx = test_m0_ep_find((uint8_t)req->Data[0]);
+            test_m0_retval(rsp, (idx >= 0) ? test_m0_ep[idx].profile_id : ZCL_PROFILE_WILDCARD);
+            break;
+
+        default:
+            test_fail("unexpected IPCC command", req->ID);
+            break;
+    }
+} /* test_m0_cmd */
+
+static uint16_t
+test_group_addr(void)
+{
+    /* A few addresses in the same hash chains */
+    if ((rand() % 4) == 0) {
+        return (uint16_t)(((unsigned int)rand() % 4U) * ZB_APS_GROUP_CACHE_SIZE * 0x101U);
+    }
+    return (uint16_t)(0x1000U + ((unsigned int)rand() % TEST_GROUP_RANGE));
+} /* test_group_addr */
+
+static uint8_t
+test_endpoint(void)
+{
+    if ((rand() % 16) == 0) {
+        return ZB_ENDPOINT_BCAST;
+    }
+    return (uint8_t)(1U + ((unsigned int)rand() % TEST_EP_RANGE));
+} /* test_endpoint */
+
+/* One random request to the stack */
+static void
+test_request(void)
+{
+    ZbApsmeGroupT group;
+    unsigned int idx;
+    int op;
+
+    op = rand() % 16;
+    if (test_emptying && (op < 4)) {
+        op += 6;
+    }
+    switch (op) {
+        case 0:
+        case 1:
+        case 2:
+        case 3:
+        case 4:
+        case 5:
+        {
+            ZbApsmeAddGroupReqT r;
+            ZbApsmeAddGroupConfT c;
+
+            r.groupAddr = test_group_addr();
+            r.endpt = test_endpoint();
+            ZbApsmeAddGroupReq(NULL, &r, &c);
+            break;
+        }
+
+        case 6:
+        case 7:
+        case 8:
+        case 9:
+        {
+            ZbApsmeRemoveGroupReqT r;
+            ZbApsmeRemoveGroupConfT c;
+
+            r.groupAddr = test_group_addr();
+            r.endpt = test_endpoint();
+            idx = (unsigned int)rand() % TEST_M0_GROUP_TABLE_SIZE;
+            if (test_emptying && (test_m0_group[idx].endpoint != ZB_ENDPOINT_BCAST)) {
+                /* An entry of the table */
+                r.groupAddr = test_m0_group[idx].groupAddr;
+                r.endpt = test_m0_group[idx].endpoint;
+            }
+            ZbApsmeRemoveGroupReq(NULL, &r, &c);
+            break;
+        }
+
+        case 10:
+        {
+            ZbApsmeRemoveAllGroupsReqT r;
+            ZbApsmeRemoveAllGroupsConfT c;
+
+            if ((rand() % 8) != 0) {
+                break;
+            }
+            r.endpt = test_endpoint();
+            ZbApsmeRemoveAllGroupsReq(NULL, &r, &c);
+            break;
+        }
+
+        case 11:
+        case 12:
+        {
+            ZbApsmeAddEndpointReqT r;
+            ZbApsmeAddEndpointConfT c;
+
+            (void)memset(&r, 0, sizeof(r));
+            r.endpoint = test_endpoint();
+            r.profileId = (uint16_t)rand();
+            r.bdbCommissioningGroupID = DEFAULT_EP_BDB_COMMISSION_GRP_ID;
+            ZbApsmeAddEndpoint(NULL, &r, &c);
+            break;
+        }
+
+        case 13:
+        {
+            ZbApsmeRemoveEndpointReqT r;
+            ZbApsmeRemoveEndpointConfT c;
+
+            r.endpoint = test_endpoint();
+            ZbApsmeRemoveEndpoint(NULL, &r, &c);
+            break;
+        }
+
+        case 14:
+            /* Group table entry written directly: cleared, or set to an
+             * entry not in the table yet */
+            idx = (unsigned int)rand() % TEST_M0_GROUP_TABLE_SIZE;
+            group.groupAddr = test_group_addr();
+            group.endpoint = test_endpoint();
+            if ((group.endpoint != ZB_ENDPOINT_BCAST) && (test_m0_group_find(group.groupAddr, group.endpoint) >= 0)) {
+                break;
+            }
+            (void)ZbApsSetIndex(NULL, ZB_APS_IB_ID_GROUP_TABLE, &group, sizeof(group), idx);
+            break;
+
+        default:
+            /* Stack reset or cache bypass */
+            if ((rand() % 16) == 0) {
+                ZbApsCacheBypass(NULL, (rand() % 4) == 0);
+            }
+            break;
+    }
+} /* test_request */
+
+static int
+test_cmp_group(const void *a, const void *b)
+{
+    return (int)*(const uint16_t *)a - (int)*(const uint16_t *)b;
+} /* test_cmp_group */
+
+/* Answers of the cache, compared to the tables of the M0 */
+static void
+test_queries(void)
+{
+    uint16_t list[TEST_M0_GROUP_TABLE_SIZE];
+    unsigned int i, n, count, max_len;
+    uint16_t group_addr;
+    uint8_t endpoint;
+    int idx;
+
+    for (n = 0U; n < 8U; n++) {
+        group_addr = test_group_addr();
+        endpoint = test_endpoint();
+        if (ZbApsGroupIsMember(NULL, group_addr, endpoint) != (test_m0_group_find(group_addr, endpoint) >= 0)) {
+            test_fail("ZbApsGroupIsMember", group_addr);
+        }
+
+        endpoint = (uint8_t)(1U + ((unsigned int)rand() % TEST_EP_RANGE));
+        idx = test_m0_ep_find(endpoint);
+        if (ZbApsEndpointExists(NULL, endpoint) != (idx >= 0)) {
+            test_fail("ZbApsEndpointExists", endpoint);
+        }
+        if ((idx >= 0) && (ZbApsEndpointProfile(NULL, endpoint) != test_m0_ep[idx].profile_id)) {
+            test_fail("ZbApsEndpointProfile", endpoint);
+        }
+    }
+
+    /* Group membership of an endpoint: same set, or a subset of max_len
+     * groups in any order */
+    endpoint = (uint8_t)(1U + ((unsigned int)rand() % TEST_EP_RANGE));
+    count = 0U;
+    for (i = 0U; i < TEST_M0_GROUP_TABLE_SIZE; i++) {
+        if (test_m0_group[i].endpoint == endpoint) {
+            count++;
+        }
+    }
+    max_len = ((rand() % 4) == 0) ? ((unsigned int)rand() % (count + 1U)) : TEST_M0_GROUP_TABLE_SIZE;
+    n = ZbApsGroupsGetMembership(NULL, endpoint, list, (uint8_t)max_len);
+    if (n != ((count < max_len) ? count : max_len)) {
+        test_fail("ZbApsGroupsGetMembership count", n);
+    }
+    qsort(list, n, sizeof(list[0]), test_cmp_group);
+    for (i = 0U; i < n; i++) {
+        if (((i > 0U) && (list[i] == list[i - 1U])) || (test_m0_group_find(list[i], endpoint) < 0)) {
+            test_fail("ZbApsGroupsGetMembership group", list[i]);
+        }
+    }
+} /* test_queries */
+
+/* The hash chains and the free list of the cache hold each entry once */
+static void
+test_cache_lists(void)
+{
+    uint8_t seen[ZB_APS_GROUP_CACHE_SIZE];
+    unsigned int i, count = 0U;
+    uint8_t idx;
+
+    if (!zb_aps_cache.group_loaded) {
+        return;
+    }
+    (void)memset(seen, 0, sizeof(seen));
+    for (i = 0U; i < ZB_APS_GROUP_CACHE_SIZE; i++) {
+        for (idx = zb_aps_cache.group_head[i]; idx != ZB_APS_CACHE_NONE; idx = zb_aps_cache.group[idx].next) {
+            if ((idx >= ZB_APS_GROUP_CACHE_SIZE) || (seen[idx] != 0U)
+                || (zb_aps_group_cache_hash(zb_aps_cache.group[idx].group_addr) != i)
+                || (zb_aps_cache.group[idx].endpoint == ZB_ENDPOINT_BCAST)) {
+                test_fail("cache hash chain", i);
+            }
+            seen[idx] = 1U;
+            count++;
+        }
+    }
+    if (count != zb_aps_cache.group_count) {
+        test_fail("cache count", count);
+    }
+    for (idx = zb_aps_cache.group_free; idx != ZB_APS_CACHE_NONE; idx = zb_aps_cache.group[idx].next) {
+        if ((idx >= ZB_APS_GROUP_CACHE_SIZE) || (seen[idx] != 0U)
+            || (zb_aps_cache.group[idx].endpoint != ZB_ENDPOINT_BCAST)) {
+            test_fail("cache free list", idx);
+        }
+        seen[idx] = 1U;
+        count++;
+    }
+    if (count != ZB_APS_GROUP_CACHE_SIZE) {
+        test_fail("cache entries lost", count);
+    }
+} /* test_cache_lists */
+
+int
+main(void)
+{
+    unsigned long overflows = 0;
+    unsigned int i;
+
+    for (i = 0U; i < TEST_M0_GROUP_TABLE_SIZE; i++) {
+        test_m0_group[i].endpoint = ZB_ENDPOINT_BCAST;
+    }
+    zb_test_m0_cmd = test_m0_cmd;
+    srand(1);
+    ZbApsCacheBypass(NULL, false);
+
+    for (test_step = 0; test_step < TEST_STEPS; test_step++) {
+        test_emptying = ((test_step / TEST_PHASE_STEPS) % 2U) != 0U;
+        test_request();
+        test_queries();
+        if (zb_aps_cache.group_overflow) {
+            overflows++;
+        }
+        test_cache_lists();
+        if (!ZbApsCacheCheck(NULL)) {
+            test_fail("ZbApsCacheCheck", 0U);
+        }
+    }
+    printf("PASS: %lu steps, cache size %u, overflowed in %lu steps\n",
+        TEST_STEPS, (unsigned int)ZB_APS_GROUP_CACHE_SIZE, overflows);
+    return 0;
+} /* main */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
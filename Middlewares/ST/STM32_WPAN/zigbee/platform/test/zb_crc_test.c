@@ -0,0 +1,293 @@
+/**
+ ******************************************************************************
+ * @file    zb_crc_test.c
+ * @author  MCD Application Team
+ * @brief   Host test of WpanCrc of zigbee_core_wb.c, built with each CRC
+ *          engine: byte-wise, slicing-by-8 (ZB_CRC_SLICE_BY_8) and CRC
+ *          peripheral (ZB_TEST_CRC_HW, with a model of the peripheral).
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#include "../../core/src/zigbee_core_wb.c"
+
+#define TEST_BUF_SIZE                       600U
+#define TEST_ITERATIONS                     20000UL
+
+static uint8_t test_buf[TEST_BUF_SIZE];
+
+static void
+test_fail(const char *msg, unsigned long arg)
+{
+    printf("FAIL: %s (%lu)\n", msg, arg);
+    exit(1);
+} /* test_fail */
+
+/* Reference: bit by bit reflected CRC-16 (CRC-16/KERMIT from 0) */
+static uint16_t
+test_crc_ref(uint16_t crc, const uint8_t *p, unsigned int len)
+{
+    unsigned int i, bit;
+
+    for (i = 0U; i < len; i++) {
+        crc ^= p[i];
+        for (bit = 0U; bit < 8U; bit++) {
+            crc = ((crc & 1U) != 0U) ? (uint16_t)((crc >> 1) ^ 0x8408U) : (uint16_t)(crc >> 1);
+        }
+    }
+    return crc;
+} /* test_crc_ref */
+
+#if defined(ZB_TEST_CRC_HW)
+/* Model of the CRC peripheral. The core writes the registers directly: each
+ * evaluation of CRC first applies the effect of the previous writes (a reset
+ * request loads the running CRC with INIT), then updates DR for the output
+ * reversal. The tests check that every register access happens with the
+ * clock on. */
+static CRC_TypeDef test_crc_regs;
+static uint32_t test_crc_state; /* Running CRC, before output reversal */
+static unsigned long test_crc_hw_calls;
+uint32_t zb_test_crc_clk;
+
+static unsigned int
+test_crc_width(void)
+{
+    switch (test_crc_regs.CR & CRC_CR_POLYSIZE) {
+        case 0U:
+            return 32U;
+        case CRC_CR_POLYSIZE_0:
+            return 16U;
+        case CRC_CR_POLYSIZE_1:
+            return 8U;
+        default:
+            test_fail("7 bit CRC not modelled", test_crc_regs.CR);
+            return 0U;
+    }
+} /* test_crc_width */
+
+static uint32_t
+test_crc_reverse(uint32_t value, unsigned int width)
+{
+    uint32_t reversed = 0U;
+    unsigned int i;
+
+    for (i = 0U; i < width; i++) {
+        if ((value & (1UL << i)) != 0U) {
+            reversed |= 1UL << (width - 1U - i);
+        }
+    }
+    return reversed;
+} /* test_crc_reverse */
+
+CRC_TypeDef *
+zb_test_crc_access(void)
+{
+    unsigned int width;
+    uint32_t mask;
+
+    if (zb_test_crc_clk == 0U) {
+        test_fail("CRC access with the clock off", test_crc_regs.CR);
+    }
+    width = test_crc_width();
+    mask = (width == 32U) ? 0xffffffffUL : ((1UL << width) - 1U);
+    if ((test_crc_regs.CR & CRC_CR_RESET) != 0U) {
+        test_crc_regs.CR &= ~CRC_CR_RESET;
+        test_crc_state = test_crc_regs.INIT & mask;
+    }
+    /* The output reversal is done on the polynomial size */
+    test_crc_regs.DR = ((test_crc_regs.CR & CRC_CR_REV_OUT) != 0U)
+        ? test_crc_reverse(test_crc_state, width) : test_crc_state;
+    return &test_crc_regs;
+} /* zb_test_crc_access */
+
+/* One byte written to DR */
+static void
+test_crc_feed(uint8_t byte)
+{
+    unsigned int width, bit;
+    uint32_t top, mask, pol;
+
+    width = test_crc_width();
+    top = 1UL << (width - 1U);
+    mask = (width == 32U) ? 0xffffffffUL : ((1UL << width) - 1U);
+    pol = test_crc_regs.POL & mask;
+    if ((test_crc_regs.CR & CRC_CR_REV_IN) != 0U) {
+        byte = (uint8_t)test_crc_reverse(byte, 8U);
+    }
+    test_crc_state ^= (uint32_t)byte << (width - 8U);
+    for (bit = 0U; bit < 8U; bit++) {
+        test_crc_state = ((test_crc_state & top) != 0U) ? ((test_crc_state << 1) ^ pol) : (test_crc_state << 1);
+        test_crc_state &= mask;
+    }
+} /* test_crc_feed */
+
+/* HAL functions used by zb_crc_hw(), writing the registers as the HAL does */
+HAL_StatusTypeDef
+HAL_CRC_Init(CRC_HandleTypeDef *hcrc)
+{
+    if (hcrc->Instance != &test_crc_regs) {
+        test_fail("CRC instance", 0U);
+    }
+    if (hcrc->Init.DefaultPolynomialUse == DEFAULT_POLYNOMIAL_DISABLE) {
+        CRC->POL = hcrc->Init.GeneratingPolynomial;
+        CRC->CR = (CRC->CR & ~CRC_CR_POLYSIZE) | hcrc->Init.CRCLength;
+    }
+    else {
+        CRC->POL = DEFAULT_CRC32_POLY;
+        CRC->CR = CRC->CR & ~CRC_CR_POLYSIZE;
+    }
+    CRC->INIT = (hcrc->Init.DefaultInitValueUse == DEFAULT_INIT_VALUE_DISABLE) ? hcrc->Init.InitValue : DEFAULT_CRC_INITVALUE;
+    CRC->CR = (CRC->CR & ~CRC_CR_REV_IN) | hcrc->Init.InputDataInversionMode;
+    CRC->CR = (CRC->CR & ~CRC_CR_REV_OUT) | hcrc->Init.OutputDataInversionMode;
+    return HAL_OK;
+} /* HAL_CRC_Init */
+
+uint32_t
+HAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
+{
+    const uint8_t *p = (const uint8_t *)pBuffer;
+    uint32_t i;
+
+    if (hcrc->InputDataFormat != CRC_INPUTDATA_FORMAT_BYTES) {
+        test_fail("CRC input format", hcrc->InputDataFormat);
+    }
+    test_crc_hw_calls++;
+    CRC->CR |= CRC_CR_RESET;
+    (void)CRC;
+    for (i = 0U; i < BufferLength; i++) {
+        test_crc_feed(p[i]);
+    }
+    return CRC->DR;
+} /* HAL_CRC_Calculate */
+
+/* Configuration of an application CRC in progress: CRC-32/MPEG-2 style with
+ * reversed input and output, so that all the saved fields differ from the
+ * 802.15.4 ones */
+static void
+test_crc_app_start(void)
+{
+    zb_test_crc_clk = 1U;
+    CRC->POL = DEFAULT_CRC32_POLY;
+    CRC->INIT = 0xffffffffUL;
+    CRC->CR = CRC_CR_REV_IN_0 | CRC_CR_REV_IN_1 | CRC_CR_REV_OUT | CRC_CR_RESET;
+    CRC->IDR = 0xa5U;
+} /* test_crc_app_start */
+
+static void
+test_crc_app_feed(const uint8_t *p, unsigned int len)
+{
+    unsigned int i;
+
+    (void)CRC;
+    for (i = 0U; i < len; i++) {
+        test_crc_feed(p[i]);
+    }
+} /* test_crc_app_feed */
+
+/* An application CRC computed with the peripheral, with WpanCrc calls in the
+ * middle, gives the same result as without them */
+static void
+test_crc_hw_restore(void)
+{
+    static const uint8_t app_data[] = "An application CRC computed with the peripheral";
+    CRC_TypeDef *regs;
+    uint32_t expected, cr;
+    unsigned int i, half = sizeof(app_data) / 2U;
+    bool clk_on;
+
+    test_crc_app_start();
+    test_crc_app_feed(app_data, sizeof(app_data));
+    expected = CRC->DR;
+
+    for (i = 0U; i < 100U; i++) {
+        test_crc_app_start();
+        test_crc_app_feed(app_data, half);
+        cr = test_crc_regs.CR;
+        clk_on = (i % 2U) == 0U;
+        zb_test_crc_clk = clk_on ? 1U : 0U;
+
+        (void)WpanCrc((uint16_t)i, test_buf, ZB_CRC_HW_MIN_LEN + i);
+
+        if (zb_test_crc_clk != (clk_on ? 1U : 0U)) {
+            test_fail("CRC clock not restored", i);
+        }
+        zb_test_crc_clk = 1U;
+        regs = CRC;
+        if ((regs->CR != cr) || (regs->INIT != 0xffffffffUL) || (regs->POL != DEFAULT_CRC32_POLY)
+            || (regs->IDR != 0xa5U)) {
+            test_fail("CRC registers not restored", regs->CR);
+        }
+        test_crc_app_feed(&app_data[half], sizeof(app_data) - half);
+        if (CRC->DR != expected) {
+            test_fail("application CRC broken", i);
+        }
+    }
+} /* test_crc_hw_restore */
+#endif
+
+static void
+test_crc_random(void)
+{
+    unsigned long it;
+    unsigned int offset, len, split;
+    uint16_t crc, expected;
+
+    for (it = 0; it < TEST_ITERATIONS; it++) {
+        /* Unaligned buffers, on both sides of ZB_CRC_HW_MIN_LEN and of the
+         * 8 byte steps */
+        offset = (unsigned int)rand() % 8U;
+        len = ((it % 4U) == 0U) ? ((unsigned int)rand() % (TEST_BUF_SIZE - offset))
+            : ((unsigned int)rand() % 40U);
+        crc = (uint16_t)rand();
+        expected = test_crc_ref(crc, &test_buf[offset], len);
+        if (WpanCrc(crc, &test_buf[offset], len) != expected) {
+            test_fail("CRC, bytes", len);
+        }
+        /* Computed in two parts */
+        split = (len == 0U) ? 0U : ((unsigned int)rand() % len);
+        crc = WpanCrc(crc, &test_buf[offset], split);
+        if (WpanCrc(crc, &test_buf[offset + split], len - split) != expected) {
+            test_fail("CRC in two parts, bytes", len);
+        }
+    }
+} /* test_crc_random */
+
+int
+main(void)
+{
+    static const uint8_t check[] = "123456789";
+    unsigned int i;
+
+    srand(1);
+    for (i = 0U; i < TEST_BUF_SIZE; i++) {
+        test_buf[i] = (uint8_t)rand();
+    }
+    if ((test_crc_ref(0U, check, 9U) != 0x2189U) || (WpanCrc(0U, check, 9U) != 0x2189U)) {
+        test_fail("CRC-16/KERMIT check value", WpanCrc(0U, check, 9U));
+    }
+    test_crc_random();
+#if defined(ZB_TEST_CRC_HW)
+    if (test_crc_hw_calls == 0U) {
+        test_fail("CRC peripheral not used", 0U);
+    }
+    test_crc_hw_restore();
+    printf("PASS: WpanCrc, CRC peripheral\n");
+#elif defined(ZB_CRC_SLICE_BY_8)
+    printf("PASS: WpanCrc, slicing-by-8\n");
+#else
+    printf("PASS: WpanCrc, byte-wise\n");
+#endif
+    return 0;
+} /* main */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,169 @@
+/**
+ ******************************************************************************
+ * @file    zb_hash_test.c
+ * @author  MCD Application Team
+ * @brief   Host test of the AES-128 and AES-MMO hash of zigbee_core_wb.c,
+ *          with known-answer vectors.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+/* The core is built in this file, so that its static AES is reachable */
+#include "../../core/src/zigbee_core_wb.c"
+
+#define TEST_MSG_MAX                        10000U
+
+struct test_aes_vector {
+    const char *key;
+    const char *in;
+    const char *out;
+};
+
+struct test_mmo_vector {
+    unsigned int len; /* Message of bytes (i mod 256), or the message below */
+    const char *msg;
+    const char *hash;
+};
+
+/* FIPS-197, appendix B and appendix C.1 */
+static const struct test_aes_vector test_aes_vectors[] = {
+    { "2b7e151628aed2a6abf7158809cf4f3c", "3243f6a8885a308d313198a2e0370734", "3925841d02dc09fbdc118597196a0b32" },
+    { "000102030405060708090a0b0c0d0e0f", "00112233445566778899aabbccddeeff", "69c4e0d86a7b0430d8cdb78070b4c55a" },
+};
+
+/* Zigbee specification, section C.6.1 for the first two. The others cross the
+ * padding boundaries: 13 to 15 bytes leave no room for the 16 bit length in
+ * the last block, 8191 bytes is the longest message with a 16 bit length,
+ * and 8192 bytes the shortest with a 32 bit length. */
+static const struct test_mmo_vector test_mmo_vectors[] = {
+    { 1U, "c0", "ae3a102a28d43ee0d4a09e22788b206c" },
+    { 16U, "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf", "a7977e88bc0b61e8210827109a228f2d" },
+    { 13U, NULL, "3ef02c344cb836f76abcfacdc80c5ed4" },
+    { 14U, NULL, "d2d987af392a74aa2350be20253b9e18" },
+    { 15U, NULL, "f688be4220fb747774fadf5f71cc0db2" },
+    { 8191U, NULL, "24ec2fe75bbffcb34789bc0610e7f165" },
+    { 8192U, NULL, "dc6b0687f09f8607131c170b3bd31591" },
+    { 8193U, NULL, "21fecadecd1af7c33ae5be9c3a584bb5" },
+    { 10000U, NULL, "385859b05c8a71222c623f974155e075" },
+};
+
+static uint8_t test_msg[TEST_MSG_MAX];
+
+static void
+test_fail(const char *msg, unsigned long arg)
+{
+    printf("FAIL: %s (%lu)\n", msg, arg);
+    exit(1);
+} /* test_fail */
+
+static void
+test_hex(const char *hex, uint8_t *out, unsigned int len)
+{
+    unsigned int i, byte;
+
+    for (i = 0U; i < len; i++) {
+        if (sscanf(&hex[2U * i], "%2x", &byte) != 1) {
+            test_fail("bad vector", i);
+        }
+        out[i] = (uint8_t)byte;
+    }
+} /* test_hex */
+
+static void
+test_aes(void)
+{
+    uint8_t key[AES_BLOCK_SIZE], in[AES_BLOCK_SIZE], out[AES_BLOCK_SIZE], expected[AES_BLOCK_SIZE];
+    unsigned int i;
+
+    for (i = 0U; i < (sizeof(test_aes_vectors) / sizeof(test_aes_vectors[0])); i++) {
+        test_hex(test_aes_vectors[i].key, key, AES_BLOCK_SIZE);
+        test_hex(test_aes_vectors[i].in, in, AES_BLOCK_SIZE);
+        test_hex(test_aes_vectors[i].out, expected, AES_BLOCK_SIZE);
+        zb_aes_encrypt(key, in, out);
+        if (memcmp(out, expected, AES_BLOCK_SIZE) != 0) {
+            test_fail("AES-128 vector", i);
+        }
+        /* Output over the input */
+        zb_aes_encrypt(key, in, in);
+        if (memcmp(in, expected, AES_BLOCK_SIZE) != 0) {
+            test_fail("AES-128 vector in place", i);
+        }
+    }
+} /* test_aes */
+
+static void
+test_mmo(void)
+{
+    const struct test_mmo_vector *vector;
+    struct ZbHash hash;
+    uint8_t digest[AES_BLOCK_SIZE], expected[AES_BLOCK_SIZE];
+    unsigned int i, offset, chunk;
+
+    for (i = 0U; i < (sizeof(test_mmo_vectors) / sizeof(test_mmo_vectors[0])); i++) {
+        vector = &test_mmo_vectors[i];
+        if (vector->msg != NULL) {
+            test_hex(vector->msg, test_msg, vector->len);
+        }
+        else {
+            for (offset = 0U; offset < vector->len; offset++) {
+                test_msg[offset] = (uint8_t)offset;
+            }
+        }
+        test_hex(vector->hash, expected, AES_BLOCK_SIZE);
+
+        ZbAesMmoHash(test_msg, vector->len, digest);
+        if (memcmp(digest, expected, AES_BLOCK_SIZE) != 0) {
+            test_fail("AES-MMO vector, bytes", vector->len);
+        }
+
+        /* Same hash when added in random chunks and single bytes */
+        ZbHashInit(&hash);
+        for (offset = 0U; offset < vector->len; offset += chunk) {
+            chunk = 1U + ((unsigned int)rand() % 40U);
+            if (chunk > (vector->len - offset)) {
+                chunk = vector->len - offset;
+            }
+            if (chunk == 1U) {
+                ZbHashByte(&hash, test_msg[offset]);
+            }
+            else {
+                ZbHashAdd(&hash, &test_msg[offset], chunk);
+            }
+        }
+        if (hash.length != vector->len) {
+            test_fail("hashed length", hash.length);
+        }
+        ZbHashDigest(&hash, digest);
+        if (memcmp(digest, expected, AES_BLOCK_SIZE) != 0) {
+            test_fail("AES-MMO vector in chunks, bytes", vector->len);
+        }
+    }
+} /* test_mmo */
+
+int
+main(void)
+{
+    struct ZbHash hash;
+
+    /* The padding needs the length of messages of 2^16 bits and more */
+    if (sizeof(hash.length) < sizeof(uint32_t)) {
+        test_fail("struct ZbHash length size", sizeof(hash.length));
+    }
+    srand(1);
+    test_aes();
+    test_mmo();
+    printf("PASS: AES-128 and AES-MMO vectors\n");
+    return 0;
+} /* main */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,142 @@
+/**
+ ******************************************************************************
+ * @file    zb_test_stub.c
+ * @author  MCD Application Team
+ * @brief   Application and M0 side of the host tests of zigbee_core_wb.c:
+ *          the IPCC buffers, with the M0 replaced by a function call.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "zb_test_stub.h"
+#include "zigbee_interface.h"
+#include "tl_zigbee_hci.h"
+
+/* Objects on the stack are at most this far above the frame of the M0 */
+#define ZB_TEST_STACK_RANGE                 (1024U * 1024U)
+
+struct cli_app;
+
+void (*zb_test_m0_cmd)(const Zigbee_Cmd_Request_t *req, Zigbee_Cmd_Request_t *rsp);
+
+static Zigbee_Cmd_Request_t zb_test_cmd_buffer;
+static Zigbee_Cmd_Request_t zb_test_rsp_buffer;
+static Zigbee_Cmd_Request_t zb_test_notif_buffer;
+static Zigbee_Cmd_Request_t zb_test_logging_buffer;
+
+void *
+zb_test_ptr(uint32_t value)
+{
+    uintptr_t frame = (uintptr_t)__builtin_frame_address(0);
+    uint32_t offset;
+
+    /* Offset from this frame, modulo 2^32: small for the stack of the callers */
+    offset = value - (uint32_t)frame;
+    if (offset < ZB_TEST_STACK_RANGE) {
+        return (void *)(frame + offset);
+    }
+    return (void *)(uintptr_t)value;
+} /* zb_test_ptr */
+
+uint32_t
+HAL_GetTick(void)
+{
+    return 0U;
+} /* HAL_GetTick */
+
+void
+Pre_ZigbeeCmdProcessing(void)
+{
+} /* Pre_ZigbeeCmdProcessing */
+
+void
+ZIGBEE_CmdTransfer(void)
+{
+    (void)memset(&zb_test_rsp_buffer, 0, sizeof(zb_test_rsp_buffer));
+    zb_test_rsp_buffer.Size = 1U;
+    if (zb_test_m0_cmd != NULL) {
+        zb_test_m0_cmd(&zb_test_cmd_buffer, &zb_test_rsp_buffer);
+    }
+} /* ZIGBEE_CmdTransfer */
+
+Zigbee_Cmd_Request_t *
+ZIGBEE_Get_OTCmdPayloadBuffer(void)
+{
+    return &zb_test_cmd_buffer;
+} /* ZIGBEE_Get_OTCmdPayloadBuffer */
+
+Zigbee_Cmd_Request_t *
+ZIGBEE_Get_OTCmdRspPayloadBuffer(void)
+{
+    return &zb_test_rsp_buffer;
+} /* ZIGBEE_Get_OTCmdRspPayloadBuffer */
+
+Zigbee_Cmd_Request_t *
+ZIGBEE_Get_NotificationPayloadBuffer(void)
+{
+    return &zb_test_notif_buffer;
+} /* ZIGBEE_Get_NotificationPayloadBuffer */
+
+Zigbee_Cmd_Request_t *
+ZIGBEE_Get_LoggingPayloadBuffer(void)
+{
+    return &zb_test_logging_buffer;
+} /* ZIGBEE_Get_LoggingPayloadBuffer */
+
+void
+TL_ZIGBEE_SendAckAfterAppliNotifFromM0(void)
+{
+} /* TL_ZIGBEE_SendAckAfterAppliNotifFromM0 */
+
+void
+TL_ZIGBEE_SendAckAfterAppliLoggingFromM0(void)
+{
+} /* TL_ZIGBEE_SendAckAfterAppliLoggingFromM0 */
+
+void
+ZIGBEE_TimerStart(uint32_t timeout_ms)
+{
+    (void)timeout_ms;
+} /* ZIGBEE_TimerStart */
+
+void
+ZIGBEE_TimerStop(void)
+{
+} /* ZIGBEE_TimerStop */
+
+void
+cli_port_print_msg(struct cli_app *cli_p, const char *msg)
+{
+    (void)cli_p;
+    (void)printf("%s", msg);
+} /* cli_port_print_msg */
+
+int
+zcl_cluster_data_ind(ZbApsdeDataIndT *dataIndPtr, void *arg)
+{
+    (void)dataIndPtr;
+    (void)arg;
+    return ZB_APS_FILTER_CONTINUE;
+} /* zcl_cluster_data_ind */
+
+int
+zcl_cluster_alarm_data_ind(ZbApsdeDataIndT *data_ind, void *arg)
+{
+    (void)data_ind;
+    (void)arg;
+    return ZB_APS_FILTER_CONTINUE;
+} /* zcl_cluster_alarm_data_ind */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,37 @@
+/**
+ ******************************************************************************
+ * @file    zb_test_stub.h
+ * @author  MCD Application Team
+ * @brief   Application and M0 side of the host tests of zigbee_core_wb.c
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#ifndef ZB_TEST_STUB_H
+#define ZB_TEST_STUB_H
+
+#include <stdint.h>
+#include "stm32wbxx_core_interface_def.h"
+
+/* Called by ZIGBEE_CmdTransfer() in place of the M0. The answer is written to
+ * rsp. Without a handler, the commands return 0. */
+extern void (*zb_test_m0_cmd)(const Zigbee_Cmd_Request_t *req, Zigbee_Cmd_Request_t *rsp);
+
+/* The core passes the pointers to the M0 on 32 bits. Returns the host pointer
+ * for such a value: an object on the stack of the caller, or a static object
+ * (the tests are linked without PIE). */
+void * zb_test_ptr(uint32_t value);
+
+#endif /* ZB_TEST_STUB_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
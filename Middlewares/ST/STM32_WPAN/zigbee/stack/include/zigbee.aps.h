@@ -468,6 +468,14 @@ bool ZbApsEndpointExists(struct ZigBeeT *zb, uint8_t endpoint);
 /* Get the Profile ID for this endpoint */
 uint16_t ZbApsEndpointProfile(struct ZigBeeT *zb, uint8_t endpoint);
 
+/* The M4 caches the group table and the endpoints, so that ZbApsGroupIsMember,
+ * ZbApsGroupsGetMembership, ZbApsEndpointExists and ZbApsEndpointProfile don't
+ * query the stack. ZbApsCacheBypass(zb, true) flushes the cache and sends every
+ * request to the stack. ZbApsCacheCheck compares the cache with the stack and
+ * returns false on a mismatch (debug only, it costs the requests the cache saves). */
+void ZbApsCacheBypass(struct ZigBeeT *zb, bool bypass);
+bool ZbApsCacheCheck(struct ZigBeeT *zb);
+
 /*---------------------------------------------------------------
  * APSME - Security
  *---------------------------------------------------------------
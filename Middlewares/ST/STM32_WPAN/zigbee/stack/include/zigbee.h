@@ -544,7 +544,7 @@ struct ZbHash {
     uint8_t m[AES_BLOCK_SIZE];
     uint8_t hash[AES_BLOCK_SIZE];
     uint8_t key[AES_BLOCK_SIZE];
-    uint8_t length;
+    uint32_t length; /* Number of bytes hashed */
 };
 
 /* Matyas-Meyer-Oseas hash function. */
@@ -603,11 +603,24 @@ uint16_t ZbShortAddress(struct ZigBeeT *zb);
 /* Total memory allocated from the heap. */
 unsigned int ZbMallocTotalSz(void);
 
-/* Memory allocated from the internal ZigBee heap. */
+/* Memory allocated from the internal ZigBee heap, slab blocks and malloc
+ * fallback blocks included. */
 unsigned long ZbHeapUsed(struct ZigBeeT *zb);
 
+/* Peak of ZbHeapUsed. */
 unsigned long ZbHeapHighWaterMark(struct ZigBeeT *zb);
 
+/* Usage of one of the fixed-size block classes backing the heap. Returns false
+ * if class_idx is past the last class. */
+struct ZbHeapSlabStatsT {
+    unsigned int block_size;
+    unsigned int block_nbr;
+    unsigned int in_use;
+    unsigned int high_water;
+    unsigned int fail;
+};
+bool ZbHeapSlabStats(unsigned int class_idx, struct ZbHeapSlabStatsT *stats);
+
 /*
  * Dumps outstanding memory allocation information.
  * If printfCb is NULL, output is sent to log output provided by
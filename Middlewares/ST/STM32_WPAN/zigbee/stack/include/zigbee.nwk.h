@@ -772,6 +772,11 @@ uint16_t ZbNwkAddrLookupNwk(struct ZigBeeT *zb, uint64_t extAddr);
  * if known, otherwise returns 0. */
 uint64_t ZbNwkAddrLookupExt(struct ZigBeeT *zb, uint16_t nwkAddr);
 
+/* The M4 caches the translations returned by ZbNwkAddrLookupNwk and ZbNwkAddrLookupExt.
+ * ZbNwkAddrCacheBypass(zb, true) flushes the cache and sends every lookup to the stack. */
+void ZbNwkAddrCacheBypass(struct ZigBeeT *zb, bool bypass);
+void ZbNwkAddrCacheStats(struct ZigBeeT *zb, uint32_t *hits, uint32_t *misses);
+
 bool ZbNwkGetSecMaterial(struct ZigBeeT *zb, uint8_t keySeqno, ZbNwkSecMaterialT *material);
 bool ZbNwkSetFrameCounter(struct ZigBeeT *zb, uint8_t keySeqno, uint64_t srcAddr, uint32_t newFrameCount);
 bool ZbNwkGetActiveKey(struct ZigBeeT *zb, ZbNwkSecMaterialT *active_key);
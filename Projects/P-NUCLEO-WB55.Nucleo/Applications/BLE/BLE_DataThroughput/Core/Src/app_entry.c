@@ -260,6 +260,16 @@ void UTIL_SEQ_Idle( void )
   return;
 }
 
+void UTIL_SEQ_PreIdle( void )
+{
+  /**
+   * Send back to the CPU2 the event buffers released below CFG_TL_MM_EVT_RELEASE_HWM
+   */
+  TL_MM_EvtFlush( );
+
+  return;
+}
+
 void UTIL_SEQ_EvtIdle( UTIL_SEQ_bm_t task_id_bm, UTIL_SEQ_bm_t evt_waited_bm )
 {
   UTIL_SEQ_Run( UTIL_SEQ_DEFAULT );
@@ -0,0 +1,38 @@
+/**
+ ******************************************************************************
+ * @file    ts_list.c
+ * @author  MCD Application Team
+ * @brief   Timer server before the timer wheel, built over the model of
+ *          ts_test.c. Its public functions are renamed.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#define HW_TS_Init                        RefTS_Init
+#define HW_TS_Create                      RefTS_Create
+#define HW_TS_Stop                        RefTS_Stop
+#define HW_TS_Start                       RefTS_Start
+#define HW_TS_Delete                      RefTS_Delete
+#define HW_TS_RTC_Wakeup_Handler          RefTS_RTC_Wakeup_Handler
+#define HW_TS_RTC_ReadLeftTicksToCount    RefTS_RTC_ReadLeftTicksToCount
+
+#define TS_TEST_SERVER
+#include "ts_test.h"
+#include "hw_timerserver_ref.c"
+
+const ts_test_server_t ts_test_list = {
+  "list", HW_TS_Init, HW_TS_Create, HW_TS_Stop, HW_TS_Start, HW_TS_Delete, HW_TS_RTC_Wakeup_Handler,
+  HW_TS_RTC_ReadLeftTicksToCount
+};
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,785 @@
+/**
+ ******************************************************************************
+ * @file    ts_test.c
+ * @author  MCD Application Team
+ * @brief   Timer server host test: random traces of timer creations, starts,
+ *          stops and deletions, with restarts from the timer callbacks, are
+ *          replayed on the timer wheel of the applications and on the sorted
+ *          list it replaced, over a model of the RTC wakeup timer. Each
+ *          expiry is checked against the time the timer was started for.
+ *          make test : replay test
+ *          make bench: CPU time per call and wakeups of each timer server
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#include <stdbool.h>
+#include <time.h>
+#include "ts_test.h"
+
+/* A wakeup timer tick is a tick of the RTC subsecond register */
+#if ((CFG_RTC_ASYNCH_PRESCALER + 1) != (16 >> CFG_RTC_WUCKSEL_DIVIDER))
+#error "The model requires the subsecond register to count at the wakeup timer clock"
+#endif
+
+#define TEST_OPS                            50000UL
+#define TEST_LATENCY_MAX                    3U        /* Ticks before the wakeup interrupt is taken */
+#define TEST_NO_TIME                        0xFFFFFFFFFFFFFFFFULL
+#define TEST_RTC_WPR_UNLOCKED               0x53U
+#define TEST_RTC_WPR_LOCKED                 0xFFU
+
+typedef struct
+{
+  const char *name;
+  uint32_t    timeout_bits;       /* Timeouts up to 2^timeout_bits - 1 ticks */
+  uint32_t    gap_bits;           /* Ticks between two operations up to 2^gap_bits - 1 */
+  uint32_t    repeated_percent;   /* Timers created in repeated mode */
+  uint32_t    restart_percent;    /* Single shot timers restarted from their callback */
+} test_profile_t;
+
+static const test_profile_t test_profiles[] = {
+  { "application",              20U, 14U, 30U, 30U },
+  { "short timeouts",            7U,  6U, 20U, 50U },
+  { "long timeouts",            27U, 20U, 10U, 10U },
+  { "restarts from callbacks",  10U, 10U,  0U, 90U },
+};
+
+/* Model of a timer */
+typedef struct
+{
+  bool         created;
+  bool         running;
+  HW_TS_Mode_t mode;
+  uint32_t     process_id;
+  uint32_t     timeout;
+  uint64_t     expiry;           /* Earliest time of the expiry */
+  uint32_t     expiry_count;
+} test_timer_t;
+
+/* Expiry reported */
+typedef struct
+{
+  uint64_t time;
+  uint8_t  timer_id;
+} test_expiry_t;
+
+typedef struct
+{
+  unsigned long expiries;
+  unsigned long interrupts;
+  uint64_t      lateness;        /* Sum of the ticks from the expiry time to the report */
+  uint64_t      lateness_max;
+  double        start_ns, stop_ns, interrupt_ns;
+  unsigned long starts, stops;
+} test_stats_t;
+
+/* Model of the RTC, of the EXTI and of the Cortex */
+RTC_TypeDef ts_test_rtc;
+EXTI_TypeDef ts_test_exti;
+uint32_t ts_test_primask;
+static RTC_HandleTypeDef test_hrtc = { .Instance = &ts_test_rtc };
+static uint64_t test_time;
+static uint32_t test_ssr_offset;
+static uint64_t test_wut_next;
+static uint32_t test_wut_period;
+static bool test_irq_enabled, test_irq_pending, test_in_isr;
+static uint64_t test_irq_time;
+static uint32_t test_latency_max;
+static uint64_t test_latency_rng;
+
+/* Replay */
+static const ts_test_server_t *test_server;
+static const test_profile_t *test_profile;
+static test_timer_t test_timers[TS_TEST_TIMER_NBR];
+static uint64_t test_rng, test_seed;
+static bool test_draining, test_bench;
+static uint64_t test_tolerance;
+static test_stats_t *test_stats;
+static test_expiry_t *test_log;
+static size_t test_log_count, test_log_size;
+static unsigned long test_count_updated;
+
+static void test_fail(const char *msg, unsigned long arg)
+{
+  printf("FAIL: %s (%lu), %s timer server, %s, latency %u, seed %llu, time %llu\n", msg, arg,
+         (test_server != NULL) ? test_server->name : "no", (test_profile != NULL) ? test_profile->name : "no trace",
+         test_latency_max, (unsigned long long)test_seed, (unsigned long long)test_time);
+  exit(1);
+}
+
+static uint64_t test_random(uint64_t *state)
+{
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return *state * 2685821657736338717ULL;
+}
+
+/* Between 0 and 2^bits - 1, each number of bits being as likely */
+static uint32_t test_random_bits(uint64_t *state, uint32_t bits)
+{
+  uint32_t n = (uint32_t)(test_random(state) % (bits + 1U));
+
+  return (n == 0U) ? 0U : (uint32_t)(test_random(state) & (0xFFFFFFFFU >> (32U - n)));
+}
+
+static double test_clock(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
+
+/* Model ----------------------------------------------------------------------*/
+
+static void test_set_time(uint64_t time)
+{
+  test_time = time;
+  ts_test_rtc.SSR = CFG_RTC_SYNCH_PRESCALER -
+                    (uint32_t)((time + test_ssr_offset) % (CFG_RTC_SYNCH_PRESCALER + 1U));
+}
+
+void ts_test_wakeup_timer_enable(void)
+{
+  if (ts_test_rtc.WPR != TEST_RTC_WPR_UNLOCKED)
+  {
+    test_fail("wakeup timer enabled with the RTC write protected", ts_test_rtc.WPR);
+  }
+  if ((ts_test_rtc.CR & RTC_CR_WUTE) == 0U)
+  {
+    /* The wakeup flag is set after WUT + 1 ticks, then on each auto-reload */
+    ts_test_rtc.CR |= RTC_CR_WUTE;
+    ts_test_rtc.ISR &= ~RTC_ISR_WUTWF;
+    test_wut_period = (ts_test_rtc.WUTR & RTC_WUTR_WUT) + 1U;
+    test_wut_next = test_time + test_wut_period;
+  }
+}
+
+void ts_test_wakeup_timer_disable(void)
+{
+  if (ts_test_rtc.WPR != TEST_RTC_WPR_UNLOCKED)
+  {
+    test_fail("wakeup timer disabled with the RTC write protected", ts_test_rtc.WPR);
+  }
+  ts_test_rtc.CR &= ~RTC_CR_WUTE;
+  ts_test_rtc.ISR |= RTC_ISR_WUTWF;
+}
+
+void ts_test_rtc_clear_flag(uint32_t Flag)
+{
+  ts_test_rtc.ISR &= ~Flag;
+}
+
+/* RBIT is a single instruction on the Cortex-M4 */
+uint32_t ts_test_rbit(uint32_t Value)
+{
+  Value = ((Value >> 1) & 0x55555555U) | ((Value & 0x55555555U) << 1);
+  Value = ((Value >> 2) & 0x33333333U) | ((Value & 0x33333333U) << 2);
+  Value = ((Value >> 4) & 0x0F0F0F0FU) | ((Value & 0x0F0F0F0FU) << 4);
+  return __builtin_bswap32(Value);
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+  (void)PreemptPriority;
+  (void)SubPriority;
+  if (IRQn != RTC_WKUP_IRQn)
+  {
+    test_fail("priority of another interrupt", (unsigned long)IRQn);
+  }
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+  if (IRQn != RTC_WKUP_IRQn)
+  {
+    test_fail("another interrupt enabled", (unsigned long)IRQn);
+  }
+  test_irq_enabled = true;
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+  if (IRQn != RTC_WKUP_IRQn)
+  {
+    test_fail("another interrupt disabled", (unsigned long)IRQn);
+  }
+  test_irq_enabled = false;
+}
+
+void HAL_NVIC_SetPendingIRQ(IRQn_Type IRQn)
+{
+  if (IRQn != RTC_WKUP_IRQn)
+  {
+    test_fail("another interrupt set pending", (unsigned long)IRQn);
+  }
+  if (!test_irq_pending)
+  {
+    test_irq_pending = true;
+    test_irq_time = test_time + (test_random(&test_latency_rng) % (test_latency_max + 1U));
+  }
+}
+
+void HAL_NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+  if (IRQn != RTC_WKUP_IRQn)
+  {
+    test_fail("another interrupt cleared", (unsigned long)IRQn);
+  }
+  test_irq_pending = false;
+}
+
+void HW_TS_RTC_CountUpdated_AppNot(void)
+{
+  test_count_updated++;
+}
+
+/* The wakeup flag is set, and goes through the EXTI line to the NVIC */
+static void test_wakeup_event(void)
+{
+  ts_test_rtc.ISR |= RTC_ISR_WUTF;
+  test_wut_next += test_wut_period;
+  if (((ts_test_rtc.CR & RTC_CR_WUTIE) != 0U) &&
+      ((ts_test_exti.IMR1 & ts_test_exti.RTSR1 & RTC_EXTI_LINE_WAKEUPTIMER_EVENT) != 0U))
+  {
+    ts_test_exti.PR1 |= RTC_EXTI_LINE_WAKEUPTIMER_EVENT;
+    HAL_NVIC_SetPendingIRQ(RTC_WKUP_IRQn);
+  }
+}
+
+static void test_interrupt(void)
+{
+  double start = test_bench ? test_clock() : 0.0;
+
+  test_irq_pending = false;
+  test_in_isr = true;
+  test_server->Wakeup_Handler();
+  test_in_isr = false;
+  test_stats->interrupts++;
+  if (test_bench)
+  {
+    test_stats->interrupt_ns += test_clock() - start;
+  }
+  if (ts_test_primask != 0U)
+  {
+    test_fail("PRIMASK not restored by the wakeup handler", ts_test_primask);
+  }
+}
+
+/* Replay ---------------------------------------------------------------------*/
+
+static void test_timer_callback(void)
+{
+}
+
+static void test_check_missed(void)
+{
+  uint32_t i;
+
+  for (i = 0U; i < TS_TEST_TIMER_NBR; i++)
+  {
+    if (test_timers[i].running && (test_time > (test_timers[i].expiry + test_tolerance)))
+    {
+      test_fail("timer not reported", i);
+    }
+  }
+}
+
+/* The interrupt is taken when enabled, out of any critical section */
+static void test_advance(uint64_t time)
+{
+  uint64_t next;
+
+  for (;;)
+  {
+    next = ((ts_test_rtc.CR & RTC_CR_WUTE) != 0U) ? test_wut_next : TEST_NO_TIME;
+    if (test_irq_pending && test_irq_enabled && (test_irq_time < next))
+    {
+      next = test_irq_time;
+    }
+    if (next > time)
+    {
+      break;
+    }
+    if (next > test_time)
+    {
+      test_set_time(next);
+    }
+    if (((ts_test_rtc.CR & RTC_CR_WUTE) != 0U) && (test_wut_next <= test_time))
+    {
+      test_wakeup_event();
+    }
+    else
+    {
+      test_interrupt();
+    }
+    test_check_missed();
+  }
+  test_set_time(time);
+  test_check_missed();
+}
+
+/* After each call from the application, nothing is left masked or unlocked */
+static void test_check_state(void)
+{
+  if (ts_test_primask != 0U)
+  {
+    test_fail("PRIMASK not restored", ts_test_primask);
+  }
+  if (!test_irq_enabled)
+  {
+    test_fail("wakeup interrupt left disabled", 0U);
+  }
+  if (ts_test_rtc.WPR != TEST_RTC_WPR_LOCKED)
+  {
+    test_fail("RTC left unprotected", ts_test_rtc.WPR);
+  }
+}
+
+static void test_start(uint8_t timer_id, uint32_t timeout)
+{
+  test_timer_t *timer = &test_timers[timer_id];
+  double start = test_bench ? test_clock() : 0.0;
+
+  test_server->Start(timer_id, timeout);
+  if (test_bench)
+  {
+    test_stats->start_ns += test_clock() - start;
+  }
+  test_stats->starts++;
+  timer->running = true;
+  timer->timeout = timeout;
+  timer->expiry = test_time + timeout;
+}
+
+static void test_stop(uint8_t timer_id)
+{
+  double start = test_bench ? test_clock() : 0.0;
+
+  test_server->Stop(timer_id);
+  if (test_bench)
+  {
+    test_stats->stop_ns += test_clock() - start;
+  }
+  test_stats->stops++;
+  test_timers[timer_id].running = false;
+}
+
+static uint32_t test_timeout(uint64_t *state, HW_TS_Mode_t mode)
+{
+  uint32_t timeout = test_random_bits(state, test_profile->timeout_bits);
+
+  /* The repeated timers do not expire more often than the square root of the longest timeout */
+  return (mode == hw_ts_Repeated) ? (timeout | (1UL << (test_profile->timeout_bits / 2U))) : timeout;
+}
+
+static void test_create(void)
+{
+  test_timer_t *timer;
+  uint8_t timer_id = TS_TEST_TIMER_NBR;
+  HW_TS_Mode_t mode;
+  uint32_t process_id;
+
+  mode = ((test_random(&test_rng) % 100U) < test_profile->repeated_percent) ? hw_ts_Repeated : hw_ts_SingleShot;
+  process_id = (uint32_t)test_random(&test_rng);
+  if ((test_server->Create(process_id, &timer_id, mode, test_timer_callback) != hw_ts_Successful) ||
+      (timer_id >= TS_TEST_TIMER_NBR) || test_timers[timer_id].created)
+  {
+    test_fail("timer not created", timer_id);
+  }
+  timer = &test_timers[timer_id];
+  timer->created = true;
+  timer->running = false;
+  timer->mode = mode;
+  timer->process_id = process_id;
+}
+
+/* Notification of the timer server, in the wakeup interrupt */
+void HW_TS_RTC_Int_AppNot(uint32_t TimerProcessID, uint8_t TimerID, HW_TS_pTimerCb_t pTimerCallBack)
+{
+  test_timer_t *timer;
+  test_expiry_t *expiry;
+  uint64_t lateness;
+  uint64_t state;
+
+  if (!test_in_isr)
+  {
+    test_fail("timer reported out of the wakeup interrupt", TimerID);
+  }
+  if (TimerID >= TS_TEST_TIMER_NBR)
+  {
+    test_fail("unknown timer reported", TimerID);
+  }
+  timer = &test_timers[TimerID];
+  if (!timer->created || !timer->running)
+  {
+    test_fail("timer not running reported", TimerID);
+  }
+  if ((TimerProcessID != timer->process_id) || (pTimerCallBack != test_timer_callback))
+  {
+    test_fail("timer reported with the context of another one", TimerID);
+  }
+  if (test_time < timer->expiry)
+  {
+    test_fail("timer reported early", (unsigned long)(timer->expiry - test_time));
+  }
+  lateness = test_time - timer->expiry;
+  if (lateness > test_tolerance)
+  {
+    test_fail("timer reported late", (unsigned long)lateness);
+  }
+  test_stats->expiries++;
+  test_stats->lateness += lateness;
+  if (lateness > test_stats->lateness_max)
+  {
+    test_stats->lateness_max = lateness;
+  }
+
+  if (test_log_count == test_log_size)
+  {
+    test_log_size = (test_log_size == 0U) ? 0x10000U : (test_log_size * 2U);
+    test_log = realloc(test_log, test_log_size * sizeof(test_expiry_t));
+    if (test_log == NULL)
+    {
+      test_fail("no memory", 0U);
+    }
+  }
+  expiry = &test_log[test_log_count++];
+  expiry->time = test_time;
+  expiry->timer_id = TimerID;
+
+  if (timer->mode == hw_ts_Repeated)
+  {
+    timer->expiry = test_time + timer->timeout;
+  }
+  else
+  {
+    timer->running = false;
+  }
+  pTimerCallBack();
+
+  /* The decision only depends on the timer and its number of expiries, so that both timer servers replay the
+   * same trace whatever the order they report the timers expiring at the same time */
+  state = test_seed ^ ((uint64_t)TimerID << 56) ^ ((uint64_t)timer->expiry_count << 24) ^ 0x9E3779B97F4A7C15ULL;
+  timer->expiry_count++;
+  if ((timer->mode == hw_ts_SingleShot) && !test_draining &&
+      ((test_random(&state) % 100U) < test_profile->restart_percent))
+  {
+    test_start(TimerID, test_timeout(&state, hw_ts_SingleShot));
+  }
+}
+
+/* The wakeup timer shall not expire after the next timer, unless the interrupt is pending */
+static void test_check_left_ticks(void)
+{
+  uint16_t left = test_server->ReadLeftTicksToCount();
+  uint64_t expiry = TEST_NO_TIME;
+  uint32_t i;
+
+  for (i = 0U; i < TS_TEST_TIMER_NBR; i++)
+  {
+    if (test_timers[i].running && (test_timers[i].expiry < expiry))
+    {
+      expiry = test_timers[i].expiry;
+    }
+  }
+  if (test_irq_pending)
+  {
+    /* The interrupt is about to be taken */
+  }
+  else if (left == 0xFFFFU)
+  {
+    if (expiry != TEST_NO_TIME)
+    {
+      test_fail("no tick left to count with timers running", (unsigned long)(expiry - test_time));
+    }
+  }
+  else if ((test_time + left) > expiry)
+  {
+    test_fail("ticks left to count beyond the next expiry", left);
+  }
+}
+
+static void test_init(const ts_test_server_t *server, const test_profile_t *profile, uint32_t latency_max,
+                      uint64_t seed, test_stats_t *stats)
+{
+  memset(&ts_test_rtc, 0, sizeof(ts_test_rtc));
+  memset(&ts_test_exti, 0, sizeof(ts_test_exti));
+  memset(test_timers, 0, sizeof(test_timers));
+  test_server = server;
+  test_profile = profile;
+  test_latency_max = latency_max;
+  test_seed = seed;
+  test_rng = seed;
+  test_latency_rng = seed ^ 0x5DEECE66DULL;
+  test_stats = stats;
+  test_log_count = 0U;
+  test_draining = false;
+  test_irq_enabled = false;
+  test_irq_pending = false;
+  ts_test_primask = 0U;
+
+  /* The wheel reports all the timers expired in the same interrupt: one interrupt latency. A timer restarted
+   * with no timeout from a callback once the interrupt has reported as many timers as there are is reported
+   * by the next interrupt, one latency after its restart. The list reports one timer per interrupt: one
+   * interrupt latency for each timer expiring at the same time, and for each restart with no timeout from a
+   * callback. */
+  if (server == &ts_test_wheel)
+  {
+    test_tolerance = latency_max;
+  }
+  else
+  {
+    test_tolerance = (uint64_t)(2U * TS_TEST_TIMER_NBR) * (latency_max + 1U);
+  }
+
+  /* RTC as configured by the applications */
+  ts_test_rtc.CR = CFG_RTC_WUCKSEL_DIVIDER;
+  ts_test_rtc.PRER = ((uint32_t)CFG_RTC_ASYNCH_PRESCALER << RTC_PRER_PREDIV_A_Pos) | CFG_RTC_SYNCH_PRESCALER;
+  ts_test_rtc.ISR = RTC_ISR_WUTWF;
+  ts_test_rtc.WPR = TEST_RTC_WPR_LOCKED;
+  test_ssr_offset = (uint32_t)(test_random(&test_rng) % (CFG_RTC_SYNCH_PRESCALER + 1U));
+  test_set_time(test_random(&test_rng) & 0xFFFFFFFFULL);
+
+  test_server->Init(hw_ts_InitMode_Full, &test_hrtc);
+  test_check_state();
+  if ((ts_test_exti.IMR1 & ts_test_exti.RTSR1 & RTC_EXTI_LINE_WAKEUPTIMER_EVENT) == 0U)
+  {
+    test_fail("EXTI line of the wakeup timer not enabled", ts_test_exti.IMR1);
+  }
+}
+
+/* Stop the repeated timers, then let all the others expire */
+static void test_drain(void)
+{
+  uint64_t end = test_time;
+  uint32_t i;
+
+  test_draining = true;
+  for (i = 0U; i < TS_TEST_TIMER_NBR; i++)
+  {
+    if (test_timers[i].running && (test_timers[i].mode == hw_ts_Repeated))
+    {
+      test_stop((uint8_t)i);
+      test_check_state();
+    }
+    if (test_timers[i].running && (test_timers[i].expiry > end))
+    {
+      end = test_timers[i].expiry;
+    }
+  }
+  test_advance(end + test_tolerance + 1U);
+  for (i = 0U; i < TS_TEST_TIMER_NBR; i++)
+  {
+    if (test_timers[i].running)
+    {
+      test_fail("timer still running", i);
+    }
+  }
+  if (test_server->ReadLeftTicksToCount() != 0xFFFFU)
+  {
+    test_fail("wakeup timer running with no timer", 0U);
+  }
+}
+
+static void test_replay(void)
+{
+  unsigned long op;
+  uint32_t i;
+  uint8_t timer_id;
+
+  for (i = 0U; i < TS_TEST_TIMER_NBR; i++)
+  {
+    test_create();
+  }
+  for (op = 0UL; op < TEST_OPS; op++)
+  {
+    test_advance(test_time + test_random_bits(&test_rng, test_profile->gap_bits));
+    timer_id = (uint8_t)(test_random(&test_rng) % TS_TEST_TIMER_NBR);
+    switch (test_random(&test_rng) % 20U)
+    {
+      case 0:
+      case 1:
+      case 2:
+      case 3:
+      case 4:
+      case 5:
+      case 6:
+      case 7:
+      case 8:
+        test_start(timer_id, test_timeout(&test_rng, test_timers[timer_id].mode));
+        break;
+      case 9:
+      case 10:
+      case 11:
+      case 12:
+        test_stop(timer_id);
+        break;
+      case 13:
+        test_server->Delete(timer_id);
+        test_timers[timer_id].created = false;
+        test_timers[timer_id].running = false;
+        test_check_state();
+        test_create();
+        break;
+      case 14:
+      case 15:
+        test_check_left_ticks();
+        break;
+      default:
+        break;
+    }
+    test_check_state();
+  }
+  test_drain();
+}
+
+/* Timeouts at the limits of the wakeup timer and of the subsecond register */
+static void test_limits(const ts_test_server_t *server, test_stats_t *stats)
+{
+  static const uint32_t timeouts[] = {
+    0U, 1U, 2U, 3U, 31U, 32U, 33U, 1023U, 1024U, 1025U, 0x7FEBU, 0x7FECU, 0x7FEDU, 0x7FFFU, 0x8000U,
+    0x8001U, 0xFFFFU, 0x10000U, 0x12345678U, 0xFFFFFFFFU
+  };
+  static const test_profile_t profile = { "limits", 0U, 0U, 0U, 0U };
+  uint32_t i;
+
+  for (i = 0U; i < (sizeof(timeouts) / sizeof(timeouts[0])); i++)
+  {
+    test_init(server, &profile, 0U, i + 1U, stats);
+    test_create();
+    test_start(0U, timeouts[i]);
+    test_check_state();
+    test_check_left_ticks();
+    test_drain();
+    if (test_log_count != 1U)
+    {
+      test_fail("timer not reported once", timeouts[i]);
+    }
+    if (test_log[0].time != (test_time - test_tolerance - 1U))
+    {
+      test_fail("timer not reported on time", timeouts[i]);
+    }
+  }
+}
+
+static int test_compare_expiry(const void *a, const void *b)
+{
+  const test_expiry_t *ea = a;
+  const test_expiry_t *eb = b;
+
+  if (ea->time != eb->time)
+  {
+    return (ea->time < eb->time) ? -1 : 1;
+  }
+  return (int)ea->timer_id - (int)eb->timer_id;
+}
+
+static void test_print_stats(const char *name, const test_stats_t *stats)
+{
+  printf("  %-6s %9lu expiries, %9lu interrupts, lateness mean %.3f max %llu ticks",
+         name, stats->expiries, stats->interrupts,
+         (stats->expiries != 0UL) ? ((double)stats->lateness / (double)stats->expiries) : 0.0,
+         (unsigned long long)stats->lateness_max);
+  if (test_bench)
+  {
+    printf(", %.0f ns per start, %.0f ns per stop, %.0f ns per interrupt",
+           stats->start_ns / (double)stats->starts, stats->stop_ns / (double)stats->stops,
+           stats->interrupt_ns / (double)stats->interrupts);
+  }
+  printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+  test_expiry_t *wheel_log;
+  size_t wheel_count;
+  test_stats_t wheel_total = { 0 };
+  test_stats_t list_total = { 0 };
+  test_stats_t wheel_stats, list_stats;
+  uint32_t p, latency;
+  uint64_t seed;
+  size_t i;
+  unsigned long compared = 0UL;
+
+  test_bench = (argc > 1) && (strcmp(argv[1], "bench") == 0);
+  test_limits(&ts_test_wheel, &wheel_total);
+  test_limits(&ts_test_list, &list_total);
+
+  for (p = 0U; p < (sizeof(test_profiles) / sizeof(test_profiles[0])); p++)
+  {
+    for (latency = 0U; latency <= TEST_LATENCY_MAX; latency += TEST_LATENCY_MAX)
+    {
+      seed = 0x2545F4914F6CDD1DULL * (((uint64_t)p << 8) + latency + 1U);
+      memset(&wheel_stats, 0, sizeof(wheel_stats));
+      memset(&list_stats, 0, sizeof(list_stats));
+
+      test_init(&ts_test_wheel, &test_profiles[p], latency, seed, &wheel_stats);
+      test_replay();
+      wheel_log = test_log;
+      wheel_count = test_log_count;
+      test_log = NULL;
+      test_log_size = 0U;
+
+      test_init(&ts_test_list, &test_profiles[p], latency, seed, &list_stats);
+      test_replay();
+
+      /* With no interrupt latency, both report the same timers at the same time */
+      if (latency == 0U)
+      {
+        qsort(wheel_log, wheel_count, sizeof(test_expiry_t), test_compare_expiry);
+        qsort(test_log, test_log_count, sizeof(test_expiry_t), test_compare_expiry);
+        if (wheel_count != test_log_count)
+        {
+          test_fail("timer servers reported a different number of expiries", (unsigned long)wheel_count);
+        }
+        for (i = 0U; i < wheel_count; i++)
+        {
+          if (test_compare_expiry(&wheel_log[i], &test_log[i]) != 0)
+          {
+            test_fail("timer servers reported different expiries", (unsigned long)i);
+          }
+        }
+        compared += wheel_count;
+      }
+      free(wheel_log);
+
+      /* Moving the timers down the wheel does not wake up the CPU: the wheel only takes more interrupts than
+       * the list when the timer stopped was the next one to expire */
+      if ((wheel_stats.interrupts * 10UL) > (list_stats.interrupts * 11UL))
+      {
+        test_fail("timer wheel woke up more than the list", wheel_stats.interrupts);
+      }
+
+      if (test_bench)
+      {
+        printf("%s, %u timers, interrupt latency up to %u ticks:\n", test_profiles[p].name, TS_TEST_TIMER_NBR,
+               latency);
+        test_print_stats("wheel", &wheel_stats);
+        test_print_stats("list", &list_stats);
+      }
+      wheel_total.expiries += wheel_stats.expiries;
+      wheel_total.interrupts += wheel_stats.interrupts;
+      list_total.interrupts += list_stats.interrupts;
+    }
+  }
+  free(test_log);
+
+  printf("PASS: timer server, %u timers, %lu expiries (%lu compared with the list), %lu wakeup interrupts "
+         "(list %lu)\n", TS_TEST_TIMER_NBR, wheel_total.expiries, compared, wheel_total.interrupts,
+         list_total.interrupts);
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,87 @@
+/**
+ ******************************************************************************
+ * @file    ts_test.h
+ * @author  MCD Application Team
+ * @brief   Timer server host test: model of the RTC wakeup timer, of the
+ *          EXTI line, of the NVIC and of PRIMASK, and the timer servers built
+ *          over it (ts_wheel.c, ts_list.c).
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#ifndef TS_TEST_H
+#define TS_TEST_H
+
+#include "app_common.h"
+#include "hw_conf.h"
+
+/* The applications use 6 timers, the benchmark also runs with more */
+#ifdef TS_TEST_TIMER_NBR
+#undef CFG_HW_TS_MAX_NBR_CONCURRENT_TIMER
+#define CFG_HW_TS_MAX_NBR_CONCURRENT_TIMER    TS_TEST_TIMER_NBR
+#else
+#define TS_TEST_TIMER_NBR                     CFG_HW_TS_MAX_NBR_CONCURRENT_TIMER
+#endif
+
+/* Public interface of a timer server */
+typedef struct
+{
+  const char *name;
+  void (*Init)(HW_TS_InitMode_t TimerInitMode, RTC_HandleTypeDef *hrtc);
+  HW_TS_ReturnStatus_t (*Create)(uint32_t TimerProcessID, uint8_t *pTimerId, HW_TS_Mode_t TimerMode,
+                                 HW_TS_pTimerCb_t pTimerCallBack);
+  void (*Stop)(uint8_t TimerID);
+  void (*Start)(uint8_t TimerID, uint32_t timeout_ticks);
+  void (*Delete)(uint8_t TimerID);
+  void (*Wakeup_Handler)(void);
+  uint16_t (*ReadLeftTicksToCount)(void);
+} ts_test_server_t;
+
+/* Timer wheel of the applications, ts_wheel.c */
+extern const ts_test_server_t ts_test_wheel;
+/* Sorted list before the timer wheel, ts_list.c */
+extern const ts_test_server_t ts_test_list;
+
+/* Model, ts_test.c */
+extern RTC_TypeDef ts_test_rtc;
+extern EXTI_TypeDef ts_test_exti;
+extern uint32_t ts_test_primask;
+void ts_test_wakeup_timer_enable(void);
+void ts_test_wakeup_timer_disable(void);
+void ts_test_rtc_clear_flag(uint32_t Flag);
+uint32_t ts_test_rbit(uint32_t Value);
+
+/* The timer servers access the model instead of the RTC, the EXTI and the
+ * Cortex registers. The HAL macros reading registers only are kept. */
+#ifdef TS_TEST_SERVER
+#undef RTC
+#define RTC                                           (&ts_test_rtc)
+#undef EXTI
+#define EXTI                                          (&ts_test_exti)
+#define LL_EXTI_EnableRisingTrig_0_31(__EXTI_LINE__)  SET_BIT(EXTI->RTSR1, (__EXTI_LINE__))
+#define LL_EXTI_EnableIT_0_31(__EXTI_LINE__)          SET_BIT(EXTI->IMR1, (__EXTI_LINE__))
+#undef __HAL_RTC_WAKEUPTIMER_ENABLE
+#define __HAL_RTC_WAKEUPTIMER_ENABLE(__HANDLE__)      ts_test_wakeup_timer_enable()
+#undef __HAL_RTC_WAKEUPTIMER_DISABLE
+#define __HAL_RTC_WAKEUPTIMER_DISABLE(__HANDLE__)     ts_test_wakeup_timer_disable()
+#undef __HAL_RTC_WAKEUPTIMER_CLEAR_FLAG
+#define __HAL_RTC_WAKEUPTIMER_CLEAR_FLAG(__HANDLE__, __FLAG__)  ts_test_rtc_clear_flag(__FLAG__)
+#define __get_PRIMASK()                               (ts_test_primask)
+#define __set_PRIMASK(__PRIMASK__)                    (ts_test_primask = (__PRIMASK__))
+#define __disable_irq()                               (ts_test_primask = 1U)
+#define __RBIT(__VALUE__)                             ts_test_rbit(__VALUE__)
+#endif
+
+#endif /* TS_TEST_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,29 @@
+/**
+ ******************************************************************************
+ * @file    ts_wheel.c
+ * @author  MCD Application Team
+ * @brief   Timer wheel of the applications, built over the model of ts_test.c
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#define TS_TEST_SERVER
+#include "ts_test.h"
+#include "../Core/Src/hw_timerserver.c"
+
+const ts_test_server_t ts_test_wheel = {
+  "wheel", HW_TS_Init, HW_TS_Create, HW_TS_Stop, HW_TS_Start, HW_TS_Delete, HW_TS_RTC_Wakeup_Handler,
+  HW_TS_RTC_ReadLeftTicksToCount
+};
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
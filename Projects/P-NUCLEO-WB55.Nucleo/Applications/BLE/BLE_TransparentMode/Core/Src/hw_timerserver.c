@@ -29,12 +29,6 @@ typedef enum
   TimerID_Running
 }TimerIDStatus_t;
 
-typedef enum
-{
-  SSR_Read_Requested,
-  SSR_Read_Not_Requested
-}RequestReadSSR_t;
-
 typedef enum
 {
   WakeupTimerValue_Overpassed,
@@ -45,10 +39,11 @@ typedef struct
 {
   HW_TS_pTimerCb_t  pTimerCallBack;
   uint32_t        CounterInit;
-  uint32_t        CountLeft;
+  uint64_t        Expiry;
   TimerIDStatus_t     TimerIDStatus;
   HW_TS_Mode_t   TimerMode;
   uint32_t        TimerProcessID;
+  uint16_t        ListID;
   uint8_t         PreviousID;
   uint8_t         NextID;
 }TimerContext_t;
@@ -57,6 +52,23 @@ typedef struct
 #define SSR_FORBIDDEN_VALUE   0xFFFFFFFF
 #define TIMER_LIST_EMPTY      0xFFFF
 
+/**
+ * The running timers are stored in a hierarchical timer wheel
+ * Each level has 32 slots. A slot of level n covers 32^n ticks so that 7 levels cover more than the 32 bits timeout
+ * A timer is linked in the slot of the lowest level that is reached before it expires. When the time reaches the
+ * beginning of a slot of level n > 0, its timers are moved down to a lower level. When the time reaches a slot of
+ * level 0, its timers expire.
+ * The time is an absolute 64 bits count of wakeup timer ticks so that it never wraps
+ */
+#define WHEEL_SLOT_SHIFT      5
+#define WHEEL_SLOT_NBR        (1 << WHEEL_SLOT_SHIFT)
+#define WHEEL_SLOT_MASK       (WHEEL_SLOT_NBR - 1)
+#define WHEEL_LEVEL_NBR       7
+#define WHEEL_EXPIRED_LIST    (WHEEL_LEVEL_NBR * WHEEL_SLOT_NBR)
+#define WHEEL_NO_LIST         0xFFFF
+#define WHEEL_NO_TIMER        CFG_HW_TS_MAX_NBR_CONCURRENT_TIMER
+#define WHEEL_NO_EVENT        0xFFFFFFFFFFFFFFFFULL
+
 /* Private macros ------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 
@@ -65,8 +77,12 @@ typedef struct
  */
 
 PLACE_IN_SECTION("TIMERSERVER_CONTEXT") static volatile TimerContext_t aTimerContext[CFG_HW_TS_MAX_NBR_CONCURRENT_TIMER];
-PLACE_IN_SECTION("TIMERSERVER_CONTEXT") static volatile uint8_t CurrentRunningTimerID;
-PLACE_IN_SECTION("TIMERSERVER_CONTEXT") static volatile uint8_t PreviousRunningTimerID;
+PLACE_IN_SECTION("TIMERSERVER_CONTEXT") static volatile uint8_t aWheelList[WHEEL_EXPIRED_LIST + 1];
+PLACE_IN_SECTION("TIMERSERVER_CONTEXT") static volatile uint32_t aWheelBitmap[WHEEL_LEVEL_NBR];
+PLACE_IN_SECTION("TIMERSERVER_CONTEXT") static volatile uint8_t ExpiredListTailID;
+PLACE_IN_SECTION("TIMERSERVER_CONTEXT") static volatile uint64_t WheelTime;
+PLACE_IN_SECTION("TIMERSERVER_CONTEXT") static volatile uint64_t TimeOnLastSetup;
+PLACE_IN_SECTION("TIMERSERVER_CONTEXT") static volatile uint64_t WakeupEventTime;
 PLACE_IN_SECTION("TIMERSERVER_CONTEXT") static volatile uint32_t SSRValueOnLastSetup;
 PLACE_IN_SECTION("TIMERSERVER_CONTEXT") static volatile WakeupTimerLimitation_Status_t  WakeupTimerLimitation;
 
@@ -83,12 +99,20 @@ static volatile uint16_t MaxWakeupTimerSetup;
 /* Global variables ----------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 static void RestartWakeupCounter(uint16_t Value);
+static void StopWakeupCounter(void);
 static uint16_t ReturnTimeElapsed(void);
+static uint64_t ReturnCurrentTime(void);
+static void UpdateTimeOnLastSetup(void);
 static void RescheduleTimerList(void);
-static void UnlinkTimer(uint8_t TimerID, RequestReadSSR_t RequestReadSSR);
-static void LinkTimerBefore(uint8_t TimerID, uint8_t RefTimerID);
-static void LinkTimerAfter(uint8_t TimerID, uint8_t RefTimerID);
-static uint16_t linkTimer(uint8_t TimerID);
+static void LinkTimer(uint8_t TimerID, uint16_t ListID);
+static void UnlinkTimer(uint8_t TimerID);
+static void InsertTimer(uint8_t TimerID);
+static uint32_t FirstSlotFrom(uint32_t Bitmap, uint32_t Slot);
+static uint64_t ReturnNextEventTime(void);
+static uint64_t ReturnNextExpiryTime(void);
+static void ProcessEvent(void);
+static void AdvanceTime(uint64_t Time);
+static uint8_t IsWheelEmpty(void);
 static uint32_t ReadRtcSsrValue(void);
 
 __weak void HW_TS_RTC_CountUpdated_AppNot(void);
@@ -122,166 +146,332 @@ static uint32_t ReadRtcSsrValue(void)
 }
 
 /**
- * @brief  Insert a Timer in the list after the Timer ID specified
+ * @brief  Insert a Timer in a list of the wheel
+ * @note  The timers are inserted at the head of the wheel slots as their order does not matter
+ *        The expired timers are inserted at the tail so that they are reported in order
  * @param  TimerID:   The ID of the Timer
- * @param  RefTimerID: The ID of the Timer to be linked after
+ * @param  ListID:    The wheel slot or WHEEL_EXPIRED_LIST
  * @retval None
  */
-static void LinkTimerAfter(uint8_t TimerID, uint8_t RefTimerID)
+static void LinkTimer(uint8_t TimerID, uint16_t ListID)
 {
   uint8_t next_id;
+  uint8_t previous_id;
 
-  next_id = aTimerContext[RefTimerID].NextID;
+  aTimerContext[TimerID].ListID = ListID;
 
-  if(next_id != CFG_HW_TS_MAX_NBR_CONCURRENT_TIMER)
+  if(ListID == WHEEL_EXPIRED_LIST)
   {
-    aTimerContext[next_id].PreviousID = TimerID;
+    previous_id = ExpiredListTailID;
+
+    aTimerContext[TimerID].PreviousID = previous_id;
+    aTimerContext[TimerID].NextID = WHEEL_NO_TIMER;
+    if(previous_id != WHEEL_NO_TIMER)
+    {
+      aTimerContext[previous_id].NextID = TimerID;
+    }
+    else
+    {
+      aWheelList[ListID] = TimerID;
+    }
+    ExpiredListTailID = TimerID;
+  }
+  else
+  {
+    next_id = aWheelList[ListID];
+
+    aTimerContext[TimerID].PreviousID = WHEEL_NO_TIMER;
+    aTimerContext[TimerID].NextID = next_id;
+    if(next_id != WHEEL_NO_TIMER)
+    {
+      aTimerContext[next_id].PreviousID = TimerID;
+    }
+    aWheelList[ListID] = TimerID;
+
+    aWheelBitmap[ListID >> WHEEL_SLOT_SHIFT] |= (1UL << (ListID & WHEEL_SLOT_MASK));
   }
-  aTimerContext[TimerID].NextID = next_id;
-  aTimerContext[TimerID].PreviousID = RefTimerID ;
-  aTimerContext[RefTimerID].NextID = TimerID;
 
   return;
 }
 
 /**
- * @brief  Insert a Timer in the list before the ID specified
+ * @brief  Remove a Timer from its list of the wheel
  * @param  TimerID:   The ID of the Timer
- * @param  RefTimerID: The ID of the Timer to be linked before
  * @retval None
  */
-static void LinkTimerBefore(uint8_t TimerID, uint8_t RefTimerID)
+static void UnlinkTimer(uint8_t TimerID)
 {
+  uint16_t list_id;
   uint8_t previous_id;
+  uint8_t next_id;
 
-  if(RefTimerID != CurrentRunningTimerID)
-  {
-    previous_id = aTimerContext[RefTimerID].PreviousID;
+  list_id = aTimerContext[TimerID].ListID;
+  previous_id = aTimerContext[TimerID].PreviousID;
+  next_id = aTimerContext[TimerID].NextID;
 
-    aTimerContext[previous_id].NextID = TimerID;
-    aTimerContext[TimerID].NextID = RefTimerID;
-    aTimerContext[TimerID].PreviousID = previous_id ;
-    aTimerContext[RefTimerID].PreviousID = TimerID;
+  if(previous_id != WHEEL_NO_TIMER)
+  {
+    aTimerContext[previous_id].NextID = next_id;
   }
   else
   {
-    aTimerContext[TimerID].NextID = RefTimerID;
-    aTimerContext[RefTimerID].PreviousID = TimerID;
+    aWheelList[list_id] = next_id;
   }
 
+  if(next_id != WHEEL_NO_TIMER)
+  {
+    aTimerContext[next_id].PreviousID = previous_id;
+  }
+  else if(list_id == WHEEL_EXPIRED_LIST)
+  {
+    ExpiredListTailID = previous_id;
+  }
+
+  if((list_id != WHEEL_EXPIRED_LIST) && (aWheelList[list_id] == WHEEL_NO_TIMER))
+  {
+    aWheelBitmap[list_id >> WHEEL_SLOT_SHIFT] &= ~(1UL << (list_id & WHEEL_SLOT_MASK));
+  }
+
+  aTimerContext[TimerID].ListID = WHEEL_NO_LIST;
+
   return;
 }
 
 /**
- * @brief  Insert a Timer in the list
+ * @brief  Insert a Timer in the wheel according to its expiry time
+ * @note  The level is the lowest one where the timer expires within the 32 next slots from WheelTime
  * @param  TimerID:   The ID of the Timer
  * @retval None
  */
-static uint16_t linkTimer(uint8_t TimerID)
+static void InsertTimer(uint8_t TimerID)
 {
-  uint32_t time_left;
-  uint16_t time_elapsed;
-  uint8_t timer_id_lookup;
-  uint8_t next_id;
+  uint64_t expiry;
+  uint64_t time_left;
+  uint32_t level;
 
-  if(CurrentRunningTimerID == CFG_HW_TS_MAX_NBR_CONCURRENT_TIMER)
-  {
-    /**
-     * No timer in the list
-     */
-    PreviousRunningTimerID = CurrentRunningTimerID;
-    CurrentRunningTimerID = TimerID;
-    aTimerContext[TimerID].NextID = CFG_HW_TS_MAX_NBR_CONCURRENT_TIMER;
+  expiry = aTimerContext[TimerID].Expiry;
 
-    SSRValueOnLastSetup = SSR_FORBIDDEN_VALUE;
-    time_elapsed = 0;
+  if(expiry <= WheelTime)
+  {
+    LinkTimer(TimerID, WHEEL_EXPIRED_LIST);
   }
   else
   {
-    time_elapsed = ReturnTimeElapsed();
+    time_left = expiry - WheelTime;
+    level = 0;
+    while(((time_left >> ((level + 1) * WHEEL_SLOT_SHIFT)) != 0) && (level < (WHEEL_LEVEL_NBR - 1)))
+    {
+      level++;
+    }
 
-    /**
-     * update count of the timer to be linked
-     */
-    aTimerContext[TimerID].CountLeft += time_elapsed;
-    time_left = aTimerContext[TimerID].CountLeft;
+    LinkTimer(TimerID, (level * WHEEL_SLOT_NBR) + ((uint32_t)(expiry >> (level * WHEEL_SLOT_SHIFT)) & WHEEL_SLOT_MASK));
+  }
 
-    /**
-     * Search for index where the new timer shall be linked
-     */
-    if(aTimerContext[CurrentRunningTimerID].CountLeft <= time_left)
+  return;
+}
+
+/**
+ * @brief  Return the distance from Slot to the first slot in use, searching circularly
+ * @param  Bitmap: The slots in use of one level. It shall not be 0
+ * @param  Slot:   The first slot to be checked
+ * @retval Number of slots from Slot to the first slot in use
+ */
+static uint32_t FirstSlotFrom(uint32_t Bitmap, uint32_t Slot)
+{
+  if(Slot != 0)
+  {
+    Bitmap = (Bitmap >> Slot) | (Bitmap << (WHEEL_SLOT_NBR - Slot));
+  }
+
+  return __CLZ(__RBIT(Bitmap));
+}
+
+/**
+ * @brief  Return the time when the wheel has next to be processed
+ * @note  This is either the expiry of a timer in the level 0 or the beginning of a slot of an upper level
+ *        where the timers have to be moved down
+ *        The expired timers not yet reported are not taken into account
+ * @param  None
+ * @retval Time of the next event or WHEEL_NO_EVENT when the wheel is empty
+ */
+static uint64_t ReturnNextEventTime(void)
+{
+  uint64_t event_time;
+  uint64_t level_event_time;
+  uint32_t level;
+  uint32_t shift;
+  uint32_t slot;
+
+  event_time = WHEEL_NO_EVENT;
+
+  if(aWheelBitmap[0] != 0)
+  {
+    slot = (uint32_t)WheelTime & WHEEL_SLOT_MASK;
+    event_time = WheelTime + FirstSlotFrom(aWheelBitmap[0], slot);
+  }
+
+  for(level = 1; level < WHEEL_LEVEL_NBR; level++)
+  {
+    if(aWheelBitmap[level] != 0)
     {
       /**
-       * Search for the ID after the first one
+       * The current slot of an upper level is only reached again after a full turn
        */
-      timer_id_lookup = CurrentRunningTimerID;
-      next_id = aTimerContext[timer_id_lookup].NextID;
-      while((next_id != CFG_HW_TS_MAX_NBR_CONCURRENT_TIMER) && (aTimerContext[next_id].CountLeft <= time_left))
+      shift = level * WHEEL_SLOT_SHIFT;
+      slot = ((uint32_t)(WheelTime >> shift) + 1) & WHEEL_SLOT_MASK;
+      level_event_time = ((WheelTime >> shift) + 1 + FirstSlotFrom(aWheelBitmap[level], slot)) << shift;
+
+      if(level_event_time < event_time)
       {
-        timer_id_lookup = aTimerContext[timer_id_lookup].NextID;
-        next_id = aTimerContext[timer_id_lookup].NextID;
+        event_time = level_event_time;
       }
-
-      /**
-       * Link after the ID
-       */
-      LinkTimerAfter(TimerID, timer_id_lookup);
-    }
-    else
-    {
-      /**
-       * Link before the first ID
-       */
-      LinkTimerBefore(TimerID, CurrentRunningTimerID);
-      PreviousRunningTimerID = CurrentRunningTimerID;
-      CurrentRunningTimerID = TimerID;
     }
   }
 
-  return time_elapsed;
+  return event_time;
 }
 
 /**
- * @brief  Remove a Timer from the list
- * @param  TimerID:   The ID of the Timer
- * @param  RequestReadSSR: Request to read the SSR register or not
- * @retval None
+ * @brief  Return the time when the first running timer expires
+ * @note  The wakeup timer is set to this time rather than to the next event of the wheel so that moving
+ *        the timers down to a lower level does not wake up the CPU
+ *        In each level, the first slot in use from WheelTime holds the timers expiring first in that level
+ *        The expired timers not yet reported are not taken into account
+ * @param  None
+ * @retval Expiry time or WHEEL_NO_EVENT when the wheel is empty
  */
-static void UnlinkTimer(uint8_t TimerID, RequestReadSSR_t RequestReadSSR)
+static uint64_t ReturnNextExpiryTime(void)
 {
-  uint8_t previous_id;
-  uint8_t next_id;
+  uint64_t expiry_time;
+  uint32_t level;
+  uint32_t shift;
+  uint32_t slot;
+  uint8_t timer_id;
 
-  if(TimerID == CurrentRunningTimerID)
+  expiry_time = WHEEL_NO_EVENT;
+
+  if(aWheelBitmap[0] != 0)
   {
-    PreviousRunningTimerID = CurrentRunningTimerID;
-    CurrentRunningTimerID = aTimerContext[TimerID].NextID;
+    slot = (uint32_t)WheelTime & WHEEL_SLOT_MASK;
+    expiry_time = WheelTime + FirstSlotFrom(aWheelBitmap[0], slot);
   }
-  else
+
+  for(level = 1; level < WHEEL_LEVEL_NBR; level++)
   {
-    previous_id = aTimerContext[TimerID].PreviousID;
-    next_id = aTimerContext[TimerID].NextID;
+    if(aWheelBitmap[level] != 0)
+    {
+      shift = level * WHEEL_SLOT_SHIFT;
+      slot = ((uint32_t)(WheelTime >> shift) + 1) & WHEEL_SLOT_MASK;
+      slot = (slot + FirstSlotFrom(aWheelBitmap[level], slot)) & WHEEL_SLOT_MASK;
+
+      timer_id = aWheelList[(level * WHEEL_SLOT_NBR) + slot];
+      while(timer_id != WHEEL_NO_TIMER)
+      {
+        if(aTimerContext[timer_id].Expiry < expiry_time)
+        {
+          expiry_time = aTimerContext[timer_id].Expiry;
+        }
+        timer_id = aTimerContext[timer_id].NextID;
+      }
+    }
+  }
 
-    aTimerContext[previous_id].NextID = aTimerContext[TimerID].NextID;
-    if(next_id != CFG_HW_TS_MAX_NBR_CONCURRENT_TIMER)
+  return expiry_time;
+}
+
+/**
+ * @brief  Process the slots reached at WheelTime
+ * @note  The upper levels are processed first as their timers may be moved down to the slot of level 0
+ *        reached at the same time
+ * @param  None
+ * @retval None
+ */
+static void ProcessEvent(void)
+{
+  uint32_t level;
+  uint32_t shift;
+  uint16_t list_id;
+  uint8_t timer_id;
+
+  for(level = (WHEEL_LEVEL_NBR - 1); level > 0; level--)
+  {
+    shift = level * WHEEL_SLOT_SHIFT;
+    if((WheelTime & ((1ULL << shift) - 1)) == 0)
     {
-      aTimerContext[next_id].PreviousID = aTimerContext[TimerID].PreviousID;
+      list_id = (level * WHEEL_SLOT_NBR) + ((uint32_t)(WheelTime >> shift) & WHEEL_SLOT_MASK);
+      timer_id = aWheelList[list_id];
+      while(timer_id != WHEEL_NO_TIMER)
+      {
+        UnlinkTimer(timer_id);
+        InsertTimer(timer_id);
+        timer_id = aWheelList[list_id];
+      }
     }
   }
 
-  /**
-   * Timer is out of the list
-   */
-  aTimerContext[TimerID].TimerIDStatus = TimerID_Created;
+  list_id = (uint32_t)WheelTime & WHEEL_SLOT_MASK;
+  timer_id = aWheelList[list_id];
+  while(timer_id != WHEEL_NO_TIMER)
+  {
+    UnlinkTimer(timer_id);
+    LinkTimer(timer_id, WHEEL_EXPIRED_LIST);
+    timer_id = aWheelList[list_id];
+  }
+
+  return;
+}
 
-  if((CurrentRunningTimerID == CFG_HW_TS_MAX_NBR_CONCURRENT_TIMER) && (RequestReadSSR == SSR_Read_Requested))
+/**
+ * @brief  Move the wheel up to the time specified
+ * @note  All timers expiring up to that time are moved to the expired list
+ * @param  Time: The time to be reached
+ * @retval None
+ */
+static void AdvanceTime(uint64_t Time)
+{
+  uint64_t event_time;
+
+  event_time = ReturnNextEventTime();
+  while(event_time <= Time)
   {
-    SSRValueOnLastSetup = SSR_FORBIDDEN_VALUE;
+    WheelTime = event_time;
+    ProcessEvent();
+    event_time = ReturnNextEventTime();
+  }
+
+  if(Time > WheelTime)
+  {
+    WheelTime = Time;
   }
 
   return;
 }
 
+/**
+ * @brief  Check whether there is no timer running
+ * @param  None
+ * @retval TRUE when no timer is running
+ */
+static uint8_t IsWheelEmpty(void)
+{
+  uint32_t level;
+
+  if(aWheelList[WHEEL_EXPIRED_LIST] != WHEEL_NO_TIMER)
+  {
+    return FALSE;
+  }
+
+  for(level = 0; level < WHEEL_LEVEL_NBR; level++)
+  {
+    if(aWheelBitmap[level] != 0)
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
 /**
  * @brief  Return the number of ticks counted by the wakeuptimer since it has been started
  * @note  The API is reading the SSR register to get how many ticks have been counted
@@ -323,6 +513,31 @@ static uint16_t ReturnTimeElapsed(void)
   return (uint16_t)return_value;
 }
 
+/**
+ * @brief  Return the current time of the timer server
+ * @param  None
+ * @retval Time in Ticks
+ */
+static uint64_t ReturnCurrentTime(void)
+{
+  return (TimeOnLastSetup + ReturnTimeElapsed());
+}
+
+/**
+ * @brief  Take a new reference of the SSR register
+ * @note  The time counted since the previous reference is accumulated so that the time of the timer server
+ *        keeps increasing
+ * @param  None
+ * @retval None
+ */
+static void UpdateTimeOnLastSetup(void)
+{
+  TimeOnLastSetup += ReturnTimeElapsed();
+  SSRValueOnLastSetup = ReadRtcSsrValue();
+
+  return;
+}
+
 /**
  * @brief  Set the wakeup counter
  * @note  The API is writing the counter value so that the value is decreased by one to cope with the fact
@@ -341,7 +556,7 @@ static void RestartWakeupCounter(uint16_t Value)
 
   if(Value == 0)
   {
-    SSRValueOnLastSetup = ReadRtcSsrValue();
+    UpdateTimeOnLastSetup();
 
     /**
      * Simulate that the Timer expired
@@ -373,7 +588,7 @@ static void RestartWakeupCounter(uint16_t Value)
     /**
      * Update the value here after the WUTWF polling that may take some time
      */
-    SSRValueOnLastSetup = ReadRtcSsrValue();
+    UpdateTimeOnLastSetup();
 
     __HAL_RTC_WAKEUPTIMER_ENABLE(phrtc);    /**<  Enable the Wakeup Timer */
 
@@ -384,22 +599,14 @@ static void RestartWakeupCounter(uint16_t Value)
 }
 
 /**
- * @brief  Reschedule the list of timer
- * @note  1) Update the count left for each timer in the list
- *    2) Setup the wakeuptimer
+ * @brief  Stop the wakeup counter when there is no more timer running
  * @param  None
  * @retval None
  */
-static void RescheduleTimerList(void)
+static void StopWakeupCounter(void)
 {
-  uint8_t   localTimerID;
-  uint32_t  timecountleft;
-  uint16_t  wakeup_timer_value;
-  uint16_t  time_elapsed;
-
   /**
-   * The wakeuptimer is disabled now to reduce the time to poll the WUTWF
-   * FLAG when the new value will have to be written
+   * Disable the timer
    */
   if((READ_BIT(RTC->CR, RTC_CR_WUTE) == (RTC_CR_WUTE)) == SET)
   {
@@ -410,66 +617,104 @@ static void RescheduleTimerList(void)
   }
   __HAL_RTC_WAKEUPTIMER_DISABLE(phrtc);   /**<  Disable the Wakeup Timer */
 
-  localTimerID = CurrentRunningTimerID;
+  while(__HAL_RTC_WAKEUPTIMER_GET_FLAG(phrtc, RTC_FLAG_WUTWF) == RESET);
 
   /**
-   * Calculate what will be the value to write in the wakeuptimer
+   * make sure to clear the flags after checking the WUTWF.
+   * It takes 2 RTCCLK between the time the WUTE bit is disabled and the
+   * time the timer is disabled. The WUTWF bit somehow guarantee the system is stable
+   * Otherwise, when the timer is periodic with 1 Tick, it may generate an extra interrupt in between
+   * due to the autoreload feature
    */
-  timecountleft = aTimerContext[localTimerID].CountLeft;
+  __HAL_RTC_WAKEUPTIMER_CLEAR_FLAG(phrtc, RTC_FLAG_WUTF);   /**<  Clear flag in RTC module */
+  __HAL_RTC_WAKEUPTIMER_EXTI_CLEAR_FLAG(); /**<  Clear flag in EXTI module */
+  HAL_NVIC_ClearPendingIRQ(CFG_HW_TS_RTC_WAKEUP_HANDLER_ID);   /**<  Clear pending bit in NVIC */
 
   /**
-   * Read how much has been counted
+   * The time does not need to be counted anymore. It restarts from the same value on the next timer start
    */
-  time_elapsed = ReturnTimeElapsed();
+  TimeOnLastSetup = ReturnCurrentTime();
+  SSRValueOnLastSetup = SSR_FORBIDDEN_VALUE;
+  WakeupEventTime = WHEEL_NO_EVENT;
+
+  return;
+}
 
-  if(timecountleft < time_elapsed )
+/**
+ * @brief  Reschedule the list of timer
+ * @note  1) Move the wheel up to the current time
+ *    2) Setup the wakeuptimer to the next expiry
+ * @param  None
+ * @retval None
+ */
+static void RescheduleTimerList(void)
+{
+  uint64_t  current_time;
+  uint64_t  event_time;
+  uint16_t  wakeup_timer_value;
+
+  current_time = ReturnCurrentTime();
+
+  AdvanceTime(current_time);
+
+  if(aWheelList[WHEEL_EXPIRED_LIST] != WHEEL_NO_TIMER)
   {
-    /**
-     * There is no tick left to count
-     */
-    wakeup_timer_value = 0;
-    WakeupTimerLimitation = WakeupTimerValue_LargeEnough;
+    event_time = current_time;
   }
   else
   {
-    if(timecountleft > (time_elapsed + MaxWakeupTimerSetup))
+    event_time = ReturnNextExpiryTime();
+  }
+
+  if(event_time == WHEEL_NO_EVENT)
+  {
+    StopWakeupCounter();
+  }
+  else
+  {
+    /**
+     * The wakeuptimer is disabled now to reduce the time to poll the WUTWF
+     * FLAG when the new value will have to be written
+     */
+    if((READ_BIT(RTC->CR, RTC_CR_WUTE) == (RTC_CR_WUTE)) == SET)
+    {
+      /**
+       * Wait for the flag to be back to 0 when the wakeup timer is enabled
+       */
+      while(__HAL_RTC_WAKEUPTIMER_GET_FLAG(phrtc, RTC_FLAG_WUTWF) == SET);
+    }
+    __HAL_RTC_WAKEUPTIMER_DISABLE(phrtc);   /**<  Disable the Wakeup Timer */
+
+    if(event_time <= current_time)
+    {
+      /**
+       * There is no tick left to count
+       */
+      wakeup_timer_value = 0;
+      WakeupTimerLimitation = WakeupTimerValue_LargeEnough;
+    }
+    else if((event_time - current_time) > MaxWakeupTimerSetup)
     {
       /**
        * The number of tick left is greater than the Wakeuptimer maximum value
        */
       wakeup_timer_value = MaxWakeupTimerSetup;
-
       WakeupTimerLimitation = WakeupTimerValue_Overpassed;
     }
     else
     {
-      wakeup_timer_value = timecountleft - time_elapsed;
+      wakeup_timer_value = (uint16_t)(event_time - current_time);
       WakeupTimerLimitation = WakeupTimerValue_LargeEnough;
     }
 
-  }
+    WakeupEventTime = current_time + wakeup_timer_value;
 
-  /**
-   * update ticks left to be counted for each timer
-   */
-  while(localTimerID != CFG_HW_TS_MAX_NBR_CONCURRENT_TIMER)
-  {
-    if (aTimerContext[localTimerID].CountLeft < time_elapsed)
-    {
-      aTimerContext[localTimerID].CountLeft = 0;
-    }
-    else
-    {
-      aTimerContext[localTimerID].CountLeft -= time_elapsed;
-    }
-    localTimerID = aTimerContext[localTimerID].NextID;
+    /**
+     * Write next count
+     */
+    RestartWakeupCounter(wakeup_timer_value);
   }
 
-  /**
-   * Write next count
-   */
-  RestartWakeupCounter(wakeup_timer_value);
-
   return ;
 }
 
@@ -486,7 +731,9 @@ void HW_TS_RTC_Wakeup_Handler(void)
 {
   HW_TS_pTimerCb_t ptimer_callback;
   uint32_t timer_process_id;
-  uint8_t local_current_running_timer_id;
+  uint64_t current_time;
+  uint8_t expired_timer_id;
+  uint8_t nbr_expired_timer;
 #if (CFG_HW_TS_USE_PRIMASK_AS_CRITICAL_SECTION == 1)
   uint32_t primask_bit;
 #endif
@@ -506,77 +753,66 @@ void HW_TS_RTC_Wakeup_Handler(void)
    */
   __HAL_RTC_WAKEUPTIMER_DISABLE(phrtc);
 
-  local_current_running_timer_id = CurrentRunningTimerID;
+  /**
+   * It should be good to rely only on the time elapsed to know which timers have expired
+   * However, due to the inaccuracy of the reading of the time elapsed, it may return there is 1 tick
+   * to be left whereas the count is over
+   * A more secure implementation has been done with a flag to state whereas the full count has been written
+   * in the wakeuptimer or not
+   */
+  current_time = ReturnCurrentTime();
+  if((WakeupTimerLimitation != WakeupTimerValue_Overpassed) && (WakeupEventTime != WHEEL_NO_EVENT)
+     && (current_time < WakeupEventTime))
+  {
+    current_time = WakeupEventTime;
+  }
+  AdvanceTime(current_time);
 
-  if(aTimerContext[local_current_running_timer_id].TimerIDStatus == TimerID_Running)
+  /**
+   * Report the expired timers
+   * The number of timers reported is bounded in case a timer is restarted with a null timeout from its callback
+   */
+  nbr_expired_timer = 0;
+  expired_timer_id = aWheelList[WHEEL_EXPIRED_LIST];
+  while((expired_timer_id != WHEEL_NO_TIMER) && (nbr_expired_timer < CFG_HW_TS_MAX_NBR_CONCURRENT_TIMER))
   {
-    ptimer_callback = aTimerContext[local_current_running_timer_id].pTimerCallBack;
-    timer_process_id = aTimerContext[local_current_running_timer_id].TimerProcessID;
+    ptimer_callback = aTimerContext[expired_timer_id].pTimerCallBack;
+    timer_process_id = aTimerContext[expired_timer_id].TimerProcessID;
 
-    /**
-     * It should be good to check whether the TimeElapsed is greater or not than the tick left to be counted
-     * However, due to the inaccuracy of the reading of the time elapsed, it may return there is 1 tick
-     * to be left whereas the count is over
-     * A more secure implementation has been done with a flag to state whereas the full count has been written
-     * in the wakeuptimer or not
-     */
-    if(WakeupTimerLimitation != WakeupTimerValue_Overpassed)
+    UnlinkTimer(expired_timer_id);
+
+    if(aTimerContext[expired_timer_id].TimerMode == hw_ts_Repeated)
     {
-      if(aTimerContext[local_current_running_timer_id].TimerMode == hw_ts_Repeated)
-      {
-        UnlinkTimer(local_current_running_timer_id, SSR_Read_Not_Requested);
-#if (CFG_HW_TS_USE_PRIMASK_AS_CRITICAL_SECTION == 1)
-        __set_PRIMASK(primask_bit); /**< Restore PRIMASK bit*/
-#endif
-        HW_TS_Start(local_current_running_timer_id, aTimerContext[local_current_running_timer_id].CounterInit);
+      aTimerContext[expired_timer_id].Expiry = WheelTime + aTimerContext[expired_timer_id].CounterInit;
+      InsertTimer(expired_timer_id);
+    }
+    else
+    {
+      aTimerContext[expired_timer_id].TimerIDStatus = TimerID_Created;
+    }
 
-        /* Disable the write protection for RTC registers */
-        __HAL_RTC_WRITEPROTECTION_DISABLE( phrtc );
-        }
-      else
-      {
 #if (CFG_HW_TS_USE_PRIMASK_AS_CRITICAL_SECTION == 1)
-        __set_PRIMASK(primask_bit); /**< Restore PRIMASK bit*/
+    __set_PRIMASK(primask_bit); /**< Restore PRIMASK bit*/
 #endif
-        HW_TS_Stop(local_current_running_timer_id);
 
-        /* Disable the write protection for RTC registers */
-        __HAL_RTC_WRITEPROTECTION_DISABLE( phrtc );
-        }
+    HW_TS_RTC_Int_AppNot(timer_process_id, expired_timer_id, ptimer_callback);
 
-      HW_TS_RTC_Int_AppNot(timer_process_id, local_current_running_timer_id, ptimer_callback);
-    }
-    else
-    {
-      RescheduleTimerList();
 #if (CFG_HW_TS_USE_PRIMASK_AS_CRITICAL_SECTION == 1)
-      __set_PRIMASK(primask_bit); /**< Restore PRIMASK bit*/
+    __disable_irq();          /**< Disable all interrupts by setting PRIMASK bit on Cortex*/
 #endif
-    }
+
+    /* Disable the write protection for RTC registers */
+    __HAL_RTC_WRITEPROTECTION_DISABLE( phrtc );
+
+    nbr_expired_timer++;
+    expired_timer_id = aWheelList[WHEEL_EXPIRED_LIST];
   }
-  else
-  {
-    /**
-     * We should never end up in this case
-     * However, if due to any bug in the timer server this is the case, the mistake may not impact the user.
-     * We could just clean the interrupt flag and get out from this unexpected interrupt
-     */
-    while(__HAL_RTC_WAKEUPTIMER_GET_FLAG(phrtc, RTC_FLAG_WUTWF) == RESET);
 
-    /**
-     * make sure to clear the flags after checking the WUTWF.
-     * It takes 2 RTCCLK between the time the WUTE bit is disabled and the
-     * time the timer is disabled. The WUTWF bit somehow guarantee the system is stable
-     * Otherwise, when the timer is periodic with 1 Tick, it may generate an extra interrupt in between
-     * due to the autoreload feature
-     */
-    __HAL_RTC_WAKEUPTIMER_CLEAR_FLAG(phrtc, RTC_FLAG_WUTF);   /**<  Clear flag in RTC module */
-    __HAL_RTC_WAKEUPTIMER_EXTI_CLEAR_FLAG(); /**<  Clear flag in EXTI module */
+  RescheduleTimerList();
 
 #if (CFG_HW_TS_USE_PRIMASK_AS_CRITICAL_SECTION == 1)
-    __set_PRIMASK(primask_bit); /**< Restore PRIMASK bit*/
+  __set_PRIMASK(primask_bit); /**< Restore PRIMASK bit*/
 #endif
-  }
 
   /* Enable the write protection for RTC registers */
   __HAL_RTC_WRITEPROTECTION_ENABLE( phrtc );
@@ -586,7 +822,7 @@ void HW_TS_RTC_Wakeup_Handler(void)
 
 void HW_TS_Init(HW_TS_InitMode_t TimerInitMode, RTC_HandleTypeDef *hrtc)
 {
-  uint8_t loop;
+  uint16_t loop;
   uint32_t localmaxwakeuptimersetup;
 
   /**
@@ -633,6 +869,9 @@ void HW_TS_Init(HW_TS_InitMode_t TimerInitMode, RTC_HandleTypeDef *hrtc)
   {
     WakeupTimerLimitation = WakeupTimerValue_LargeEnough;
     SSRValueOnLastSetup = SSR_FORBIDDEN_VALUE;
+    TimeOnLastSetup = 0;
+    WheelTime = 0;
+    WakeupEventTime = WHEEL_NO_EVENT;
 
     /**
      * Initialize the timer server
@@ -640,9 +879,20 @@ void HW_TS_Init(HW_TS_InitMode_t TimerInitMode, RTC_HandleTypeDef *hrtc)
     for(loop = 0; loop < CFG_HW_TS_MAX_NBR_CONCURRENT_TIMER; loop++)
     {
       aTimerContext[loop].TimerIDStatus = TimerID_Free;
+      aTimerContext[loop].ListID = WHEEL_NO_LIST;
     }
 
-    CurrentRunningTimerID = CFG_HW_TS_MAX_NBR_CONCURRENT_TIMER;   /**<  Set ID to non valid value */
+    for(loop = 0; loop < (WHEEL_EXPIRED_LIST + 1); loop++)
+    {
+      aWheelList[loop] = WHEEL_NO_TIMER;
+    }
+
+    for(loop = 0; loop < WHEEL_LEVEL_NBR; loop++)
+    {
+      aWheelBitmap[loop] = 0;
+    }
+
+    ExpiredListTailID = WHEEL_NO_TIMER;
 
     __HAL_RTC_WAKEUPTIMER_DISABLE(phrtc);                       /**<  Disable the Wakeup Timer */
     __HAL_RTC_WAKEUPTIMER_CLEAR_FLAG(phrtc, RTC_FLAG_WUTF);     /**<  Clear flag in RTC module */
@@ -726,8 +976,6 @@ void HW_TS_Delete(uint8_t timer_id)
 
 void HW_TS_Stop(uint8_t timer_id)
 {
-  uint8_t localcurrentrunningtimerid;
-
 #if (CFG_HW_TS_USE_PRIMASK_AS_CRITICAL_SECTION == 1)
   uint32_t primask_bit;
 #endif
@@ -744,43 +992,16 @@ void HW_TS_Stop(uint8_t timer_id)
 
   if(aTimerContext[timer_id].TimerIDStatus == TimerID_Running)
   {
-    UnlinkTimer(timer_id, SSR_Read_Requested);
-    localcurrentrunningtimerid = CurrentRunningTimerID;
-
-    if(localcurrentrunningtimerid == CFG_HW_TS_MAX_NBR_CONCURRENT_TIMER)
-    {
-      /**
-       * List is empty
-       */
-
-      /**
-       * Disable the timer
-       */
-      if((READ_BIT(RTC->CR, RTC_CR_WUTE) == (RTC_CR_WUTE)) == SET)
-      {
-        /**
-         * Wait for the flag to be back to 0 when the wakeup timer is enabled
-         */
-        while(__HAL_RTC_WAKEUPTIMER_GET_FLAG(phrtc, RTC_FLAG_WUTWF) == SET);
-      }
-      __HAL_RTC_WAKEUPTIMER_DISABLE(phrtc);   /**<  Disable the Wakeup Timer */
-
-      while(__HAL_RTC_WAKEUPTIMER_GET_FLAG(phrtc, RTC_FLAG_WUTWF) == RESET);
+    UnlinkTimer(timer_id);
+    aTimerContext[timer_id].TimerIDStatus = TimerID_Created;
 
-      /**
-       * make sure to clear the flags after checking the WUTWF.
-       * It takes 2 RTCCLK between the time the WUTE bit is disabled and the
-       * time the timer is disabled. The WUTWF bit somehow guarantee the system is stable
-       * Otherwise, when the timer is periodic with 1 Tick, it may generate an extra interrupt in between
-       * due to the autoreload feature
-       */
-      __HAL_RTC_WAKEUPTIMER_CLEAR_FLAG(phrtc, RTC_FLAG_WUTF);   /**<  Clear flag in RTC module */
-      __HAL_RTC_WAKEUPTIMER_EXTI_CLEAR_FLAG(); /**<  Clear flag in EXTI module */
-      HAL_NVIC_ClearPendingIRQ(CFG_HW_TS_RTC_WAKEUP_HANDLER_ID);   /**<  Clear pending bit in NVIC */
-    }
-    else if(PreviousRunningTimerID != localcurrentrunningtimerid)
+    /**
+     * The wakeup timer is not reprogrammed when other timers are still running. If the stopped timer was
+     * the next one to expire, the wakeup timer interrupt only reschedules the wheel
+     */
+    if(IsWheelEmpty() == TRUE)
     {
-      RescheduleTimerList();
+      StopWakeupCounter();
     }
   }
 
@@ -798,9 +1019,6 @@ void HW_TS_Stop(uint8_t timer_id)
 
 void HW_TS_Start(uint8_t timer_id, uint32_t timeout_ticks)
 {
-  uint16_t time_elapsed;
-  uint8_t localcurrentrunningtimerid;
-
 #if (CFG_HW_TS_USE_PRIMASK_AS_CRITICAL_SECTION == 1)
   uint32_t primask_bit;
 #endif
@@ -822,21 +1040,18 @@ void HW_TS_Start(uint8_t timer_id, uint32_t timeout_ticks)
 
   aTimerContext[timer_id].TimerIDStatus = TimerID_Running;
 
-  aTimerContext[timer_id].CountLeft = timeout_ticks;
   aTimerContext[timer_id].CounterInit = timeout_ticks;
+  aTimerContext[timer_id].Expiry = ReturnCurrentTime() + timeout_ticks;
 
-  time_elapsed =  linkTimer(timer_id);
+  InsertTimer(timer_id);
 
-  localcurrentrunningtimerid = CurrentRunningTimerID;
-
-  if(PreviousRunningTimerID != localcurrentrunningtimerid)
+  /**
+   * The wakeup timer is reprogrammed only when the new timer expires before the next programmed event
+   */
+  if(aTimerContext[timer_id].Expiry < WakeupEventTime)
   {
     RescheduleTimerList();
   }
-  else
-  {
-    aTimerContext[timer_id].CountLeft -= time_elapsed;
-  }
 
   /* Enable the write protection for RTC registers */
   __HAL_RTC_WRITEPROTECTION_ENABLE( phrtc );
@@ -251,6 +251,20 @@
 #define CFG_TLBLE_MOST_EVENT_PAYLOAD_SIZE 255   /**< Set to 255 with the memory manager and the mailbox */
 
 #define TL_BLE_EVENT_FRAME_SIZE ( TL_EVT_HDR_SIZE + CFG_TLBLE_MOST_EVENT_PAYLOAD_SIZE )
+
+/**
+ * Maximum number of asynchronous events reported to the application on each call of hci_user_evt_proc()
+ * When set to 1, the events are reported one by one to give the opportunity to run other background tasks
+ * between each event. A higher value reduces the scheduler and IPCC overhead under heavy traffic as all buffers
+ * released during the call are sent back to the CPU2 with a single notification.
+ */
+#define CFG_TLBLE_EVT_DRAIN_MAX_NBR     8
+
+/**
+ * Maximum time in us spent in hci_user_evt_proc() to report events. When set to 0, there is no time limit
+ * and only CFG_TLBLE_EVT_DRAIN_MAX_NBR applies. When not 0, hci_get_timestamp_us() shall be implemented
+ */
+#define CFG_TLBLE_EVT_DRAIN_BUDGET_US   0
 /******************************************************************************
  * UART interfaces
  ******************************************************************************/
@@ -64,7 +64,13 @@ typedef enum
 #define C_RESSOURCE_FUOTA_SEND             "FUOTA_SEND"
 
 #define FUOTA_NUMBER_WORDS_64BITS                50
-#define FUOTA_PAYLOAD_SIZE                FUOTA_NUMBER_WORDS_64BITS * 8
+#define FUOTA_PAYLOAD_SIZE                (FUOTA_NUMBER_WORDS_64BITS * 8)
+
+/* Each block is preceded by its offset in the binary, the blocks may arrive in
+ * any order and a block may be received again when its acknowledgment is lost. */
+#define FUOTA_BLOCK_HEADER_SIZE           4U
+#define FUOTA_BLOCK_MAX                   ((0x100000U / FUOTA_PAYLOAD_SIZE) + 1U) /* 1 Mbyte flash */
+#define FUOTA_BLOCK_MAP_WORDS             ((FUOTA_BLOCK_MAX + 31U) / 32U)
 
 #define LED_TOGGLE_TIMING                  (0.1*1000*1000/CFG_TS_TICK_VAL) /**< 0.5s */
 
@@ -121,7 +127,8 @@ static void APP_THREAD_CoapReqHandlerFuota(otCoapHeader        * pHeader,
     otMessage           * pMessage,
     const otMessageInfo * pMessageInfo);
 static void APP_THREAD_CoapSendDataResponseFuota(otCoapHeader    * pRequestHeader,
-    const otMessageInfo * pMessageInfo);
+    const otMessageInfo * pMessageInfo,
+    otCoapCode            CoapCode);
 
 static void APP_THREAD_CoapReqHandlerFuotaParameters(otCoapHeader * pHeader,
     otMessage            * pMessage,
@@ -170,10 +177,11 @@ static otCoapHeader  OT_Header = {0};
 static otMessage* pOT_Message = NULL;
 
 static uint8_t TimerID;
-static uint32_t FuotaBinData_index = 0;
 static uint64_t FuotaTransferArray[FUOTA_NUMBER_WORDS_64BITS] = {0};
 static APP_THREAD_OtaContext_t OtaContext;
-static uint32_t flash_current_offset = 0;
+static uint32_t FuotaBlockCount = 0;
+static uint32_t FuotaBlockReceived = 0;
+static uint32_t FuotaBlockMap[FUOTA_BLOCK_MAP_WORDS] = {0};
 /* USER CODE END PV */
 
 /* Functions Definition ------------------------------------------------------*/
@@ -673,6 +681,9 @@ static void APP_THREAD_CoapReqHandlerFuotaParameters(otCoapHeader * pHeader,
   if (APP_THREAD_CheckDeviceCapabilities() == APP_THREAD_OK)
   {
     OT_Command = APP_THREAD_OK;
+    FuotaBlockCount = (OtaContext.binary_size + FUOTA_PAYLOAD_SIZE - 1U) / FUOTA_PAYLOAD_SIZE;
+    FuotaBlockReceived = 0;
+    memset(FuotaBlockMap, 0, sizeof(FuotaBlockMap));
     HW_TS_Start(TimerID, (uint32_t)LED_TOGGLE_TIMING);
   }
   else
@@ -718,7 +729,8 @@ static APP_THREAD_StatusTypeDef APP_THREAD_CheckDeviceCapabilities(void)
   APP_DBG("Server requests    : %d bytes", OtaContext.binary_size);
   APP_DBG("Client Free memory : %d bytes", free_size);
 
-  if (free_size < OtaContext.binary_size)
+  if ((free_size < OtaContext.binary_size) ||
+      (OtaContext.binary_size > (FUOTA_BLOCK_MAX * FUOTA_PAYLOAD_SIZE)))
   {
     status = APP_THREAD_ERROR;
     APP_DBG("WARNING: Not enough Free Flash Memory available to download binary from Server!");
@@ -745,65 +757,74 @@ static void APP_THREAD_CoapReqHandlerFuota(otCoapHeader * pHeader,
 {
   bool l_end_full_bin_transfer = FALSE;
   uint32_t flash_index = 0;
+  uint32_t flash_current_offset = 0;
+  uint32_t block;
   uint64_t l_read64 = 0;
 
-  if (otMessageRead(pMessage, otMessageGetOffset(pMessage), &FuotaTransferArray, FUOTA_PAYLOAD_SIZE) != FUOTA_PAYLOAD_SIZE)
+  if ((otMessageRead(pMessage, otMessageGetOffset(pMessage), &flash_current_offset, FUOTA_BLOCK_HEADER_SIZE) != FUOTA_BLOCK_HEADER_SIZE) ||
+      (otMessageRead(pMessage, otMessageGetOffset(pMessage) + FUOTA_BLOCK_HEADER_SIZE, &FuotaTransferArray, FUOTA_PAYLOAD_SIZE) != FUOTA_PAYLOAD_SIZE))
   {
     APP_THREAD_Error(ERR_THREAD_MESSAGE_READ, 0);
   }
 
-  /* Test if magic Keyword is in FuotaBinData */
-  for (int index = 0; index < FUOTA_NUMBER_WORDS_64BITS; ++index) {
-    if((FuotaTransferArray[index] & 0x00000000FFFFFFFF) == OtaContext.magic_keyword)
-    {
-      APP_DBG("1 - FUOTA_MAGIC_KEYWORD found at flash_current_offset = %d", (FuotaBinData_index + index)*8);
-      l_end_full_bin_transfer = TRUE;
-    }
-    else
-    if (((FuotaTransferArray[index] & 0xFFFFFFFF00000000) >> 32) == OtaContext.magic_keyword)
+  block = flash_current_offset / FUOTA_PAYLOAD_SIZE;
+  if (((flash_current_offset % FUOTA_PAYLOAD_SIZE) != 0U) || (block >= FuotaBlockCount))
+  {
+    APP_DBG("FUOTA: block at offset %d is out of the binary, ignored", flash_current_offset);
+    if (otCoapHeaderGetType(pHeader) == OT_COAP_TYPE_CONFIRMABLE)
     {
-      APP_DBG("2 - FUOTA_MAGIC_KEYWORD found at flash_current_offset = %d", (FuotaBinData_index + index)*8);
-      l_end_full_bin_transfer = TRUE;
+      /* Stops the retransmissions of the request */
+      APP_THREAD_CoapSendDataResponseFuota(pHeader, pMessageInfo, OT_COAP_CODE_BAD_REQUEST);
     }
+    return;
   }
 
-  FuotaBinData_index += FUOTA_NUMBER_WORDS_64BITS;
-
-  /* Write to Flash Memory */
-  for(flash_index = 0; flash_index < FUOTA_NUMBER_WORDS_64BITS; flash_index++)
+  /* A block already written is only acknowledged again */
+  if ((FuotaBlockMap[block / 32U] & (1UL << (block % 32U))) == 0U)
   {
-    while( LL_HSEM_1StepLock( HSEM, CFG_HW_FLASH_SEMID ) );
-    HAL_FLASH_Unlock();
-    while(LL_FLASH_IsActiveFlag_OperationSuspended());
-
-    if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD,
-        OtaContext.base_address + flash_current_offset,
-        FuotaTransferArray[flash_index]) == HAL_OK)
+    /* Write to Flash Memory */
+    for(flash_index = 0; flash_index < FUOTA_NUMBER_WORDS_64BITS; flash_index++)
     {
-      /* Read back value for verification */
-      l_read64 = *(uint64_t*)(OtaContext.base_address + flash_current_offset);
-      if(l_read64 != FuotaTransferArray[flash_index])
+      while( LL_HSEM_1StepLock( HSEM, CFG_HW_FLASH_SEMID ) );
+      HAL_FLASH_Unlock();
+      while(LL_FLASH_IsActiveFlag_OperationSuspended());
+
+      if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD,
+          OtaContext.base_address + flash_current_offset,
+          FuotaTransferArray[flash_index]) == HAL_OK)
       {
-        APP_DBG("FLASH: Comparison failed l_read64 = 0x%jx / ram_array = 0x%jx", l_read64, FuotaTransferArray[flash_index])
-                  APP_THREAD_Error(ERR_THREAD_MSG_COMPARE_FAILED,0);
+        /* Read back value for verification */
+        l_read64 = *(uint64_t*)(OtaContext.base_address + flash_current_offset);
+        if(l_read64 != FuotaTransferArray[flash_index])
+        {
+          APP_DBG("FLASH: Comparison failed l_read64 = 0x%jx / ram_array = 0x%jx", l_read64, FuotaTransferArray[flash_index])
+                    APP_THREAD_Error(ERR_THREAD_MSG_COMPARE_FAILED,0);
+        }
       }
+      else
+      {
+        APP_DBG("HAL_FLASH_Program FAILED at flash_index = %d", flash_index)
+        APP_THREAD_Error(ERR_THREAD_FLASH_PROGRAM,0);
+      }
+
+      HAL_FLASH_Lock();
+      LL_HSEM_ReleaseLock( HSEM, CFG_HW_FLASH_SEMID, 0 );
+
+      flash_current_offset += 8;
     }
-    else
+
+    FuotaBlockMap[block / 32U] |= (1UL << (block % 32U));
+    FuotaBlockReceived++;
+    if (FuotaBlockReceived == FuotaBlockCount)
     {
-      APP_DBG("HAL_FLASH_Program FAILED at flash_index = %d", flash_index)
-      APP_THREAD_Error(ERR_THREAD_FLASH_PROGRAM,0);
+      l_end_full_bin_transfer = TRUE;
     }
-
-    HAL_FLASH_Lock();
-    LL_HSEM_ReleaseLock( HSEM, CFG_HW_FLASH_SEMID, 0 );
-
-    flash_current_offset += 8;
   }
 
   /* If Message is Confirmable, send response */
   if (otCoapHeaderGetType(pHeader) == OT_COAP_TYPE_CONFIRMABLE)
   {
-    APP_THREAD_CoapSendDataResponseFuota(pHeader, pMessageInfo);
+    APP_THREAD_CoapSendDataResponseFuota(pHeader, pMessageInfo, OT_COAP_CODE_CHANGED);
   }
 
   if(l_end_full_bin_transfer == TRUE)
@@ -817,16 +838,18 @@ static void APP_THREAD_CoapReqHandlerFuota(otCoapHeader * pHeader,
  *    back to the sender.
  * @param  pRequestHeader coap header
  * @param  pMessageInfo message info pointer
+ * @param  CoapCode response code, OT_COAP_CODE_CHANGED when the block is written
  * @retval None
  */
 static void APP_THREAD_CoapSendDataResponseFuota(otCoapHeader    * pRequestHeader,
-    const otMessageInfo * pMessageInfo)
+    const otMessageInfo * pMessageInfo,
+    otCoapCode            CoapCode)
 {
   otError  error = OT_ERROR_NONE;
   static otCoapHeader  OT_Header = {0};
 
   do{
-    otCoapHeaderInit(&OT_Header, OT_COAP_TYPE_ACKNOWLEDGMENT, OT_COAP_CODE_CHANGED);
+    otCoapHeaderInit(&OT_Header, OT_COAP_TYPE_ACKNOWLEDGMENT, CoapCode);
     otCoapHeaderSetMessageId(&OT_Header, otCoapHeaderGetMessageId(pRequestHeader));
     otCoapHeaderSetToken(&OT_Header,
         otCoapHeaderGetToken(pRequestHeader),
@@ -81,6 +81,53 @@ typedef enum
 #define FUOTA_NUMBER_WORDS_64BITS                50
 #define FUOTA_PAYLOAD_SIZE                (FUOTA_NUMBER_WORDS_64BITS * 8)
 
+/* Each block is preceded by its offset in the binary, so that the blocks can be
+ * received in any order. Up to FUOTA_WINDOW_MAX blocks are outstanding (each
+ * one holds messages buffers on CPU2 until acknowledged). The window grows by
+ * one block once a window of blocks is acknowledged, and shrinks by a quarter on
+ * a loss or on a RTT above the retransmission timeout estimate, i.e. when the
+ * CoAP layer had to retransmit. The lost blocks are sent again. */
+#define FUOTA_BLOCK_HEADER_SIZE           4U
+#define FUOTA_BLOCK_MAX                   ((0x100000U / FUOTA_PAYLOAD_SIZE) + 1U) /* 1 Mbyte flash */
+#define FUOTA_BLOCK_MAP_WORDS             ((FUOTA_BLOCK_MAX + 31U) / 32U)
+#ifndef FUOTA_WINDOW_MAX
+#define FUOTA_WINDOW_MAX                  4U
+#endif
+#if (FUOTA_WINDOW_MAX > 8U)
+#error "FUOTA_WINDOW_MAX: one response handler is defined per slot, up to 8"
+#endif
+#define FUOTA_WINDOW_INIT                 2U
+/* Transfer aborted after this number of losses in a row */
+#define FUOTA_LOSS_MAX                    10U
+/* Delay before sending again when no block could be sent, in ms */
+#define FUOTA_RETRY_DELAY                 100U
+
+typedef struct
+{
+  bool     busy;
+  uint32_t block;
+  uint32_t send_tick;
+} APP_THREAD_FuotaSlot_t;
+
+typedef struct
+{
+  uint32_t block_count;
+  uint32_t next_block;          /* first block never sent */
+  uint32_t acked_count;
+  uint32_t resend_count;        /* blocks set in resend_map */
+  uint32_t outstanding;
+  uint32_t window;
+  uint32_t window_credit;       /* blocks acknowledged since the window grew */
+  uint32_t decrease_tick;
+  uint32_t srtt;                /* ms */
+  uint32_t rttvar;              /* ms */
+  uint32_t losses;              /* in a row */
+  uint32_t retransmissions;
+  uint32_t acked_map[FUOTA_BLOCK_MAP_WORDS];
+  uint32_t resend_map[FUOTA_BLOCK_MAP_WORDS];
+  APP_THREAD_FuotaSlot_t slot[FUOTA_WINDOW_MAX];
+} APP_THREAD_FuotaTransfer_t;
+
 typedef void (*CoapRespHandlerCallback) (otCoapHeader * pHeader, otMessage * pMessage,const otMessageInfo * pMessageInfo,otError Result);
 /* USER CODE END PD */
 
@@ -117,7 +164,7 @@ static void RxCpltCallback(void);
 #endif /* (CFG_USB_INTERFACE_ENABLE != 0) */
 
 /* USER CODE BEGIN PFP */
-static void APP_THREAD_CoapSendRequest(otCoapResource* pCoapRessource,
+static otError APP_THREAD_CoapSendRequest(otCoapResource* pCoapRessource,
     otCoapType CoapType,
     otCoapCode CoapCode,
     otIp6Address* Ip6Address,
@@ -141,10 +188,9 @@ static void APP_THREAD_CoapDummyRespHandler(void * p_context,
     const otMessageInfo * pMessageInfo,
     otError Result);
 
-static void APP_THREAD_CoapRespHandlerFuotaSend(otCoapHeader        * pHeader,
-    otMessage           * pMessage,
-    const otMessageInfo * pMessageInfo,
-    otError             Result);
+static void APP_THREAD_FuotaBlockDone(uint32_t slot, otError Result);
+static otError APP_THREAD_FuotaSendBlock(uint32_t slot, uint32_t block);
+static bool APP_THREAD_FuotaNextBlock(uint32_t * pBlock);
 static void APP_THREAD_CoapRespHandlerFuotaReboot(otCoapHeader        * pHeader,
     otMessage           * pMessage,
     const otMessageInfo * pMessageInfo,
@@ -204,7 +250,8 @@ static uint16_t OT_BufferIdSend = 1U;
 
 static otIp6Address   OT_PeerAddress = { .mFields.m8 = { 0 } };
 
-static uint64_t FuotaTransferArray[FUOTA_NUMBER_WORDS_64BITS] = {0};
+static uint8_t FuotaBlockBuffer[FUOTA_BLOCK_HEADER_SIZE + FUOTA_PAYLOAD_SIZE];
+static APP_THREAD_FuotaTransfer_t FuotaTransfer;
 
 static APP_THREAD_OtaContext_t OtaContext;
 /* USER CODE END PV */
@@ -539,9 +586,9 @@ static void APP_THREAD_CheckWirelessFirmwareInfo(void)
  * @param[in]  Size             Size of the transfer in bytes.
  * @param[in]  RespHandlerCb    Callback function called in case of confirmable message.
  *
- * @retval none.
+ * @retval OT_ERROR_NONE when the request is sent, the error otherwise (no message buffer left).
  */
-static void APP_THREAD_CoapSendRequest(otCoapResource* pCoapRessource,
+static otError APP_THREAD_CoapSendRequest(otCoapResource* pCoapRessource,
     otCoapType CoapType,
     otCoapCode CoapCode,
     otIp6Address* Ip6Address,
@@ -573,7 +620,7 @@ static void APP_THREAD_CoapSendRequest(otCoapResource* pCoapRessource,
     pOT_Message = otCoapNewMessage(NULL, &OT_Header);
     if (pOT_Message == NULL)
     {
-      APP_THREAD_Error(ERR_THREAD_COAP_NEW_MSG,error);
+      error = OT_ERROR_NO_BUFS;
       break;
     }
 
@@ -582,7 +629,6 @@ static void APP_THREAD_CoapSendRequest(otCoapResource* pCoapRessource,
       error = otMessageAppend(pOT_Message, Payload, Size);
       if (error != OT_ERROR_NONE)
       {
-        APP_THREAD_Error(ERR_THREAD_COAP_APPEND,error);
         break;
       }
     }
@@ -615,8 +661,8 @@ static void APP_THREAD_CoapSendRequest(otCoapResource* pCoapRessource,
   if (error != OT_ERROR_NONE && pOT_Message != NULL)
   {
     otMessageFree(pOT_Message);
-    APP_THREAD_Error(ERR_THREAD_COAP_SEND_REQUEST,error);
   }
+  return error;
 }
 
 /**
@@ -671,7 +717,9 @@ static void APP_THREAD_ProvisioningRespHandler(otCoapHeader        * pHeader,
 }
 
 /**
- * @brief This function manages the response handler for FUOTA binary datas.
+ * @brief Response handlers for FUOTA binary datas. The response handler doesn't
+ *        get a context, so each slot of the window has its own to know which
+ *        block is acknowledged or lost.
  *
  * @param pHeader  header
  * @param pMessage message pointer
@@ -679,19 +727,112 @@ static void APP_THREAD_ProvisioningRespHandler(otCoapHeader        * pHeader,
  * @param Result error code
  * @retval None
  */
-static void APP_THREAD_CoapRespHandlerFuotaSend(otCoapHeader        * pHeader,
-    otMessage           * pMessage,
-    const otMessageInfo * pMessageInfo,
-    otError             Result)
+#define FUOTA_SLOT_RESP_HANDLER(n)                                              \
+static void APP_THREAD_CoapRespHandlerFuotaSlot##n(otCoapHeader * pHeader,      \
+    otMessage           * pMessage,                                             \
+    const otMessageInfo * pMessageInfo,                                         \
+    otError             Result)                                                 \
+{                                                                               \
+  UNUSED(pHeader);                                                              \
+  UNUSED(pMessage);                                                             \
+  UNUSED(pMessageInfo);                                                         \
+  APP_THREAD_FuotaBlockDone(n, Result);                                         \
+}
+
+FUOTA_SLOT_RESP_HANDLER(0)
+FUOTA_SLOT_RESP_HANDLER(1)
+FUOTA_SLOT_RESP_HANDLER(2)
+FUOTA_SLOT_RESP_HANDLER(3)
+FUOTA_SLOT_RESP_HANDLER(4)
+FUOTA_SLOT_RESP_HANDLER(5)
+FUOTA_SLOT_RESP_HANDLER(6)
+FUOTA_SLOT_RESP_HANDLER(7)
+
+static const CoapRespHandlerCallback FuotaSlotRespHandler[8] =
+{
+  &APP_THREAD_CoapRespHandlerFuotaSlot0, &APP_THREAD_CoapRespHandlerFuotaSlot1,
+  &APP_THREAD_CoapRespHandlerFuotaSlot2, &APP_THREAD_CoapRespHandlerFuotaSlot3,
+  &APP_THREAD_CoapRespHandlerFuotaSlot4, &APP_THREAD_CoapRespHandlerFuotaSlot5,
+  &APP_THREAD_CoapRespHandlerFuotaSlot6, &APP_THREAD_CoapRespHandlerFuotaSlot7
+};
+
+/**
+ * @brief Updates the transfer state when the exchange of a block ends.
+ * @param slot   slot of the window used by the block
+ * @param Result error code
+ * @retval None
+ */
+static void APP_THREAD_FuotaBlockDone(uint32_t slot, otError Result)
 {
+  APP_THREAD_FuotaTransfer_t * p_transfer = &FuotaTransfer;
+  APP_THREAD_FuotaSlot_t * p_slot = &p_transfer->slot[slot];
+  uint32_t now = HAL_GetTick();
+  uint32_t rtt = now - p_slot->send_tick;
+  uint32_t block = p_slot->block;
+  bool congestion = FALSE;
+
+  if (p_slot->busy == FALSE)
+  {
+    return;
+  }
+  p_slot->busy = FALSE;
+  p_transfer->outstanding--;
+
   if (Result == OT_ERROR_NONE)
   {
-    UTIL_SEQ_SetEvt(EVENT_TRANSFER_64BITS_DONE);
+    p_transfer->losses = 0U;
+    if ((p_transfer->acked_map[block / 32U] & (1UL << (block % 32U))) == 0U)
+    {
+      p_transfer->acked_map[block / 32U] |= (1UL << (block % 32U));
+      p_transfer->acked_count++;
+    }
+
+    /* RFC 6298 estimators, a RTT above the timeout means a CoAP retransmission */
+    if (p_transfer->srtt == 0U)
+    {
+      p_transfer->srtt = rtt;
+      p_transfer->rttvar = rtt / 2U;
+    }
+    else
+    {
+      congestion = (rtt > (p_transfer->srtt + (4U * p_transfer->rttvar))) ? TRUE : FALSE;
+      p_transfer->rttvar = ((3U * p_transfer->rttvar) +
+          ((rtt > p_transfer->srtt) ? (rtt - p_transfer->srtt) : (p_transfer->srtt - rtt))) / 4U;
+      p_transfer->srtt = ((7U * p_transfer->srtt) + rtt) / 8U;
+    }
   }
   else
   {
-    APP_DBG("APP_THREAD_CoapRespHandlerFuotaSend : WARNING Result %d", Result);
+    APP_DBG("FUOTA block %d lost, Result %d", block, Result);
+    p_transfer->losses++;
+    p_transfer->retransmissions++;
+    p_transfer->resend_map[block / 32U] |= (1UL << (block % 32U));
+    p_transfer->resend_count++;
+    congestion = TRUE;
+  }
+
+  if (congestion == TRUE)
+  {
+    /* Once per RTT, the blocks sent before the decrease see the same loss */
+    if ((now - p_transfer->decrease_tick) >= p_transfer->srtt)
+    {
+      /* Most losses are not due to congestion, a quarter is given back */
+      p_transfer->window -= (p_transfer->window + 2U) / 4U;
+      p_transfer->window_credit = 0U;
+      p_transfer->decrease_tick = now;
+    }
   }
+  else if (p_transfer->window < FUOTA_WINDOW_MAX)
+  {
+    p_transfer->window_credit++;
+    if (p_transfer->window_credit >= p_transfer->window)
+    {
+      p_transfer->window++;
+      p_transfer->window_credit = 0U;
+    }
+  }
+
+  UTIL_SEQ_SetEvt(EVENT_TRANSFER_64BITS_DONE);
 }
 
 /**
@@ -804,9 +945,10 @@ static void APP_THREAD_FuotaProvisioning(void)
   APP_DBG("Send FUOTA PROVISONING request");
 
   uint8_t l_provisioning_data = 0x1;
+  otError error;
 
   /* Send a MULTICAST CONFIRMABLE GET Request */
-  APP_THREAD_CoapSendRequest(&OT_RessourceFuotaProvisioning,
+  error = APP_THREAD_CoapSendRequest(&OT_RessourceFuotaProvisioning,
       OT_COAP_TYPE_NON_CONFIRMABLE,
       OT_COAP_CODE_GET,
       NULL,
@@ -815,6 +957,10 @@ static void APP_THREAD_FuotaProvisioning(void)
       &l_provisioning_data,
       sizeof(l_provisioning_data),
       &APP_THREAD_ProvisioningRespHandler);
+  if (error != OT_ERROR_NONE)
+  {
+    APP_THREAD_Error(ERR_THREAD_COAP_SEND_REQUEST, error);
+  }
 }
 
 static uint32_t APP_THREAD_GetBinSize(void)
@@ -877,6 +1023,8 @@ static uint32_t APP_THREAD_GetBinSize(void)
  */
 static void APP_THREAD_FuotaParameters(void)
 {
+  otError error;
+
   APP_DBG("FUOTA PROVISIONING OK, Set FUOTA PARAMETERS");
 
   if(OtaContext.file_type == APP_THREAD_OTA_FILE_TYPE_FW_APP)
@@ -898,7 +1046,7 @@ static void APP_THREAD_FuotaParameters(void)
   APP_DBG("\r Base address = 0x%x", OtaContext.base_address);
 
   /* Send a CONFIRMABLE PUT Request */
-  APP_THREAD_CoapSendRequest(&OT_RessourceFuotaParameters,
+  error = APP_THREAD_CoapSendRequest(&OT_RessourceFuotaParameters,
       OT_COAP_TYPE_CONFIRMABLE,
       OT_COAP_CODE_PUT,
       &OT_PeerAddress,
@@ -907,6 +1055,93 @@ static void APP_THREAD_FuotaParameters(void)
       (uint8_t*)&OtaContext,
       sizeof(OtaContext),
       &APP_THREAD_CoapRespHandlerFuotaParameters);
+  if (error != OT_ERROR_NONE)
+  {
+    APP_THREAD_Error(ERR_THREAD_COAP_SEND_REQUEST, error);
+  }
+}
+
+/**
+ * @brief Sends a block of the binary. A block that cannot be sent is sent
+ *        again later, and the window shrinks to the blocks in flight: their
+ *        responses free the buffers.
+ * @param slot  free slot of the window
+ * @param block block index
+ * @retval OT_ERROR_NONE when the block is sent
+ */
+static otError APP_THREAD_FuotaSendBlock(uint32_t slot, uint32_t block)
+{
+  APP_THREAD_FuotaSlot_t * p_slot = &FuotaTransfer.slot[slot];
+  uint32_t offset = block * FUOTA_PAYLOAD_SIZE;
+  otError error;
+
+  /* Read data from flash memory */
+  memcpy(&FuotaBlockBuffer[0], &offset, FUOTA_BLOCK_HEADER_SIZE);
+  memcpy(&FuotaBlockBuffer[FUOTA_BLOCK_HEADER_SIZE], (uint8_t*)(OtaContext.base_address + offset), FUOTA_PAYLOAD_SIZE);
+
+  p_slot->busy = TRUE;
+  p_slot->block = block;
+  p_slot->send_tick = HAL_GetTick();
+  FuotaTransfer.outstanding++;
+
+  /* Send a CONFIRMABLE PUT Request */
+  error = APP_THREAD_CoapSendRequest(&OT_RessourceFuotaSend,
+      OT_COAP_TYPE_CONFIRMABLE,
+      OT_COAP_CODE_PUT,
+      &OT_PeerAddress,
+      NULL,
+      APP_THREAD_COAP_IP6_ADDRESS,
+      FuotaBlockBuffer,
+      sizeof(FuotaBlockBuffer),
+      FuotaSlotRespHandler[slot]);
+  if (error != OT_ERROR_NONE)
+  {
+    /* Most likely no message buffer left on CPU2: not a loss, no response will
+     * come for this slot */
+    APP_DBG("FUOTA block %d not sent, Error %d", block, error);
+    p_slot->busy = FALSE;
+    FuotaTransfer.outstanding--;
+    FuotaTransfer.resend_map[block / 32U] |= (1UL << (block % 32U));
+    FuotaTransfer.resend_count++;
+    if (FuotaTransfer.window > FuotaTransfer.outstanding)
+    {
+      FuotaTransfer.window = (FuotaTransfer.outstanding != 0U) ? FuotaTransfer.outstanding : 1U;
+      FuotaTransfer.window_credit = 0U;
+    }
+  }
+  return error;
+}
+
+/**
+ * @brief Gets the next block to send, the lost blocks first.
+ * @param pBlock block index
+ * @retval FALSE if there is no block to send
+ */
+static bool APP_THREAD_FuotaNextBlock(uint32_t * pBlock)
+{
+  APP_THREAD_FuotaTransfer_t * p_transfer = &FuotaTransfer;
+  uint32_t index;
+
+  if (p_transfer->resend_count != 0U)
+  {
+    for (index = 0U; index < FUOTA_BLOCK_MAP_WORDS; index++)
+    {
+      if (p_transfer->resend_map[index] != 0U)
+      {
+        *pBlock = (index * 32U) + (uint32_t)__CLZ(__RBIT(p_transfer->resend_map[index]));
+        p_transfer->resend_map[index] &= ~(1UL << (*pBlock % 32U));
+        p_transfer->resend_count--;
+        return TRUE;
+      }
+    }
+  }
+
+  if (p_transfer->next_block < p_transfer->block_count)
+  {
+    *pBlock = p_transfer->next_block++;
+    return TRUE;
+  }
+  return FALSE;
 }
 
 /**
@@ -916,86 +1151,82 @@ static void APP_THREAD_FuotaParameters(void)
  */
 static void APP_THREAD_FuotaSend(void)
 {
-  uint32_t flash_current_offset = 0x0;
-  bool binary_transfer_on_going = TRUE;
-  uint32_t l_debug_count = 0;
+  APP_THREAD_FuotaTransfer_t * p_transfer = &FuotaTransfer;
   uint32_t l_current_index_progress = 0;
-  uint32_t FuotaProgressArray[100] = {0};
-  uint32_t FuotaTransferArraySize = 0;
   uint32_t l_start_transfer_time = 0;
   uint32_t l_end_transfer_time = 0;
   double l_transfer_time = 0;
   double l_transfer_throughput = 0;
-  uint8_t l_Fuota_progress_multiplied = 0;
+  uint32_t slot;
+  uint32_t block;
 
   APP_DBG("FUOTA PARAMETERS SET, START FUOTA BINARY TRANSFER");
 
-  /* Number of elements in OtaContext.binary_size */
-  FuotaTransferArraySize = OtaContext.binary_size / FUOTA_PAYLOAD_SIZE;
-  APP_DBG("\r -> %d elements of %d bytes to be transferred", FuotaTransferArraySize, FUOTA_PAYLOAD_SIZE);
-  if(FuotaTransferArraySize < 100)
+  /* The response to a block of an aborted transfer would be credited to the
+   * block of the new transfer using the same slot */
+  if (p_transfer->outstanding != 0U)
   {
-    l_Fuota_progress_multiplied = 1;
-    FuotaTransferArraySize = FuotaTransferArraySize * 10;
+    APP_DBG("FUOTA: %d blocks of the aborted transfer still outstanding, try again later", p_transfer->outstanding);
+    return;
   }
-  for (int index = 1; index < 100; index++)
+
+  /* The last block holds the magic keyword */
+  memset(p_transfer, 0, sizeof(*p_transfer));
+  p_transfer->block_count = (OtaContext.binary_size + FUOTA_PAYLOAD_SIZE - 1U) / FUOTA_PAYLOAD_SIZE;
+  p_transfer->window = FUOTA_WINDOW_INIT;
+  APP_DBG("\r -> %d elements of %d bytes to be transferred", p_transfer->block_count, FUOTA_PAYLOAD_SIZE);
+  if (p_transfer->block_count > FUOTA_BLOCK_MAX)
   {
-    FuotaProgressArray[index] = (FuotaTransferArraySize / 100) * index;
+    APP_DBG("FUOTA: binary too large, aborting!");
+    return;
   }
 
   l_start_transfer_time = HAL_GetTick();
 
-  while(binary_transfer_on_going == TRUE){
-
-    /* Get data to be sent */
-    /* Read data from flash memory */
-    memcpy(FuotaTransferArray, (uint8_t*)(OtaContext.base_address + flash_current_offset), FUOTA_PAYLOAD_SIZE);
-
-    /* Send a CONFIRMABLE PUT Request */
-    APP_THREAD_CoapSendRequest(&OT_RessourceFuotaSend,
-        OT_COAP_TYPE_CONFIRMABLE,
-        OT_COAP_CODE_PUT,
-        &OT_PeerAddress,
-        NULL,
-        APP_THREAD_COAP_IP6_ADDRESS,
-        (uint8_t*)&FuotaTransferArray,
-        FUOTA_PAYLOAD_SIZE,
-        &APP_THREAD_CoapRespHandlerFuotaSend);
-
-    UTIL_SEQ_WaitEvt(EVENT_TRANSFER_64BITS_DONE);
-
-    /* Test if magic Keyword is in FuotaTransferArray */
-    for (int index = 0; index < FUOTA_NUMBER_WORDS_64BITS; ++index) {
-      if((FuotaTransferArray[index] & 0x00000000FFFFFFFF) == OtaContext.magic_keyword)
+  while (p_transfer->acked_count < p_transfer->block_count)
+  {
+    /* Fill the window */
+    for (slot = 0U; (slot < FUOTA_WINDOW_MAX) && (p_transfer->outstanding < p_transfer->window); slot++)
+    {
+      if (p_transfer->slot[slot].busy == TRUE)
       {
-        APP_DBG("1 - FUOTA_MAGIC_KEYWORD found at flash_current_offset = %d", (flash_current_offset + (index*8)));
-        binary_transfer_on_going = FALSE;
+        continue;
       }
-      else
-      if (((FuotaTransferArray[index] & 0xFFFFFFFF00000000) >> 32) == OtaContext.magic_keyword)
+      if (APP_THREAD_FuotaNextBlock(&block) == FALSE)
       {
-        APP_DBG("2 - FUOTA_MAGIC_KEYWORD found at flash_current_offset = %d", (flash_current_offset + (index*8)));
-        binary_transfer_on_going = FALSE;
+        break;
+      }
+      if (APP_THREAD_FuotaSendBlock(slot, block) != OT_ERROR_NONE)
+      {
+        break;
       }
     }
 
-    flash_current_offset += FUOTA_PAYLOAD_SIZE;
+    if (p_transfer->outstanding == 0U)
+    {
+      /* Nothing in flight, the blocks could not be sent: let CPU2 free some
+       * buffers, this counts as a loss */
+      p_transfer->losses++;
+      HAL_Delay(FUOTA_RETRY_DELAY);
+    }
+    else
+    {
+      UTIL_SEQ_WaitEvt(EVENT_TRANSFER_64BITS_DONE);
+    }
 
-    /* Display Transfer Progress */
-    if(l_debug_count == FuotaProgressArray[l_current_index_progress+1])
+    if (p_transfer->losses >= FUOTA_LOSS_MAX)
     {
-      l_current_index_progress += 1;
-      if(l_Fuota_progress_multiplied == 1)
-      {
-        APP_DBG("FUOTA Transfer %d%...", l_current_index_progress*10);
-      }
-      else
-      {
-        APP_DBG("FUOTA Transfer %d%...", l_current_index_progress);
-      }
+      APP_DBG("FUOTA: %d blocks lost in a row, aborting!", p_transfer->losses);
+      return;
     }
 
-    l_debug_count++;
+    /* Display Transfer Progress */
+    while (((l_current_index_progress + 1U) * p_transfer->block_count) <= (p_transfer->acked_count * 10U))
+    {
+      l_current_index_progress += 1U;
+      APP_DBG("FUOTA Transfer %d%%... (window %d, srtt %d ms)",
+          l_current_index_progress * 10U, p_transfer->window, p_transfer->srtt);
+    }
   }
 
   l_end_transfer_time = HAL_GetTick();
@@ -1007,9 +1238,8 @@ static void APP_THREAD_FuotaSend(void)
   APP_DBG("  - Payload size = %d bytes", FUOTA_PAYLOAD_SIZE);
   APP_DBG("  - Transfer time = %.2f seconds", l_transfer_time);
   APP_DBG("  - Average throughput = %.2f kbit/s", l_transfer_throughput);
+  APP_DBG("  - Blocks sent again = %d, final window = %d", p_transfer->retransmissions, p_transfer->window);
   APP_DBG("**************************************************************");
-
-  /* Notify end of transfer to Thread_Ota ? */
 }
 
 /**
@@ -1020,10 +1250,11 @@ static void APP_THREAD_FuotaSend(void)
 static void APP_THREAD_FuotaReboot(void)
 {
   uint32_t l_data = 0x1;
+  otError error;
   APP_DBG("Send a request to current OTA application to reboot on Thread_Ota");
 
   /* Send a CONFIRMABLE PUT Request */
-  APP_THREAD_CoapSendRequest(&OT_RessourceFuotaReboot,
+  error = APP_THREAD_CoapSendRequest(&OT_RessourceFuotaReboot,
       OT_COAP_TYPE_CONFIRMABLE,
       OT_COAP_CODE_PUT,
       NULL,
@@ -1032,6 +1263,10 @@ static void APP_THREAD_FuotaReboot(void)
       (uint8_t*)&l_data,
       sizeof(l_data),
       &APP_THREAD_CoapRespHandlerFuotaReboot);
+  if (error != OT_ERROR_NONE)
+  {
+    APP_THREAD_Error(ERR_THREAD_COAP_SEND_REQUEST, error);
+  }
 
   UTIL_SEQ_WaitEvt(EVENT_FUOTA_REBOOT_RESP_DONE);
 
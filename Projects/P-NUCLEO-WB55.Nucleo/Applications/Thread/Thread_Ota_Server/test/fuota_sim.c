@@ -0,0 +1,1358 @@
+/**
+ ******************************************************************************
+ * @file    fuota_sim.c
+ * @author  MCD Application Team
+ * @brief   FUOTA host simulator: a binary goes from Thread_Ota_Server to
+ *          Thread_Ota over a model of the CoAP layer of CPU2 (confirmable
+ *          requests retransmitted as in RFC 7252, a pool of message buffers)
+ *          and of a link losing datagrams. The simulated time only moves
+ *          forward when the applications wait.
+ *          make test : transfers on links of several quality, checked
+ *          make bench: throughput per loss rate
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "stm32wbxx_hal.h"
+#include "stm32wbxx_nucleo.h"
+#include "hw_if.h"
+#include "stm_logging.h"
+#include "openthread_api_wb.h"
+#include "shci.h"
+#include "tl.h"
+#include "stm32_lpm.h"
+#include "stm32_seq.h"
+#include "fuota_sim.h"
+
+/* CoAP of CPU2, RFC 7252 default transmission parameters */
+#define SIM_ACK_TIMEOUT                     2000U   /* ms, up to 1.5 times more */
+#define SIM_MAX_RETRANSMIT                  4U
+#define SIM_MESSAGE_NBR                     48U
+#define SIM_MESSAGE_SIZE                    512U
+#define SIM_EXCHANGE_NBR                    16U
+#define SIM_PACKET_NBR                      256U
+#define SIM_NOTIFICATION_NBR                32U
+#define SIM_LOG_SIZE                        256U
+/* A transfer lasting more than a simulated day is stuck */
+#define SIM_TIME_MAX                        (24UL * 3600UL * 1000UL)
+
+/* Flash of both devices at the same address: the server reads the binary
+ * where the client programs it. The client programs it only in the map of the
+ * doublewords written, checked against the binary. */
+#define SIM_FLASH_SIZE                      0x100000U
+#define SIM_SFSA                            0xF0U   /* First secure sector */
+#define SIM_FLASH_DWORDS                    (SIM_FLASH_SIZE / 8U)
+#define SIM_MAGIC_KEYWORD_APP               0x94448A29U
+
+typedef void (*sim_request_handler_t)(otCoapHeader *pHeader, otMessage *pMessage, const otMessageInfo *pMessageInfo);
+typedef void (*sim_response_handler_t)(otCoapHeader *pHeader, otMessage *pMessage, const otMessageInfo *pMessageInfo,
+                                       otError Result);
+
+/* Message of CPU2: the applications only see its first field */
+typedef struct
+{
+  otMessage        message;
+  bool             used;
+  fuota_sim_node_t node;
+  otCoapHeader     header;
+  uint16_t         length;
+  uint8_t          data[SIM_MESSAGE_SIZE];
+} sim_message_t;
+
+/* Confirmable request waiting for its response */
+typedef struct
+{
+  bool           active;
+  sim_message_t *request;
+  otMessageInfo  info;
+  void          *context;       /* Response handler of the application */
+  uint32_t       timeout;
+  uint32_t       transmissions;
+  uint32_t       timer;         /* Next retransmission, or end of the exchange */
+} sim_exchange_t;
+
+/* Datagram on the link */
+typedef struct
+{
+  bool             used;
+  uint32_t         tick;        /* Reception */
+  fuota_sim_node_t dest;
+  otCoapHeader     header;
+  uint16_t         length;
+  uint8_t          data[SIM_MESSAGE_SIZE];
+} sim_packet_t;
+
+/* Response handler call queued for the server */
+typedef struct
+{
+  void          *context;
+  otCoapHeader   header;
+  sim_message_t *message;
+  otError        result;
+} sim_notification_t;
+
+typedef struct
+{
+  const char *name;
+  uint32_t    loss;             /* Per mille, each way */
+  uint32_t    latency_min;      /* ms, one way */
+  uint32_t    latency_max;
+  uint32_t    buffers;          /* Message buffers of the server CPU2 */
+  uint32_t    outage;           /* ms of link down in the middle of the transfer */
+} test_link_t;
+
+#define TEST_OUTAGE_ABORT                   0xffffffffU /* Down until the transfer aborts */
+
+static const test_link_t test_links[] = {
+  { "clean link",           0U,  5U,  20U, 16U, 0U                },
+  { "5% loss",             50U,  5U,  40U, 16U, 0U                },
+  { "20% loss",           200U, 10U,  80U, 16U, 0U                },
+  { "35% loss",           350U, 10U, 120U, 16U, 0U                },
+  { "3 CPU2 buffers",      50U,  5U,  40U,  3U, 0U                },
+  { "20 s outage",         50U,  5U,  40U, 16U, 20000U            },
+  { "outage",              50U,  5U,  40U, 16U, TEST_OUTAGE_ABORT },
+};
+
+/* Simulated devices and link */
+static fuota_sim_node_t sim_node;
+static uint32_t sim_now;
+static uint32_t sim_tasks[FUOTA_SIM_NODE_NBR];
+static uint32_t sim_events;
+static const test_link_t *sim_link;
+static bool sim_link_down;
+static sim_message_t sim_messages[SIM_MESSAGE_NBR];
+static uint32_t sim_buffers[FUOTA_SIM_NODE_NBR];
+static sim_exchange_t sim_exchanges[SIM_EXCHANGE_NBR];
+static sim_packet_t sim_packets[SIM_PACKET_NBR];
+static sim_notification_t sim_notifications[SIM_NOTIFICATION_NBR];
+static uint32_t sim_notification_nbr;
+static otCoapResource *sim_resources[4];
+static uint32_t sim_resource_nbr;
+static uint32_t sim_token;
+static bool sim_verbose;
+
+/* Response of the client captured instead of sent */
+static bool sim_capture;
+static uint32_t sim_captured_nbr;
+static otCoapCode sim_captured_code;
+
+/* Flash */
+static uint8_t * const sim_flash = (uint8_t *)FLASH_BASE;
+static uint32_t sim_base;
+static uint8_t sim_programmed[SIM_FLASH_DWORDS / 8U];
+static uint32_t sim_program_nbr;
+
+/* Statistics of a transfer */
+static unsigned long sim_requests, sim_send_failures, sim_drops, sim_late, sim_timeouts, sim_completed;
+
+/* The parameters of a new transfer reset the blocks received, not the
+ * blocks acknowledged */
+static bool test_sending;
+
+static void test_check_transfer(void);
+static void test_outage_check(void);
+
+void fuota_sim_fail(const char *msg, unsigned long arg)
+{
+  printf("FAIL: %s (%lu) at %lu ms, link %s\n", msg, arg, (unsigned long)sim_now,
+         (sim_link != NULL) ? sim_link->name : "-");
+  exit(1);
+}
+
+void fuota_sim_set_node(fuota_sim_node_t node)
+{
+  sim_node = node;
+}
+
+bool fuota_sim_take_task(fuota_sim_node_t node, uint32_t task)
+{
+  bool set = (sim_tasks[node] & task) != 0U;
+
+  sim_tasks[node] &= ~task;
+  return set;
+}
+
+void fuota_sim_reset(void)
+{
+  fuota_sim_fail("unexpected reset", sim_node);
+}
+
+/* Messages --------------------------------------------------------------------*/
+/* Only the messages allocated by the server application are limited: a
+ * response received always has a buffer */
+static sim_message_t *sim_message_new(fuota_sim_node_t node, const otCoapHeader *pHeader, bool limited)
+{
+  uint32_t i;
+
+  if (limited && (sim_buffers[node] >= sim_link->buffers))
+  {
+    return NULL;
+  }
+  for (i = 0U; i < SIM_MESSAGE_NBR; i++)
+  {
+    if (!sim_messages[i].used)
+    {
+      memset(&sim_messages[i], 0, sizeof(sim_messages[i]));
+      sim_messages[i].used = true;
+      sim_messages[i].node = node;
+      sim_messages[i].header = *pHeader;
+      sim_buffers[node]++;
+      return &sim_messages[i];
+    }
+  }
+  fuota_sim_fail("message pool of the simulator", SIM_MESSAGE_NBR);
+  return NULL;
+}
+
+static void sim_message_free(sim_message_t *pMessage)
+{
+  if ((pMessage < sim_messages) || (pMessage >= &sim_messages[SIM_MESSAGE_NBR]) || !pMessage->used)
+  {
+    fuota_sim_fail("free of an unknown message", 0U);
+  }
+  pMessage->used = false;
+  sim_buffers[pMessage->node]--;
+}
+
+static sim_message_t *sim_message(otMessage *aMessage)
+{
+  sim_message_t *message = (sim_message_t *)aMessage;
+
+  if ((message < sim_messages) || (message >= &sim_messages[SIM_MESSAGE_NBR]) || !message->used)
+  {
+    fuota_sim_fail("unknown message", 0U);
+  }
+  return message;
+}
+
+/* Link ------------------------------------------------------------------------*/
+static bool sim_same_token(const otCoapHeader *pHeader1, const otCoapHeader *pHeader2)
+{
+  uint8_t length = otCoapHeaderGetTokenLength(pHeader1);
+
+  return (length == otCoapHeaderGetTokenLength(pHeader2))
+      && (memcmp(otCoapHeaderGetToken(pHeader1), otCoapHeaderGetToken(pHeader2), length) == 0);
+}
+
+static void sim_transmit(fuota_sim_node_t dest, const otCoapHeader *pHeader, const uint8_t *pData, uint16_t length)
+{
+  uint32_t i;
+
+  if (sim_link_down || (((uint32_t)rand() % 1000U) < sim_link->loss))
+  {
+    sim_drops++;
+    return;
+  }
+  for (i = 0U; i < SIM_PACKET_NBR; i++)
+  {
+    if (!sim_packets[i].used)
+    {
+      sim_packets[i].used = true;
+      sim_packets[i].tick = sim_now + sim_link->latency_min
+          + ((uint32_t)rand() % (sim_link->latency_max - sim_link->latency_min + 1U));
+      sim_packets[i].dest = dest;
+      sim_packets[i].header = *pHeader;
+      sim_packets[i].length = length;
+      memcpy(sim_packets[i].data, pData, length);
+      return;
+    }
+  }
+  fuota_sim_fail("packets in flight", SIM_PACKET_NBR);
+}
+
+static void sim_notify(void *context, const otCoapHeader *pHeader, sim_message_t *pMessage, otError result)
+{
+  sim_notification_t *notification;
+
+  if (sim_notification_nbr >= SIM_NOTIFICATION_NBR)
+  {
+    fuota_sim_fail("notifications queued", SIM_NOTIFICATION_NBR);
+  }
+  notification = &sim_notifications[sim_notification_nbr++];
+  notification->context = context;
+  notification->header = *pHeader;
+  notification->message = pMessage;
+  notification->result = result;
+}
+
+/* A request reaches the client: handler of the resource of its Uri-Path */
+static void sim_receive_request(const sim_packet_t *pPacket)
+{
+  const char *uri = (const char *)&pPacket->header.mHeader.mBytes[4U + otCoapHeaderGetTokenLength(&pPacket->header)];
+  otMessageInfo info;
+  sim_message_t *message;
+  uint32_t i;
+
+  for (i = 0U; i < sim_resource_nbr; i++)
+  {
+    if (strcmp(sim_resources[i]->mUriPath, uri) == 0)
+    {
+      break;
+    }
+  }
+  if (i == sim_resource_nbr)
+  {
+    fuota_sim_fail("request on an unknown resource", sim_resource_nbr);
+  }
+  message = sim_message_new(FUOTA_SIM_CLIENT, &pPacket->header, false);
+  message->length = pPacket->length;
+  memcpy(message->data, pPacket->data, pPacket->length);
+  memset(&info, 0, sizeof(info));
+
+  fuota_sim_set_node(FUOTA_SIM_CLIENT);
+  ((sim_request_handler_t)sim_resources[i]->mContext)(&message->header, &message->message, &info);
+  fuota_sim_set_node(FUOTA_SIM_SERVER);
+  sim_message_free(message);
+}
+
+/* A response reaches the server: end of the exchange with the same token */
+static void sim_receive_response(const sim_packet_t *pPacket)
+{
+  sim_exchange_t *exchange = NULL;
+  sim_message_t *message;
+  uint32_t i;
+
+  for (i = 0U; i < SIM_EXCHANGE_NBR; i++)
+  {
+    if (sim_exchanges[i].active && sim_same_token(&sim_exchanges[i].request->header, &pPacket->header))
+    {
+      exchange = &sim_exchanges[i];
+      break;
+    }
+  }
+  if (exchange == NULL)
+  {
+    /* Response to a retransmission, the exchange is over */
+    sim_late++;
+    return;
+  }
+  message = sim_message_new(FUOTA_SIM_SERVER, &pPacket->header, false);
+  message->length = pPacket->length;
+  memcpy(message->data, pPacket->data, pPacket->length);
+  exchange->active = false;
+  sim_message_free(exchange->request);
+  sim_notify(exchange->context, &pPacket->header, message, OT_ERROR_NONE);
+}
+
+static void sim_exchange_timer(sim_exchange_t *pExchange)
+{
+  if (pExchange->transmissions <= SIM_MAX_RETRANSMIT)
+  {
+    pExchange->transmissions++;
+    pExchange->timeout *= 2U;
+    pExchange->timer = sim_now + pExchange->timeout;
+    sim_transmit(FUOTA_SIM_CLIENT, &pExchange->request->header, pExchange->request->data, pExchange->request->length);
+    return;
+  }
+  sim_timeouts++;
+  pExchange->active = false;
+  sim_notify(pExchange->context, &pExchange->request->header, NULL, OT_ERROR_RESPONSE_TIMEOUT);
+  sim_message_free(pExchange->request);
+}
+
+/* Processes the next event of CPU2 or of the link not after the end tick,
+ * FALSE if there is none */
+static bool sim_step(uint32_t end)
+{
+  sim_packet_t *packet = NULL;
+  sim_exchange_t *exchange = NULL;
+  uint32_t tick = end;
+  uint32_t i;
+
+  for (i = 0U; i < SIM_PACKET_NBR; i++)
+  {
+    if (sim_packets[i].used && ((int32_t)(sim_packets[i].tick - tick) <= 0))
+    {
+      packet = &sim_packets[i];
+      tick = packet->tick;
+    }
+  }
+  for (i = 0U; i < SIM_EXCHANGE_NBR; i++)
+  {
+    if (sim_exchanges[i].active && ((int32_t)(sim_exchanges[i].timer - tick) < 0))
+    {
+      exchange = &sim_exchanges[i];
+      tick = exchange->timer;
+      packet = NULL;
+    }
+  }
+  if ((packet == NULL) && (exchange == NULL))
+  {
+    return false;
+  }
+  if ((int32_t)(tick - sim_now) > 0)
+  {
+    sim_now = tick;
+  }
+  if (exchange != NULL)
+  {
+    sim_exchange_timer(exchange);
+  }
+  else
+  {
+    packet->used = false;
+    if (packet->dest == FUOTA_SIM_CLIENT)
+    {
+      sim_receive_request(packet);
+    }
+    else
+    {
+      sim_receive_response(packet);
+    }
+  }
+  return true;
+}
+
+/* The server runs the response handlers queued */
+static void sim_dispatch(void)
+{
+  sim_notification_t notification;
+  otMessageInfo info;
+
+  while (sim_notification_nbr != 0U)
+  {
+    notification = sim_notifications[0];
+    sim_notification_nbr--;
+    memmove(&sim_notifications[0], &sim_notifications[1], sim_notification_nbr * sizeof(sim_notifications[0]));
+    memset(&info, 0, sizeof(info));
+
+    fuota_sim_set_node(FUOTA_SIM_SERVER);
+    ((sim_response_handler_t)notification.context)(&notification.header,
+        (notification.message != NULL) ? &notification.message->message : NULL, &info, notification.result);
+    if (notification.message != NULL)
+    {
+      sim_message_free(notification.message);
+    }
+    test_check_transfer();
+  }
+}
+
+static bool sim_busy(void)
+{
+  uint32_t i;
+
+  for (i = 0U; i < SIM_EXCHANGE_NBR; i++)
+  {
+    if (sim_exchanges[i].active)
+    {
+      return true;
+    }
+  }
+  for (i = 0U; i < SIM_PACKET_NBR; i++)
+  {
+    if (sim_packets[i].used)
+    {
+      return true;
+    }
+  }
+  return sim_notification_nbr != 0U;
+}
+
+/* Stubs of the HAL, BSP, utilities, and transport layer ------------------------*/
+uint32_t HAL_GetTick(void)
+{
+  return sim_now;
+}
+
+/* Busy wait of the server: CPU2 and the link go on, the response handlers
+ * wait for the sequencer */
+void HAL_Delay(uint32_t Delay)
+{
+  uint32_t end = sim_now + Delay;
+
+  while (sim_step(end))
+  {
+  }
+  sim_now = end;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+  return HAL_OK;
+}
+
+/* A doubleword of the binary, programmed once as the NOR flash requires */
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+  uint32_t dword = (Address - FLASH_BASE) / 8U;
+  uint32_t blocks = fuota_sim_client_block_count();
+
+  if ((sim_node != FUOTA_SIM_CLIENT) || (TypeProgram != FLASH_TYPEPROGRAM_DOUBLEWORD) || ((Address % 8U) != 0U))
+  {
+    fuota_sim_fail("flash programming", Address);
+  }
+  if ((Address < sim_base) || (Address >= (sim_base + (blocks * fuota_sim_server_payload_size()))))
+  {
+    fuota_sim_fail("flash programmed out of the binary", Address - sim_base);
+  }
+  if ((sim_programmed[dword / 8U] & (1U << (dword % 8U))) != 0U)
+  {
+    fuota_sim_fail("flash doubleword programmed twice", Address - sim_base);
+  }
+  if (Data != *(uint64_t *)Address)
+  {
+    fuota_sim_fail("flash programmed with data not in the binary", Address - sim_base);
+  }
+  sim_programmed[dword / 8U] |= (uint8_t)(1U << (dword % 8U));
+  sim_program_nbr++;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError)
+{
+  fuota_sim_fail("flash erase", 0U);
+  return HAL_ERROR;
+}
+
+void HAL_PWR_EnterSLEEPMode(uint32_t Regulator, uint8_t SLEEPEntry)
+{
+  fuota_sim_fail("sleep mode", 0U);
+}
+
+void BSP_LED_On(Led_TypeDef Led)
+{
+}
+
+void BSP_LED_Off(Led_TypeDef Led)
+{
+}
+
+void BSP_LED_Toggle(Led_TypeDef Led)
+{
+}
+
+HW_TS_ReturnStatus_t HW_TS_Create(uint32_t TimerProcessID, uint8_t *pTimerId, HW_TS_Mode_t TimerMode,
+                                  HW_TS_pTimerCb_t pTimerCallBack)
+{
+  return hw_ts_Successful;
+}
+
+void HW_TS_Start(uint8_t TimerID, uint32_t timeout_ticks)
+{
+}
+
+void HW_TS_Stop(uint8_t TimerID)
+{
+}
+
+void HW_UART_Receive_IT(hw_uart_id_t hw_uart_id, uint8_t *pData, uint16_t Size, void (*Callback)(void))
+{
+}
+
+void HW_UART_Transmit_IT(hw_uart_id_t hw_uart_id, uint8_t *pData, uint16_t Size, void (*Callback)(void))
+{
+}
+
+void MX_USART1_UART_Init(void)
+{
+}
+
+void UTIL_LPM_SetOffMode(UTIL_LPM_bm_t lpm_id_bm, UTIL_LPM_State_t state)
+{
+}
+
+void UTIL_SEQ_RegTask(UTIL_SEQ_bm_t TaskId_bm, uint32_t Flags, void (*Task)(void))
+{
+}
+
+void UTIL_SEQ_SetTask(UTIL_SEQ_bm_t TaskId_bm, uint32_t Task_Prio)
+{
+  sim_tasks[sim_node] |= TaskId_bm;
+}
+
+void UTIL_SEQ_SetEvt(UTIL_SEQ_bm_t EvtId_bm)
+{
+  if (sim_node != FUOTA_SIM_SERVER)
+  {
+    fuota_sim_fail("event of the client", EvtId_bm);
+  }
+  sim_events |= EvtId_bm;
+}
+
+/* The server waits: the sequencer runs the response handlers, CPU2 and the
+ * link go on */
+void UTIL_SEQ_WaitEvt(UTIL_SEQ_bm_t EvtId_bm)
+{
+  uint32_t start = sim_now;
+
+  if (sim_node != FUOTA_SIM_SERVER)
+  {
+    fuota_sim_fail("wait of the client", EvtId_bm);
+  }
+  test_check_transfer();
+  for (;;)
+  {
+    sim_dispatch();
+    test_outage_check();
+    if ((sim_events & EvtId_bm) != 0U)
+    {
+      sim_events &= ~EvtId_bm;
+      return;
+    }
+    if (!sim_step(sim_now + SIM_TIME_MAX))
+    {
+      fuota_sim_fail("wait of an event that never comes", EvtId_bm);
+    }
+    if ((sim_now - start) > SIM_TIME_MAX)
+    {
+      fuota_sim_fail("wait of an event for more than a day", EvtId_bm);
+    }
+  }
+}
+
+void logApplication(appliLogLevel_t aLogLevel, appliLogRegion_t aLogRegion, const char *aFormat, ...)
+{
+  char line[SIM_LOG_SIZE];
+  va_list args;
+
+  va_start(args, aFormat);
+  (void)vsnprintf(line, sizeof(line), aFormat, args);
+  va_end(args);
+
+  if (sim_verbose)
+  {
+    printf("%8lu %s %s\n", (unsigned long)sim_now, (sim_node == FUOTA_SIM_SERVER) ? "server" : "client", line);
+  }
+  if (strstr(line, "Fatal error") != NULL)
+  {
+    printf("%s\n", line);
+    fuota_sim_fail("fatal error of the application", sim_node);
+  }
+  if (strstr(line, "FUOTA_SERVER : END OF TRANSFER COMPLETED") != NULL)
+  {
+    sim_completed++;
+  }
+}
+
+HAL_StatusTypeDef OpenThread_CallBack_Processing(void)
+{
+  return HAL_OK;
+}
+
+SHCI_CmdStatus_t SHCI_C2_THREAD_Init(void)
+{
+  return SHCI_Success;
+}
+
+SHCI_CmdStatus_t SHCI_GetWirelessFwInfo(WirelessFwInfo_t *pWirelessInfo)
+{
+  memset(pWirelessInfo, 0, sizeof(*pWirelessInfo));
+  return SHCI_Success;
+}
+
+uint8_t SHCI_C2_FUS_GetState(SHCI_FUS_GetState_ErrorCode_t *p_rsp)
+{
+  return SHCI_Success;
+}
+
+void TL_THREAD_Init(TL_TH_Config_t *p_Config)
+{
+}
+
+void TL_OT_SendCmd(void)
+{
+}
+
+void TL_CLI_SendCmd(void)
+{
+}
+
+void TL_THREAD_CliSendAck(void)
+{
+}
+
+/* OpenThread API of CPU2 -------------------------------------------------------*/
+otError otInstanceErasePersistentInfo(otInstance *aInstance)
+{
+  return OT_ERROR_NONE;
+}
+
+void otInstanceFinalize(otInstance *aInstance)
+{
+}
+
+otInstance *otInstanceInitSingle(void)
+{
+  return NULL;
+}
+
+otError otSetStateChangedCallback(otInstance *aInstance, otStateChangedCallback aCallback, void *aContext)
+{
+  return OT_ERROR_NONE;
+}
+
+otError otLinkSetChannel(otInstance *aInstance, uint8_t aChannel)
+{
+  return OT_ERROR_NONE;
+}
+
+otError otLinkSetPanId(otInstance *aInstance, otPanId aPanId)
+{
+  return OT_ERROR_NONE;
+}
+
+otError otIp6SetEnabled(otInstance *aInstance, bool aEnabled)
+{
+  return OT_ERROR_NONE;
+}
+
+otError otThreadSetEnabled(otInstance *aInstance, bool aEnabled)
+{
+  return OT_ERROR_NONE;
+}
+
+otDeviceRole otThreadGetDeviceRole(otInstance *aInstance)
+{
+  return OT_DEVICE_ROLE_CHILD;
+}
+
+const otIp6Address *otThreadGetMeshLocalEid(otInstance *aInstance)
+{
+  static otIp6Address address;
+
+  return &address;
+}
+
+otError otIp6AddressFromString(const char *aString, otIp6Address *aAddress)
+{
+  memset(aAddress, 0, sizeof(*aAddress));
+  return OT_ERROR_NONE;
+}
+
+otError otCoapStart(otInstance *aInstance, uint16_t aPort)
+{
+  return OT_ERROR_NONE;
+}
+
+otError otCoapAddResource(otInstance *aInstance, otCoapResource *aResource)
+{
+  if (sim_resource_nbr < (sizeof(sim_resources) / sizeof(sim_resources[0])))
+  {
+    sim_resources[sim_resource_nbr++] = aResource;
+  }
+  return OT_ERROR_NONE;
+}
+
+/* CoAP header model: the base header and the token as in RFC 7252, the
+ * Uri-Path as a string after the token */
+void otCoapHeaderInit(otCoapHeader *aHeader, otCoapType aType, otCoapCode aCode)
+{
+  memset(aHeader, 0, sizeof(*aHeader));
+  aHeader->mHeader.mFields.mVersionTypeToken = (uint8_t)(0x40U | (uint8_t)aType);
+  aHeader->mHeader.mFields.mCode = (uint8_t)aCode;
+  aHeader->mHeaderLength = 4U;
+}
+
+void otCoapHeaderSetMessageId(otCoapHeader *aHeader, uint16_t aMessageId)
+{
+  aHeader->mHeader.mFields.mMessageId = aMessageId;
+}
+
+void otCoapHeaderSetToken(otCoapHeader *aHeader, const uint8_t *aToken, uint8_t aTokenLength)
+{
+  aHeader->mHeader.mFields.mVersionTypeToken = (uint8_t)((aHeader->mHeader.mFields.mVersionTypeToken & 0xf0U) | aTokenLength);
+  memcpy(&aHeader->mHeader.mBytes[4], aToken, aTokenLength);
+  aHeader->mHeaderLength = (uint8_t)(4U + aTokenLength);
+}
+
+void otCoapHeaderGenerateToken(otCoapHeader *aHeader, uint8_t aTokenLength)
+{
+  uint8_t token[8] = { 0 };
+  uint32_t value = ++sim_token;
+  uint8_t i;
+
+  for (i = 0U; i < aTokenLength; i++)
+  {
+    token[i] = (uint8_t)(value >> (8U * (i % 4U)));
+  }
+  otCoapHeaderSetToken(aHeader, token, aTokenLength);
+}
+
+otError otCoapHeaderAppendUriPathOptions(otCoapHeader *aHeader, const char *aUriPath)
+{
+  size_t length = strlen(aUriPath) + 1U;
+
+  if ((aHeader->mHeaderLength + length) > OT_COAP_HEADER_MAX_LENGTH)
+  {
+    return OT_ERROR_NO_BUFS;
+  }
+  memcpy(&aHeader->mHeader.mBytes[aHeader->mHeaderLength], aUriPath, length);
+  aHeader->mHeaderLength = (uint8_t)(aHeader->mHeaderLength + length);
+  return OT_ERROR_NONE;
+}
+
+otError otCoapHeaderSetPayloadMarker(otCoapHeader *aHeader)
+{
+  return OT_ERROR_NONE;
+}
+
+otCoapType otCoapHeaderGetType(const otCoapHeader *aHeader)
+{
+  return (otCoapType)(aHeader->mHeader.mFields.mVersionTypeToken & 0x30U);
+}
+
+otCoapCode otCoapHeaderGetCode(const otCoapHeader *aHeader)
+{
+  return (otCoapCode)aHeader->mHeader.mFields.mCode;
+}
+
+uint16_t otCoapHeaderGetMessageId(const otCoapHeader *aHeader)
+{
+  return aHeader->mHeader.mFields.mMessageId;
+}
+
+uint8_t otCoapHeaderGetTokenLength(const otCoapHeader *aHeader)
+{
+  return aHeader->mHeader.mFields.mVersionTypeToken & 0x0fU;
+}
+
+const uint8_t *otCoapHeaderGetToken(const otCoapHeader *aHeader)
+{
+  return &aHeader->mHeader.mBytes[4];
+}
+
+otMessage *otCoapNewMessage(otInstance *aInstance, const otCoapHeader *aHeader)
+{
+  sim_message_t *message = sim_message_new(sim_node, aHeader, sim_node == FUOTA_SIM_SERVER);
+
+  if (message == NULL)
+  {
+    sim_send_failures++;
+    return NULL;
+  }
+  return &message->message;
+}
+
+otError otMessageAppend(otMessage *aMessage, const void *aBuf, uint16_t aLength)
+{
+  sim_message_t *message = sim_message(aMessage);
+
+  if ((message->length + aLength) > SIM_MESSAGE_SIZE)
+  {
+    return OT_ERROR_NO_BUFS;
+  }
+  memcpy(&message->data[message->length], aBuf, aLength);
+  message->length = (uint16_t)(message->length + aLength);
+  return OT_ERROR_NONE;
+}
+
+uint16_t otMessageGetOffset(otMessage *aMessage)
+{
+  (void)sim_message(aMessage);
+  return 0U;
+}
+
+int otMessageRead(otMessage *aMessage, uint16_t aOffset, void *aBuf, uint16_t aLength)
+{
+  sim_message_t *message = sim_message(aMessage);
+
+  if (aOffset >= message->length)
+  {
+    return 0;
+  }
+  if (aLength > (message->length - aOffset))
+  {
+    aLength = (uint16_t)(message->length - aOffset);
+  }
+  memcpy(aBuf, &message->data[aOffset], aLength);
+  return aLength;
+}
+
+void otMessageFree(otMessage *aMessage)
+{
+  sim_message_free(sim_message(aMessage));
+}
+
+/* The message belongs to CPU2 once sent */
+otError otCoapSendRequest(otInstance *aInstance, otMessage *aMessage, const otMessageInfo *aMessageInfo,
+                          otCoapResponseHandler aHandler, void *aContext)
+{
+  sim_message_t *message = sim_message(aMessage);
+  sim_exchange_t *exchange = NULL;
+  uint32_t i;
+
+  if (sim_node != FUOTA_SIM_SERVER)
+  {
+    fuota_sim_fail("request of the client", 0U);
+  }
+  sim_requests++;
+  if (otCoapHeaderGetType(&message->header) == OT_COAP_TYPE_CONFIRMABLE)
+  {
+    for (i = 0U; i < SIM_EXCHANGE_NBR; i++)
+    {
+      if (!sim_exchanges[i].active)
+      {
+        exchange = &sim_exchanges[i];
+        break;
+      }
+    }
+    if (exchange == NULL)
+    {
+      fuota_sim_fail("exchanges of the simulator", SIM_EXCHANGE_NBR);
+    }
+    exchange->active = true;
+    exchange->request = message;
+    exchange->info = *aMessageInfo;
+    exchange->context = aContext;
+    exchange->timeout = SIM_ACK_TIMEOUT + ((uint32_t)rand() % ((SIM_ACK_TIMEOUT / 2U) + 1U));
+    exchange->transmissions = 1U;
+    exchange->timer = sim_now + exchange->timeout;
+  }
+  sim_transmit(FUOTA_SIM_CLIENT, &message->header, message->data, message->length);
+  if (exchange == NULL)
+  {
+    sim_message_free(message);
+  }
+  return OT_ERROR_NONE;
+}
+
+otError otCoapSendResponse(otInstance *aInstance, otMessage *aMessage, const otMessageInfo *aMessageInfo)
+{
+  sim_message_t *message = sim_message(aMessage);
+
+  if (sim_node != FUOTA_SIM_CLIENT)
+  {
+    fuota_sim_fail("response of the server", 0U);
+  }
+  if (sim_capture)
+  {
+    sim_captured_nbr++;
+    sim_captured_code = otCoapHeaderGetCode(&message->header);
+  }
+  else
+  {
+    sim_transmit(FUOTA_SIM_SERVER, &message->header, message->data, message->length);
+  }
+  sim_message_free(message);
+  return OT_ERROR_NONE;
+}
+
+/* Checks ------------------------------------------------------------------------*/
+/* A block acknowledged was received, and a slot is busy while the response to
+ * its block can come */
+static void test_check_transfer(void)
+{
+  fuota_sim_transfer_t transfer;
+  uint32_t slot, i, busy = 0U, pending;
+  const void *handler;
+
+  fuota_sim_server_transfer(&transfer);
+  for (slot = 0U; slot < fuota_sim_server_window_max(); slot++)
+  {
+    handler = fuota_sim_server_slot_handler(slot);
+    pending = 0U;
+    for (i = 0U; i < SIM_EXCHANGE_NBR; i++)
+    {
+      pending += (sim_exchanges[i].active && (sim_exchanges[i].context == handler)) ? 1U : 0U;
+    }
+    for (i = 0U; i < sim_notification_nbr; i++)
+    {
+      pending += (sim_notifications[i].context == handler) ? 1U : 0U;
+    }
+    if (pending != (fuota_sim_server_slot_busy(slot) ? 1U : 0U))
+    {
+      fuota_sim_fail("slot state and responses to come differ", slot);
+    }
+    busy += pending;
+  }
+  if (transfer.outstanding != busy)
+  {
+    fuota_sim_fail("outstanding blocks", transfer.outstanding);
+  }
+  if (((transfer.window == 0U) && (transfer.block_count != 0U)) || (transfer.window > fuota_sim_server_window_max())
+      || (transfer.acked_count > transfer.block_count))
+  {
+    fuota_sim_fail("transfer state", transfer.window);
+  }
+  for (i = 0U; test_sending && (i < transfer.block_count); i++)
+  {
+    if (fuota_sim_server_acked(i) && !fuota_sim_client_received(i))
+    {
+      fuota_sim_fail("block acknowledged but not received", i);
+    }
+  }
+}
+
+/* The link goes down once half of the binary is acknowledged */
+static bool test_outage_armed;
+static uint32_t test_outage_end;
+
+static void test_outage_check(void)
+{
+  fuota_sim_transfer_t transfer;
+
+  if (test_outage_armed)
+  {
+    fuota_sim_server_transfer(&transfer);
+    if ((transfer.acked_count * 2U) >= transfer.block_count)
+    {
+      sim_link_down = true;
+      test_outage_armed = false;
+      test_outage_end = sim_now + sim_link->outage;
+    }
+  }
+  else if (sim_link_down && (sim_link->outage != TEST_OUTAGE_ABORT) && ((int32_t)(sim_now - test_outage_end) >= 0))
+  {
+    sim_link_down = false;
+  }
+}
+
+/* Random binary of size bytes ending with the magic keyword, which is not
+ * found before */
+static void test_image(uint32_t size)
+{
+  uint32_t i, *word = (uint32_t *)&sim_flash[sim_base - FLASH_BASE];
+
+  for (i = 0U; i < ((SIM_FLASH_SIZE - (sim_base - FLASH_BASE)) / 4U); i++)
+  {
+    word[i] = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+    if (word[i] == SIM_MAGIC_KEYWORD_APP)
+    {
+      word[i]++;
+    }
+  }
+  word[(size / 4U) - 1U] = SIM_MAGIC_KEYWORD_APP;
+  memset(sim_programmed, 0, sizeof(sim_programmed));
+  sim_program_nbr = 0U;
+}
+
+/* Runs CPU2, the link and the server sequencer until the server has a task
+ * to run or nothing is left to do */
+static void test_idle(void)
+{
+  for (;;)
+  {
+    sim_dispatch();
+    if ((sim_tasks[FUOTA_SIM_SERVER] != 0U) || !sim_step(sim_now + SIM_TIME_MAX))
+    {
+      return;
+    }
+  }
+}
+
+/* Request of the client from the test: response code captured */
+static uint32_t test_inject(uint32_t offset, otCoapType type, otCoapCode *pCode)
+{
+  uint8_t payload[4U + SIM_MESSAGE_SIZE];
+  uint32_t payload_size = fuota_sim_server_payload_size();
+  sim_packet_t packet;
+
+  memset(&packet, 0, sizeof(packet));
+  otCoapHeaderInit(&packet.header, type, OT_COAP_CODE_PUT);
+  otCoapHeaderGenerateToken(&packet.header, 2U);
+  (void)otCoapHeaderAppendUriPathOptions(&packet.header, "FUOTA_SEND");
+  memcpy(payload, &offset, 4U);
+  if ((offset % 8U) == 0U && (offset < (SIM_FLASH_SIZE - (sim_base - FLASH_BASE) - payload_size)))
+  {
+    memcpy(&payload[4], &sim_flash[(sim_base - FLASH_BASE) + offset], payload_size);
+  }
+  else
+  {
+    memset(&payload[4], 0x5a, payload_size);
+  }
+  packet.length = (uint16_t)(4U + payload_size);
+  memcpy(packet.data, payload, packet.length);
+
+  sim_capture = true;
+  sim_captured_nbr = 0U;
+  sim_receive_request(&packet);
+  sim_capture = false;
+  *pCode = sim_captured_code;
+  return sim_captured_nbr;
+}
+
+/* Blocks out of the binary are answered 4.00 and not written, blocks
+ * received again are answered 2.04 and not written again */
+static void test_reject(uint32_t block_count)
+{
+  uint32_t payload_size = fuota_sim_server_payload_size();
+  uint32_t program_nbr = sim_program_nbr;
+  uint32_t i, offset, responses;
+  otCoapType type;
+  otCoapCode code, expected;
+
+  for (i = 0U; i < 1000U; i++)
+  {
+    type = ((rand() % 4) == 0) ? OT_COAP_TYPE_NON_CONFIRMABLE : OT_COAP_TYPE_CONFIRMABLE;
+    switch (rand() % 4)
+    {
+    case 0:
+      /* Misaligned */
+      offset = (((uint32_t)rand() % block_count) * payload_size) + 1U + ((uint32_t)rand() % (payload_size - 1U));
+      expected = OT_COAP_CODE_BAD_REQUEST;
+      break;
+    case 1:
+      /* Past the end */
+      offset = (block_count + ((uint32_t)rand() % 4U)) * payload_size;
+      expected = OT_COAP_CODE_BAD_REQUEST;
+      break;
+    case 2:
+      offset = 0xffffffffU - ((uint32_t)rand() % 1000U);
+      expected = OT_COAP_CODE_BAD_REQUEST;
+      break;
+    default:
+      /* Already received */
+      offset = ((uint32_t)rand() % block_count) * payload_size;
+      expected = OT_COAP_CODE_CHANGED;
+      break;
+    }
+    responses = test_inject(offset, type, &code);
+    if (type == OT_COAP_TYPE_NON_CONFIRMABLE)
+    {
+      if (responses != 0U)
+      {
+        fuota_sim_fail("response to a non-confirmable block", offset);
+      }
+    }
+    else if ((responses != 1U) || (code != expected))
+    {
+      fuota_sim_fail("response to a block received again or out of the binary", offset);
+    }
+  }
+  if (sim_program_nbr != program_nbr)
+  {
+    fuota_sim_fail("flash programmed by a block received again or out of the binary", sim_program_nbr - program_nbr);
+  }
+  if (fuota_sim_client_reset_requested())
+  {
+    fuota_sim_fail("reset requested again", 0U);
+  }
+}
+
+/* The transfer aborted by the outage: nothing reported as completed, no new
+ * transfer while blocks are outstanding. The window is down to one block after
+ * a few losses, the transfer aborts with blocks outstanding only now and then. */
+static unsigned long test_restart_refused;
+
+static void test_outage_restart(void)
+{
+  fuota_sim_transfer_t before, after;
+  unsigned long requests;
+
+  fuota_sim_server_transfer(&before);
+  if ((before.acked_count >= before.block_count) || (sim_completed != 0UL))
+  {
+    fuota_sim_fail("transfer not aborted by the outage", before.acked_count);
+  }
+  if (before.outstanding != 0U)
+  {
+    requests = sim_requests;
+    fuota_sim_server_send();
+    fuota_sim_server_transfer(&after);
+    if ((sim_requests != requests) || (memcmp(&before, &after, sizeof(before)) != 0))
+    {
+      fuota_sim_fail("transfer started with blocks outstanding", before.outstanding);
+    }
+    test_restart_refused++;
+  }
+
+  /* The link comes back, the server sends again once all is over */
+  sim_link_down = false;
+  test_idle();
+  fuota_sim_server_transfer(&after);
+  if ((after.outstanding != 0U) || sim_busy())
+  {
+    fuota_sim_fail("blocks outstanding after the outage", after.outstanding);
+  }
+  fuota_sim_server_send();
+}
+
+typedef struct
+{
+  unsigned long time;           /* ms */
+  unsigned long size;
+  unsigned long retransmissions;
+  unsigned long window;
+  unsigned long send_failures;
+} test_stats_t;
+
+static void test_transfer(const test_link_t *pLink, unsigned int seed, test_stats_t *pStats)
+{
+  fuota_sim_transfer_t transfer;
+  uint32_t size, expected, i, start, tries;
+
+  srand(seed);
+  memset(sim_tasks, 0, sizeof(sim_tasks));
+  sim_events = 0U;
+  sim_link = pLink;
+  sim_link_down = false;
+  sim_requests = sim_send_failures = sim_drops = sim_late = sim_timeouts = sim_completed = 0UL;
+  test_outage_armed = pLink->outage != 0U;
+
+  expected = 8U * (1U + ((uint32_t)rand() % 20000U));
+  test_image(expected);
+  size = fuota_sim_server_set_context();
+  if (size != expected)
+  {
+    fuota_sim_fail("binary size", size);
+  }
+
+  /* Parameters, sent again until acknowledged */
+  for (tries = 0U; !fuota_sim_server_send_requested(); tries++)
+  {
+    if (tries == 10U)
+    {
+      fuota_sim_fail("parameters not acknowledged", tries);
+    }
+    fuota_sim_server_parameters();
+    test_idle();
+  }
+
+  start = sim_now;
+  test_sending = true;
+  fuota_sim_server_send();
+  if (pLink->outage == TEST_OUTAGE_ABORT)
+  {
+    test_outage_restart();
+  }
+  fuota_sim_server_transfer(&transfer);
+  pStats->time = sim_now - start;
+  pStats->size = size;
+  pStats->retransmissions = transfer.retransmissions;
+  pStats->window = transfer.window;
+
+  if ((transfer.acked_count != transfer.block_count) || (sim_completed != 1UL))
+  {
+    fuota_sim_fail("transfer not completed", transfer.acked_count);
+  }
+  if ((transfer.block_count != fuota_sim_client_block_count()) || !fuota_sim_client_reset_requested())
+  {
+    fuota_sim_fail("binary not received", fuota_sim_client_block_count());
+  }
+  if (sim_program_nbr != ((transfer.block_count * fuota_sim_server_payload_size()) / 8U))
+  {
+    fuota_sim_fail("doublewords programmed", sim_program_nbr);
+  }
+
+  /* Retransmissions of the requests already acknowledged */
+  test_idle();
+  fuota_sim_server_transfer(&transfer);
+  if ((transfer.outstanding != 0U) || sim_busy())
+  {
+    fuota_sim_fail("exchanges left", transfer.outstanding);
+  }
+  for (i = 0U; i < FUOTA_SIM_NODE_NBR; i++)
+  {
+    if (sim_buffers[i] != 0U)
+    {
+      fuota_sim_fail("message buffers not freed", sim_buffers[i]);
+    }
+  }
+  pStats->send_failures = sim_send_failures;
+  test_reject(transfer.block_count);
+  test_sending = false;
+}
+
+/* Flash, flash registers, hardware semaphores and SRAM1 at their address */
+static void test_map(uintptr_t address, size_t size)
+{
+  void *map = mmap((void *)address, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+  if (map != (void *)address)
+  {
+    fuota_sim_fail("memory map", (unsigned long)address);
+  }
+}
+
+static void test_map_memory(void)
+{
+  uint32_t i;
+
+  test_map(FLASH_BASE, SIM_FLASH_SIZE);
+  test_map(HSEM_BASE & ~0xfffUL, (FLASH_REG_BASE + 0x1000UL) - (HSEM_BASE & ~0xfffUL));
+  test_map(SRAM1_BASE, 0x1000U);
+  FLASH->SFR = SIM_SFSA << FLASH_SFR_SFSA_Pos;
+  /* Every semaphore taken by CPU1 at the first try */
+  for (i = 0U; i < 32U; i++)
+  {
+    HSEM->RLR[i] = HSEM_R_LOCK | LL_HSEM_COREID;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  bool bench = (argc > 1) && (strcmp(argv[1], "bench") == 0);
+  const unsigned int seeds = bench ? 8U : 3U;
+  test_stats_t stats, total;
+  test_link_t link;
+  unsigned long transfers = 0UL, failures;
+  unsigned int seed;
+  uint32_t i, loss;
+
+  sim_verbose = getenv("FUOTA_SIM_VERBOSE") != NULL;
+  test_map_memory();
+  sim_base = FLASH_BASE + (0x10U * 0x1000U);
+  fuota_sim_client_init();
+  if (sim_resource_nbr != 3U)
+  {
+    fuota_sim_fail("resources of the client", sim_resource_nbr);
+  }
+
+  for (i = 0U; i < (sizeof(test_links) / sizeof(test_links[0])); i++)
+  {
+    memset(&total, 0, sizeof(total));
+    failures = 0UL;
+    for (seed = 1U; seed <= seeds; seed++)
+    {
+      test_transfer(&test_links[i], seed, &stats);
+      total.time += stats.time;
+      total.size += stats.size;
+      total.retransmissions += stats.retransmissions;
+      failures += stats.send_failures;
+      transfers++;
+    }
+    printf("%-16s %6.1f kbit/s, %4lu blocks sent again, %4lu messages not allocated\n", test_links[i].name,
+           (total.size * 8.0) / total.time, total.retransmissions, failures);
+    if ((test_links[i].buffers < fuota_sim_server_window_max()) && (failures == 0UL))
+    {
+      fuota_sim_fail("no message allocation failure with few buffers", test_links[i].buffers);
+    }
+  }
+
+  if (bench)
+  {
+    printf("loss   kbit/s  blocks sent again  final window\n");
+    for (loss = 0U; loss <= 400U; loss += 50U)
+    {
+      link = test_links[0];
+      link.loss = loss;
+      link.latency_max = 60U;
+      memset(&total, 0, sizeof(total));
+      for (seed = 1U; seed <= seeds; seed++)
+      {
+        test_transfer(&link, seed, &stats);
+        total.time += stats.time;
+        total.size += stats.size;
+        total.retransmissions += stats.retransmissions;
+        total.window += stats.window;
+      }
+      printf("%3u%%  %7.1f  %17lu  %12.1f\n", (unsigned int)(loss / 10U), (total.size * 8.0) / total.time,
+             total.retransmissions, (double)total.window / seeds);
+    }
+  }
+  printf("PASS: FUOTA transfers over lossy links, %lu transfers, window of %u blocks, %lu restarts refused\n",
+         transfers, (unsigned int)fuota_sim_server_window_max(), test_restart_refused);
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
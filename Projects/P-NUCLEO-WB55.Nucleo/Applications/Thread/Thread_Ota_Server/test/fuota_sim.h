@@ -0,0 +1,91 @@
+/**
+ ******************************************************************************
+ * @file    fuota_sim.h
+ * @author  MCD Application Team
+ * @brief   FUOTA host simulator: the Thread_Ota_Server and Thread_Ota
+ *          applications are each built in their own translation unit, over a
+ *          model of the CPU2 CoAP layer and of a lossy link.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#ifndef FUOTA_SIM_H
+#define FUOTA_SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Device running the application code being called */
+typedef enum
+{
+  FUOTA_SIM_SERVER,
+  FUOTA_SIM_CLIENT,
+  FUOTA_SIM_NODE_NBR
+} fuota_sim_node_t;
+
+/* State of the transfer of the server */
+typedef struct
+{
+  uint32_t block_count;
+  uint32_t acked_count;
+  uint32_t outstanding;
+  uint32_t window;
+  uint32_t losses;
+  uint32_t retransmissions;
+  uint32_t srtt;
+} fuota_sim_transfer_t;
+
+/* Both applications define the same global functions: each one gets its own
+ * prefix */
+#define APP_THREAD_Error                      FUOTA_SIM_APP(APP_THREAD_Error)
+#define APP_THREAD_Init                       FUOTA_SIM_APP(APP_THREAD_Init)
+#define APP_THREAD_Init_UART_CLI              FUOTA_SIM_APP(APP_THREAD_Init_UART_CLI)
+#define APP_THREAD_ProcessMsgM0ToM4           FUOTA_SIM_APP(APP_THREAD_ProcessMsgM0ToM4)
+#define APP_THREAD_RegisterCmdBuffer          FUOTA_SIM_APP(APP_THREAD_RegisterCmdBuffer)
+#define APP_THREAD_TL_THREAD_INIT             FUOTA_SIM_APP(APP_THREAD_TL_THREAD_INIT)
+#define Ot_Cmd_Transfer                       FUOTA_SIM_APP(Ot_Cmd_Transfer)
+#define Pre_OtCmdProcessing                   FUOTA_SIM_APP(Pre_OtCmdProcessing)
+#define THREAD_Get_NotificationPayloadBuffer  FUOTA_SIM_APP(THREAD_Get_NotificationPayloadBuffer)
+#define THREAD_Get_OTCmdPayloadBuffer         FUOTA_SIM_APP(THREAD_Get_OTCmdPayloadBuffer)
+#define THREAD_Get_OTCmdRspPayloadBuffer      FUOTA_SIM_APP(THREAD_Get_OTCmdRspPayloadBuffer)
+#define TL_OT_CmdEvtReceived                  FUOTA_SIM_APP(TL_OT_CmdEvtReceived)
+#define TL_THREAD_CliNotReceived              FUOTA_SIM_APP(TL_THREAD_CliNotReceived)
+#define TL_THREAD_NotReceived                 FUOTA_SIM_APP(TL_THREAD_NotReceived)
+
+/* Simulator */
+void fuota_sim_fail(const char *msg, unsigned long arg);
+bool fuota_sim_take_task(fuota_sim_node_t node, uint32_t task);
+void fuota_sim_set_node(fuota_sim_node_t node);
+void fuota_sim_reset(void);
+
+/* Thread_Ota_Server, fuota_sim_server.c */
+uint32_t fuota_sim_server_set_context(void);
+void fuota_sim_server_parameters(void);
+bool fuota_sim_server_send_requested(void);
+void fuota_sim_server_send(void);
+void fuota_sim_server_transfer(fuota_sim_transfer_t *pTransfer);
+bool fuota_sim_server_acked(uint32_t block);
+uint32_t fuota_sim_server_window_max(void);
+bool fuota_sim_server_slot_busy(uint32_t slot);
+const void *fuota_sim_server_slot_handler(uint32_t slot);
+uint32_t fuota_sim_server_payload_size(void);
+
+/* Thread_Ota, fuota_sim_client.c */
+void fuota_sim_client_init(void);
+bool fuota_sim_client_reset_requested(void);
+bool fuota_sim_client_received(uint32_t block);
+uint32_t fuota_sim_client_block_count(void);
+
+#endif /* FUOTA_SIM_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
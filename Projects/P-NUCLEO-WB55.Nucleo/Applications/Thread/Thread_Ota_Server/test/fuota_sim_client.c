@@ -0,0 +1,55 @@
+/**
+ ******************************************************************************
+ * @file    fuota_sim_client.c
+ * @author  MCD Application Team
+ * @brief   Thread_Ota application of the FUOTA host simulator, with access to
+ *          the blocks it received.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#define FUOTA_SIM_APP(name)   fuota_sim_client_##name
+#include "fuota_sim.h"
+#include "app_common.h"
+
+/* The reset of the CMSIS is an Arm instruction */
+#undef NVIC_SystemReset
+#define NVIC_SystemReset      fuota_sim_reset
+
+#include "../../Thread_Ota/STM32_WPAN/App/app_thread.c"
+
+void fuota_sim_client_init(void)
+{
+  /* First sector free for the download, see CheckDeviceCapabilities */
+  *((uint8_t*)SRAM1_BASE + 1) = CFG_APP_START_SECTOR_INDEX;
+
+  fuota_sim_set_node(FUOTA_SIM_CLIENT);
+  APP_THREAD_DeviceConfig();
+}
+
+bool fuota_sim_client_reset_requested(void)
+{
+  return fuota_sim_take_task(FUOTA_SIM_CLIENT, TASK_FUOTA_RESET);
+}
+
+bool fuota_sim_client_received(uint32_t block)
+{
+  return (FuotaBlockMap[block / 32U] & (1UL << (block % 32U))) != 0U;
+}
+
+uint32_t fuota_sim_client_block_count(void)
+{
+  return FuotaBlockCount;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,88 @@
+/**
+ ******************************************************************************
+ * @file    fuota_sim_server.c
+ * @author  MCD Application Team
+ * @brief   Thread_Ota_Server application of the FUOTA host simulator, with
+ *          access to its transfer state.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#define FUOTA_SIM_APP(name)   fuota_sim_server_##name
+#include "fuota_sim.h"
+#include "../STM32_WPAN/App/app_thread.c"
+
+uint32_t fuota_sim_server_set_context(void)
+{
+  fuota_sim_set_node(FUOTA_SIM_SERVER);
+  if (APP_THREAD_SetOtaContext(APP_THREAD_OTA_FILE_TYPE_FW_APP) != APP_THREAD_OK)
+  {
+    fuota_sim_fail("server OTA context", 0U);
+  }
+  return OtaContext.binary_size;
+}
+
+void fuota_sim_server_parameters(void)
+{
+  fuota_sim_set_node(FUOTA_SIM_SERVER);
+  APP_THREAD_FuotaParameters();
+}
+
+bool fuota_sim_server_send_requested(void)
+{
+  return fuota_sim_take_task(FUOTA_SIM_SERVER, TASK_FUOTA_SEND);
+}
+
+void fuota_sim_server_send(void)
+{
+  fuota_sim_set_node(FUOTA_SIM_SERVER);
+  APP_THREAD_FuotaSend();
+}
+
+void fuota_sim_server_transfer(fuota_sim_transfer_t *pTransfer)
+{
+  pTransfer->block_count = FuotaTransfer.block_count;
+  pTransfer->acked_count = FuotaTransfer.acked_count;
+  pTransfer->outstanding = FuotaTransfer.outstanding;
+  pTransfer->window = FuotaTransfer.window;
+  pTransfer->losses = FuotaTransfer.losses;
+  pTransfer->retransmissions = FuotaTransfer.retransmissions;
+  pTransfer->srtt = FuotaTransfer.srtt;
+}
+
+bool fuota_sim_server_acked(uint32_t block)
+{
+  return (FuotaTransfer.acked_map[block / 32U] & (1UL << (block % 32U))) != 0U;
+}
+
+uint32_t fuota_sim_server_window_max(void)
+{
+  return FUOTA_WINDOW_MAX;
+}
+
+bool fuota_sim_server_slot_busy(uint32_t slot)
+{
+  return FuotaTransfer.slot[slot].busy;
+}
+
+const void *fuota_sim_server_slot_handler(uint32_t slot)
+{
+  return (const void *)FuotaSlotRespHandler[slot];
+}
+
+uint32_t fuota_sim_server_payload_size(void)
+{
+  return FUOTA_PAYLOAD_SIZE;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -53,11 +53,13 @@ static void APP_ZIGBEE_CheckWirelessFirmwareInfo(void);
 static void Wait_Getting_Ack_From_M0(void);
 static void Receive_Ack_From_M0(void);
 static void Receive_Notification_From_M0(void);
+static void APP_ZIGBEE_TimerExpired(void);
 
 /* Private variables -----------------------------------------------*/
 static TL_CmdPacket_t *p_ZIGBEE_otcmdbuffer;
 static TL_EvtPacket_t *p_ZIGBEE_notif_M0_to_M4;
 static __IO uint32_t CptReceiveMsgFromM0 = 0;
+static uint8_t TimerZigbeeId;
 
 PLACE_IN_SECTION("MB_MEM1") ALIGN(4) static TL_ZIGBEE_Config_t ZigbeeConfigBuffer;
 PLACE_IN_SECTION("MB_MEM2") ALIGN(4) static TL_CmdPacket_t ZigbeeOtCmdBuffer;
@@ -97,6 +99,10 @@ void APP_ZIGBEE_Init(void)
   /* Create the different tasks */
   UTIL_SEQ_RegTask(1U << (uint32_t)CFG_TASK_MSG_FROM_M0_TO_M4, UTIL_SEQ_RFU,APP_ZIGBEE_ProcessMsgM0ToM4);
 
+  /* Task and timer running the Zigbee timers allocated by the M4 */
+  UTIL_SEQ_RegTask(1U << (uint32_t)CFG_TASK_ZIGBEE_TIMER, UTIL_SEQ_RFU, Zigbee_TimerProcessing);
+  HW_TS_Create(CFG_TIM_PROC_ID_ISR, &TimerZigbeeId, hw_ts_SingleShot, APP_ZIGBEE_TimerExpired);
+
   /* Task associated with network creation process */
   UTIL_SEQ_RegTask(1U << CFG_TASK_ZIGBEE_NETWORK_FORM, UTIL_SEQ_RFU, APP_ZIGBEE_NwkForm);
 
@@ -404,6 +410,33 @@ Zigbee_Cmd_Request_t * ZIGBEE_Get_NotificationPayloadBuffer(void)
   return (Zigbee_Cmd_Request_t *)(p_ZIGBEE_notif_M0_to_M4)->evtserial.evt.payload;
 } /* ZIGBEE_Get_NotificationPayloadBuffer */
 
+/**
+ * @brief  Start the timer of the Zigbee timers allocated by the M4.
+ *         It is restarted each time the next timer to expire changes.
+ * @param  timeout_ms : time left before the next timer expires in ms
+ * @retval None
+ */
+void ZIGBEE_TimerStart(uint32_t timeout_ms)
+{
+  uint64_t ticks;
+
+  ticks = (((uint64_t)timeout_ms * 1000U) + CFG_TS_TICK_VAL - 1U) / CFG_TS_TICK_VAL;
+  if (ticks > UINT32_MAX) {
+    ticks = UINT32_MAX;
+  }
+  HW_TS_Start(TimerZigbeeId, (uint32_t)ticks);
+} /* ZIGBEE_TimerStart */
+
+/**
+ * @brief  Stop the timer of the Zigbee timers allocated by the M4.
+ * @param  None
+ * @retval None
+ */
+void ZIGBEE_TimerStop(void)
+{
+  HW_TS_Stop(TimerZigbeeId);
+} /* ZIGBEE_TimerStop */
+
 /**
  * @brief  This function is used to transfer the commands from the M4 to the M0.
  *
@@ -502,6 +535,16 @@ static void Receive_Notification_From_M0(void)
   UTIL_SEQ_SetTask(1U << CFG_TASK_MSG_FROM_M0_TO_M4, CFG_SCH_PRIO_0);
 } /* Receive_Notification_From_M0 */
 
+/**
+ * @brief  Called under interrupt when the timer of the Zigbee timers expires.
+ * @param  None
+ * @retval None
+ */
+static void APP_ZIGBEE_TimerExpired(void)
+{
+  UTIL_SEQ_SetTask(1U << CFG_TASK_ZIGBEE_TIMER, CFG_SCH_PRIO_0);
+} /* APP_ZIGBEE_TimerExpired */
+
 /**
  * @brief Perform initialization of TL for Zigbee.
  * @param  None
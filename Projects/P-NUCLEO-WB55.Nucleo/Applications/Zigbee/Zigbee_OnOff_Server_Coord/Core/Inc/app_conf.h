@@ -282,6 +282,7 @@ typedef enum {
   CFG_TASK_MSG_FROM_M0_TO_M4,
   CFG_TASK_SYSTEM_HCI_ASYNCH_EVT,
   CFG_TASK_ZIGBEE_NETWORK_FORM,
+  CFG_TASK_ZIGBEE_TIMER,
 #if (CFG_USB_INTERFACE_ENABLE != 0)
   CFG_TASK_VCP_SEND_DATA,
 #endif /* (CFG_USB_INTERFACE_ENABLE != 0) */
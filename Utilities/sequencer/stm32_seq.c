@@ -23,13 +23,6 @@
 #include "stm32_seq.h"
 #include "utilities_conf.h"
 
-/* Private typedef -----------------------------------------------------------*/
-typedef struct
-{
-uint32_t priority;
-uint32_t round_robin;
-} UTIL_SEQ_Priority_t;
-
 /* Private defines -----------------------------------------------------------*/
 #define UTIL_SEQ_NO_BIT_SET   (0)
 #define UTIL_SEQ_ALL_BIT_SET    (~0)
@@ -46,50 +39,157 @@ uint32_t round_robin;
   #define UTIL_SEQ_EXIT_CRITICAL_SECTION( )     UTILS_EXIT_CRITICAL_SECTION( )
 #endif
 
-/*default number of task is default 32 (maximum), can be reduced by redefining in utilities_conf.h*/
+/*default number of task is default 32, can be changed by redefining in utilities_conf.h (256 maximum)*/
 #ifndef UTIL_SEQ_CONF_TASK_NBR 
 	#define UTIL_SEQ_CONF_TASK_NBR  (32)
 #endif 
 
-#if UTIL_SEQ_CONF_TASK_NBR > 32
-#error "UTIL_SEQ_CONF_PRIO_NBR must be less of equal then 32"
+#if UTIL_SEQ_CONF_TASK_NBR > 256
+#error "UTIL_SEQ_CONF_TASK_NBR must be less or equal than 256"
 #endif
   
 #ifndef UTIL_SEQ_CONF_PRIO_NBR 
   #define UTIL_SEQ_CONF_PRIO_NBR  (2)
 #endif
 
+#if UTIL_SEQ_CONF_PRIO_NBR > 32
+#error "UTIL_SEQ_CONF_PRIO_NBR must be less or equal than 32"
+#endif
+
 #ifndef UTIL_SEQ_MEMSET8
 #define UTIL_SEQ_MEMSET8( dest, value, size )   UTILS_MEMSET8( dest, value, size )
 #endif
 
+/**
+ * Number of 32 bits words needed to hold one bit per task
+ */
+#define UTIL_SEQ_TASK_WORD_NBR  ((UTIL_SEQ_CONF_TASK_NBR + 31) / 32)
+
+/**
+ * Tasks of a bit mapping which are registered in the sequencer, the other bits are ignored
+ */
+#if UTIL_SEQ_CONF_TASK_NBR < 32
+#define UTIL_SEQ_TASK_BM_MASK   ((1U << UTIL_SEQ_CONF_TASK_NBR) - 1U)
+#else
+#define UTIL_SEQ_TASK_BM_MASK   (UTIL_SEQ_ALL_BIT_SET)
+#endif
+
+#define UTIL_SEQ_NO_TASK        (~0U)
+#define UTIL_SEQ_NO_PRIO        (0xFF)
+
+/**
+ * The run time statistics are disabled by default. They are enabled by defining in utilities_conf.h
+ * UTIL_SEQ_CONF_STATS_ENABLE to 1
+ */
+#ifndef UTIL_SEQ_CONF_STATS_ENABLE
+  #define UTIL_SEQ_CONF_STATS_ENABLE  (0)
+#endif
+
+#if (UTIL_SEQ_CONF_STATS_ENABLE != 0)
+/**
+ * By default, the time is read from the DWT cycle counter of the Cortex-M4
+ * It may be replaced by defining UTIL_SEQ_STATS_GET_TIME() ( and UTIL_SEQ_STATS_INIT_TIME() when the counter needs
+ * to be started ) in utilities_conf.h, for instance with a clock_gettime() wrapper on a host build
+ */
+#ifndef UTIL_SEQ_STATS_GET_TIME
+  #define UTIL_SEQ_DEMCR                  (*(volatile uint32_t *)0xE000EDFCUL)
+  #define UTIL_SEQ_DWT_CTRL               (*(volatile uint32_t *)0xE0001000UL)
+  #define UTIL_SEQ_DWT_CYCCNT             (*(volatile uint32_t *)0xE0001004UL)
+  #define UTIL_SEQ_STATS_INIT_TIME( )     do{ UTIL_SEQ_DEMCR |= (1UL << 24); UTIL_SEQ_DWT_CTRL |= 1UL; }while(0)
+  #define UTIL_SEQ_STATS_GET_TIME( )      UTIL_SEQ_DWT_CYCCNT
+#endif
+
+#ifndef UTIL_SEQ_STATS_INIT_TIME
+  #define UTIL_SEQ_STATS_INIT_TIME( )
+#endif
+
+#define UTIL_SEQ_STATS_TASK_SET( task_idx )             TaskSetTime[task_idx] = UTIL_SEQ_STATS_GET_TIME( )
+#define UTIL_SEQ_STATS_START( )                         stats_start_time = UTIL_SEQ_STATS_GET_TIME( )
+#define UTIL_SEQ_STATS_TASK_START( task_idx )           stats_latency = StatsTaskStart( task_idx, &stats_start_time )
+#define UTIL_SEQ_STATS_TASK_RUN( task_idx )             StatsTaskRun( task_idx, stats_start_time, stats_latency )
+#define UTIL_SEQ_STATS_IDLE( )                          StatsIdle( stats_start_time )
+#define UTIL_SEQ_STATS_EVT_WAIT( evt_id_bm )            StatsEvtWait( evt_id_bm, stats_start_time )
+#else
+#define UTIL_SEQ_STATS_TASK_SET( task_idx )
+#define UTIL_SEQ_STATS_START( )
+#define UTIL_SEQ_STATS_TASK_START( task_idx )
+#define UTIL_SEQ_STATS_TASK_RUN( task_idx )
+#define UTIL_SEQ_STATS_IDLE( )
+#define UTIL_SEQ_STATS_EVT_WAIT( evt_id_bm )
+#endif
+
+/* Private typedef -----------------------------------------------------------*/
+/**
+ * The pending tasks of one priority are stored in a multi-word bitmap.
+ * word_set has one bit per word of the bitmap which is not null so that the selection of the task
+ * is done with two find-first-set operations whatever the number of tasks
+ */
+typedef struct
+{
+UTIL_SEQ_bm_t priority[UTIL_SEQ_TASK_WORD_NBR];
+UTIL_SEQ_bm_t round_robin[UTIL_SEQ_TASK_WORD_NBR];
+uint32_t word_set;
+} UTIL_SEQ_Priority_t;
+
 /* Private variables ---------------------------------------------------------*/
 
-static UTIL_SEQ_bm_t TaskSet = UTIL_SEQ_NO_BIT_SET;
-static UTIL_SEQ_bm_t TaskMask = UTIL_SEQ_ALL_BIT_SET;
-static UTIL_SEQ_bm_t SuperMask = UTIL_SEQ_ALL_BIT_SET;
+static UTIL_SEQ_bm_t TaskMask[UTIL_SEQ_TASK_WORD_NBR];
+static UTIL_SEQ_bm_t SuperMask[UTIL_SEQ_TASK_WORD_NBR];
 static UTIL_SEQ_bm_t EvtSet = UTIL_SEQ_NO_BIT_SET;
 static UTIL_SEQ_bm_t EvtWaited = UTIL_SEQ_NO_BIT_SET;
 static uint32_t CurrentTaskIdx = 0;
 static void (*TaskCb[UTIL_SEQ_CONF_TASK_NBR])( void );
 static UTIL_SEQ_Priority_t TaskPrio[UTIL_SEQ_CONF_PRIO_NBR] = { 0 };
+/** One bit per priority which has at least one pending task */
+static uint32_t PrioSet = UTIL_SEQ_NO_BIT_SET;
+/** Priority at which each task is pending or UTIL_SEQ_NO_PRIO when the task is not pending */
+static uint8_t TaskPrioIdx[UTIL_SEQ_CONF_TASK_NBR];
+
+#if (UTIL_SEQ_CONF_STATS_ENABLE != 0)
+static UTIL_SEQ_TaskStats_t TaskStats[UTIL_SEQ_CONF_TASK_NBR];
+static UTIL_SEQ_EvtStats_t EvtStats[32];
+static UTIL_SEQ_IdleStats_t IdleStats;
+/** Time at which each pending task has been requested */
+static uint32_t TaskSetTime[UTIL_SEQ_CONF_TASK_NBR];
+#endif
 
 /* Global variables ----------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 static uint32_t bit_position(uint32_t value);
+static void TaskPendingSet( uint32_t task_idx, uint32_t task_prio );
+static void TaskPendingClr( uint32_t task_idx );
+static uint32_t ReadyWords( uint32_t prio, UTIL_SEQ_bm_t *p_ready );
+static uint32_t IsTaskReady( void );
+static uint32_t TaskPick( void );
+#if (UTIL_SEQ_CONF_STATS_ENABLE != 0)
+static uint32_t StatsTaskStart( uint32_t task_idx, uint32_t *p_start_time );
+static void StatsTaskRun( uint32_t task_idx, uint32_t start_time, uint32_t latency );
+static void StatsIdle( uint32_t start_time );
+static void StatsEvtWait( UTIL_SEQ_bm_t evt_id_bm, uint32_t start_time );
+#endif
 
 /* Functions Definition ------------------------------------------------------*/
 void UTIL_SEQ_Init( void )
 {
-  TaskSet = UTIL_SEQ_NO_BIT_SET;
-  TaskMask = UTIL_SEQ_ALL_BIT_SET;
-  SuperMask = UTIL_SEQ_ALL_BIT_SET;
+  uint32_t counter;
+
+  for (counter = 0; counter < UTIL_SEQ_TASK_WORD_NBR; counter++)
+  {
+    TaskMask[counter] = UTIL_SEQ_ALL_BIT_SET;
+    SuperMask[counter] = UTIL_SEQ_ALL_BIT_SET;
+  }
   EvtSet = UTIL_SEQ_NO_BIT_SET;
   EvtWaited = UTIL_SEQ_NO_BIT_SET;
   CurrentTaskIdx = 0;
+  PrioSet = UTIL_SEQ_NO_BIT_SET;
   UTIL_SEQ_MEMSET8(TaskCb, 0, sizeof(TaskCb));
   UTIL_SEQ_MEMSET8(TaskPrio, 0, sizeof(TaskPrio));
+  UTIL_SEQ_MEMSET8(TaskPrioIdx, UTIL_SEQ_NO_PRIO, sizeof(TaskPrioIdx));
   UTIL_SEQ_INIT_CRITICAL_SECTION( );
+#if (UTIL_SEQ_CONF_STATS_ENABLE != 0)
+  UTIL_SEQ_STATS_INIT_TIME( );
+  UTIL_SEQ_StatsReset( );
+#endif
 }
 
 void UTIL_SEQ_DeInit( void )
@@ -104,16 +204,31 @@ void UTIL_SEQ_DeInit( void )
 void UTIL_SEQ_Run( UTIL_SEQ_bm_t mask_bm )
 {
   uint32_t counter;
-  UTIL_SEQ_bm_t current_task_set;
-  UTIL_SEQ_bm_t super_mask_backup;
+  uint32_t task_idx;
+  UTIL_SEQ_bm_t super_mask_backup[UTIL_SEQ_TASK_WORD_NBR];
+#if (UTIL_SEQ_CONF_STATS_ENABLE != 0)
+  uint32_t stats_start_time;
+  uint32_t stats_latency;
+#endif
 
   /**
    *  When this function is nested, the mask to be applied cannot be larger than the first call
    *  The mask is always getting smaller and smaller
    *  A copy is made of the mask set by UTIL_SEQ_Run() in case it is called again in the task
+   *  mask_bm covers the tasks 0 to 31. The tasks above are kept only when mask_bm is UTIL_SEQ_DEFAULT
    */
-  super_mask_backup = SuperMask;
-  SuperMask &= mask_bm;
+  for (counter = 0; counter < UTIL_SEQ_TASK_WORD_NBR; counter++)
+  {
+    super_mask_backup[counter] = SuperMask[counter];
+    if (counter == 0)
+    {
+      SuperMask[counter] &= mask_bm;
+    }
+    else if (mask_bm != (UTIL_SEQ_bm_t)UTIL_SEQ_DEFAULT)
+    {
+      SuperMask[counter] = UTIL_SEQ_NO_BIT_SET;
+    }
+  }
 
   /**
    * There are two independent mask to check:
@@ -122,72 +237,43 @@ void UTIL_SEQ_Run( UTIL_SEQ_bm_t mask_bm )
    * If the waited event is there, exit from  UTIL_SEQ_Run() to return to the
    * waiting task
    */
-  while( (TaskSet & TaskMask & SuperMask) && (!(EvtSet & EvtWaited)) )
+  while(!(EvtSet & EvtWaited))
   {
-    counter = 0;
-    /**
-     * When a flag is set, the associated bit is set in TaskPrio[counter].priority mask depending
-     * on the priority parameter given from UTIL_SEQ_SetTask()
-     * The while loop is looking for a flag set from the highest priority maskr to the lower
-     */
-    while(!(TaskPrio[counter].priority & TaskMask & SuperMask))
-    {
-      counter++;
-    }
-
-    current_task_set = TaskPrio[counter].priority & TaskMask & SuperMask;
-
-    /**
-     * The round_robin register is a mask of allowed flags to be evaluated.
-     * The concept is to make sure that on each round on UTIL_SEQ_Run(), if two same flags are always set,
-     * the sequencer does not run always only the first one.
-     * When a task has been executed, The flag is removed from the round_robin mask.
-     * If on the next UTIL_SEQ_RUN(), the two same flags are set again, the round_robin mask will mask out the first flag
-     * so that the second one can be executed.
-     * Note that the first flag is not removed from the list of pending task but just masked by the round_robin mask
-     *
-     * In the check below, the round_robin mask is reinitialize in case all pending tasks haven been executed at least once
-     */
-    if (!(TaskPrio[counter].round_robin & current_task_set))
-    {
-      TaskPrio[counter].round_robin = UTIL_SEQ_ALL_BIT_SET;
-    }
-
     /** Read the flag index of the task to be executed
 	 *  Once the index is read, the associated task will be executed even though a higher priority stack is requested
 	 *  before task execution.
 	 */
-    CurrentTaskIdx = bit_position(current_task_set & TaskPrio[counter].round_robin);
-
-    /** remove from the roun_robin mask the task that has been selected to be executed */
-    TaskPrio[counter].round_robin &= ~(1 << (CurrentTaskIdx));
-
-    UTIL_SEQ_ENTER_CRITICAL_SECTION( );
-    /** remove from the list or pending task the one that has been selected to be executed */
-    TaskSet &= ~(1 << (CurrentTaskIdx));
-    /** remove from all priority mask the task that has been selected to be executed */
-    for (counter = UTIL_SEQ_CONF_PRIO_NBR; counter; counter--)
+    task_idx = TaskPick( );
+    if (task_idx == UTIL_SEQ_NO_TASK)
     {
-      TaskPrio[counter - 1].priority &= ~(1 << (CurrentTaskIdx));
+      break;
     }
-    UTIL_SEQ_EXIT_CRITICAL_SECTION( );
+    CurrentTaskIdx = task_idx;
+
     /** Execute the task */
+    UTIL_SEQ_STATS_TASK_START( task_idx );
     TaskCb[CurrentTaskIdx]( );
+    UTIL_SEQ_STATS_TASK_RUN( task_idx );
   }
 
   UTIL_SEQ_PreIdle( );
   
   UTIL_SEQ_ENTER_CRITICAL_SECTION( );
-  if (!((TaskSet & TaskMask & SuperMask) || (EvtSet & EvtWaited)))
+  if (!(IsTaskReady( ) || (EvtSet & EvtWaited)))
   {
+    UTIL_SEQ_STATS_START( );
     UTIL_SEQ_Idle( );
+    UTIL_SEQ_STATS_IDLE( );
   }
   UTIL_SEQ_EXIT_CRITICAL_SECTION( );
   
   UTIL_SEQ_PostIdle( );
 
   /** restore the mask from UTIL_SEQ_Run() */
-  SuperMask = super_mask_backup;
+  for (counter = 0; counter < UTIL_SEQ_TASK_WORD_NBR; counter++)
+  {
+    SuperMask[counter] = super_mask_backup[counter];
+  }
 
   return;
 }
@@ -197,9 +283,30 @@ void UTIL_SEQ_Run( UTIL_SEQ_bm_t mask_bm )
  */
 void UTIL_SEQ_RegTask( UTIL_SEQ_bm_t task_id_bm , uint32_t flags, void (*task)( void ) )
 {
+  task_id_bm &= UTIL_SEQ_TASK_BM_MASK;
+  if (task_id_bm == UTIL_SEQ_NO_BIT_SET)
+  {
+    return;
+  }
+
+  UTIL_SEQ_RegTaskIdx( bit_position(task_id_bm), flags, task );
+
+  return;
+}
+
+/**
+ *  this function can be nested
+ */
+void UTIL_SEQ_RegTaskIdx( uint32_t task_idx, uint32_t flags, void (*task)( void ) )
+{
+  if (task_idx >= UTIL_SEQ_CONF_TASK_NBR)
+  {
+    return;
+  }
+
   UTIL_SEQ_ENTER_CRITICAL_SECTION( );
 
-  TaskCb[bit_position(task_id_bm)] = task;
+  TaskCb[task_idx] = task;
 
   UTIL_SEQ_EXIT_CRITICAL_SECTION( );
 
@@ -211,10 +318,38 @@ void UTIL_SEQ_RegTask( UTIL_SEQ_bm_t task_id_bm , uint32_t flags, void (*task)(
  */
 void UTIL_SEQ_SetTask( UTIL_SEQ_bm_t task_id_bm , uint32_t task_prio )
 {
+  uint32_t task_idx;
+
+  /** The bits above the last task are ignored */
+  task_id_bm &= UTIL_SEQ_TASK_BM_MASK;
+
+  UTIL_SEQ_ENTER_CRITICAL_SECTION( );
+
+  while (task_id_bm)
+  {
+    task_idx = bit_position(task_id_bm);
+    task_id_bm &= ~(1U << task_idx);
+    TaskPendingSet( task_idx, task_prio );
+  }
+
+  UTIL_SEQ_EXIT_CRITICAL_SECTION( );
+
+  return;
+}
+
+/**
+ *  this function can be nested
+ */
+void UTIL_SEQ_SetTaskIdx( uint32_t task_idx , uint32_t task_prio )
+{
+  if (task_idx >= UTIL_SEQ_CONF_TASK_NBR)
+  {
+    return;
+  }
+
   UTIL_SEQ_ENTER_CRITICAL_SECTION( );
 
-  TaskSet |= task_id_bm;
-  TaskPrio[task_prio].priority |= task_id_bm;
+  TaskPendingSet( task_idx, task_prio );
 
   UTIL_SEQ_EXIT_CRITICAL_SECTION( );
 
@@ -228,7 +363,26 @@ void UTIL_SEQ_PauseTask( UTIL_SEQ_bm_t task_id_bm )
 {
   UTIL_SEQ_ENTER_CRITICAL_SECTION( );
 
-  TaskMask &= (~task_id_bm);
+  TaskMask[0] &= (~task_id_bm);
+
+  UTIL_SEQ_EXIT_CRITICAL_SECTION( );
+
+  return;
+}
+
+/**
+ *  this function can be nested
+ */
+void UTIL_SEQ_PauseTaskIdx( uint32_t task_idx )
+{
+  if (task_idx >= UTIL_SEQ_CONF_TASK_NBR)
+  {
+    return;
+  }
+
+  UTIL_SEQ_ENTER_CRITICAL_SECTION( );
+
+  TaskMask[task_idx >> 5] &= ~(1U << (task_idx & 31));
 
   UTIL_SEQ_EXIT_CRITICAL_SECTION( );
 
@@ -242,7 +396,26 @@ void UTIL_SEQ_ResumeTask( UTIL_SEQ_bm_t task_id_bm )
 {
   UTIL_SEQ_ENTER_CRITICAL_SECTION( );
 
-  TaskMask |= task_id_bm;
+  TaskMask[0] |= task_id_bm;
+
+  UTIL_SEQ_EXIT_CRITICAL_SECTION( );
+
+  return;
+}
+
+/**
+ *  this function can be nested
+ */
+void UTIL_SEQ_ResumeTaskIdx( uint32_t task_idx )
+{
+  if (task_idx >= UTIL_SEQ_CONF_TASK_NBR)
+  {
+    return;
+  }
+
+  UTIL_SEQ_ENTER_CRITICAL_SECTION( );
+
+  TaskMask[task_idx >> 5] |= (1U << (task_idx & 31));
 
   UTIL_SEQ_EXIT_CRITICAL_SECTION( );
 
@@ -284,11 +457,17 @@ void UTIL_SEQ_WaitEvt( UTIL_SEQ_bm_t evt_id_bm )
 {
   UTIL_SEQ_bm_t event_waited_id_backup;
   UTIL_SEQ_bm_t current_task_id_bm;
+#if (UTIL_SEQ_CONF_STATS_ENABLE != 0)
+  uint32_t stats_start_time;
+#endif
+
+  UTIL_SEQ_STATS_START( );
 
   /** store in local the current_task_id_bm as the global variable CurrentTaskIdx
    *  may be overwritten in case there are nested call of UTIL_SEQ_Run()
+   *  A task above 31 cannot be reported in a bit mapping so it is reported as 0
    */
-  current_task_id_bm = (1 << CurrentTaskIdx);
+  current_task_id_bm = (CurrentTaskIdx < 32) ? (1U << CurrentTaskIdx) : UTIL_SEQ_NO_BIT_SET;
 
   /** backup the event id that was currently waited */
   event_waited_id_backup = EvtWaited;
@@ -308,6 +487,8 @@ void UTIL_SEQ_WaitEvt( UTIL_SEQ_bm_t evt_id_bm )
   EvtSet &= (~EvtWaited);
   EvtWaited = event_waited_id_backup;
 
+  UTIL_SEQ_STATS_EVT_WAIT( evt_id_bm );
+
   return;
 }
 
@@ -319,6 +500,108 @@ UTIL_SEQ_bm_t UTIL_SEQ_IsEvtPend( void )
   return (EvtSet & EvtWaited);
 }
 
+#if (UTIL_SEQ_CONF_STATS_ENABLE != 0)
+void UTIL_SEQ_StatsReset( void )
+{
+  UTIL_SEQ_ENTER_CRITICAL_SECTION( );
+
+  UTIL_SEQ_MEMSET8(TaskStats, 0, sizeof(TaskStats));
+  UTIL_SEQ_MEMSET8(EvtStats, 0, sizeof(EvtStats));
+  UTIL_SEQ_MEMSET8(&IdleStats, 0, sizeof(IdleStats));
+
+  UTIL_SEQ_EXIT_CRITICAL_SECTION( );
+
+  return;
+}
+
+void UTIL_SEQ_StatsGetTask( uint32_t task_idx, UTIL_SEQ_TaskStats_t *p_stats )
+{
+  UTIL_SEQ_ENTER_CRITICAL_SECTION( );
+
+  *p_stats = TaskStats[task_idx];
+
+  UTIL_SEQ_EXIT_CRITICAL_SECTION( );
+
+  return;
+}
+
+void UTIL_SEQ_StatsGetEvt( UTIL_SEQ_bm_t evt_id_bm, UTIL_SEQ_EvtStats_t *p_stats )
+{
+  if (evt_id_bm == UTIL_SEQ_NO_BIT_SET)
+  {
+    UTIL_SEQ_MEMSET8(p_stats, 0, sizeof(*p_stats));
+    return;
+  }
+
+  UTIL_SEQ_ENTER_CRITICAL_SECTION( );
+
+  *p_stats = EvtStats[bit_position(evt_id_bm)];
+
+  UTIL_SEQ_EXIT_CRITICAL_SECTION( );
+
+  return;
+}
+
+void UTIL_SEQ_StatsGetIdle( UTIL_SEQ_IdleStats_t *p_stats )
+{
+  UTIL_SEQ_ENTER_CRITICAL_SECTION( );
+
+  *p_stats = IdleStats;
+
+  UTIL_SEQ_EXIT_CRITICAL_SECTION( );
+
+  return;
+}
+
+/**
+ * Only the tasks that have been executed and the events that have been waited are reported
+ * The cumulated times are reported in thousands of time units to fit in 32 bits
+ */
+void UTIL_SEQ_StatsDump( int (*p_print)( const char *format, ... ) )
+{
+  uint32_t counter;
+  UTIL_SEQ_TaskStats_t task_stats;
+  UTIL_SEQ_EvtStats_t evt_stats;
+  UTIL_SEQ_IdleStats_t idle_stats;
+
+  for (counter = 0; counter < UTIL_SEQ_CONF_TASK_NBR; counter++)
+  {
+    UTIL_SEQ_StatsGetTask( counter, &task_stats );
+    if (task_stats.RunCount != 0)
+    {
+      p_print("SEQ T%lu run=%lu exec=%luk/%lu lat=%lu/%lu\r\n",
+              (unsigned long)counter,
+              (unsigned long)task_stats.RunCount,
+              (unsigned long)(task_stats.ExecTimeSum / 1000),
+              (unsigned long)task_stats.ExecTimeMax,
+              (unsigned long)(task_stats.LatencySum / task_stats.RunCount),
+              (unsigned long)task_stats.LatencyMax);
+    }
+  }
+
+  for (counter = 0; counter < 32; counter++)
+  {
+    UTIL_SEQ_StatsGetEvt( (1U << counter), &evt_stats );
+    if (evt_stats.WaitCount != 0)
+    {
+      p_print("SEQ E%lu wait=%lu time=%luk/%lu\r\n",
+              (unsigned long)counter,
+              (unsigned long)evt_stats.WaitCount,
+              (unsigned long)(evt_stats.WaitTimeSum / 1000),
+              (unsigned long)evt_stats.WaitTimeMax);
+    }
+  }
+
+  UTIL_SEQ_StatsGetIdle( &idle_stats );
+  p_print("SEQ idle=%lu time=%luk\r\n",
+          (unsigned long)idle_stats.IdleCount,
+          (unsigned long)(idle_stats.IdleTimeSum / 1000));
+
+  return;
+}
+
+#endif
+
 __WEAK void UTIL_SEQ_EvtIdle( uint32_t UTIL_SEQ_bm_t, uint32_t evt_waited_bm )
 {
   /**
@@ -355,6 +638,282 @@ __WEAK void UTIL_SEQ_PostIdle( void )
   return;
 }
 
+/**
+ * Shall be called in critical section
+ * A task is pending at a single priority. When it is requested several times before being executed,
+ * it is kept at the highest requested priority and executed only once
+ */
+static void TaskPendingSet( uint32_t task_idx, uint32_t task_prio )
+{
+  uint32_t word = task_idx >> 5;
+
+  if (TaskPrioIdx[task_idx] <= task_prio)
+  {
+    return;
+  }
+
+  if (TaskPrioIdx[task_idx] == UTIL_SEQ_NO_PRIO)
+  {
+    /** The latency is measured from the first request of the task */
+    UTIL_SEQ_STATS_TASK_SET( task_idx );
+  }
+
+  TaskPendingClr( task_idx );
+
+  TaskPrio[task_prio].priority[word] |= (1U << (task_idx & 31));
+  TaskPrio[task_prio].word_set |= (1U << word);
+  PrioSet |= (1U << task_prio);
+  TaskPrioIdx[task_idx] = (uint8_t)task_prio;
+
+  return;
+}
+
+/**
+ * Shall be called in critical section
+ */
+static void TaskPendingClr( uint32_t task_idx )
+{
+  uint32_t word = task_idx >> 5;
+  uint32_t prio = TaskPrioIdx[task_idx];
+
+  if (prio == UTIL_SEQ_NO_PRIO)
+  {
+    return;
+  }
+
+  TaskPrio[prio].priority[word] &= ~(1U << (task_idx & 31));
+  if (TaskPrio[prio].priority[word] == UTIL_SEQ_NO_BIT_SET)
+  {
+    TaskPrio[prio].word_set &= ~(1U << word);
+    if (TaskPrio[prio].word_set == UTIL_SEQ_NO_BIT_SET)
+    {
+      PrioSet &= ~(1U << prio);
+    }
+  }
+  TaskPrioIdx[task_idx] = UTIL_SEQ_NO_PRIO;
+
+  return;
+}
+
+/**
+ * Shall be called in critical section
+ * Computes in p_ready the tasks of a priority that are pending and not masked
+ * It returns a bit mapping of the words of p_ready which are not null
+ */
+static uint32_t ReadyWords( uint32_t prio, UTIL_SEQ_bm_t *p_ready )
+{
+  uint32_t word;
+  uint32_t words = TaskPrio[prio].word_set;
+  uint32_t ready_words = UTIL_SEQ_NO_BIT_SET;
+
+  while (words)
+  {
+    word = bit_position(words);
+    words &= ~(1U << word);
+    p_ready[word] = TaskPrio[prio].priority[word] & TaskMask[word] & SuperMask[word];
+    if (p_ready[word])
+    {
+      ready_words |= (1U << word);
+    }
+  }
+
+  return ready_words;
+}
+
+/**
+ * Shall be called in critical section
+ */
+static uint32_t IsTaskReady( void )
+{
+  uint32_t prio;
+  uint32_t prio_set = PrioSet;
+  UTIL_SEQ_bm_t ready[UTIL_SEQ_TASK_WORD_NBR];
+
+  while (prio_set)
+  {
+    prio = bit_position(prio_set & (~prio_set + 1U));
+    prio_set &= ~(1U << prio);
+    if (ReadyWords( prio, ready ))
+    {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * Selects the next task to be executed and removes it from the list of pending tasks
+ * It returns UTIL_SEQ_NO_TASK when there is no task to be executed
+ */
+static uint32_t TaskPick( void )
+{
+  uint32_t prio;
+  uint32_t prio_set;
+  uint32_t word;
+  uint32_t words;
+  uint32_t ready_words = UTIL_SEQ_NO_BIT_SET;
+  uint32_t task_idx = UTIL_SEQ_NO_TASK;
+  UTIL_SEQ_bm_t ready[UTIL_SEQ_TASK_WORD_NBR];
+  UTIL_SEQ_Priority_t *p_prio;
+
+  UTIL_SEQ_ENTER_CRITICAL_SECTION( );
+
+  /**
+   * When a flag is set, the associated bit is set in the priority mask given from UTIL_SEQ_SetTask()
+   * and the priority is flagged in PrioSet. The lowest bit set in PrioSet is the highest priority.
+   * A priority is skipped only when all its pending tasks are masked
+   */
+  prio_set = PrioSet;
+  while (prio_set)
+  {
+    prio = bit_position(prio_set & (~prio_set + 1U));
+    prio_set &= ~(1U << prio);
+    ready_words = ReadyWords( prio, ready );
+    if (ready_words)
+    {
+      break;
+    }
+  }
+
+  if (ready_words)
+  {
+    p_prio = &TaskPrio[prio];
+
+    /**
+     * The round_robin register is a mask of allowed flags to be evaluated.
+     * The concept is to make sure that on each round on UTIL_SEQ_Run(), if two same flags are always set,
+     * the sequencer does not run always only the first one.
+     * When a task has been executed, The flag is removed from the round_robin mask.
+     * If on the next UTIL_SEQ_RUN(), the two same flags are set again, the round_robin mask will mask out the first flag
+     * so that the second one can be executed.
+     * Note that the first flag is not removed from the list of pending task but just masked by the round_robin mask
+     *
+     * In the check below, the round_robin mask is reinitialize in case all pending tasks haven been executed at least once
+     */
+    words = UTIL_SEQ_NO_BIT_SET;
+    for (word = 0; word < UTIL_SEQ_TASK_WORD_NBR; word++)
+    {
+      if ((ready_words & (1U << word)) && (ready[word] & p_prio->round_robin[word]))
+      {
+        words |= (1U << word);
+      }
+    }
+    if (words == UTIL_SEQ_NO_BIT_SET)
+    {
+      for (word = 0; word < UTIL_SEQ_TASK_WORD_NBR; word++)
+      {
+        p_prio->round_robin[word] = UTIL_SEQ_ALL_BIT_SET;
+      }
+      words = ready_words;
+    }
+
+    /** The highest task id is selected first as it has always been done with a single word */
+    word = bit_position(words);
+    task_idx = bit_position(ready[word] & p_prio->round_robin[word]);
+
+    /** remove from the roun_robin mask the task that has been selected to be executed */
+    p_prio->round_robin[word] &= ~(1U << task_idx);
+
+    task_idx += (word << 5);
+
+    /** remove from the list or pending task the one that has been selected to be executed */
+    TaskPendingClr( task_idx );
+  }
+
+  UTIL_SEQ_EXIT_CRITICAL_SECTION( );
+
+  return task_idx;
+}
+
+#if (UTIL_SEQ_CONF_STATS_ENABLE != 0)
+/**
+ * Reads the start time of a task that has been picked and returns its latency
+ * This is done before the task is executed as the task may be requested again while it runs, and in critical section
+ * so that TaskSetTime[] is not newer than the start time
+ */
+static uint32_t StatsTaskStart( uint32_t task_idx, uint32_t *p_start_time )
+{
+  uint32_t latency;
+
+  UTIL_SEQ_ENTER_CRITICAL_SECTION( );
+
+  *p_start_time = UTIL_SEQ_STATS_GET_TIME( );
+  latency = *p_start_time - TaskSetTime[task_idx];
+
+  UTIL_SEQ_EXIT_CRITICAL_SECTION( );
+
+  return latency;
+}
+
+/**
+ * The execution time of a task includes the tasks executed from a nested call of UTIL_SEQ_Run()
+ */
+static void StatsTaskRun( uint32_t task_idx, uint32_t start_time, uint32_t latency )
+{
+  uint32_t exec_time = UTIL_SEQ_STATS_GET_TIME( ) - start_time;
+  UTIL_SEQ_TaskStats_t *p_stats = &TaskStats[task_idx];
+
+  UTIL_SEQ_ENTER_CRITICAL_SECTION( );
+
+  p_stats->RunCount++;
+  p_stats->ExecTimeSum += exec_time;
+  if (exec_time > p_stats->ExecTimeMax)
+  {
+    p_stats->ExecTimeMax = exec_time;
+  }
+  p_stats->LatencySum += latency;
+  if (latency > p_stats->LatencyMax)
+  {
+    p_stats->LatencyMax = latency;
+  }
+
+  UTIL_SEQ_EXIT_CRITICAL_SECTION( );
+
+  return;
+}
+
+/**
+ * Shall be called in critical section
+ */
+static void StatsIdle( uint32_t start_time )
+{
+  IdleStats.IdleCount++;
+  IdleStats.IdleTimeSum += UTIL_SEQ_STATS_GET_TIME( ) - start_time;
+
+  return;
+}
+
+/**
+ * A wait on several events is counted once for each of them
+ */
+static void StatsEvtWait( UTIL_SEQ_bm_t evt_id_bm, uint32_t start_time )
+{
+  uint32_t wait_time = UTIL_SEQ_STATS_GET_TIME( ) - start_time;
+  uint32_t evt_idx;
+  UTIL_SEQ_EvtStats_t *p_stats;
+
+  UTIL_SEQ_ENTER_CRITICAL_SECTION( );
+
+  while (evt_id_bm)
+  {
+    evt_idx = bit_position(evt_id_bm);
+    evt_id_bm &= ~(1U << evt_idx);
+    p_stats = &EvtStats[evt_idx];
+    p_stats->WaitCount++;
+    p_stats->WaitTimeSum += wait_time;
+    if (wait_time > p_stats->WaitTimeMax)
+    {
+      p_stats->WaitTimeMax = wait_time;
+    }
+  }
+
+  UTIL_SEQ_EXIT_CRITICAL_SECTION( );
+
+  return;
+}
+#endif
+
 #if( __CORTEX_M == 0)
 static const uint8_t clz_table_4bit[16] = { 4, 3, 2, 2, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0 };	
 static uint32_t bit_position(uint32_t value)
@@ -32,6 +32,39 @@ extern "C" {
 /* Exported types ------------------------------------------------------------*/
   typedef uint32_t  UTIL_SEQ_bm_t;
 
+/**
+ * Run time statistics of a task
+ * Available when UTIL_SEQ_CONF_STATS_ENABLE is set to 1 in utilities_conf.h
+ * The times are in units of UTIL_SEQ_STATS_GET_TIME() (CPU cycles by default)
+ */
+  typedef struct
+  {
+    uint32_t RunCount;      /**< Number of times the task has been executed */
+    uint64_t ExecTimeSum;   /**< Cumulated execution time */
+    uint32_t ExecTimeMax;   /**< Maximum execution time */
+    uint64_t LatencySum;    /**< Cumulated time from UTIL_SEQ_SetTask() to the start of the task */
+    uint32_t LatencyMax;    /**< Maximum time from UTIL_SEQ_SetTask() to the start of the task */
+  } UTIL_SEQ_TaskStats_t;
+
+/**
+ * Time spent in UTIL_SEQ_WaitEvt() for one event
+ */
+  typedef struct
+  {
+    uint32_t WaitCount;
+    uint64_t WaitTimeSum;
+    uint32_t WaitTimeMax;
+  } UTIL_SEQ_EvtStats_t;
+
+/**
+ * Time spent in UTIL_SEQ_Idle()
+ */
+  typedef struct
+  {
+    uint32_t IdleCount;
+    uint64_t IdleTimeSum;
+  } UTIL_SEQ_IdleStats_t;
+
 /* Exported constants --------------------------------------------------------*/
 /* External variables --------------------------------------------------------*/
 /* Exported macros -----------------------------------------------------------*/
@@ -118,6 +151,8 @@ void UTIL_SEQ_PostIdle( void );
  *         This function should be called in a while loop in the application
  *
  * @param  mask_bm: this is the list of task (bit mapping) that is be kept in the sequencer list
+ *         It covers the tasks 0 to 31. When UTIL_SEQ_CONF_TASK_NBR is above 32, the tasks 32 and above
+ *         are kept only when mask_bm is UTIL_SEQ_DEFAULT
  * @retval None
  */
 void UTIL_SEQ_Run( UTIL_SEQ_bm_t mask_bm );
@@ -134,19 +169,44 @@ void UTIL_SEQ_Run( UTIL_SEQ_bm_t mask_bm );
  */
 void UTIL_SEQ_RegTask( UTIL_SEQ_bm_t task_id_bm, uint32_t flags, void (*task)( void ) );
 
+/**
+ * @brief Same as UTIL_SEQ_RegTask() with the task given by its index
+ *        This shall be used for the tasks 32 and above when UTIL_SEQ_CONF_TASK_NBR is above 32
+ *
+ * @param task_idx: The index of the task from 0 to (UTIL_SEQ_CONF_TASK_NBR - 1)
+ * @param flags: Flags are reserved param for future use
+ * @param task: Reference of the function to be executed
+ *
+ * @retval None
+ */
+void UTIL_SEQ_RegTaskIdx( uint32_t task_idx, uint32_t flags, void (*task)( void ) );
+
 /**
  * @brief  Request a task to be executed
  *
  * @param  task_id_bm: The Id of the task
  *         It shall be (1<<task_id) where task_id is the number assigned when the task has been registered
+ *         The bits at or above UTIL_SEQ_CONF_TASK_NBR are ignored
  * @param  task_prio: The priority of the task
- *         It shall an number from  0 (high priority) to 31 (low priority)
+ *         It shall an number from  0 (high priority) to (UTIL_SEQ_CONF_PRIO_NBR - 1) (low priority)
+ *         UTIL_SEQ_CONF_PRIO_NBR shall not be above 32
  *         The priority is checked each time the sequencer needs to select a new task to execute
  *         It does not permit to preempt a running task with lower priority
+ *         When a task is requested several times before being executed, it is executed once with the highest
+ *         requested priority
  * @retval None
  */
 void UTIL_SEQ_SetTask( UTIL_SEQ_bm_t task_id_bm , uint32_t task_prio );
 
+/**
+ * @brief  Same as UTIL_SEQ_SetTask() with the task given by its index
+ *
+ * @param  task_idx: The index of the task from 0 to (UTIL_SEQ_CONF_TASK_NBR - 1), the call is ignored otherwise
+ * @param  task_prio: The priority of the task
+ * @retval None
+ */
+void UTIL_SEQ_SetTaskIdx( uint32_t task_idx , uint32_t task_prio );
+
 /**
  * @brief Prevents a task to be called by the sequencer even when set with UTIL_SEQ_SetTask()
  *        By default, all tasks are executed by the sequencer when set with UTIL_SEQ_SetTask()
@@ -158,6 +218,14 @@ void UTIL_SEQ_SetTask( UTIL_SEQ_bm_t task_id_bm , uint32_t task_prio );
  */
 void UTIL_SEQ_PauseTask( UTIL_SEQ_bm_t task_id_bm );
 
+/**
+ * @brief Same as UTIL_SEQ_PauseTask() with the task given by its index
+ *
+ * @param  task_idx: The index of the task from 0 to (UTIL_SEQ_CONF_TASK_NBR - 1)
+ * @retval None
+ */
+void UTIL_SEQ_PauseTaskIdx( uint32_t task_idx );
+
 /**
  * @brief Allows a task to be called by the sequencer if set with UTIL_SEQ_SetTask()
  *        By default, all tasks are executed by the sequencer when set with UTIL_SEQ_SetTask()
@@ -170,6 +238,14 @@ void UTIL_SEQ_PauseTask( UTIL_SEQ_bm_t task_id_bm );
  */
 void UTIL_SEQ_ResumeTask( UTIL_SEQ_bm_t task_id_bm );
 
+/**
+ * @brief Same as UTIL_SEQ_ResumeTask() with the task given by its index
+ *
+ * @param  task_idx: The index of the task from 0 to (UTIL_SEQ_CONF_TASK_NBR - 1)
+ * @retval None
+ */
+void UTIL_SEQ_ResumeTaskIdx( uint32_t task_idx );
+
 /**
  * @brief It sets an event that is waited with UTIL_SEQ_WaitEvt()
  *
@@ -220,11 +296,63 @@ UTIL_SEQ_bm_t UTIL_SEQ_IsEvtPend( void );
  *
  * @param  task_id_bm: The task id that is currently running. When task_id_bm = 0, it means UTIL_SEQ_WaitEvt( )
  *                     has been called outside a registered task (ie at startup before UTIL_SEQ_Run( ) has been called
+ *                     or from a task with an index above 31
  * @param  evt_waited_bm: The event id that is waited.
  * @retval None
  */
 void UTIL_SEQ_EvtIdle( UTIL_SEQ_bm_t task_id_bm, UTIL_SEQ_bm_t evt_waited_bm );
 
+/**
+ * @brief The following APIs are available only when UTIL_SEQ_CONF_STATS_ENABLE is set to 1 in utilities_conf.h
+ *        When it is not, no time is measured and the sequencer has no overhead
+ *        By default the time is read from the DWT cycle counter. It may be changed by defining
+ *        UTIL_SEQ_STATS_GET_TIME() in utilities_conf.h
+ */
+
+/**
+ * @brief Clears all the statistics
+ *
+ * @param  None
+ * @retval None
+ */
+void UTIL_SEQ_StatsReset( void );
+
+/**
+ * @brief Reads the statistics of a task
+ *
+ * @param  task_idx: The index of the task from 0 to (UTIL_SEQ_CONF_TASK_NBR - 1)
+ * @param  p_stats: Where the statistics are copied
+ * @retval None
+ */
+void UTIL_SEQ_StatsGetTask( uint32_t task_idx, UTIL_SEQ_TaskStats_t *p_stats );
+
+/**
+ * @brief Reads the time spent in UTIL_SEQ_WaitEvt() for an event
+ *        A call of UTIL_SEQ_WaitEvt() with several events is counted for each of them
+ *
+ * @param  evt_id_bm: It shall be a bit mapping where only 1 bit is set
+ *         When several bits are set, the highest one is reported. When none is set, p_stats is cleared
+ * @param  p_stats: Where the statistics are copied
+ * @retval None
+ */
+void UTIL_SEQ_StatsGetEvt( UTIL_SEQ_bm_t evt_id_bm, UTIL_SEQ_EvtStats_t *p_stats );
+
+/**
+ * @brief Reads the time spent in UTIL_SEQ_Idle()
+ *
+ * @param  p_stats: Where the statistics are copied
+ * @retval None
+ */
+void UTIL_SEQ_StatsGetIdle( UTIL_SEQ_IdleStats_t *p_stats );
+
+/**
+ * @brief Prints one line per task executed and per event waited, and one line for the idle time
+ *
+ * @param  p_print: printf like function used to report the statistics
+ * @retval None
+ */
+void UTIL_SEQ_StatsDump( int (*p_print)( const char *format, ... ) );
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,133 @@
+/**
+ ******************************************************************************
+ * @file    seq_stats_test.c
+ * @author  MCD Application Team
+ * @brief   Host test of the run time statistics of the sequencer.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under BSD 3-Clause license,
+ * the "License"; You may not use this file except in compliance with the
+ * License. You may obtain a copy of the License at:
+ *                        opensource.org/licenses/BSD-3-Clause
+ *
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "stm32_seq.h"
+#include "utilities_conf.h"
+
+#define TEST_TASK                           (3U)
+
+uint32_t seq_test_time;
+static int test_set_again;
+static UTIL_SEQ_bm_t test_evt_set;
+
+static void
+test_fail(const char *msg, unsigned long value)
+{
+  printf("FAIL: %s (%lu)\n", msg, value);
+  exit(1);
+}
+
+/* Runs 15 time units, and requests itself again after 10 of them */
+static void
+test_task(void)
+{
+  seq_test_time += 10;
+  if (test_set_again)
+  {
+    test_set_again = 0;
+    UTIL_SEQ_SetTaskIdx(TEST_TASK, 0);
+  }
+  seq_test_time += 5;
+}
+
+void
+UTIL_SEQ_EvtIdle( uint32_t task_id_bm, uint32_t evt_waited_bm )
+{
+  seq_test_time += 7;
+  UTIL_SEQ_SetEvt(test_evt_set);
+}
+
+/* A task requested again while it runs: the latency of the first run is from
+ * the first request, not from the new one made after the start of the task */
+static void
+test_task_latency(void)
+{
+  UTIL_SEQ_TaskStats_t stats;
+
+  UTIL_SEQ_Init();
+  UTIL_SEQ_RegTaskIdx(TEST_TASK, UTIL_SEQ_RFU, test_task);
+  seq_test_time = 100;
+  UTIL_SEQ_SetTaskIdx(TEST_TASK, 0);
+  seq_test_time = 150;
+  test_set_again = 1;
+  UTIL_SEQ_Run(UTIL_SEQ_DEFAULT);
+
+  /* Runs at 150 (latency 50) and at 165 (set at 160, latency 5) */
+  UTIL_SEQ_StatsGetTask(TEST_TASK, &stats);
+  if (stats.RunCount != 2)
+  {
+    test_fail("run count", stats.RunCount);
+  }
+  if ((stats.LatencyMax != 50) || (stats.LatencySum != 55))
+  {
+    test_fail("latency", stats.LatencyMax);
+  }
+  if ((stats.ExecTimeMax != 15) || (stats.ExecTimeSum != 30))
+  {
+    test_fail("execution time", stats.ExecTimeMax);
+  }
+}
+
+/* A wait on several events is counted for each of them */
+static void
+test_evt_wait(void)
+{
+  UTIL_SEQ_EvtStats_t stats;
+
+  UTIL_SEQ_Init();
+  seq_test_time = 1000;
+  test_evt_set = (1U << 2);
+  UTIL_SEQ_WaitEvt((1U << 0) | (1U << 2));
+  UTIL_SEQ_StatsGetEvt((1U << 0), &stats);
+  if ((stats.WaitCount != 1) || (stats.WaitTimeSum != 7) || (stats.WaitTimeMax != 7))
+  {
+    test_fail("event 0", stats.WaitCount);
+  }
+  UTIL_SEQ_StatsGetEvt((1U << 2), &stats);
+  if ((stats.WaitCount != 1) || (stats.WaitTimeSum != 7))
+  {
+    test_fail("event 2", stats.WaitCount);
+  }
+  UTIL_SEQ_StatsGetEvt((1U << 1), &stats);
+  if (stats.WaitCount != 0)
+  {
+    test_fail("event 1", stats.WaitCount);
+  }
+
+  /* No event: cleared statistics, no access out of EvtStats[] (checked by UBSan) */
+  stats.WaitCount = 1;
+  UTIL_SEQ_StatsGetEvt(0, &stats);
+  if ((stats.WaitCount != 0) || (stats.WaitTimeSum != 0))
+  {
+    test_fail("no event", stats.WaitCount);
+  }
+}
+
+int
+main(void)
+{
+  test_task_latency();
+  test_evt_wait();
+  printf("PASS: statistics\n");
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,264 @@
+/**
+ ******************************************************************************
+ * @file    seq_test.c
+ * @author  MCD Application Team
+ * @brief   Host test and dispatch benchmark of the sequencer, built for
+ *          several values of UTIL_SEQ_CONF_TASK_NBR.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under BSD 3-Clause license,
+ * the "License"; You may not use this file except in compliance with the
+ * License. You may obtain a copy of the License at:
+ *                        opensource.org/licenses/BSD-3-Clause
+ *
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "stm32_seq.h"
+#include "utilities_conf.h"
+
+#define TEST_TASK_NBR                       (UTIL_SEQ_CONF_TASK_NBR)
+#define TEST_PRIO_NBR                       (UTIL_SEQ_CONF_PRIO_NBR)
+#define TEST_BENCH_DISPATCH                 2000000UL
+
+static unsigned long test_run_count[TEST_TASK_NBR];
+static uint32_t test_order[TEST_TASK_NBR];
+static uint32_t test_order_nbr;
+static uint32_t test_prio[TEST_TASK_NBR];
+/* Task re-set by the task itself while test_reset_left is not 0 */
+static unsigned long test_reset_left;
+
+static void
+test_fail(const char *msg, unsigned long arg)
+{
+  printf("FAIL (%u tasks): %s (%lu)\n", (unsigned int)TEST_TASK_NBR, msg, arg);
+  exit(1);
+}
+
+/* The task callbacks have no argument: each task has its own small function
+ * calling test_task_run() with its index */
+static void
+test_task_run(uint32_t task_idx)
+{
+  if (task_idx >= TEST_TASK_NBR)
+  {
+    test_fail("unknown task", task_idx);
+  }
+  test_run_count[task_idx]++;
+  if (test_order_nbr < TEST_TASK_NBR)
+  {
+    test_order[test_order_nbr++] = task_idx;
+  }
+  if (test_reset_left != 0)
+  {
+    test_reset_left--;
+    UTIL_SEQ_SetTaskIdx(task_idx, 0);
+  }
+}
+
+#define TEST_TASK_1(n)      static void test_task_##n(void) { test_task_run(n); }
+#define TEST_TASK_8(n)      TEST_TASK_1(n##0) TEST_TASK_1(n##1) TEST_TASK_1(n##2) TEST_TASK_1(n##3) \
+                            TEST_TASK_1(n##4) TEST_TASK_1(n##5) TEST_TASK_1(n##6) TEST_TASK_1(n##7)
+#define TEST_TASK_64(n)     TEST_TASK_8(n##0) TEST_TASK_8(n##1) TEST_TASK_8(n##2) TEST_TASK_8(n##3) \
+                            TEST_TASK_8(n##4) TEST_TASK_8(n##5) TEST_TASK_8(n##6) TEST_TASK_8(n##7)
+/* Octal task numbers: 0000 to 0377 */
+TEST_TASK_64(00) TEST_TASK_64(01) TEST_TASK_64(02) TEST_TASK_64(03)
+
+#define TEST_CB_1(n)        test_task_##n,
+#define TEST_CB_8(n)        TEST_CB_1(n##0) TEST_CB_1(n##1) TEST_CB_1(n##2) TEST_CB_1(n##3) \
+                            TEST_CB_1(n##4) TEST_CB_1(n##5) TEST_CB_1(n##6) TEST_CB_1(n##7)
+#define TEST_CB_64(n)       TEST_CB_8(n##0) TEST_CB_8(n##1) TEST_CB_8(n##2) TEST_CB_8(n##3) \
+                            TEST_CB_8(n##4) TEST_CB_8(n##5) TEST_CB_8(n##6) TEST_CB_8(n##7)
+static void (* const test_task_cb[256])(void) = {
+  TEST_CB_64(00) TEST_CB_64(01) TEST_CB_64(02) TEST_CB_64(03)
+};
+
+static void
+test_init(void)
+{
+  uint32_t i;
+
+  UTIL_SEQ_Init();
+  for (i = 0; i < TEST_TASK_NBR; i++)
+  {
+    if (i < 32)
+    {
+      UTIL_SEQ_RegTask((1U << i), UTIL_SEQ_RFU, test_task_cb[i]);
+    }
+    else
+    {
+      UTIL_SEQ_RegTaskIdx(i, UTIL_SEQ_RFU, test_task_cb[i]);
+    }
+  }
+  memset(test_run_count, 0, sizeof(test_run_count));
+  test_order_nbr = 0;
+  test_reset_left = 0;
+}
+
+static double
+test_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (ts.tv_sec * 1e9) + ts.tv_nsec;
+}
+
+/* All the tasks set at random priorities: each one runs once, by priority */
+static void
+test_priorities(void)
+{
+  uint32_t i;
+  int round;
+
+  for (round = 0; round < 200; round++)
+  {
+    test_init();
+    for (i = 0; i < TEST_TASK_NBR; i++)
+    {
+      test_prio[i] = (uint32_t)rand() % TEST_PRIO_NBR;
+      UTIL_SEQ_SetTaskIdx(i, test_prio[i]);
+      if ((rand() % 4) == 0)
+      {
+        /* A lower priority request does not change the pending one */
+        UTIL_SEQ_SetTaskIdx(i, TEST_PRIO_NBR - 1);
+      }
+    }
+    UTIL_SEQ_Run(UTIL_SEQ_DEFAULT);
+    if (test_order_nbr != TEST_TASK_NBR)
+    {
+      test_fail("tasks run", test_order_nbr);
+    }
+    for (i = 0; i < TEST_TASK_NBR; i++)
+    {
+      if (test_run_count[i] != 1)
+      {
+        test_fail("task not run once", i);
+      }
+      if ((i > 0) && (test_prio[test_order[i]] < test_prio[test_order[i - 1]]))
+      {
+        test_fail("priority order", i);
+      }
+    }
+  }
+}
+
+/* Tasks that keep setting themselves at the same priority run in turn */
+static void
+test_round_robin(void)
+{
+  uint32_t low = 0, high = TEST_TASK_NBR - 1;
+
+  test_init();
+  test_reset_left = 1000;
+  UTIL_SEQ_SetTaskIdx(low, 0);
+  UTIL_SEQ_SetTaskIdx(high, 0);
+  UTIL_SEQ_Run(UTIL_SEQ_DEFAULT);
+  if ((test_run_count[low] + test_run_count[high] != 1002)
+      || (test_run_count[low] != test_run_count[high]))
+  {
+    test_fail("round robin", test_run_count[low]);
+  }
+}
+
+/* Paused tasks, masked tasks, and requests out of the task range */
+static void
+test_masks(void)
+{
+  uint32_t last = TEST_TASK_NBR - 1;
+
+  test_init();
+  UTIL_SEQ_PauseTaskIdx(last);
+  UTIL_SEQ_SetTaskIdx(last, 0);
+  UTIL_SEQ_SetTaskIdx(0, 1);
+  UTIL_SEQ_Run(UTIL_SEQ_DEFAULT);
+  if ((test_run_count[last] != 0) || (test_run_count[0] != 1))
+  {
+    test_fail("paused task run", last);
+  }
+  UTIL_SEQ_ResumeTaskIdx(last);
+  UTIL_SEQ_Run(~1U);
+  if ((last != 0) && (last < 32) && (test_run_count[last] != 1))
+  {
+    test_fail("resumed task not run", last);
+  }
+  UTIL_SEQ_Run(UTIL_SEQ_DEFAULT);
+  if (test_run_count[last] != 1)
+  {
+    test_fail("resumed task not run", last);
+  }
+
+  /* Nothing to run, and nothing written out of the tables (checked by ASan) */
+  test_init();
+  UTIL_SEQ_SetTask(~0U, 0);
+  UTIL_SEQ_SetTaskIdx(TEST_TASK_NBR, 0);
+  UTIL_SEQ_PauseTaskIdx(TEST_TASK_NBR + 40);
+  UTIL_SEQ_ResumeTaskIdx(TEST_TASK_NBR + 40);
+  UTIL_SEQ_RegTaskIdx(TEST_TASK_NBR, UTIL_SEQ_RFU, test_task_cb[0]);
+  UTIL_SEQ_Run(UTIL_SEQ_DEFAULT);
+  if (test_order_nbr != ((TEST_TASK_NBR < 32) ? TEST_TASK_NBR : 32))
+  {
+    test_fail("tasks set from a bit mapping", test_order_nbr);
+  }
+}
+
+/* Time per task run when all the tasks are pending, and when only the last one is */
+static void
+test_bench(void)
+{
+  unsigned long n, dispatch = 0;
+  uint32_t i;
+  double start, all_ns, one_ns;
+
+  test_init();
+  start = test_now();
+  while (dispatch < TEST_BENCH_DISPATCH)
+  {
+    for (i = 0; i < TEST_TASK_NBR; i++)
+    {
+      UTIL_SEQ_SetTaskIdx(i, i % TEST_PRIO_NBR);
+    }
+    UTIL_SEQ_Run(UTIL_SEQ_DEFAULT);
+    dispatch += TEST_TASK_NBR;
+  }
+  all_ns = (test_now() - start) / dispatch;
+
+  start = test_now();
+  for (n = 0; n < TEST_BENCH_DISPATCH; n++)
+  {
+    UTIL_SEQ_SetTaskIdx(TEST_TASK_NBR - 1, TEST_PRIO_NBR - 1);
+    UTIL_SEQ_Run(UTIL_SEQ_DEFAULT);
+  }
+  one_ns = (test_now() - start) / TEST_BENCH_DISPATCH;
+
+  printf("%3u tasks: %6.1f ns per task with all tasks pending, %6.1f ns with one task pending\n",
+         (unsigned int)TEST_TASK_NBR, all_ns, one_ns);
+}
+
+int
+main(int argc, char *argv[])
+{
+  srand(1);
+  test_priorities();
+  test_round_robin();
+  test_masks();
+  if ((argc > 1) && (strcmp(argv[1], "bench") == 0))
+  {
+    test_bench();
+  }
+  else
+  {
+    printf("PASS: %u tasks\n", (unsigned int)TEST_TASK_NBR);
+  }
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,48 @@
+/**
+ ******************************************************************************
+ * @file    utilities_conf.h
+ * @author  MCD Application Team
+ * @brief   Configuration of the sequencer for the host tests.
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under BSD 3-Clause license,
+ * the "License"; You may not use this file except in compliance with the
+ * License. You may obtain a copy of the License at:
+ *                        opensource.org/licenses/BSD-3-Clause
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef UTILITIES_CONF_H
+#define UTILITIES_CONF_H
+
+#include <stdint.h>
+#include <string.h>
+
+/* What cmsis_compiler.h gives on the target */
+#define __CORTEX_M                              (4)
+#define __CLZ( value )                          ((uint32_t)__builtin_clz( value ))
+#define __WEAK                                  __attribute__((weak))
+
+/* Single threaded: no critical section */
+#define UTILS_ENTER_CRITICAL_SECTION( )
+#define UTILS_EXIT_CRITICAL_SECTION( )
+#define UTILS_MEMSET8( dest, value, size )      memset( dest, value, size )
+
+/* UTIL_SEQ_CONF_TASK_NBR and UTIL_SEQ_CONF_STATS_ENABLE are given by the Makefile */
+#define UTIL_SEQ_CONF_PRIO_NBR                  (8)
+
+#if defined(UTIL_SEQ_CONF_STATS_ENABLE) && (UTIL_SEQ_CONF_STATS_ENABLE != 0)
+/* Time set by the test, so that the statistics can be checked */
+extern uint32_t seq_test_time;
+#define UTIL_SEQ_STATS_GET_TIME( )              (seq_test_time)
+#endif
+
+#endif /* UTILITIES_CONF_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/